@@ -482,9 +482,11 @@ int App::processConverter(const CommandLineParser::ConverterTask& task)
     }
 
     switch (task.type) {
-    case CommandLineParser::ConvertType::Batch:
-        ret = converter()->batchConvert(task.inputFile, stylePath, forceMode, soundProfile);
-        break;
+    case CommandLineParser::ConvertType::Batch: {
+        size_t parallelJobs = task.params[CommandLineParser::ParamKey::BatchJobs].toUInt();
+        muse::io::path_t summaryPath = task.params[CommandLineParser::ParamKey::BatchSummaryPath].toString();
+        ret = converter()->batchConvert(task.inputFile, stylePath, forceMode, soundProfile, parallelJobs, summaryPath);
+    } break;
     case CommandLineParser::ConvertType::File:
         ret = converter()->fileConvert(task.inputFile, task.outputFile, stylePath, forceMode, soundProfile);
         break;
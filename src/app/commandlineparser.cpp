@@ -84,6 +84,10 @@ void CommandLineParser::init()
     // Converter mode
     m_parser.addOption(QCommandLineOption({ "r", "image-resolution" }, "Set output resolution for image export", "DPI"));
     m_parser.addOption(QCommandLineOption({ "j", "job" }, "Process a conversion job", "file"));
+    m_parser.addOption(QCommandLineOption("jobs", "Use with '-j <file>', convert the scores in N parallel processes "
+                                                  "and print a JSON summary to stdout", "N"));
+    m_parser.addOption(QCommandLineOption("job-summary", "Use with '-j <file>', write the JSON summary of the conversion job to the file",
+                                          "file"));
     m_parser.addOption(QCommandLineOption({ "o", "export-to" }, "Export to 'file'. Format depends on file's extension", "file"));
     m_parser.addOption(QCommandLineOption({ "F", "factory-settings" }, "Use factory settings"));
     m_parser.addOption(QCommandLineOption({ "R", "revert-settings" }, "Revert to factory settings, but keep default preferences"));
@@ -299,6 +303,20 @@ void CommandLineParser::parse(int argc, char** argv)
         m_runMode = IApplication::RunMode::ConsoleApp;
         m_converterTask.type = ConvertType::Batch;
         m_converterTask.inputFile = fromUserInputPath(m_parser.value("j"));
+
+        if (m_parser.isSet("jobs")) {
+            bool ok = false;
+            int jobs = m_parser.value("jobs").toInt(&ok);
+            if (ok && jobs > 0) {
+                m_converterTask.params[CommandLineParser::ParamKey::BatchJobs] = jobs;
+            } else {
+                LOGE() << "Option: --jobs not recognized value: " << m_parser.value("jobs");
+            }
+        }
+
+        if (m_parser.isSet("job-summary")) {
+            m_converterTask.params[CommandLineParser::ParamKey::BatchSummaryPath] = fromUserInputPath(m_parser.value("job-summary"));
+        }
     }
 
     if (m_parser.isSet("score-media")) {
@@ -112,6 +112,8 @@ public:
         ScoreTransposeOptions,
         ForceMode,
         SoundProfile,
+        BatchJobs,
+        BatchSummaryPath,
 
         // Video
     };
@@ -36,9 +36,13 @@ public:
     virtual muse::Ret fileConvert(const muse::io::path_t& in, const muse::io::path_t& out,
                                   const muse::io::path_t& stylePath = muse::io::path_t(), bool forceMode = false,
                                   const muse::String& soundProfile = muse::String()) = 0;
+    //! NOTE: parallelJobs == 0 - the jobs are converted one by one in this process, without a summary
+    //! parallelJobs > 0 - the jobs are converted by the given number of worker processes,
+    //! the JSON summary is written to summaryPath or printed to stdout
     virtual muse::Ret batchConvert(const muse::io::path_t& batchJobFile,
                                    const muse::io::path_t& stylePath = muse::io::path_t(), bool forceMode = false,
-                                   const muse::String& soundProfile = muse::String()) = 0;
+                                   const muse::String& soundProfile = muse::String(), size_t parallelJobs = 0,
+                                   const muse::io::path_t& summaryPath = muse::io::path_t()) = 0;
 
     virtual muse::Ret convertScoreParts(const muse::io::path_t& in, const muse::io::path_t& out,
                                         const muse::io::path_t& stylePath = muse::io::path_t(), bool forceMode = false) = 0;
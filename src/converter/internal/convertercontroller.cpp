@@ -21,10 +21,18 @@
  */
 #include "convertercontroller.h"
 
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include <QCoreApplication>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QJsonParseError>
+#include <QTemporaryDir>
 
 #include "global/io/file.h"
 #include "global/io/dir.h"
@@ -45,8 +53,39 @@ static const std::string PDF_SUFFIX = "pdf";
 static const std::string PNG_SUFFIX = "png";
 static const std::string SVG_SUFFIX = "svg";
 
+static double elapsedMs(const std::chrono::steady_clock::time_point& start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+//! NOTE: The arguments of this process without the batch options, so the workers run with the same settings
+static std::vector<std::string> workerArguments()
+{
+    static const QStringList BATCH_OPTIONS_WITH_VALUE = { "-j", "--job", "--jobs", "--job-summary" };
+
+    std::vector<std::string> args;
+    const QStringList appArgs = QCoreApplication::arguments();
+
+    for (int i = 1; i < appArgs.size(); ++i) {
+        const QString& arg = appArgs.at(i);
+
+        if (BATCH_OPTIONS_WITH_VALUE.contains(arg)) {
+            ++i; // skip the value
+            continue;
+        }
+
+        if (arg.startsWith("--job=") || arg.startsWith("--jobs=") || arg.startsWith("--job-summary=")) {
+            continue;
+        }
+
+        args.push_back(arg.toStdString());
+    }
+
+    return args;
+}
+
 Ret ConverterController::batchConvert(const muse::io::path_t& batchJobFile, const muse::io::path_t& stylePath, bool forceMode,
-                                      const String& soundProfile)
+                                      const String& soundProfile, size_t parallelJobs, const muse::io::path_t& summaryPath)
 {
     TRACEFUNC;
 
@@ -56,16 +95,39 @@ Ret ConverterController::batchConvert(const muse::io::path_t& batchJobFile, cons
         return batchJob.ret;
     }
 
+    const auto start = std::chrono::steady_clock::now();
+
+    BatchResult result;
+    if (parallelJobs > 1 && batchJob.val.size() > 1) {
+        result = convertInWorkers(batchJob.val, std::min(parallelJobs, batchJob.val.size()));
+    } else {
+        result.resize(batchJob.val.size());
+        for (size_t i = 0; i < batchJob.val.size(); ++i) {
+            const Job& job = batchJob.val.at(i);
+            result[i].ret = doFileConvert(job.in, job.out, stylePath, forceMode, soundProfile, &result[i]);
+        }
+    }
+
+    const double elapsedTimeMs = elapsedMs(start);
+
     StringList errors;
 
-    for (const Job& job : batchJob.val) {
-        Ret ret = fileConvert(job.in, job.out, stylePath, forceMode, soundProfile);
+    for (size_t i = 0; i < batchJob.val.size(); ++i) {
+        const Job& job = batchJob.val.at(i);
+        const Ret& ret = result.at(i).ret;
         if (!ret) {
             errors.emplace_back(String(u"failed convert, err: %1, in: %2, out: %3")
                                 .arg(String::fromStdString(ret.toString())).arg(job.in.toString()).arg(job.out.toString()));
         }
     }
 
+    if (parallelJobs > 0 || !summaryPath.empty()) {
+        Ret ret = writeBatchSummary(summaryPath, batchJob.val, result, std::max(parallelJobs, size_t(1)), elapsedTimeMs);
+        if (!ret) {
+            LOGE() << "failed write batch summary, err: " << ret.toString();
+        }
+    }
+
     if (!errors.empty()) {
         return make_ret(Err::ConvertFailed, errors.join(u"\n").toStdString());
     }
@@ -73,13 +135,102 @@ Ret ConverterController::batchConvert(const muse::io::path_t& batchJobFile, cons
     return make_ret(Ret::Code::Ok);
 }
 
+ConverterController::BatchResult ConverterController::convertInWorkers(const BatchJob& batchJob, size_t workerCount)
+{
+    TRACEFUNC;
+
+    //! NOTE: The engraving and the notation modules have global state (the current project, MScore settings and etc),
+    //! so the scores are converted by separate processes, each of them runs a part of the batch job.
+    //! The parts are small enough to balance the load, but not too small to pay the startup of a process for every score.
+    const size_t chunkSize = std::max(batchJob.size() / (workerCount * 4), size_t(1));
+    const size_t chunkCount = (batchJob.size() + chunkSize - 1) / chunkSize;
+
+    BatchResult result(batchJob.size());
+
+    QTemporaryDir tempDir;
+    if (!tempDir.isValid()) {
+        LOGE() << "failed create temp dir: " << tempDir.errorString();
+        for (JobResult& r : result) {
+            r.ret = make_ret(Err::UnknownError);
+        }
+        return result;
+    }
+
+    const std::string program = QCoreApplication::applicationFilePath().toStdString();
+    const std::vector<std::string> baseArgs = workerArguments();
+    const std::shared_ptr<IProcess> proc = process();
+
+    std::atomic<size_t> nextChunk { 0 };
+    std::mutex progressMutex;
+    size_t doneCount = 0;
+
+    auto worker = [&]() {
+        size_t chunk = 0;
+        while ((chunk = nextChunk.fetch_add(1)) < chunkCount) {
+            const size_t begin = chunk * chunkSize;
+            const size_t end = std::min(begin + chunkSize, batchJob.size());
+
+            const muse::io::path_t jobPath = tempDir.filePath(QString("job_%1.json").arg(chunk));
+            const muse::io::path_t summaryPath = tempDir.filePath(QString("summary_%1.json").arg(chunk));
+
+            BatchResult chunkResult;
+            int exitCode = 0;
+
+            Ret ret = writeBatchJob(jobPath, batchJob, begin, end);
+            if (ret) {
+                std::vector<std::string> args = baseArgs;
+                args.insert(args.end(), { "-j", jobPath.toStdString(), "--job-summary", summaryPath.toStdString() });
+
+                exitCode = proc->execute(program, args);
+                chunkResult = readBatchSummary(summaryPath);
+            }
+
+            for (size_t i = begin; i < end; ++i) {
+                if (chunkResult.size() == end - begin) {
+                    result[i] = chunkResult.at(i - begin);
+                } else if (!ret) {
+                    result[i].ret = ret;
+                } else {
+                    //! NOTE: The worker crashed or did not write the summary
+                    result[i].ret = make_ret(Err::ConvertFailed, "worker process failed, exit code: " + std::to_string(exitCode));
+                }
+            }
+
+            std::lock_guard lock(progressMutex);
+            doneCount += end - begin;
+            LOGI() << "converted: " << doneCount << "/" << batchJob.size();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        threads.emplace_back(worker);
+    }
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    return result;
+}
+
 Ret ConverterController::fileConvert(const muse::io::path_t& in, const muse::io::path_t& out, const muse::io::path_t& stylePath,
                                      bool forceMode,
                                      const String& soundProfile)
+{
+    return doFileConvert(in, out, stylePath, forceMode, soundProfile);
+}
+
+Ret ConverterController::doFileConvert(const muse::io::path_t& in, const muse::io::path_t& out, const muse::io::path_t& stylePath,
+                                       bool forceMode, const String& soundProfile, JobResult* result)
 {
     TRACEFUNC;
 
     LOGI() << "in: " << in << ", out: " << out;
+
+    const auto start = std::chrono::steady_clock::now();
+
     auto notationProject = notationCreator()->newProject();
     IF_ASSERT_FAILED(notationProject) {
         return make_ret(Err::UnknownError);
@@ -102,10 +253,23 @@ Ret ConverterController::fileConvert(const muse::io::path_t& in, const muse::io:
         notationProject->audioSettings()->setActiveSoundProfile(soundProfile);
     }
 
+    const double loadTimeMs = elapsedMs(start);
+    if (result) {
+        result->loadTimeMs = loadTimeMs;
+    }
+
+    auto finish = [&](Ret r) {
+        if (result) {
+            result->totalTimeMs = elapsedMs(start);
+            result->exportTimeMs = result->totalTimeMs - loadTimeMs;
+        }
+        return r;
+    };
+
     globalContext()->setCurrentProject(notationProject);
 
     if (suffix == engraving::MSCZ || suffix == engraving::MSCX || suffix == engraving::MSCS) {
-        return notationProject->save(out);
+        return finish(notationProject->save(out));
     }
 
     if (isConvertPageByPage(suffix)) {
@@ -122,7 +286,7 @@ Ret ConverterController::fileConvert(const muse::io::path_t& in, const muse::io:
 
     globalContext()->setCurrentProject(nullptr);
 
-    return ret;
+    return finish(ret);
 }
 
 Ret ConverterController::convertScoreParts(const muse::io::path_t& in, const muse::io::path_t& out, const muse::io::path_t& stylePath,
@@ -199,6 +363,122 @@ RetVal<ConverterController::BatchJob> ConverterController::parseBatchJob(const m
     return rv;
 }
 
+Ret ConverterController::writeBatchJob(const muse::io::path_t& batchJobFile, const BatchJob& batchJob, size_t begin, size_t end) const
+{
+    QJsonArray arr;
+    for (size_t i = begin; i < end; ++i) {
+        const Job& job = batchJob.at(i);
+
+        QJsonObject obj;
+        obj["in"] = job.in.toQString();
+        obj["out"] = job.out.toQString();
+        arr.append(obj);
+    }
+
+    QFile file(batchJobFile.toQString());
+    if (!file.open(QIODevice::WriteOnly)) {
+        return make_ret(Err::BatchJobFileFailedOpen);
+    }
+
+    file.write(QJsonDocument(arr).toJson(QJsonDocument::Compact));
+
+    return make_ret(Ret::Code::Ok);
+}
+
+ConverterController::BatchResult ConverterController::readBatchSummary(const muse::io::path_t& summaryPath) const
+{
+    BatchResult result;
+
+    QFile file(summaryPath.toQString());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return result;
+    }
+
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    const QJsonArray jobs = doc.object().value("jobs").toArray();
+
+    result.reserve(jobs.size());
+    for (const QJsonValue v : jobs) {
+        QJsonObject obj = v.toObject();
+
+        JobResult r;
+        r.ret = obj.value("success").toBool() ? make_ret(Ret::Code::Ok)
+                : Ret(obj.value("errorCode").toInt(), obj.value("error").toString().toStdString());
+        r.loadTimeMs = obj.value("loadTimeMs").toDouble();
+        r.exportTimeMs = obj.value("exportTimeMs").toDouble();
+        r.totalTimeMs = obj.value("totalTimeMs").toDouble();
+        result.push_back(std::move(r));
+    }
+
+    return result;
+}
+
+Ret ConverterController::writeBatchSummary(const muse::io::path_t& summaryPath, const BatchJob& batchJob, const BatchResult& result,
+                                           size_t workerCount, double elapsedTimeMs) const
+{
+    QJsonArray jobs;
+    size_t succeeded = 0;
+    double loadTimeMs = 0.0;
+    double exportTimeMs = 0.0;
+
+    for (size_t i = 0; i < batchJob.size(); ++i) {
+        const Job& job = batchJob.at(i);
+        const JobResult& r = result.at(i);
+
+        QJsonObject obj;
+        obj["in"] = job.in.toQString();
+        obj["out"] = job.out.toQString();
+        obj["success"] = r.ret.success();
+        if (!r.ret.success()) {
+            obj["errorCode"] = r.ret.code();
+            obj["error"] = QString::fromStdString(r.ret.toString());
+        }
+        obj["loadTimeMs"] = r.loadTimeMs;
+        obj["exportTimeMs"] = r.exportTimeMs;
+        obj["totalTimeMs"] = r.totalTimeMs;
+        jobs.append(obj);
+
+        if (r.ret.success()) {
+            ++succeeded;
+        }
+
+        loadTimeMs += r.loadTimeMs;
+        exportTimeMs += r.exportTimeMs;
+    }
+
+    QJsonObject stages;
+    stages["loadTimeMs"] = loadTimeMs;
+    stages["exportTimeMs"] = exportTimeMs;
+
+    QJsonObject summary;
+    summary["total"] = static_cast<int>(batchJob.size());
+    summary["succeeded"] = static_cast<int>(succeeded);
+    summary["failed"] = static_cast<int>(batchJob.size() - succeeded);
+    summary["workers"] = static_cast<int>(workerCount);
+    summary["elapsedTimeMs"] = elapsedTimeMs;
+    summary["scoresPerSecond"] = elapsedTimeMs > 0.0 ? batchJob.size() * 1000.0 / elapsedTimeMs : 0.0;
+    summary["stages"] = stages;
+    summary["jobs"] = jobs;
+
+    QByteArray data = QJsonDocument(summary).toJson(QJsonDocument::Indented);
+
+    if (summaryPath.empty()) {
+        std::cout << data.toStdString() << std::endl;
+        return make_ret(Ret::Code::Ok);
+    }
+
+    QFile file(summaryPath.toQString());
+    if (!file.open(QIODevice::WriteOnly)) {
+        return make_ret(Err::OutFileFailedOpen);
+    }
+
+    if (file.write(data) != data.size()) {
+        return make_ret(Err::OutFileFailedWrite);
+    }
+
+    return make_ret(Ret::Code::Ok);
+}
+
 bool ConverterController::isConvertPageByPage(const std::string& suffix) const
 {
     QList<std::string> types {
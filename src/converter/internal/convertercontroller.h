@@ -22,7 +22,7 @@
 #ifndef MU_CONVERTER_CONVERTERCONTROLLER_H
 #define MU_CONVERTER_CONVERTERCONTROLLER_H
 
-#include <list>
+#include <vector>
 
 #include "../iconvertercontroller.h"
 
@@ -31,6 +31,7 @@
 #include "project/inotationwritersregister.h"
 #include "project/iprojectrwregister.h"
 #include "context/iglobalcontext.h"
+#include "iprocess.h"
 
 #include "types/retval.h"
 
@@ -41,6 +42,7 @@ class ConverterController : public IConverterController
     INJECT(project::INotationWritersRegister, writers)
     INJECT(project::IProjectRWRegister, projectRW)
     INJECT(context::IGlobalContext, globalContext)
+    INJECT(muse::IProcess, process)
 
 public:
     ConverterController() = default;
@@ -50,7 +52,8 @@ public:
                           const muse::String& soundProfile = muse::String()) override;
     muse::Ret batchConvert(const muse::io::path_t& batchJobFile,
                            const muse::io::path_t& stylePath = muse::io::path_t(), bool forceMode = false,
-                           const muse::String& soundProfile = muse::String()) override;
+                           const muse::String& soundProfile = muse::String(), size_t parallelJobs = 0,
+                           const muse::io::path_t& summaryPath = muse::io::path_t()) override;
 
     muse::Ret convertScoreParts(const muse::io::path_t& in, const muse::io::path_t& out,
                                 const muse::io::path_t& stylePath = muse::io::path_t(), bool forceMode = false) override;
@@ -78,9 +81,27 @@ private:
         muse::io::path_t out;
     };
 
-    using BatchJob = std::list<Job>;
+    using BatchJob = std::vector<Job>;
+
+    struct JobResult {
+        muse::Ret ret;
+        double loadTimeMs = 0.0;
+        double exportTimeMs = 0.0;
+        double totalTimeMs = 0.0;
+    };
+
+    using BatchResult = std::vector<JobResult>;
+
+    muse::Ret doFileConvert(const muse::io::path_t& in, const muse::io::path_t& out, const muse::io::path_t& stylePath, bool forceMode,
+                            const muse::String& soundProfile, JobResult* result = nullptr);
 
     muse::RetVal<BatchJob> parseBatchJob(const muse::io::path_t& batchJobFile) const;
+    muse::Ret writeBatchJob(const muse::io::path_t& batchJobFile, const BatchJob& batchJob, size_t begin, size_t end) const;
+
+    BatchResult convertInWorkers(const BatchJob& batchJob, size_t workerCount);
+    BatchResult readBatchSummary(const muse::io::path_t& summaryPath) const;
+    muse::Ret writeBatchSummary(const muse::io::path_t& summaryPath, const BatchJob& batchJob, const BatchResult& result,
+                                size_t workerCount, double elapsedTimeMs) const;
 
     bool isConvertPageByPage(const std::string& suffix) const;
     muse::Ret convertPageByPage(project::INotationWriterPtr writer, notation::INotationPtr notation, const muse::io::path_t& out) const;
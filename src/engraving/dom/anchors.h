@@ -40,6 +40,8 @@ private:
 
 class TimeTickAnchor : public EngravingItem
 {
+    OBJECT_ALLOCATOR(engraving, TimeTickAnchor)
+
 public:
     TimeTickAnchor(Segment* parent);
 
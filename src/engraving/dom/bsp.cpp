@@ -20,6 +20,7 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <cmath>
 
 #include "bsp.h"
@@ -28,54 +29,6 @@
 using namespace mu;
 
 namespace mu::engraving {
-//---------------------------------------------------------
-//   InsertItemBspTreeVisitor
-//---------------------------------------------------------
-
-class InsertItemBspTreeVisitor : public BspTreeVisitor
-{
-    OBJECT_ALLOCATOR(engraving, InsertItemBspTreeVisitor)
-public:
-    EngravingItem* item;
-
-    inline void visit(std::list<EngravingItem*>* items) { items->push_front(item); }
-};
-
-//---------------------------------------------------------
-//   RemoveItemBspTreeVisitor
-//---------------------------------------------------------
-
-class RemoveItemBspTreeVisitor : public BspTreeVisitor
-{
-    OBJECT_ALLOCATOR(engraving, RemoveItemBspTreeVisitor)
-public:
-    EngravingItem* item;
-
-    inline void visit(std::list<EngravingItem*>* items) { items->remove(item); }
-};
-
-//---------------------------------------------------------
-//   FindItemBspTreeVisitor
-//---------------------------------------------------------
-
-class FindItemBspTreeVisitor : public BspTreeVisitor
-{
-    OBJECT_ALLOCATOR(engraving, FindItemBspTreeVisitor)
-public:
-    std::list<EngravingItem*> foundItems;
-
-    void visit(std::list<EngravingItem*>* items)
-    {
-        for (auto it = items->begin(); it != items->end(); ++it) {
-            EngravingItem* item = *it;
-            if (!item->itemDiscovered) {
-                item->itemDiscovered = true;
-                foundItems.push_front(item);
-            }
-        }
-    }
-};
-
 //---------------------------------------------------------
 //   BspTree
 //---------------------------------------------------------
@@ -106,9 +59,13 @@ void BspTree::initialize(const RectF& rec, int n)
     m_leafCnt    = 0;
 
     m_nodes.resize((1 << (m_depth + 1)) - 1);
-    m_leaves.resize(1LL << m_depth);
-    std::fill(m_leaves.begin(), m_leaves.end(), std::list<EngravingItem*>());
     initialize(rec, m_depth, 0);
+
+    m_items.clear();
+    m_leafItems.clear();
+    m_leafOffsets.assign(m_leafCnt + 1, 0);
+    m_itemStamps.clear();
+    m_queryStamp = 0;
 }
 
 //---------------------------------------------------------
@@ -119,66 +76,136 @@ void BspTree::clear()
 {
     m_leafCnt = 0;
     m_nodes.clear();
-    m_leaves.clear();
+    m_items.clear();
+    m_leafItems.clear();
+    m_leafOffsets.clear();
+    m_itemStamps.clear();
+    m_queryStamp = 0;
 }
 
 //---------------------------------------------------------
-//   insert
+//   rebuild
+//    The leaves of every item are collected first, then the
+//    (leaf, item) pairs are bucketed by leaf in one pass.
+//    In a leaf the items are in reverse order, the last added first,
+//    so the queries return the items in the same order as the
+//    tree filled with insert() one by one did
 //---------------------------------------------------------
 
-void BspTree::insert(EngravingItem* element)
+void BspTree::rebuild(const RectF& rect, std::vector<EngravingItem*> items)
 {
-    InsertItemBspTreeVisitor insertVisitor;
-    insertVisitor.item = element;
-    climbTree(&insertVisitor, element->pageBoundingRect());
+    initialize(rect, static_cast<int>(items.size()));
+    m_items = std::move(items);
+
+    std::vector<std::pair<int, uint32_t> > entries;
+    entries.reserve(m_items.size() * 2);
+
+    for (size_t i = m_items.size(); i > 0; --i) {
+        const uint32_t itemIndex = static_cast<uint32_t>(i - 1);
+        climbTree(m_items[itemIndex]->pageBoundingRect(), [&entries, itemIndex](int leafIndex) {
+            entries.emplace_back(leafIndex, itemIndex);
+        });
+    }
+
+    for (const auto& entry : entries) {
+        ++m_leafOffsets[entry.first + 1];
+    }
+    for (int i = 0; i < m_leafCnt; ++i) {
+        m_leafOffsets[i + 1] += m_leafOffsets[i];
+    }
+
+    m_leafItems.resize(entries.size());
+    std::vector<uint32_t> fill(m_leafOffsets.begin(), m_leafOffsets.end() - 1);
+    for (const auto& entry : entries) {
+        m_leafItems[fill[entry.first]++] = entry.second;
+    }
+
+    m_itemStamps.assign(m_items.size(), 0);
+    m_queryStamp = 0;
 }
 
 //---------------------------------------------------------
-//   remove
+//   startQuery
 //---------------------------------------------------------
 
-void BspTree::remove(EngravingItem* element)
+void BspTree::startQuery() const
 {
-    RemoveItemBspTreeVisitor removeVisitor;
-    removeVisitor.item = element;
-    climbTree(&removeVisitor, element->pageBoundingRect());
+    if (++m_queryStamp == 0) {
+        std::fill(m_itemStamps.begin(), m_itemStamps.end(), 0);
+        m_queryStamp = 1;
+    }
 }
 
 //---------------------------------------------------------
-//   items
+//   visitLeaf
+//    adds the items of the leaf that aren't found yet
 //---------------------------------------------------------
 
-std::vector<EngravingItem*> BspTree::items(const RectF& rec)
+void BspTree::visitLeaf(int leafIndex, std::vector<EngravingItem*>& result) const
 {
-    FindItemBspTreeVisitor findVisitor;
-    climbTree(&findVisitor, rec);
-    std::vector<EngravingItem*> l;
-    for (EngravingItem* e : findVisitor.foundItems) {
-        e->itemDiscovered = false;
-        if (e->pageBoundingRect().intersects(rec)) {
-            l.push_back(e);
+    const uint32_t end = m_leafOffsets[leafIndex + 1];
+    for (uint32_t i = m_leafOffsets[leafIndex]; i < end; ++i) {
+        const uint32_t itemIndex = m_leafItems[i];
+        if (m_itemStamps[itemIndex] != m_queryStamp) {
+            m_itemStamps[itemIndex] = m_queryStamp;
+            result.push_back(m_items[itemIndex]);
         }
     }
-    return l;
 }
 
 //---------------------------------------------------------
 //   items
 //---------------------------------------------------------
 
-std::vector<EngravingItem*> BspTree::items(const PointF& pos)
+void BspTree::items(const RectF& rec, std::vector<EngravingItem*>& result) const
 {
-    FindItemBspTreeVisitor findVisitor;
-    climbTree(&findVisitor, pos);
-
-    std::vector<EngravingItem*> l;
-    for (EngravingItem* e : findVisitor.foundItems) {
-        e->itemDiscovered = false;
-        if (e->contains(pos)) {
-            l.push_back(e);
-        }
+    result.clear();
+    if (m_items.empty()) {
+        return;
     }
-    return l;
+
+    startQuery();
+    climbTree(rec, [this, &result](int leafIndex) {
+        visitLeaf(leafIndex, result);
+    });
+
+    // the latest found first, as before
+    std::reverse(result.begin(), result.end());
+    result.erase(std::remove_if(result.begin(), result.end(), [&rec](const EngravingItem* e) {
+        return !e->pageBoundingRect().intersects(rec);
+    }), result.end());
+}
+
+void BspTree::items(const PointF& pos, std::vector<EngravingItem*>& result) const
+{
+    result.clear();
+    if (m_items.empty()) {
+        return;
+    }
+
+    startQuery();
+    climbTree(pos, [this, &result](int leafIndex) {
+        visitLeaf(leafIndex, result);
+    });
+
+    std::reverse(result.begin(), result.end());
+    result.erase(std::remove_if(result.begin(), result.end(), [&pos](const EngravingItem* e) {
+        return !e->contains(pos);
+    }), result.end());
+}
+
+std::vector<EngravingItem*> BspTree::items(const RectF& rec) const
+{
+    std::vector<EngravingItem*> result;
+    items(rec, result);
+    return result;
+}
+
+std::vector<EngravingItem*> BspTree::items(const PointF& pos) const
+{
+    std::vector<EngravingItem*> result;
+    items(pos, result);
+    return result;
 }
 
 #ifndef NDEBUG
@@ -193,11 +220,12 @@ String BspTree::debug(int index) const
     String tmp;
     if (node->type == Node::Type::LEAF) {
         RectF rec = rectForIndex(index);
-        if (!m_leaves[node->leafIndex].empty()) {
+        const uint32_t count = m_leafOffsets[node->leafIndex + 1] - m_leafOffsets[node->leafIndex];
+        if (count > 0) {
             tmp += String(u"[%1, %2, %3, %4] contains %5 items\n")
                    .arg(rec.left()).arg(rec.top())
                    .arg(rec.width()).arg(rec.height())
-                   .arg(m_leaves[node->leafIndex].size());
+                   .arg(static_cast<int>(count));
         }
     } else {
         if (node->type == Node::Type::HORIZONTAL) {
@@ -266,31 +294,32 @@ void BspTree::initialize(const RectF& rec, int dep, int index)
 //   climbTree
 //---------------------------------------------------------
 
-void BspTree::climbTree(BspTreeVisitor* visitor, const PointF& pos, int index)
+template<typename Func>
+void BspTree::climbTree(const PointF& pos, const Func& func, int index) const
 {
     if (m_nodes.empty()) {
         return;
     }
 
-    Node* node = &m_nodes[index];
+    const Node* node = &m_nodes[index];
     int childIndex = firstChildIndex(index);
 
     switch (node->type) {
     case Node::Type::LEAF:
-        visitor->visit(&m_leaves[node->leafIndex]);
+        func(node->leafIndex);
         break;
     case Node::Type::VERTICAL:
         if (pos.x() < node->offset) {
-            climbTree(visitor, pos, childIndex);
+            climbTree(pos, func, childIndex);
         } else {
-            climbTree(visitor, pos, childIndex + 1);
+            climbTree(pos, func, childIndex + 1);
         }
         break;
     case Node::Type::HORIZONTAL:
         if (pos.y() < node->offset) {
-            climbTree(visitor, pos, childIndex);
+            climbTree(pos, func, childIndex);
         } else {
-            climbTree(visitor, pos, childIndex + 1);
+            climbTree(pos, func, childIndex + 1);
         }
         break;
     }
@@ -300,37 +329,38 @@ void BspTree::climbTree(BspTreeVisitor* visitor, const PointF& pos, int index)
 //   climbTree
 //---------------------------------------------------------
 
-void BspTree::climbTree(BspTreeVisitor* visitor, const RectF& rec, int index)
+template<typename Func>
+void BspTree::climbTree(const RectF& rec, const Func& func, int index) const
 {
     if (m_nodes.empty()) {
         return;
     }
 
-    Node* node = &m_nodes[index];
+    const Node* node = &m_nodes[index];
     int childIndex = firstChildIndex(index);
 
     switch (node->type) {
     case Node::Type::LEAF:
-        visitor->visit(&m_leaves[node->leafIndex]);
+        func(node->leafIndex);
         break;
     case Node::Type::VERTICAL:
         if (rec.left() < node->offset) {
-            climbTree(visitor, rec, childIndex);
+            climbTree(rec, func, childIndex);
             if (rec.right() >= node->offset) {
-                climbTree(visitor, rec, childIndex + 1);
+                climbTree(rec, func, childIndex + 1);
             }
         } else {
-            climbTree(visitor, rec, childIndex + 1);
+            climbTree(rec, func, childIndex + 1);
         }
         break;
     case Node::Type::HORIZONTAL:
         if (rec.top() < node->offset) {
-            climbTree(visitor, rec, childIndex);
+            climbTree(rec, func, childIndex);
             if (rec.bottom() >= node->offset) {
-                climbTree(visitor, rec, childIndex + 1);
+                climbTree(rec, func, childIndex + 1);
             }
         } else {
-            climbTree(visitor, rec, childIndex + 1);
+            climbTree(rec, func, childIndex + 1);
         }
     }
 }
@@ -23,23 +23,21 @@
 #ifndef MU_ENGRAVING_BSP_H
 #define MU_ENGRAVING_BSP_H
 
-#include <list>
+#include <cstdint>
+#include <vector>
 
-#include "global/allocator.h"
 #include "types/string.h"
 #include "../types/types.h"
 
 namespace mu::engraving {
-class BspTreeVisitor;
-class InsertItemBspTreeVisitor;
-class RemoveItemBspTreeVisitor;
-class FindItemBspTreeVisitor;
-
 class EngravingItem;
 
 //---------------------------------------------------------
 //   BspTree
 //    binary space partitioning
+//    The leaves are stored flat: the items of the leaf i are
+//    m_leafItems[m_leafOffsets[i] .. m_leafOffsets[i + 1]),
+//    as indices into m_items
 //---------------------------------------------------------
 
 class BspTree
@@ -58,32 +56,48 @@ public:
 private:
 
     void initialize(const RectF& rect, int depth, int index);
-    void climbTree(BspTreeVisitor* visitor, const PointF& pos, int index = 0);
-    void climbTree(BspTreeVisitor* visitor, const RectF& rect, int index = 0);
 
-    void findItems(std::list<EngravingItem*>* foundItems, const RectF& rect, int index);
-    void findItems(std::list<EngravingItem*>* foundItems, const PointF& pos, int index);
+    template<typename Func>
+    void climbTree(const PointF& pos, const Func& func, int index = 0) const;
+    template<typename Func>
+    void climbTree(const RectF& rect, const Func& func, int index = 0) const;
+
+    void startQuery() const;
+    void visitLeaf(int leafIndex, std::vector<EngravingItem*>& result) const;
     RectF rectForIndex(int index) const;
 
     unsigned int m_depth = 0;
     std::vector<Node> m_nodes;
-    std::vector<std::list<EngravingItem*> > m_leaves;
     int m_leafCnt = 0;
     RectF m_rect;
 
+    std::vector<EngravingItem*> m_items;
+    std::vector<uint32_t> m_leafOffsets;
+    std::vector<uint32_t> m_leafItems;
+
+    // the items already found by the current query
+    mutable std::vector<uint32_t> m_itemStamps;
+    mutable uint32_t m_queryStamp = 0;
+
 public:
     BspTree();
 
     void initialize(const RectF& rect, int depth);
     void clear();
 
-    void insert(EngravingItem* item);
-    void remove(EngravingItem* item);
+    //! NOTE Builds the tree over all the items at once
+    void rebuild(const RectF& rect, std::vector<EngravingItem*> items);
+
+    //! NOTE The results are written to the buffer (it's cleared first),
+    //! so the caller can reuse it between the queries
+    void items(const RectF& rect, std::vector<EngravingItem*>& result) const;
+    void items(const PointF& pos, std::vector<EngravingItem*>& result) const;
 
-    std::vector<EngravingItem*> items(const RectF& rect);
-    std::vector<EngravingItem*> items(const PointF& pos);
+    std::vector<EngravingItem*> items(const RectF& rect) const;
+    std::vector<EngravingItem*> items(const PointF& pos) const;
 
     int leafCount() const { return m_leafCnt; }
+    size_t itemCount() const { return m_items.size(); }
     inline int firstChildIndex(int index) const { return index * 2 + 1; }
 
     inline int parentIndex(int index) const
@@ -95,17 +109,5 @@ public:
     String debug(int index) const;
 #endif
 };
-
-//---------------------------------------------------------
-//   BspTreeVisitor
-//---------------------------------------------------------
-
-class BspTreeVisitor
-{
-    OBJECT_ALLOCATOR(engraving, BspTreeVisitor)
-public:
-    virtual ~BspTreeVisitor() {}
-    virtual void visit(std::list<EngravingItem*>* items) = 0;
-};
 } // namespace mu::engraving
 #endif
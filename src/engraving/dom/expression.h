@@ -29,6 +29,7 @@ class Dynamic;
 
 class Expression final : public TextBase
 {
+    OBJECT_ALLOCATOR(engraving, Expression)
     M_PROPERTY(bool, snapToDynamics, setSnapToDynamics)
     DECLARE_CLASSOF(ElementType::EXPRESSION)
 
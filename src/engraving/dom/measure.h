@@ -358,6 +358,35 @@ public:
 
     void respaceSegments();
 
+    //! NOTE: The result of the horizontal spacing of the measure, see rendering MeasureLayout::computeWidth.
+    //! It is reused while the content of the measure and the spacing parameters are the same
+    struct SpacingCache {
+        struct SegmentSpacing {
+            double x = 0.0;
+            double width = 0.0;
+            double widthOffset = 0.0;
+            double stretch = 1.0;
+        };
+
+        struct Entry {
+            uint64_t key = 0;
+            double width = 0.0;
+            double squeezableSpace = 0.0;
+            double layoutStretch = 1.0;
+            bool widthLocked = false;
+            std::vector<SegmentSpacing> segments;
+        };
+
+        //! NOTE: The width is computed with the different parameters while the systems are collected,
+        //! so keep a few last results
+        static constexpr size_t MAX_ENTRIES = 4;
+
+        std::vector<Entry> entries;
+    };
+
+    SpacingCache& spacingCache() const { return m_spacingCache; }
+    void invalidateSpacingCache() { m_spacingCache.entries.clear(); }
+
     bool canAddStringTunings(staff_idx_t staffIdx) const;
 
 private:
@@ -401,6 +430,8 @@ private:
 
     double m_layoutStretch = 1.0;
     bool m_isWidthLocked = false;
+
+    mutable SpacingCache m_spacingCache;
 };
 } // namespace mu::engraving
 #endif
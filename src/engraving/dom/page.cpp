@@ -74,6 +74,14 @@ std::vector<EngravingItem*> Page::items(const PointF& point)
     return bspTree.items(point);
 }
 
+void Page::items(const RectF& rect, std::vector<EngravingItem*>& result)
+{
+    if (!m_bspTreeValid) {
+        doRebuildBspTree();
+    }
+    bspTree.items(rect, result);
+}
+
 //---------------------------------------------------------
 //   appendSystem
 //---------------------------------------------------------
@@ -249,28 +257,14 @@ void Page::scanElements(void* data, void (* func)(void*, EngravingItem*), bool a
     func(data, this);
 }
 
-//---------------------------------------------------------
-//   bspInsert
-//---------------------------------------------------------
-
-static void bspInsert(void* bspTree, EngravingItem* e)
-{
-    ((BspTree*)bspTree)->insert(e);
-}
-
-static void countElements(void* data, EngravingItem* /*e*/)
-{
-    ++(*(int*)data);
-}
-
 //---------------------------------------------------------
 //   doRebuildBspTree
 //---------------------------------------------------------
 
 void Page::doRebuildBspTree()
 {
-    int n = 0;
-    scanElements(&n, countElements, false);
+    std::vector<EngravingItem*> elements;
+    scanElements(&elements, collectElements, false);
 
     RectF r;
     if (score()->linearMode()) {
@@ -288,8 +282,7 @@ void Page::doRebuildBspTree()
         r = abbox();
     }
 
-    bspTree.initialize(r, n);
-    scanElements(&bspTree, &bspInsert, false);
+    bspTree.rebuild(r, std::move(elements));
     m_bspTreeValid = true;
 }
 
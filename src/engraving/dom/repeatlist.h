@@ -23,6 +23,7 @@
 #ifndef MU_ENGRAVING_REPEATLIST_H
 #define MU_ENGRAVING_REPEATLIST_H
 
+#include <atomic>
 #include <set>
 #include <vector>
 
@@ -111,7 +112,8 @@ private:
     void flatten();
 
     Score* m_score = nullptr;
-    mutable unsigned m_idx1, m_idx2 = 0;     // cached values
+    mutable std::atomic<unsigned> m_idx1 = 0;     // cached values, may be updated by concurrent readers
+    mutable std::atomic<unsigned> m_idx2 = 0;
 
     bool m_expanded = false;
     bool m_scoreChanged = true;
@@ -846,6 +846,20 @@ public:
     bool linearMode() const { return m_layoutOptions.isLinearMode(); }
     // ----
 
+    //! NOTE The horizontal spacing of the measures is cached between the layouts (see rendering MeasureLayout),
+    //! bumping the generation drops the cache of all measures of the score. The stats are of the last layout
+    struct SpacingCacheStats {
+        size_t hits = 0;
+        size_t misses = 0;
+
+        double hitRate() const { return hits + misses > 0 ? double(hits) / double(hits + misses) : 0.0; }
+    };
+
+    uint64_t spacingCacheGeneration() const { return m_spacingCacheGeneration; }
+    void invalidateSpacingCache() { ++m_spacingCacheGeneration; }
+    const SpacingCacheStats& spacingCacheStats() const { return m_spacingCacheStats; }
+    SpacingCacheStats& spacingCacheStats() { return m_spacingCacheStats; }
+
     void cmdSelectAll();
     void cmdSelectSection();
     void transposeSemitone(int semitone);
@@ -1121,6 +1135,8 @@ private:
 
     RootItem* m_rootItem = nullptr;
     LayoutOptions m_layoutOptions;
+    uint64_t m_spacingCacheGeneration = 0;
+    SpacingCacheStats m_spacingCacheStats;
 
     muse::async::Channel<EngravingItem*> m_elementDestroyed;
 
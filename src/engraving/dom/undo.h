@@ -1639,6 +1639,8 @@ public:
 
 class ChangeStringData : public UndoCommand
 {
+    OBJECT_ALLOCATOR(engraving, ChangeStringData)
+
     Instrument* m_instrument = nullptr;
     StringTunings* m_stringTunings = nullptr;
     StringData m_stringData;
@@ -1655,6 +1657,8 @@ public:
 
 class ChangeSoundFlag : public UndoCommand
 {
+    OBJECT_ALLOCATOR(engraving, ChangeSoundFlag)
+
     SoundFlag* m_soundFlag = nullptr;
     SoundFlag::PresetCodes m_presets;
     SoundFlag::PlayingTechniqueCode m_playingTechnique;
@@ -181,6 +181,8 @@ void EngravingModule::onInit(const IApplication::RunMode& mode)
         // Symbols
         Smufl::init();
 
+        m_engravingfonts->setMetricsCachePath(m_configuration->fontMetricsCachePath());
+
         m_engravingfonts->addFont("Leland",     "Leland",      ":/fonts/leland/Leland.otf");
         m_engravingfonts->addFont("Bravura",    "Bravura",     ":/fonts/bravura/Bravura.otf");
         m_engravingfonts->addFont("Emmentaler", "MScore",      ":/fonts/mscore/mscore.ttf");
@@ -273,6 +275,8 @@ void EngravingModule::onInit(const IApplication::RunMode& mode)
         // Symbols
         Smufl::init();
 
+        m_engravingfonts->setMetricsCachePath(m_configuration->fontMetricsCachePath());
+
         m_engravingfonts->addFont("Leland",     "Leland",      ":/fonts/leland/Leland.otf");
         m_engravingfonts->addFont("Bravura",    "Bravura",     ":/fonts/bravura/Bravura.otf");
         m_engravingfonts->addFont("Emmentaler", "MScore",      ":/fonts/mscore/mscore.ttf");
@@ -41,6 +41,7 @@ public:
     virtual ~IEngravingConfiguration() = default;
 
     virtual muse::io::path_t appDataPath() const = 0;
+    virtual muse::io::path_t fontMetricsCachePath() const = 0;
 
     virtual muse::io::path_t defaultStyleFilePath() const = 0;
     virtual void setDefaultStyleFilePath(const muse::io::path_t& path) = 0;
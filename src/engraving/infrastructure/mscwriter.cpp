@@ -100,10 +100,14 @@ bool MscWriter::hasError() const
 
 MscWriter::IWriter* MscWriter::writer() const
 {
+    if (!m_writer && m_params.snapshot) {
+        m_writer = new SnapshotWriter();
+    }
+
     if (!m_writer) {
         switch (m_params.mode) {
         case MscIoMode::Zip:
-            m_writer = new ZipFileWriter();
+            m_writer = new ZipFileWriter(m_params);
             break;
         case MscIoMode::Dir:
             m_writer = new DirWriter();
@@ -235,6 +239,64 @@ void MscWriter::writeContainer(const std::vector<String>& paths)
     addFileData(u"META-INF/container.xml", data);
 }
 
+MscWriter::Snapshot MscWriter::takeSnapshot()
+{
+    Snapshot snapshot;
+
+    IF_ASSERT_FAILED(m_params.snapshot) {
+        return snapshot;
+    }
+
+    SnapshotWriter* snapshotWriter = static_cast<SnapshotWriter*>(writer());
+    if (snapshotWriter->isOpened()) {
+        writeMeta();
+        snapshotWriter->close();
+    }
+
+    snapshot.params = m_params;
+    snapshot.params.snapshot = false;
+    if (snapshot.params.fileTime == 0) {
+        snapshot.params.fileTime = snapshotWriter->time;
+    }
+
+    snapshot.files = std::move(snapshotWriter->files);
+
+    close();
+
+    return snapshot;
+}
+
+Ret MscWriter::writeSnapshot(const Snapshot& snapshot)
+{
+    IF_ASSERT_FAILED(!snapshot.params.snapshot) {
+        return make_ret(Ret::Code::InternalError);
+    }
+
+    MscWriter msczWriter(snapshot.params);
+    Ret ret = msczWriter.open();
+    if (!ret) {
+        return ret;
+    }
+
+    //! NOTE The meta file is already in the snapshot
+    msczWriter.m_meta.isWritten = true;
+
+    for (const auto& file : snapshot.files) {
+        if (!msczWriter.addFileData(file.first, file.second)) {
+            return make_ret(Ret::Code::UnknownError);
+        }
+    }
+
+    msczWriter.close();
+
+    if (msczWriter.hasError()) {
+        LOGE() << "MscWriter has error after writing snapshot";
+        return make_ret(Ret::Code::UnknownError);
+    }
+
+    return make_ok();
+}
+
 bool MscWriter::Meta::contains(const String& file) const
 {
     if (std::find(files.begin(), files.end(), file) != files.end()) {
@@ -254,6 +316,11 @@ void MscWriter::Meta::addFile(const String& file)
 // Writers
 // =======================================================================
 
+MscWriter::ZipFileWriter::ZipFileWriter(const Params& params)
+    : m_fileTime(params.fileTime), m_compressionLevel(params.compressionLevel), m_compressionThreadCount(params.compressionThreadCount)
+{
+}
+
 MscWriter::ZipFileWriter::~ZipFileWriter()
 {
     delete m_zip;
@@ -278,6 +345,9 @@ Ret MscWriter::ZipFileWriter::open(io::IODevice* device, const path_t& filePath)
     }
 
     m_zip = new ZipWriter(m_device);
+    m_zip->setFileTime(m_fileTime);
+    m_zip->setCompressionLevel(m_compressionLevel);
+    m_zip->setThreadCount(m_compressionThreadCount);
 
     return true;
 }
@@ -469,3 +539,32 @@ bool MscWriter::XmlFileWriter::addFileData(const String& fileName, const ByteArr
 
     return true;
 }
+
+Ret MscWriter::SnapshotWriter::open(io::IODevice*, const muse::io::path_t&)
+{
+    files.clear();
+    time = std::time(nullptr);
+    m_isOpened = true;
+    return true;
+}
+
+void MscWriter::SnapshotWriter::close()
+{
+    m_isOpened = false;
+}
+
+bool MscWriter::SnapshotWriter::isOpened() const
+{
+    return m_isOpened;
+}
+
+bool MscWriter::SnapshotWriter::hasError() const
+{
+    return false;
+}
+
+bool MscWriter::SnapshotWriter::addFileData(const String& fileName, const ByteArray& data)
+{
+    files.emplace_back(fileName, data);
+    return true;
+}
@@ -22,6 +22,10 @@
 #ifndef MU_ENGRAVING_MSCWRITER_H
 #define MU_ENGRAVING_MSCWRITER_H
 
+#include <ctime>
+#include <utility>
+#include <vector>
+
 #include "types/string.h"
 #include "types/ret.h"
 #include "io/path.h"
@@ -44,6 +48,27 @@ public:
         muse::io::path_t filePath;
         muse::String mainFileName;
         MscIoMode mode = MscIoMode::Zip;
+
+        //! NOTE The modification time of the files in a zip container, the current time if not set (0)
+        std::time_t fileTime = 0;
+
+        //! NOTE The compression of a zip container: the zlib level (1 - 9), -1 - the zlib default,
+        //! 0 - the files are stored without compression (autosaves and temporary files, which are written often)
+        int compressionLevel = -1;
+
+        //! NOTE The number of threads compressing the files of a zip container, 0 - all the threads of the TaskScheduler
+        size_t compressionThreadCount = 0;
+
+        //! NOTE If set, the files are only kept in memory, see takeSnapshot
+        bool snapshot = false;
+    };
+
+    //! NOTE The files of a project written in memory, without compression.
+    //! It is cheap to make, and it can be written to the target later on any thread, see writeSnapshot
+    struct Snapshot
+    {
+        Params params;
+        std::vector<std::pair<muse::String, muse::ByteArray> > files;
     };
 
     MscWriter() = default;
@@ -69,6 +94,10 @@ public:
     void writeAudioSettingsJsonFile(const muse::ByteArray& data, const muse::io::path_t& pathPrefix = "");
     void writeViewSettingsJsonFile(const muse::ByteArray& data, const muse::io::path_t& pathPrefix = "");
 
+    //! NOTE Closes the writer and returns the written files, for the snapshot mode only
+    Snapshot takeSnapshot();
+    static muse::Ret writeSnapshot(const Snapshot& snapshot);
+
 private:
 
     struct IWriter {
@@ -83,6 +112,7 @@ private:
 
     struct ZipFileWriter : public IWriter
     {
+        explicit ZipFileWriter(const Params& params);
         ~ZipFileWriter() override;
         muse::Ret open(muse::io::IODevice* device, const muse::io::path_t& filePath) override;
         void close() override;
@@ -94,6 +124,9 @@ private:
         muse::io::IODevice* m_device = nullptr;
         bool m_selfDeviceOwner = false;
         muse::ZipWriter* m_zip = nullptr;
+        std::time_t m_fileTime = 0;
+        int m_compressionLevel = -1;
+        size_t m_compressionThreadCount = 0;
     };
 
     struct DirWriter : public IWriter
@@ -122,6 +155,20 @@ private:
         muse::TextStream* m_stream = nullptr;
     };
 
+    struct SnapshotWriter : public IWriter
+    {
+        muse::Ret open(muse::io::IODevice* device, const muse::io::path_t& filePath) override;
+        void close() override;
+        bool isOpened() const override;
+        bool hasError() const override;
+        bool addFileData(const muse::String& fileName, const muse::ByteArray& data) override;
+
+        std::vector<std::pair<muse::String, muse::ByteArray> > files;
+        std::time_t time = 0;
+    private:
+        bool m_isOpened = false;
+    };
+
     struct Meta {
         std::vector<muse::String> files;
         bool isWritten = false;
@@ -65,7 +65,7 @@ void Shape::addHorizontalSpacing(EngravingItem* item, double leftEdge, double ri
 //   translate
 //---------------------------------------------------------
 
-Shape& Shape::translate(const PointF& pt)
+Shape& Shape::translate(const PointF& pt) &
 {
     for (RectF& r : m_elements) {
         r.translate(pt);
@@ -74,6 +74,11 @@ Shape& Shape::translate(const PointF& pt)
     return *this;
 }
 
+Shape&& Shape::translate(const PointF& pt) &&
+{
+    return std::move(translate(pt));
+}
+
 void Shape::translateX(double xo)
 {
     for (RectF& r : m_elements) {
@@ -96,7 +101,7 @@ void Shape::translateY(double yo)
 //   translated
 //---------------------------------------------------------
 
-Shape Shape::translated(const PointF& pt) const
+Shape Shape::translated(const PointF& pt) const&
 {
     Shape s;
     s.m_elements.reserve(m_elements.size());
@@ -106,7 +111,12 @@ Shape Shape::translated(const PointF& pt) const
     return s;
 }
 
-Shape& Shape::scale(const SizeF& mag)
+Shape Shape::translated(const PointF& pt) &&
+{
+    return std::move(translate(pt));
+}
+
+Shape& Shape::scale(const SizeF& mag) &
 {
     for (RectF& r : m_elements) {
         r.scale(mag);
@@ -115,7 +125,12 @@ Shape& Shape::scale(const SizeF& mag)
     return *this;
 }
 
-Shape Shape::scaled(const SizeF& mag) const
+Shape&& Shape::scale(const SizeF& mag) &&
+{
+    return std::move(scale(mag));
+}
+
+Shape Shape::scaled(const SizeF& mag) const&
 {
     Shape s;
     s.m_elements.reserve(m_elements.size());
@@ -125,6 +140,11 @@ Shape Shape::scaled(const SizeF& mag) const
     return s;
 }
 
+Shape Shape::scaled(const SizeF& mag) &&
+{
+    return std::move(scale(mag));
+}
+
 void Shape::invalidateBBox()
 {
     m_bbox = RectF();
@@ -462,18 +482,16 @@ void Shape::remove(const Shape& s)
 
 void Shape::removeInvisibles()
 {
-    muse::remove_if(m_elements, [](ShapeElement& shapeElement) {
+    remove_if([](ShapeElement& shapeElement) {
         return !shapeElement.item() || !shapeElement.item()->visible();
     });
-    invalidateBBox();
 }
 
 void Shape::removeTypes(const std::set<ElementType>& types)
 {
-    muse::remove_if(m_elements, [&types](ShapeElement& shapeElement) {
+    remove_if([&types](ShapeElement& shapeElement) {
         return shapeElement.item() && muse::contains(types, shapeElement.item()->type());
     });
-    invalidateBBox();
 }
 
 //---------------------------------------------------------
@@ -504,20 +522,73 @@ bool Shape::intersects(const RectF& rr) const
     return false;
 }
 
+//---------------------------------------------------------
+//   mayIntersect
+//    quick rejection test on the bboxes, the margin covers
+//    the rounding differences between the bbox and the rects
+//---------------------------------------------------------
+
+static bool mayIntersect(const RectF& box1, const RectF& box2)
+{
+    constexpr double margin = 1e-6;
+    return box1.adjusted(-margin, -margin, margin, margin).intersects(box2);
+}
+
 //---------------------------------------------------------
 //   intersects
+//    true if any of the rects intersects this shape
 //---------------------------------------------------------
 
-bool Shape::intersects(const Shape& other) const
+bool Shape::intersects(const RectF* rects, size_t count) const
 {
-    for (const RectF& r : other.m_elements) {
-        if (intersects(r)) {
+    if (m_elements.empty() || count == 0) {
+        return false;
+    }
+
+    const RectF& box = bbox();
+    for (size_t i = 0; i < count; ++i) {
+        if (!mayIntersect(box, rects[i])) {
+            continue;
+        }
+        if (intersects(rects[i])) {
             return true;
         }
     }
     return false;
 }
 
+bool Shape::intersects(const Shape& other) const
+{
+    return intersects(other.m_elements.data(), other.m_elements.size());
+}
+
+//---------------------------------------------------------
+//   intersects
+//    same as translated(pos).intersects(other.translated(otherPos)),
+//    but without the copies
+//---------------------------------------------------------
+
+bool Shape::intersects(const Shape& other, const PointF& pos, const PointF& otherPos) const
+{
+    if (m_elements.empty() || other.m_elements.empty()) {
+        return false;
+    }
+
+    if (!mayIntersect(bbox().translated(pos), other.bbox().translated(otherPos))) {
+        return false;
+    }
+
+    for (const RectF& r2 : other.m_elements) {
+        const RectF rr = r2.translated(otherPos);
+        for (const RectF& r1 : m_elements) {
+            if (r1.translated(pos).intersects(rr)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 void Shape::paint(Painter& painter) const
 {
     for (const RectF& r : m_elements) {
@@ -30,6 +30,8 @@
 
 #include "engraving/types/types.h"
 
+#include "smallvector.h"
+
 namespace muse::draw {
 class Painter;
 }
@@ -60,6 +62,10 @@ private:
     bool m_ignoreForLayout = false;
 };
 
+//! NOTE Most shapes are a single bbox or a few rects (a note, a chord of one note),
+//! they are kept inline, without a heap allocation
+using ShapeElements = SmallVector<ShapeElement, 4>;
+
 //---------------------------------------------------------
 //   Shape
 //---------------------------------------------------------
@@ -126,8 +132,8 @@ public:
 
     // ---
 
-    const std::vector<ShapeElement>& elements() const { return m_elements; }
-    std::vector<ShapeElement>& elements() { return m_elements; }
+    const ShapeElements& elements() const { return m_elements; }
+    ShapeElements& elements() { return m_elements; }
 
     std::optional<ShapeElement> find_if(const std::function<bool(const ShapeElement&)>& func) const;
     std::optional<ShapeElement> find_first(ElementType type) const;
@@ -138,12 +144,18 @@ public:
 
     void addHorizontalSpacing(EngravingItem* item, double left, double right);
 
-    Shape& translate(const PointF&);
+    //! NOTE On a temporary (like `item->shape().translate(pos)`) these work in place
+    //! and the result is moved out, so the elements are not copied again
+    Shape& translate(const PointF&) &;
+    Shape&& translate(const PointF&) &&;
     void translateX(double);
     void translateY(double);
-    Shape translated(const PointF&) const;
-    Shape& scale(const SizeF&);
-    Shape scaled(const SizeF&) const;
+    Shape translated(const PointF&) const&;
+    Shape translated(const PointF&) &&;
+    Shape& scale(const SizeF&) &;
+    Shape&& scale(const SizeF&) &&;
+    Shape scaled(const SizeF&) const&;
+    Shape scaled(const SizeF&) &&;
 
     const RectF& bbox() const;
     double minVerticalDistance(const Shape&) const;
@@ -159,7 +171,9 @@ public:
 
     bool contains(const PointF&) const;
     bool intersects(const RectF& rr) const;
+    bool intersects(const RectF* rects, size_t count) const;
     bool intersects(const Shape&) const;
+    bool intersects(const Shape& other, const PointF& pos, const PointF& otherPos) const;
     bool clearsVertically(const Shape& a) const;
 
     void paint(muse::draw::Painter& painter) const;
@@ -169,7 +183,7 @@ private:
     void invalidateBBox();
 
     Type m_type = Type::Fixed;
-    std::vector<ShapeElement> m_elements;
+    ShapeElements m_elements;
     mutable RectF m_bbox;   // cache
 };
 
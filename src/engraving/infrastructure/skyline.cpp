@@ -22,6 +22,17 @@
 
 #include "skyline.h"
 
+#include <algorithm>
+#include <limits>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define SKL_USE_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SKL_USE_SSE2
+#endif
+
 #include "realfn.h"
 #include "draw/painter.h"
 
@@ -40,6 +51,9 @@ namespace mu::engraving {
 static const double MAXIMUM_Y = 1000000.0;
 static const double MINIMUM_Y = -1000000.0;
 
+//! NOTE: Shapes with less elements are added element by element, it is cheaper than the batch merge
+static constexpr size_t BATCH_MIN_SIZE = 4;
+
 // #define SKL_DEBUG
 
 #ifdef SKL_DEBUG
@@ -49,17 +63,109 @@ static const double MINIMUM_Y = -1000000.0;
 #endif
 
 //---------------------------------------------------------
-//   add
+//   overlappingMinY
+//    minimum of y[k] for k in [begin, end) where the segment k
+//    overlaps the open interval (xl, xr)
+//    Usually only a few segments overlap, so the vector loop
+//    is entered only when there is at least one full lane
 //---------------------------------------------------------
 
-void Skyline::add(const ShapeElement& r)
+static double overlappingMinY(const double* x, const double* w, const double* y, size_t begin, size_t end, double xl, double xr)
 {
-    if (r.ignoreForLayout()) {
-        return;
+    double result = std::numeric_limits<double>::infinity();
+    size_t k = begin;
+
+#if defined(SKL_USE_AVX)
+    if (end - begin >= 4) {
+        const __m256d vxl = _mm256_set1_pd(xl);
+        const __m256d vxr = _mm256_set1_pd(xr);
+        const __m256d vinf = _mm256_set1_pd(result);
+        __m256d vmin = vinf;
+        for (; k + 4 <= end; k += 4) {
+            const __m256d vx = _mm256_loadu_pd(x + k);
+            const __m256d vend = _mm256_add_pd(vx, _mm256_loadu_pd(w + k));
+            const __m256d overlaps = _mm256_and_pd(_mm256_cmp_pd(vxr, vx, _CMP_GT_OQ), _mm256_cmp_pd(vxl, vend, _CMP_LT_OQ));
+            vmin = _mm256_min_pd(vmin, _mm256_blendv_pd(vinf, _mm256_loadu_pd(y + k), overlaps));
+        }
+        alignas(32) double lanes[4];
+        _mm256_store_pd(lanes, vmin);
+        result = std::min({ lanes[0], lanes[1], lanes[2], lanes[3] });
     }
+#elif defined(SKL_USE_SSE2)
+    if (end - begin >= 2) {
+        const __m128d vxl = _mm_set1_pd(xl);
+        const __m128d vxr = _mm_set1_pd(xr);
+        const __m128d vinf = _mm_set1_pd(result);
+        __m128d vmin = vinf;
+        for (; k + 2 <= end; k += 2) {
+            const __m128d vx = _mm_loadu_pd(x + k);
+            const __m128d vend = _mm_add_pd(vx, _mm_loadu_pd(w + k));
+            const __m128d overlaps = _mm_and_pd(_mm_cmpgt_pd(vxr, vx), _mm_cmplt_pd(vxl, vend));
+            const __m128d vy = _mm_or_pd(_mm_and_pd(overlaps, _mm_loadu_pd(y + k)), _mm_andnot_pd(overlaps, vinf));
+            vmin = _mm_min_pd(vmin, vy);
+        }
+        alignas(16) double lanes[2];
+        _mm_store_pd(lanes, vmin);
+        result = std::min(lanes[0], lanes[1]);
+    }
+#endif
+
+    for (; k < end; ++k) {
+        if (xr > x[k] && xl < x[k] + w[k]) {
+            result = std::min(result, y[k]);
+        }
+    }
+
+    return result;
+}
+
+//---------------------------------------------------------
+//   extremeY
+//---------------------------------------------------------
+
+template<bool IsMin>
+static double extremeY(const double* y, size_t size, double init)
+{
+    double result = init;
+    size_t i = 0;
+
+#if defined(SKL_USE_AVX)
+    __m256d v = _mm256_set1_pd(init);
+    for (; i + 4 <= size; i += 4) {
+        v = IsMin ? _mm256_min_pd(v, _mm256_loadu_pd(y + i)) : _mm256_max_pd(v, _mm256_loadu_pd(y + i));
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, v);
+    result = IsMin ? std::min({ lanes[0], lanes[1], lanes[2], lanes[3] }) : std::max({ lanes[0], lanes[1], lanes[2], lanes[3] });
+#elif defined(SKL_USE_SSE2)
+    __m128d v = _mm_set1_pd(init);
+    for (; i + 2 <= size; i += 2) {
+        v = IsMin ? _mm_min_pd(v, _mm_loadu_pd(y + i)) : _mm_max_pd(v, _mm_loadu_pd(y + i));
+    }
+    alignas(16) double lanes[2];
+    _mm_store_pd(lanes, v);
+    result = IsMin ? std::min(lanes[0], lanes[1]) : std::max(lanes[0], lanes[1]);
+#endif
+
+    for (; i < size; ++i) {
+        result = IsMin ? std::min(result, y[i]) : std::max(result, y[i]);
+    }
+
+    return result;
+}
+
+//---------------------------------------------------------
+//   crossStaffSides
+//    a stem of a cross staff beam (tremolo, arpeggio) must not
+//    affect the skyline on the side of the other staff
+//---------------------------------------------------------
+
+static void crossStaffSides(const ShapeElement& r, bool& crossNorth, bool& crossSouth)
+{
+    crossNorth = false;
+    crossSouth = false;
+
     const EngravingItem* item = r.item();
-    bool crossSouth = false;
-    bool crossNorth = false;
     if (item && item->isStem()) {
         Chord* chord = toStem(item)->chord();
         if (chord) {
@@ -98,6 +204,20 @@ void Skyline::add(const ShapeElement& r)
             crossSouth = true;
         }
     }
+}
+
+//---------------------------------------------------------
+//   add
+//---------------------------------------------------------
+
+void Skyline::add(const ShapeElement& r)
+{
+    if (r.ignoreForLayout()) {
+        return;
+    }
+    bool crossNorth = false;
+    bool crossSouth = false;
+    crossStaffSides(r, crossNorth, crossSouth);
     if (!crossNorth) {
         _north.add(r.x(), r.top(), r.width());
     }
@@ -106,19 +226,54 @@ void Skyline::add(const ShapeElement& r)
     }
 }
 
+void Skyline::add(const Shape& s)
+{
+    if (s.size() < BATCH_MIN_SIZE) {
+        for (const auto& r : s.elements()) {
+            add(r);
+        }
+        return;
+    }
+
+    thread_local std::vector<SkylineSegment> northRects;
+    thread_local std::vector<SkylineSegment> southRects;
+    northRects.clear();
+    southRects.clear();
+
+    for (const auto& r : s.elements()) {
+        if (r.ignoreForLayout()) {
+            continue;
+        }
+        bool crossNorth = false;
+        bool crossSouth = false;
+        crossStaffSides(r, crossNorth, crossSouth);
+        if (!crossNorth) {
+            northRects.emplace_back(r.x(), r.top(), r.width());
+        }
+        if (!crossSouth) {
+            southRects.emplace_back(r.x(), r.bottom(), r.width());
+        }
+    }
+
+    _north.addBatch(northRects);
+    _south.addBatch(southRects);
+}
+
 //---------------------------------------------------------
 //   insert
 //---------------------------------------------------------
 
-SkylineLine::SegIter SkylineLine::insert(SegIter i, double x, double y, double w)
+void SkylineLine::insert(size_t i, double x, double y, double w)
 {
     const double xr = x + w;
     // Only x coordinate change is handled here as width change gets handled
     // in SkylineLine::add().
-    if (i != seg.end() && xr > i->x) {
-        i->x = xr;
+    if (i < m_x.size() && xr > m_x[i]) {
+        m_x[i] = xr;
     }
-    return seg.emplace(i, x, y, w);
+    m_x.insert(m_x.begin() + i, x);
+    m_y.insert(m_y.begin() + i, y);
+    m_w.insert(m_w.begin() + i, w);
 }
 
 //---------------------------------------------------------
@@ -127,25 +282,23 @@ SkylineLine::SegIter SkylineLine::insert(SegIter i, double x, double y, double w
 
 void SkylineLine::append(double x, double y, double w)
 {
-    seg.emplace_back(x, y, w);
+    m_x.push_back(x);
+    m_y.push_back(y);
+    m_w.push_back(w);
 }
 
 //---------------------------------------------------------
-//   getApproxPosition
+//   find
+//    index of the segment containing x
 //---------------------------------------------------------
 
-SkylineLine::SegIter SkylineLine::find(double x)
+size_t SkylineLine::find(double x) const
 {
-    auto it = std::upper_bound(seg.begin(), seg.end(), x, [](double x, const SkylineSegment& s) { return x < s.x; });
-    if (it == seg.begin()) {
-        return it;
+    auto it = std::upper_bound(m_x.begin(), m_x.end(), x);
+    if (it == m_x.begin()) {
+        return 0;
     }
-    return --it;
-}
-
-SkylineLine::SegConstIter SkylineLine::find(double x) const
-{
-    return const_cast<SkylineLine*>(this)->find(x);
+    return static_cast<size_t>(std::distance(m_x.begin(), it)) - 1;
 }
 
 //---------------------------------------------------------
@@ -154,9 +307,23 @@ SkylineLine::SegConstIter SkylineLine::find(double x) const
 
 void SkylineLine::add(const Shape& s)
 {
+    if (s.size() < BATCH_MIN_SIZE) {
+        for (const auto& r : s.elements()) {
+            add(r);
+        }
+        return;
+    }
+
+    thread_local std::vector<SkylineSegment> rects;
+    rects.clear();
+
     for (const auto& r : s.elements()) {
-        add(r);
+        if (!r.ignoreForLayout()) {
+            rects.emplace_back(r.x(), north ? r.top() : r.bottom(), r.width());
+        }
     }
+
+    addBatch(rects);
 }
 
 void SkylineLine::add(const ShapeElement& r)
@@ -171,13 +338,6 @@ void SkylineLine::add(const ShapeElement& r)
     }
 }
 
-void Skyline::add(const Shape& s)
-{
-    for (const auto& r : s.elements()) {
-        add(r);
-    }
-}
-
 void SkylineLine::add(double x, double y, double w)
 {
 //      assert(w >= 0.0);
@@ -191,34 +351,34 @@ void SkylineLine::add(double x, double y, double w)
 
     DP("===add  %f %f %f\n", x, y, w);
 
-    SegIter i = find(x);
-    double cx = seg.empty() ? 0.0 : i->x;
-    for (; i != seg.end(); ++i) {
-        double cy = i->y;
+    size_t i = find(x);
+    double cx = m_x.empty() ? 0.0 : m_x[i];
+    for (; i < m_x.size(); ++i) {
+        double cy = m_y[i];
         if ((x + w) <= cx) {                                            // A
             return;       // break;
         }
-        if (x > (cx + i->w)) {                                          // B
-            cx += i->w;
+        if (x > (cx + m_w[i])) {                                        // B
+            cx += m_w[i];
             continue;
         }
         if ((north && (cy <= y)) || (!north && (cy >= y))) {
-            cx += i->w;
+            cx += m_w[i];
             continue;
         }
-        if ((x >= cx) && ((x + w) < (cx + i->w))) {                     // (E) insert segment
-            DP("    insert at %f %f   x:%f w:%f\n", cx, i->w, x, w);
+        if ((x >= cx) && ((x + w) < (cx + m_w[i]))) {                   // (E) insert segment
+            DP("    insert at %f %f   x:%f w:%f\n", cx, m_w[i], x, w);
             double w1 = x - cx;
             double w2 = w;
-            double w3 = i->w - (w1 + w2);
+            double w3 = m_w[i] - (w1 + w2);
             if (w1 > 0.0000001) {
-                i->w = w1;
+                m_w[i] = w1;
                 ++i;
-                i = insert(i, x, y, w2);
+                insert(i, x, y, w2);
                 DP("       A w1 %f w2 %f\n", w1, w2);
             } else {
-                i->w = w2;
-                i->y = y;
+                m_w[i] = w2;
+                m_y[i] = y;
                 DP("       B w2 %f\n", w2);
             }
             if (w3 > 0.0000001) {
@@ -227,27 +387,27 @@ void SkylineLine::add(double x, double y, double w)
                 insert(i, x + w2, cy, w3);
             }
             return;
-        } else if ((x <= cx) && ((x + w) >= (cx + i->w))) {                 // F
+        } else if ((x <= cx) && ((x + w) >= (cx + m_w[i]))) {           // F
             DP("    change(F) cx %f y %f\n", cx, y);
-            i->y = y;
+            m_y[i] = y;
         } else if (x < cx) {                                            // C
             double w1 = x + w - cx;
-            i->w    -= w1;
-            DP("    add(C) cx %f y %f w %f w1 %f\n", cx, y, w1, i->w);
+            m_w[i] -= w1;
+            DP("    add(C) cx %f y %f w %f w1 %f\n", cx, y, w1, m_w[i]);
             insert(i, cx, y, w1);
             return;
         } else {                                                        // D
             double w1 = x - cx;
-            double w2 = i->w - w1;
+            double w2 = m_w[i] - w1;
             if (w2 > 0.0000001) {
-                i->w = w1;
-                cx  += w1;
+                m_w[i] = w1;
+                cx += w1;
                 DP("    add(D) %f %f\n", y, w2);
                 ++i;
-                i = insert(i, cx, y, w2);
+                insert(i, cx, y, w2);
             }
         }
-        cx += i->w;
+        cx += m_w[i];
     }
     if (x >= cx) {
         if (x > cx) {
@@ -262,6 +422,98 @@ void SkylineLine::add(double x, double y, double w)
     }
 }
 
+//---------------------------------------------------------
+//   addBatch
+//    Merges all rects at once instead of inserting them one by one:
+//    the line is rebuilt over the sorted boundaries of the existing
+//    segments and the rects, so adding a whole shape costs
+//    O((n + k) log(n + k)) instead of O(n * k).
+//    The result is the same as adding the rects one by one:
+//    the uncovered gaps get the "no value" y, for every x the lowest (north)
+//    or the highest (south) y wins.
+//---------------------------------------------------------
+
+void SkylineLine::addBatch(std::vector<SkylineSegment>& rects)
+{
+    size_t count = 0;
+    for (SkylineSegment r : rects) {
+        if (r.x < 0.0) {
+            r.w -= -r.x;
+            r.x = 0.0;
+            if (r.w <= 0.0) {
+                continue;
+            }
+        }
+        rects[count++] = r;
+    }
+    rects.erase(rects.begin() + count, rects.end());
+
+    if (rects.empty()) {
+        return;
+    }
+
+    if (rects.size() == 1) {
+        add(rects.front().x, rects.front().y, rects.front().w);
+        return;
+    }
+
+    const double noValue = north ? MAXIMUM_Y : MINIMUM_Y;
+    const double lineEnd = m_x.empty() ? 0.0 : m_x.back() + m_w.back();
+
+    thread_local std::vector<double> bounds;
+    bounds.clear();
+    bounds.reserve(m_x.size() + 2 * rects.size() + 2);
+    bounds.push_back(0.0);
+    bounds.insert(bounds.end(), m_x.begin(), m_x.end());
+    bounds.push_back(lineEnd);
+    for (const SkylineSegment& r : rects) {
+        bounds.push_back(r.x);
+        bounds.push_back(r.x + r.w);
+    }
+    std::sort(bounds.begin(), bounds.end());
+    bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+    if (bounds.size() < 2) {
+        return;
+    }
+
+    // the values of the existing line
+    const size_t intervalCount = bounds.size() - 1;
+    thread_local std::vector<double> values;
+    values.assign(intervalCount, noValue);
+
+    size_t k = 0;
+    for (size_t j = 0; j < intervalCount && bounds[j] < lineEnd; ++j) {
+        while (k + 1 < m_x.size() && m_x[k + 1] <= bounds[j]) {
+            ++k;
+        }
+        values[j] = m_y[k];
+    }
+
+    // the rects
+    for (const SkylineSegment& r : rects) {
+        const size_t begin = std::lower_bound(bounds.begin(), bounds.end(), r.x) - bounds.begin();
+        const size_t end = std::lower_bound(bounds.begin() + begin, bounds.end(), r.x + r.w) - bounds.begin();
+        for (size_t j = begin; j < end; ++j) {
+            values[j] = north ? std::min(values[j], r.y) : std::max(values[j], r.y);
+        }
+    }
+
+    // rebuild, the neighbours with the same y are joined
+    m_x.clear();
+    m_y.clear();
+    m_w.clear();
+
+    for (size_t j = 0; j < intervalCount; ++j) {
+        const double w = bounds[j + 1] - bounds[j];
+        if (!m_y.empty() && m_y.back() == values[j]) {
+            m_w.back() += w;
+        } else {
+            append(bounds[j], values[j], w);
+        }
+    }
+}
+
 //---------------------------------------------------------
 //   clear
 //---------------------------------------------------------
@@ -272,6 +524,13 @@ void Skyline::clear()
     _south.clear();
 }
 
+void SkylineLine::clear()
+{
+    m_x.clear();
+    m_y.clear();
+    m_w.clear();
+}
+
 //-------------------------------------------------------------------
 //   minDistance
 //    a is located below this skyline.
@@ -287,35 +546,38 @@ double SkylineLine::minDistance(const SkylineLine& sl) const
 {
     double dist = MINIMUM_Y;
 
-    double x1 = 0.0;
-    double x2 = 0.0;
-    auto k   = sl.begin();
-    for (auto i = begin(); i != end(); ++i) {
-        while (k != sl.end() && (x2 + k->w) < x1) {
-            x2 += k->w;
+    const size_t size1 = m_x.size();
+    const size_t size2 = sl.m_x.size();
+
+    size_t k = 0;
+    for (size_t i = 0; i < size1; ++i) {
+        const double x1 = m_x[i];
+        const double x1r = x1 + m_w[i];
+
+        while (k < size2 && (sl.m_x[k] + sl.m_w[k]) < x1) {
             ++k;
         }
-        if (k == sl.end()) {
+        if (k == size2) {
             break;
         }
-        for (;;) {
-            if ((x1 + i->w > x2) && (x1 < x2 + k->w)) {
-                dist = std::max(dist, i->y - k->y);
-            }
-            if (x2 + k->w < x1 + i->w) {
-                x2 += k->w;
-                ++k;
-                if (k == sl.end()) {
-                    break;
-                }
-            } else {
-                break;
-            }
+
+        // the segments of sl up to the first one that reaches the end of the segment i
+        size_t kLast = k;
+        while (kLast < size2 && (sl.m_x[kLast] + sl.m_w[kLast]) < x1r) {
+            ++kLast;
+        }
+        const bool reachedEnd = kLast == size2;
+        const size_t kEnd = reachedEnd ? size2 : kLast + 1;
+
+        const double minY = overlappingMinY(sl.m_x.data(), sl.m_w.data(), sl.m_y.data(), k, kEnd, x1, x1r);
+        if (minY != std::numeric_limits<double>::infinity()) {
+            dist = std::max(dist, m_y[i] - minY);
         }
-        if (k == sl.end()) {
+
+        if (reachedEnd) {
             break;
         }
-        x1 += i->w;
+        k = kLast;
     }
     return dist;
 }
@@ -360,7 +622,7 @@ void SkylineLine::paint(Painter& painter) const
 
 bool SkylineLine::valid() const
 {
-    return !seg.empty();
+    return !m_x.empty();
 }
 
 bool SkylineLine::valid(const SkylineSegment& s) const
@@ -397,18 +659,9 @@ void SkylineLine::dump() const
 
 double SkylineLine::max() const
 {
-    double val;
     if (north) {
-        val = MAXIMUM_Y;
-        for (const SkylineSegment& s : *this) {
-            val = std::min(val, s.y);
-        }
-    } else {
-        val = MINIMUM_Y;
-        for (const SkylineSegment& s : *this) {
-            val = std::max(val, s.y);
-        }
+        return extremeY<true>(m_y.data(), m_y.size(), MAXIMUM_Y);
     }
-    return val;
+    return extremeY<false>(m_y.data(), m_y.size(), MINIMUM_Y);
 }
 } // namespace mu::engraving
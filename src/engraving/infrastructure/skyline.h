@@ -50,19 +50,24 @@ struct SkylineSegment {
 
 //---------------------------------------------------------
 //   SkylineLine
+//    The segments are stored as a structure of arrays,
+//    so the queries (minDistance, max) run over contiguous memory
 //---------------------------------------------------------
 
 class SkylineLine
 {
     const bool north;
-    std::vector<SkylineSegment> seg;
-    typedef std::vector<SkylineSegment>::iterator SegIter;
-    typedef std::vector<SkylineSegment>::const_iterator SegConstIter;
+    std::vector<double> m_x;
+    std::vector<double> m_y;
+    std::vector<double> m_w;
 
-    SegIter insert(SegIter i, double x, double y, double w);
+    void insert(size_t i, double x, double y, double w);
     void append(double x, double y, double w);
-    SegIter find(double x);
-    SegConstIter find(double x) const;
+    size_t find(double x) const;
+
+    void addBatch(std::vector<SkylineSegment>& rects);
+
+    friend class Skyline;
 
 public:
     SkylineLine(bool n)
@@ -72,7 +77,7 @@ public:
     void add(double x, double y, double w);
     void add(const RectF& r) { add(ShapeElement(r)); }
 
-    void clear() { seg.clear(); }
+    void clear();
     void paint(muse::draw::Painter& painter) const;
     void dump() const;
     double minDistance(const SkylineLine&) const;
@@ -81,10 +86,24 @@ public:
     bool valid(const SkylineSegment& s) const;
     bool isNorth() const { return north; }
 
-    SegIter begin() { return seg.begin(); }
-    SegConstIter begin() const { return seg.begin(); }
-    SegIter end() { return seg.end(); }
-    SegConstIter end() const { return seg.end(); }
+    size_t size() const { return m_x.size(); }
+    SkylineSegment at(size_t i) const { return SkylineSegment(m_x[i], m_y[i], m_w[i]); }
+
+    class const_iterator
+    {
+        const SkylineLine* m_line = nullptr;
+        size_t m_idx = 0;
+    public:
+        const_iterator(const SkylineLine* line, size_t idx)
+            : m_line(line), m_idx(idx) {}
+        const_iterator& operator++() { ++m_idx; return *this; }
+        bool operator!=(const const_iterator& i) const { return m_idx != i.m_idx; }
+        bool operator==(const const_iterator& i) const { return m_idx == i.m_idx; }
+        SkylineSegment operator*() const { return m_line->at(m_idx); }
+    };
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_x.size()); }
 };
 
 //---------------------------------------------------------
@@ -0,0 +1,273 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MU_ENGRAVING_SMALLVECTOR_H
+#define MU_ENGRAVING_SMALLVECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "log.h"
+
+namespace mu::engraving {
+//---------------------------------------------------------
+//   SmallVector
+//    A vector that keeps up to N elements inline and only
+//    goes to the heap when it grows beyond that.
+//    The iterators are plain pointers, so it can be used in place
+//    of std::vector for the common operations
+//---------------------------------------------------------
+
+template<typename T, size_t N>
+class SmallVector
+{
+    static_assert(N > 0, "SmallVector needs at least one inline element");
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() = default;
+
+    SmallVector(const SmallVector& other)
+    {
+        reserve(other.m_size);
+        std::uninitialized_copy(other.begin(), other.end(), m_data);
+        m_size = other.m_size;
+    }
+
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        moveFrom(other);
+    }
+
+    ~SmallVector()
+    {
+        clear();
+        freeHeap();
+    }
+
+    SmallVector& operator=(const SmallVector& other)
+    {
+        if (this != &other) {
+            clear();
+            reserve(other.m_size);
+            std::uninitialized_copy(other.begin(), other.end(), m_data);
+            m_size = other.m_size;
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        if (this != &other) {
+            clear();
+            freeHeap();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    iterator begin() { return m_data; }
+    iterator end() { return m_data + m_size; }
+    const_iterator begin() const { return m_data; }
+    const_iterator end() const { return m_data + m_size; }
+    const_iterator cbegin() const { return m_data; }
+    const_iterator cend() const { return m_data + m_size; }
+
+    T* data() { return m_data; }
+    const T* data() const { return m_data; }
+
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_capacity; }
+    bool empty() const { return m_size == 0; }
+    bool isInline() const { return m_data == inlineData(); }
+
+    T& operator[](size_t i) { return m_data[i]; }
+    const T& operator[](size_t i) const { return m_data[i]; }
+
+    T& at(size_t i)
+    {
+        DO_ASSERT(i < m_size);
+        return m_data[i];
+    }
+
+    const T& at(size_t i) const
+    {
+        DO_ASSERT(i < m_size);
+        return m_data[i];
+    }
+
+    T& front() { return m_data[0]; }
+    const T& front() const { return m_data[0]; }
+    T& back() { return m_data[m_size - 1]; }
+    const T& back() const { return m_data[m_size - 1]; }
+
+    void reserve(size_t capacity)
+    {
+        if (capacity <= m_capacity) {
+            return;
+        }
+
+        T* data = std::allocator<T>().allocate(capacity);
+        std::uninitialized_move(m_data, m_data + m_size, data);
+        std::destroy(m_data, m_data + m_size);
+        freeHeap();
+
+        m_data = data;
+        m_capacity = capacity;
+    }
+
+    void clear()
+    {
+        std::destroy(m_data, m_data + m_size);
+        m_size = 0;
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    template<typename ... Args>
+    T& emplace_back(Args&&... args)
+    {
+        if (m_size == m_capacity) {
+            // the arguments may refer to our own elements
+            T value(std::forward<Args>(args)...);
+            reserve(m_capacity * 2);
+            new (m_data + m_size) T(std::move(value));
+        } else {
+            new (m_data + m_size) T(std::forward<Args>(args)...);
+        }
+        return m_data[m_size++];
+    }
+
+    void pop_back()
+    {
+        std::destroy_at(m_data + m_size - 1);
+        --m_size;
+    }
+
+    template<typename InputIt>
+    iterator insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        const size_t offset = static_cast<size_t>(pos - m_data);
+        const size_t count = static_cast<size_t>(std::distance(first, last));
+        if (count == 0) {
+            return m_data + offset;
+        }
+
+        if (m_size + count > m_capacity) {
+            // copy first, the range may be a part of this vector
+            SmallVector tmp;
+            tmp.reserve(std::max(m_size + count, m_capacity * 2));
+            std::uninitialized_move(m_data, m_data + offset, tmp.m_data);
+            std::uninitialized_copy(first, last, tmp.m_data + offset);
+            std::uninitialized_move(m_data + offset, m_data + m_size, tmp.m_data + offset + count);
+            tmp.m_size = m_size + count;
+            *this = std::move(tmp);
+            return m_data + offset;
+        }
+
+        std::uninitialized_copy(first, last, m_data + m_size);
+        m_size += count;
+        std::rotate(m_data + offset, m_data + m_size - count, m_data + m_size);
+        return m_data + offset;
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        T* f = m_data + (first - m_data);
+        T* l = m_data + (last - m_data);
+        if (f != l) {
+            T* newEnd = std::move(l, end(), f);
+            std::destroy(newEnd, end());
+            m_size = static_cast<size_t>(newEnd - m_data);
+        }
+        return f;
+    }
+
+    bool operator==(const SmallVector& other) const
+    {
+        return std::equal(begin(), end(), other.begin(), other.end());
+    }
+
+    bool operator!=(const SmallVector& other) const
+    {
+        return !operator==(other);
+    }
+
+private:
+    T* inlineData() { return reinterpret_cast<T*>(m_inline); }
+    const T* inlineData() const { return reinterpret_cast<const T*>(m_inline); }
+
+    void freeHeap()
+    {
+        if (!isInline()) {
+            std::allocator<T>().deallocate(m_data, m_capacity);
+            m_data = inlineData();
+            m_capacity = N;
+        }
+    }
+
+    void moveFrom(SmallVector& other)
+    {
+        if (other.isInline()) {
+            std::uninitialized_move(other.begin(), other.end(), inlineData());
+            m_size = other.m_size;
+            other.clear();
+            return;
+        }
+
+        m_data = other.m_data;
+        m_size = other.m_size;
+        m_capacity = other.m_capacity;
+
+        other.m_data = other.inlineData();
+        other.m_size = 0;
+        other.m_capacity = N;
+    }
+
+    alignas(T) unsigned char m_inline[N * sizeof(T)];
+    T* m_data = inlineData();
+    size_t m_size = 0;
+    size_t m_capacity = N;
+};
+}
+
+#endif // MU_ENGRAVING_SMALLVECTOR_H
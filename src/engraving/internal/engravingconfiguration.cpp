@@ -90,6 +90,11 @@ muse::io::path_t EngravingConfiguration::appDataPath() const
     return globalConfiguration()->appDataPath();
 }
 
+muse::io::path_t EngravingConfiguration::fontMetricsCachePath() const
+{
+    return globalConfiguration()->userAppDataPath() + "/engraving_font_metrics_cache";
+}
+
 muse::io::path_t EngravingConfiguration::defaultStyleFilePath() const
 {
     return settings()->value(DEFAULT_STYLE_FILE_PATH).toPath();
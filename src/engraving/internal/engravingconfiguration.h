@@ -46,6 +46,7 @@ public:
     void init();
 
     muse::io::path_t appDataPath() const override;
+    muse::io::path_t fontMetricsCachePath() const override;
 
     muse::io::path_t defaultStyleFilePath() const override;
     void setDefaultStyleFilePath(const muse::io::path_t& path) override;
@@ -21,9 +21,16 @@
  */
 #include "engravingfont.h"
 
+#include <cstring>
+#include <functional>
+#include <sstream>
+
+#include "muse_framework_config.h"
+
 #include "serialization/json.h"
 #include "io/file.h"
 #include "io/fileinfo.h"
+#include "io/mappedfile.h"
 #include "draw/painter.h"
 #include "types/symnames.h"
 
@@ -39,6 +46,35 @@ using namespace muse::io;
 using namespace muse::draw;
 using namespace mu::engraving;
 
+static constexpr char METRICS_CACHE_MAGIC[4] = { 'M', 'S', 'F', 'M' };
+static constexpr uint32_t METRICS_CACHE_VERSION = 2;
+static constexpr size_t SMUFL_ANCHORS_COUNT = static_cast<size_t>(SmuflAnchorId::opticalCenter) + 1;
+
+//! NOTE: The cache file is the header, a record for every SymId and a record for every engraving default.
+//! It is only read on the machine which wrote it, so the records keep the native layout
+struct MetricsCacheHeader {
+    char magic[4] = {};
+    uint32_t version = 0;
+    uint64_t sourceKey = 0;
+    uint32_t symbolsCount = 0;
+    uint32_t engravingDefaultsCount = 0;
+    double textEnclosureThickness = 0.0;
+};
+
+struct MetricsCacheSym {
+    uint32_t code = 0;
+    uint32_t anchorsMask = 0;
+    double bbox[4] = {};
+    double advance = 0.0;
+    double anchors[SMUFL_ANCHORS_COUNT][2] = {};
+};
+
+struct MetricsCacheEngravingDefault {
+    int32_t sid = 0;
+    int32_t isBool = 0;
+    double value = 0.0;
+};
+
 // =============================================
 // ScoreFont
 // =============================================
@@ -58,6 +94,7 @@ EngravingFont::EngravingFont(const EngravingFont& other)
     m_name     = other.m_name;
     m_family   = other.m_family;
     m_fontPath = other.m_fontPath;
+    m_metricsCachePath = other.m_metricsCachePath;
 }
 
 // =============================================
@@ -105,6 +142,17 @@ void EngravingFont::ensureLoad()
     m_font.setNoFontMerging(true);
     m_font.setHinting(Font::Hinting::PreferVerticalHinting);
 
+    const uint64_t sourceKey = metricsCacheSourceKey();
+    if (readMetricsCache(sourceKey)) {
+        loadComposedGlyphs();
+
+        //! NOTE: Only the numeric engraving defaults are cached
+        m_engravingDefaults.insert({ Sid::MusicalTextFont, String(u"%1 Text").arg(String::fromStdString(m_family)) });
+
+        m_loaded = true;
+        return;
+    }
+
     for (size_t id = 0; id < m_symbols.size(); ++id) {
         Smufl::Code code = Smufl::code(static_cast<SymId>(id));
         if (!code.isValid()) {
@@ -132,9 +180,16 @@ void EngravingFont::ensureLoad()
     loadStylisticAlternates(metadataJson.value("glyphsWithAlternates").toObject());
     loadEngravingDefaults(metadataJson.value("engravingDefaults").toObject());
 
+    writeMetricsCache(sourceKey);
+
     m_loaded = true;
 }
 
+void EngravingFont::setMetricsCachePath(const path_t& path)
+{
+    m_metricsCachePath = path;
+}
+
 void EngravingFont::loadGlyphsWithAnchors(const JsonObject& glyphsWithAnchors)
 {
     for (const std::string& symName : glyphsWithAnchors.keys()) {
@@ -511,6 +566,194 @@ void EngravingFont::computeMetrics(EngravingFont::Sym& sym, const Smufl::Code& c
     }
 }
 
+// =============================================
+// Metrics cache
+// =============================================
+
+uint64_t EngravingFont::metricsCacheSourceKey() const
+{
+    if (m_metricsCachePath.empty()) {
+        return 0;
+    }
+
+    //! NOTE: The cache is valid while the font, its metadata and the code computing the metrics don't change:
+    //! the metrics of the symbols come from the font provider (SYMBOL_METRICS_VERSION), the rest is computed here
+    //! (METRICS_CACHE_VERSION). The bundled fonts are resources without a modification time, they change with the revision of the app
+    std::stringstream key;
+    key << m_fontPath.toStdString() << "|" << m_family;
+
+    for (const path_t& path : { m_fontPath, path_t(FileInfo(m_fontPath).path() + u"/metadata.json") }) {
+        RetVal<uint64_t> size = fileSystem()->fileSize(path);
+        if (!size.ret) {
+            return 0;
+        }
+
+        key << "|" << size.val << "|" << fileSystem()->lastModified(path).toString().toStdString();
+    }
+
+    key << "|" << IFontProvider::SYMBOL_METRICS_VERSION;
+
+#ifdef MUSE_APP_REVISION
+    key << "|" << MUSE_APP_REVISION;
+#endif
+#ifdef MUSE_MODULE_DRAW_USE_QTFONTMETRICS
+    key << "|qt";
+#endif
+
+    uint64_t sourceKey = std::hash<std::string> {}(key.str());
+    return sourceKey != 0 ? sourceKey : 1;
+}
+
+path_t EngravingFont::metricsCacheFilePath() const
+{
+    std::stringstream name;
+    name << std::hex << std::hash<std::string> {}(m_fontPath.toStdString()) << ".bin";
+
+    return m_metricsCachePath + "/" + name.str();
+}
+
+bool EngravingFont::readMetricsCache(uint64_t sourceKey)
+{
+    if (sourceKey == 0) {
+        return false;
+    }
+
+    MappedFile file;
+    if (!file.open(metricsCacheFilePath())) {
+        return false;
+    }
+
+    if (file.size() < sizeof(MetricsCacheHeader)) {
+        return false;
+    }
+
+    MetricsCacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    bool valid = std::memcmp(header.magic, METRICS_CACHE_MAGIC, sizeof(header.magic)) == 0
+                 && header.version == METRICS_CACHE_VERSION
+                 && header.sourceKey == sourceKey
+                 && header.symbolsCount == m_symbols.size()
+                 && file.size() == sizeof(header)
+                 + static_cast<size_t>(header.symbolsCount) * sizeof(MetricsCacheSym)
+                 + static_cast<size_t>(header.engravingDefaultsCount) * sizeof(MetricsCacheEngravingDefault);
+
+    if (!valid) {
+        return false;
+    }
+
+    const uint8_t* data = file.data() + sizeof(header);
+
+    for (Sym& sym : m_symbols) {
+        MetricsCacheSym record;
+        std::memcpy(&record, data, sizeof(record));
+        data += sizeof(record);
+
+        sym.code = record.code;
+        sym.bbox = RectF(record.bbox[0], record.bbox[1], record.bbox[2], record.bbox[3]);
+        sym.advance = record.advance;
+
+        for (size_t anchor = 0; anchor < SMUFL_ANCHORS_COUNT; ++anchor) {
+            if (record.anchorsMask & (1u << anchor)) {
+                sym.smuflAnchors[static_cast<SmuflAnchorId>(anchor)] = PointF(record.anchors[anchor][0], record.anchors[anchor][1]);
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < header.engravingDefaultsCount; ++i) {
+        MetricsCacheEngravingDefault record;
+        std::memcpy(&record, data, sizeof(record));
+        data += sizeof(record);
+
+        PropertyValue value = record.isBool ? PropertyValue(record.value != 0.0) : PropertyValue(record.value);
+        m_engravingDefaults.insert({ static_cast<Sid>(record.sid), value });
+    }
+
+    m_textEnclosureThickness = header.textEnclosureThickness;
+
+    return true;
+}
+
+void EngravingFont::writeMetricsCache(uint64_t sourceKey) const
+{
+    if (sourceKey == 0 || !fileSystem()->makePath(m_metricsCachePath)) {
+        return;
+    }
+
+    std::vector<MetricsCacheEngravingDefault> engravingDefaults;
+    for (const auto& pair : m_engravingDefaults) {
+        MetricsCacheEngravingDefault record;
+        record.sid = static_cast<int32_t>(pair.first);
+
+        if (pair.second.type() == P_TYPE::BOOL) {
+            record.isBool = 1;
+            record.value = pair.second.toBool() ? 1.0 : 0.0;
+        } else if (pair.second.type() == P_TYPE::REAL) {
+            record.value = pair.second.toReal();
+        } else {
+            continue;
+        }
+
+        engravingDefaults.push_back(record);
+    }
+
+    MetricsCacheHeader header;
+    std::memcpy(header.magic, METRICS_CACHE_MAGIC, sizeof(header.magic));
+    header.version = METRICS_CACHE_VERSION;
+    header.sourceKey = sourceKey;
+    header.symbolsCount = static_cast<uint32_t>(m_symbols.size());
+    header.engravingDefaultsCount = static_cast<uint32_t>(engravingDefaults.size());
+    header.textEnclosureThickness = m_textEnclosureThickness;
+
+    std::vector<MetricsCacheSym> symbols(m_symbols.size());
+    for (size_t id = 0; id < m_symbols.size(); ++id) {
+        const Sym& sym = m_symbols[id];
+
+        //! NOTE: The composed glyphs are stored as they were before the composition, they are composed again on read
+        if (sym.isCompound()) {
+            continue;
+        }
+
+        MetricsCacheSym& record = symbols[id];
+        record.code = sym.code;
+        record.bbox[0] = sym.bbox.x();
+        record.bbox[1] = sym.bbox.y();
+        record.bbox[2] = sym.bbox.width();
+        record.bbox[3] = sym.bbox.height();
+        record.advance = sym.advance;
+
+        for (const auto& anchor : sym.smuflAnchors) {
+            size_t index = static_cast<size_t>(anchor.first);
+            record.anchorsMask |= 1u << index;
+            record.anchors[index][0] = anchor.second.x();
+            record.anchors[index][1] = anchor.second.y();
+        }
+    }
+
+    const size_t symbolsSize = symbols.size() * sizeof(MetricsCacheSym);
+    const size_t engravingDefaultsSize = engravingDefaults.size() * sizeof(MetricsCacheEngravingDefault);
+
+    ByteArray data(sizeof(header) + symbolsSize + engravingDefaultsSize);
+    uint8_t* dst = data.data();
+    std::memcpy(dst, &header, sizeof(header));
+    std::memcpy(dst + sizeof(header), symbols.data(), symbolsSize);
+    std::memcpy(dst + sizeof(header) + symbolsSize, engravingDefaults.data(), engravingDefaultsSize);
+
+    //! NOTE: Written to a temporary file first, so that a concurrent or interrupted write never leaves a broken cache file
+    path_t filePath = metricsCacheFilePath();
+    path_t tempFilePath = filePath + ".tmp";
+
+    Ret ret = fileSystem()->writeFile(tempFilePath, data);
+    if (ret) {
+        ret = fileSystem()->move(tempFilePath, filePath, true);
+    }
+
+    if (!ret) {
+        LOGW() << "failed to write the metrics cache " << filePath << ": " << ret.toString();
+        fileSystem()->remove(tempFilePath);
+    }
+}
+
 // =============================================
 // Symbol properties
 // =============================================
@@ -22,6 +22,7 @@
 #ifndef MU_ENGRAVING_ENGRAVINGFONT_H
 #define MU_ENGRAVING_ENGRAVINGFONT_H
 
+#include <cstdint>
 #include <unordered_map>
 
 #include "iengravingfont.h"
@@ -30,6 +31,7 @@
 #include "draw/types/geometry.h"
 #include "iengravingfontsprovider.h"
 
+#include "io/ifilesystem.h"
 #include "io/path.h"
 
 #include "infrastructure/smufl.h"
@@ -53,6 +55,7 @@ class EngravingFont : public IEngravingFont
 {
     INJECT_STATIC(muse::draw::IFontProvider, fontProvider)
     INJECT_STATIC(IEngravingFontsProvider, engravingFonts)
+    INJECT_STATIC(muse::io::IFileSystem, fileSystem)
 public:
     EngravingFont(const std::string& name, const std::string& family, const muse::io::path_t& filePath);
     EngravingFont(const EngravingFont& other);
@@ -94,6 +97,10 @@ public:
 
     void ensureLoad();
 
+    //! NOTE The symbol metrics are computed on the first load and kept in this directory,
+    //! the next loads map them from there instead of parsing the metadata and asking the font for every symbol
+    void setMetricsCachePath(const muse::io::path_t& path);
+
 private:
 
     friend class SymbolFonts;
@@ -124,6 +131,11 @@ private:
     void loadEngravingDefaults(const muse::JsonObject& engravingDefaultsObject);
     void computeMetrics(Sym& sym, const Smufl::Code& code);
 
+    uint64_t metricsCacheSourceKey() const;
+    muse::io::path_t metricsCacheFilePath() const;
+    bool readMetricsCache(uint64_t sourceKey);
+    void writeMetricsCache(uint64_t sourceKey) const;
+
     void constructShapeWithCutouts(Shape& shape, SymId id);
 
     Sym& sym(SymId id);
@@ -138,6 +150,7 @@ private:
     std::string m_name;
     std::string m_family;
     muse::io::path_t m_fontPath;
+    muse::io::path_t m_metricsCachePath;
 
     std::unordered_map<Sid, PropertyValue> m_engravingDefaults;
     double m_textEnclosureThickness = 0;
@@ -32,6 +32,7 @@ using namespace mu::engraving;
 void EngravingFontsProvider::addFont(const std::string& name, const std::string& family, const muse::io::path_t& filePath)
 {
     std::shared_ptr<EngravingFont> f = std::make_shared<EngravingFont>(name, family, filePath);
+    f->setMetricsCachePath(m_metricsCachePath);
     m_symbolFonts.push_back(f);
     m_fallback.font = nullptr;
 }
@@ -103,3 +104,8 @@ void EngravingFontsProvider::loadAllFonts()
         f->ensureLoad();
     }
 }
+
+void EngravingFontsProvider::setMetricsCachePath(const muse::io::path_t& path)
+{
+    m_metricsCachePath = path;
+}
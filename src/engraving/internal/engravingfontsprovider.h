@@ -45,6 +45,9 @@ public:
 
     void loadAllFonts() override;
 
+    //! NOTE The fonts added after this call keep their computed symbol metrics there
+    void setMetricsCachePath(const muse::io::path_t& path);
+
 private:
 
     std::shared_ptr<EngravingFont> doFontByName(const std::string& name) const;
@@ -56,6 +59,7 @@ private:
     };
 
     mutable Fallback m_fallback;
+    muse::io::path_t m_metricsCachePath;
     std::vector<std::shared_ptr<EngravingFont> > m_symbolFonts;
 };
 }
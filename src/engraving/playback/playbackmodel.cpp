@@ -22,6 +22,9 @@
 
 #include "playbackmodel.h"
 
+#include "global/async/async.h"
+#include "global/concurrency/taskscheduler.h"
+
 #include "dom/fret.h"
 #include "dom/instrument.h"
 #include "dom/masterscore.h"
@@ -37,6 +40,7 @@
 
 #include "log.h"
 
+#include <algorithm>
 #include <limits>
 
 using namespace mu;
@@ -49,6 +53,11 @@ static const String CHORD_SYMBOLS_INSTRUMENT_ID(u"chord_symbols");
 
 const InstrumentTrackId PlaybackModel::METRONOME_TRACK_ID = { 999, METRONOME_INSTRUMENT_ID };
 
+//! NOTE The duration of the score rendered by load() before it returns, when the incremental load is enabled
+static constexpr double LOAD_FIRST_WINDOW_SECS = 10.0;
+//! NOTE The duration of the score rendered by every next step of the incremental load
+static constexpr double LOAD_NEXT_WINDOW_SECS = 30.0;
+
 static const Harmony* findChordSymbol(const EngravingItem* item)
 {
     if (item->isHarmony()) {
@@ -60,6 +69,19 @@ static const Harmony* findChordSymbol(const EngravingItem* item)
     return nullptr;
 }
 
+static void appendEvents(PlaybackEventsMap& destination, PlaybackEventsMap&& events)
+{
+    for (auto& pair : events) {
+        PlaybackEventList& list = destination[pair.first];
+
+        if (list.empty()) {
+            list = std::move(pair.second);
+        } else {
+            list.insert(list.end(), std::make_move_iterator(pair.second.begin()), std::make_move_iterator(pair.second.end()));
+        }
+    }
+}
+
 void PlaybackModel::load(Score* score)
 {
     TRACEFUNC;
@@ -69,6 +91,7 @@ void PlaybackModel::load(Score* score)
     }
 
     m_score = score;
+    m_pendingLoad = PendingLoad();
 
     auto changesChannel = score->changesChannel();
     changesChannel.resetOnReceive(this);
@@ -78,6 +101,9 @@ void PlaybackModel::load(Score* score)
             return;
         }
 
+        //! NOTE The changed range would be rendered twice otherwise
+        finishIncrementalLoad();
+
         TickBoundaries tickRange = tickBoundaries(range);
         TrackBoundaries trackRange = trackBoundaries(range);
 
@@ -93,13 +119,23 @@ void PlaybackModel::load(Score* score)
         notifyAboutChanges(oldTracks, trackChanges);
     });
 
-    update(0, m_score->lastMeasure()->endTick().ticks(), 0, m_score->ntracks());
+    if (m_incrementalLoadEnabled) {
+        startIncrementalLoad();
+    } else {
+        update(0, m_score->lastMeasure()->endTick().ticks(), 0, m_score->ntracks());
+    }
+
+    m_changedTimestampsMap.clear();
 
     for (const auto& pair : m_playbackDataMap) {
         m_trackAdded.send(pair.first);
     }
 
     m_dataChanged.notify();
+
+    if (!m_pendingLoad.isEmpty()) {
+        scheduleNextLoadWindow();
+    }
 }
 
 void PlaybackModel::reload()
@@ -114,6 +150,9 @@ void PlaybackModel::reload()
     int tickFrom = 0;
     int tickTo = lastMeasure ? lastMeasure->endTick().ticks() : 0;
 
+    //! NOTE Everything is rendered again below
+    m_pendingLoad = PendingLoad();
+
     clearExpiredTracks();
     clearExpiredContexts(trackFrom, trackTo);
 
@@ -122,9 +161,13 @@ void PlaybackModel::reload()
     }
 
     update(tickFrom, tickTo, trackFrom, trackTo);
+    m_changedTimestampsMap.clear();
 
     for (auto& pair : m_playbackDataMap) {
-        pair.second.mainStream.send(pair.second.originEvents, pair.second.dynamicLevelMap, pair.second.paramMap);
+        PlaybackEventsChanges changes;
+        changes.events = pair.second.originEvents;
+
+        pair.second.mainStream.send(std::move(changes), pair.second.dynamicLevelMap, pair.second.paramMap);
     }
 
     m_dataChanged.notify();
@@ -155,6 +198,31 @@ void PlaybackModel::setPlayChordSymbols(const bool isEnabled)
     m_playChordSymbols = isEnabled;
 }
 
+bool PlaybackModel::isIncrementalLoadEnabled() const
+{
+    return m_incrementalLoadEnabled;
+}
+
+void PlaybackModel::setIncrementalLoadEnabled(const bool isEnabled)
+{
+    m_incrementalLoadEnabled = isEnabled;
+}
+
+bool PlaybackModel::isParallelRenderingEnabled() const
+{
+    return m_parallelRenderingEnabled;
+}
+
+void PlaybackModel::setParallelRenderingEnabled(const bool isEnabled)
+{
+    m_parallelRenderingEnabled = isEnabled;
+}
+
+void PlaybackModel::setPlaybackPosition(const int utick)
+{
+    m_playbackUtick = utick;
+}
+
 const InstrumentTrackId& PlaybackModel::metronomeTrackId() const
 {
     return METRONOME_TRACK_ID;
@@ -196,6 +264,8 @@ const PlaybackData& PlaybackModel::resolveTrackPlaybackData(const InstrumentTrac
         return empty;
     }
 
+    finishIncrementalLoad();
+
     update(0, m_score->lastMeasure()->tick().ticks(), part->startTrack(), part->endTrack());
 
     return m_playbackDataMap[trackId];
@@ -350,7 +420,7 @@ void PlaybackModel::updateContext(const InstrumentTrackId& trackId)
 }
 
 void PlaybackModel::processSegment(const int tickPositionOffset, const Segment* segment, const std::set<staff_idx_t>& staffIdxSet,
-                                   bool isFirstSegmentOfMeasure, ChangedTrackIdSet* trackChanges)
+                                   bool isFirstSegmentOfMeasure, RenderedEvents& result) const
 {
     int segmentStartTick = segment->tick().ticks();
 
@@ -378,11 +448,12 @@ void PlaybackModel::processSegment(const int tickPositionOffset, const Segment*
         }
 
         if (chordSymbol->play()) {
-            m_renderer.renderChordSymbol(chordSymbol, tickPositionOffset, profile,
-                                         m_playbackDataMap[trackId].originEvents);
+            PlaybackEventsMap events;
+            m_renderer.renderChordSymbol(chordSymbol, tickPositionOffset, profile, events);
+            appendEvents(result.events[trackId], std::move(events));
         }
 
-        collectChangesTracks(trackId, trackChanges);
+        result.changedTracks.insert(trackId);
     }
 
     for (const EngravingItem* item : segment->elist()) {
@@ -406,7 +477,7 @@ void PlaybackModel::processSegment(const int tickPositionOffset, const Segment*
                 const MeasureRepeat* measureRepeat = toMeasureRepeat(item);
                 const Measure* currentMeasure = measureRepeat->measure();
 
-                processMeasureRepeat(tickPositionOffset, measureRepeat, currentMeasure, staffIdx, trackChanges);
+                processMeasureRepeat(tickPositionOffset, measureRepeat, currentMeasure, staffIdx, result);
 
                 continue;
             } else {
@@ -415,13 +486,16 @@ void PlaybackModel::processSegment(const int tickPositionOffset, const Segment*
                 if (currentMeasure->measureRepeatCount(staffIdx) > 0) {
                     const MeasureRepeat* measureRepeat = currentMeasure->measureRepeatElement(staffIdx);
 
-                    processMeasureRepeat(tickPositionOffset, measureRepeat, currentMeasure, staffIdx, trackChanges);
+                    processMeasureRepeat(tickPositionOffset, measureRepeat, currentMeasure, staffIdx, result);
                     continue;
                 }
             }
         }
 
-        const PlaybackContext& ctx = m_playbackCtxMap[trackId];
+        //! NOTE The contexts are updated before the events, don't insert them here: the parts are rendered concurrently
+        static const PlaybackContext emptyCtx;
+        auto ctxIt = m_playbackCtxMap.find(trackId);
+        const PlaybackContext& ctx = ctxIt != m_playbackCtxMap.cend() ? ctxIt->second : emptyCtx;
 
         ArticulationsProfilePtr profile = defaultActiculationProfile(trackId);
         if (!profile) {
@@ -429,16 +503,18 @@ void PlaybackModel::processSegment(const int tickPositionOffset, const Segment*
             continue;
         }
 
+        PlaybackEventsMap events;
         m_renderer.render(item, tickPositionOffset, ctx.appliableDynamicLevel(segmentStartTick + tickPositionOffset),
                           ctx.persistentArticulationType(segmentStartTick + tickPositionOffset), std::move(profile),
-                          m_playbackDataMap[trackId].originEvents);
+                          events);
+        appendEvents(result.events[trackId], std::move(events));
 
-        collectChangesTracks(trackId, trackChanges);
+        result.changedTracks.insert(trackId);
     }
 }
 
 void PlaybackModel::processMeasureRepeat(const int tickPositionOffset, const MeasureRepeat* measureRepeat, const Measure* currentMeasure,
-                                         const staff_idx_t staffIdx, ChangedTrackIdSet* trackChanges)
+                                         const staff_idx_t staffIdx, RenderedEvents& result) const
 {
     if (!measureRepeat || !currentMeasure) {
         return;
@@ -464,7 +540,7 @@ void PlaybackModel::processMeasureRepeat(const int tickPositionOffset, const Mea
             continue;
         }
 
-        processSegment(tickPositionOffset + repeatPositionTickOffset, seg, { staffIdx }, isFirstSegmentOfRepeatedMeasure, trackChanges);
+        processSegment(tickPositionOffset + repeatPositionTickOffset, seg, { staffIdx }, isFirstSegmentOfRepeatedMeasure, result);
         isFirstSegmentOfRepeatedMeasure = false;
     }
 }
@@ -474,10 +550,127 @@ void PlaybackModel::updateEvents(const int tickFrom, const int tickTo, const tra
 {
     TRACEFUNC;
 
-    std::set<staff_idx_t> staffToProcessIdxSet = m_score->staffIdxSetFromRange(trackFrom, trackTo, [](const Staff& staff) {
-        return staff.isPrimaryStaff(); // skip linked staves
+    renderMeasures(measuresToRender(tickFrom, tickTo), tickFrom, tickTo, trackFrom, trackTo, trackChanges);
+}
+
+void PlaybackModel::startIncrementalLoad()
+{
+    TRACEFUNC;
+
+    updateSetupData();
+    updateContext(0, m_score->ntracks());
+
+    m_pendingLoad.ranges = { UtickRange { 0, repeatList().ticks() } };
+
+    loadNextWindow(LOAD_FIRST_WINDOW_SECS, nullptr);
+}
+
+void PlaybackModel::loadNextWindow(const double secs, ChangedTrackIdSet* trackChanges)
+{
+    TRACEFUNC;
+
+    if (m_pendingLoad.isEmpty()) {
+        return;
+    }
+
+    //! NOTE The window starts at the measure of the playback position if it hasn't been rendered yet,
+    //! otherwise at the next range which hasn't (the ranges before the position come last)
+    std::vector<UtickRange>& ranges = m_pendingLoad.ranges;
+    auto range = std::find_if(ranges.begin(), ranges.end(), [this](const UtickRange& pending) {
+        return pending.utickTo > m_playbackUtick;
     });
 
+    if (range == ranges.end()) {
+        range = ranges.begin();
+    }
+
+    int windowUtickFrom = range->utickFrom;
+    if (range->utickFrom <= m_playbackUtick && m_playbackUtick < range->utickTo) {
+        windowUtickFrom = std::max(range->utickFrom, measureUtick(m_playbackUtick));
+    }
+
+    //! NOTE Make progress even if the tempo is very slow
+    const RepeatList& repeats = repeatList();
+    int windowUtickTo = repeats.utime2utick(repeats.utick2utime(windowUtickFrom) + secs);
+    windowUtickTo = std::clamp(windowUtickTo, windowUtickFrom + 1, range->utickTo);
+
+    UtickRange rangeBefore { range->utickFrom, windowUtickFrom };
+    UtickRange rangeAfter { windowUtickTo, range->utickTo };
+
+    range = ranges.erase(range);
+    if (!rangeAfter.isEmpty()) {
+        range = ranges.insert(range, rangeAfter);
+    }
+    if (!rangeBefore.isEmpty()) {
+        ranges.insert(range, rangeBefore);
+    }
+
+    std::vector<MeasureToRender> measures = measuresToRenderInUtickRange(windowUtickFrom, windowUtickTo);
+    renderMeasures(measures, 0, m_score->lastMeasure()->endTick().ticks(), 0, m_score->ntracks(), trackChanges);
+}
+
+void PlaybackModel::scheduleNextLoadWindow()
+{
+    if (m_isLoadWindowScheduled) {
+        return;
+    }
+
+    m_isLoadWindowScheduled = true;
+
+    muse::async::Async::call(this, [this]() {
+        m_isLoadWindowScheduled = false;
+
+        if (m_pendingLoad.isEmpty()) {
+            return;
+        }
+
+        InstrumentTrackIdSet oldTracks = existingTrackIdSet();
+        ChangedTrackIdSet trackChanges;
+        loadNextWindow(LOAD_NEXT_WINDOW_SECS, &trackChanges);
+
+        notifyAboutChanges(oldTracks, trackChanges);
+
+        if (!m_pendingLoad.isEmpty()) {
+            scheduleNextLoadWindow();
+        }
+    });
+}
+
+void PlaybackModel::finishIncrementalLoad()
+{
+    TRACEFUNC;
+
+    if (m_pendingLoad.isEmpty()) {
+        return;
+    }
+
+    std::vector<MeasureToRender> measures;
+    for (const UtickRange& range : m_pendingLoad.ranges) {
+        std::vector<MeasureToRender> rangeMeasures = measuresToRenderInUtickRange(range.utickFrom, range.utickTo);
+        measures.insert(measures.end(), rangeMeasures.begin(), rangeMeasures.end());
+    }
+
+    m_pendingLoad = PendingLoad();
+
+    InstrumentTrackIdSet oldTracks = existingTrackIdSet();
+    ChangedTrackIdSet trackChanges;
+    renderMeasures(measures, 0, m_score->lastMeasure()->endTick().ticks(), 0, m_score->ntracks(), &trackChanges);
+
+    notifyAboutChanges(oldTracks, trackChanges);
+}
+
+int PlaybackModel::measureUtick(const int utick) const
+{
+    int tick = repeatList().utick2tick(utick);
+    const Measure* measure = m_score->tick2measure(Fraction::fromTicks(tick));
+
+    return measure ? utick - (tick - measure->tick().ticks()) : utick;
+}
+
+std::vector<PlaybackModel::MeasureToRender> PlaybackModel::measuresToRender(const int tickFrom, const int tickTo) const
+{
+    std::vector<MeasureToRender> result;
+
     for (const RepeatSegment* repeatSegment : repeatList()) {
         int tickPositionOffset = repeatSegment->utick - repeatSegment->tick;
         int repeatStartTick = repeatSegment->tick;
@@ -495,31 +688,133 @@ void PlaybackModel::updateEvents(const int tickFrom, const int tickTo, const tra
                 continue;
             }
 
-            bool isFirstSegmentOfMeasure = true;
+            result.push_back({ measure, tickPositionOffset });
+        }
+    }
 
-            for (Segment* segment = measure->first(); segment; segment = segment->next()) {
-                if (!segment->isChordRestType()) {
-                    continue;
-                }
+    return result;
+}
 
-                int segmentStartTick = segment->tick().ticks();
-                int segmentEndTick = segmentStartTick + segment->ticks().ticks();
+std::vector<PlaybackModel::MeasureToRender> PlaybackModel::measuresToRenderInUtickRange(const int utickFrom, const int utickTo) const
+{
+    std::vector<MeasureToRender> result;
 
-                if (segmentStartTick > tickTo || segmentEndTick <= tickFrom) {
-                    continue;
-                }
+    for (const RepeatSegment* repeatSegment : repeatList()) {
+        int tickPositionOffset = repeatSegment->utick - repeatSegment->tick;
+
+        if (repeatSegment->utick >= utickTo || repeatSegment->utick + repeatSegment->len() <= utickFrom) {
+            continue;
+        }
+
+        //! NOTE A measure belongs to the window in which it starts
+        for (const Measure* measure : repeatSegment->measureList()) {
+            int measureStartUtick = measure->tick().ticks() + tickPositionOffset;
+
+            if (measureStartUtick < utickFrom || measureStartUtick >= utickTo) {
+                continue;
+            }
+
+            result.push_back({ measure, tickPositionOffset });
+        }
+    }
+
+    return result;
+}
+
+void PlaybackModel::renderMeasures(const std::vector<MeasureToRender>& measures, const int tickFrom, const int tickTo,
+                                   const track_idx_t trackFrom, const track_idx_t trackTo, ChangedTrackIdSet* trackChanges)
+{
+    if (measures.empty()) {
+        return;
+    }
+
+    std::set<staff_idx_t> staffToProcessIdxSet = m_score->staffIdxSetFromRange(trackFrom, trackTo, [](const Staff& staff) {
+        return staff.isPrimaryStaff(); // skip linked staves
+    });
+
+    //! NOTE Every part is rendered by its own task, so the items of a part (and their cached data, e.g. the grace notes groups)
+    //! are accessed by a single thread. The repeat segments of a part are rendered by the same task, since they revisit the same measures
+    std::vector<std::set<staff_idx_t> > staffIdxSetPerPart;
+    const Part* lastPart = nullptr;
+
+    for (staff_idx_t staffIdx : staffToProcessIdxSet) {
+        const Part* part = m_score->staff(staffIdx)->part();
+        if (part != lastPart || staffIdxSetPerPart.empty()) {
+            staffIdxSetPerPart.emplace_back();
+            lastPart = part;
+        }
+
+        staffIdxSetPerPart.back().insert(staffIdx);
+    }
+
+    resolveArticulationProfiles();
+
+    const size_t metronomeTaskIdx = staffIdxSetPerPart.size();
+    std::vector<RenderedEvents> results(metronomeTaskIdx + 1);
+
+    auto renderTask = [&](size_t idx) {
+        if (idx == metronomeTaskIdx) {
+            renderMetronome(measures, results.at(idx));
+        } else {
+            renderPartMeasures(measures, tickFrom, tickTo, staffIdxSetPerPart.at(idx), results.at(idx));
+        }
+    };
+
+    if (m_parallelRenderingEnabled) {
+        muse::TaskScheduler::instance()->parallelFor(results.size(), renderTask);
+    } else {
+        for (size_t idx = 0; idx < results.size(); ++idx) {
+            renderTask(idx);
+        }
+    }
+
+    for (RenderedEvents& result : results) {
+        for (auto& pair : result.events) {
+            appendRenderedEvents(pair.first, std::move(pair.second));
+        }
+
+        for (const InstrumentTrackId& trackId : result.changedTracks) {
+            collectChangesTracks(trackId, trackChanges);
+        }
+    }
+}
+
+void PlaybackModel::renderPartMeasures(const std::vector<MeasureToRender>& measures, const int tickFrom, const int tickTo,
+                                       const std::set<staff_idx_t>& staffIdxSet, RenderedEvents& result) const
+{
+    for (const MeasureToRender& measureToRender : measures) {
+        bool isFirstSegmentOfMeasure = true;
+
+        for (const Segment* segment = measureToRender.measure->first(); segment; segment = segment->next()) {
+            if (!segment->isChordRestType()) {
+                continue;
+            }
+
+            int segmentStartTick = segment->tick().ticks();
+            int segmentEndTick = segmentStartTick + segment->ticks().ticks();
 
-                processSegment(tickPositionOffset, segment, staffToProcessIdxSet, isFirstSegmentOfMeasure, trackChanges);
-                isFirstSegmentOfMeasure = false;
+            if (segmentStartTick > tickTo || segmentEndTick <= tickFrom) {
+                continue;
             }
 
-            m_renderer.renderMetronome(m_score, measureStartTick, measureEndTick, tickPositionOffset,
-                                       m_playbackDataMap[METRONOME_TRACK_ID].originEvents);
-            collectChangesTracks(METRONOME_TRACK_ID, trackChanges);
+            processSegment(measureToRender.tickPositionOffset, segment, staffIdxSet, isFirstSegmentOfMeasure, result);
+            isFirstSegmentOfMeasure = false;
         }
     }
 }
 
+void PlaybackModel::renderMetronome(const std::vector<MeasureToRender>& measures, RenderedEvents& result) const
+{
+    for (const MeasureToRender& measureToRender : measures) {
+        PlaybackEventsMap events;
+        m_renderer.renderMetronome(m_score, measureToRender.measure->tick().ticks(), measureToRender.measure->endTick().ticks(),
+                                   measureToRender.tickPositionOffset, events);
+        appendEvents(result.events[METRONOME_TRACK_ID], std::move(events));
+    }
+
+    result.changedTracks.insert(METRONOME_TRACK_ID);
+}
+
 bool PlaybackModel::hasToReloadTracks(const ScoreChangesRange& changesRange) const
 {
     static const std::unordered_set<ElementType> REQUIRED_TYPES = {
@@ -721,18 +1016,67 @@ void PlaybackModel::collectChangesTracks(const InstrumentTrackId& trackId, Chang
     result->insert(trackId);
 }
 
+void PlaybackModel::collectChangedTimestamps(const InstrumentTrackId& trackId, const timestamp_t timestampFrom,
+                                             const timestamp_t timestampTo)
+{
+    TimestampBoundaries& boundaries = m_changedTimestampsMap[trackId];
+    boundaries.timestampFrom = std::min(boundaries.timestampFrom, timestampFrom);
+    boundaries.timestampTo = std::max(boundaries.timestampTo, timestampTo);
+}
+
+void PlaybackModel::appendRenderedEvents(const InstrumentTrackId& trackId, PlaybackEventsMap&& events)
+{
+    if (events.empty()) {
+        return;
+    }
+
+    collectChangedTimestamps(trackId, events.cbegin()->first, events.crbegin()->first);
+
+    appendEvents(m_playbackDataMap[trackId].originEvents, std::move(events));
+}
+
 void PlaybackModel::notifyAboutChanges(const InstrumentTrackIdSet& oldTracks, const InstrumentTrackIdSet& changedTracks)
 {
-    for (const InstrumentTrackId& trackId : changedTracks) {
+    //! NOTE Tracks whose events have only been removed have to be notified too
+    InstrumentTrackIdSet tracksToNotify = changedTracks;
+
+    for (const auto& pair : m_changedTimestampsMap) {
+        tracksToNotify.insert(pair.first);
+    }
+
+    for (const InstrumentTrackId& trackId : tracksToNotify) {
         auto search = m_playbackDataMap.find(trackId);
 
         if (search == m_playbackDataMap.cend()) {
             continue;
         }
 
-        search->second.mainStream.send(search->second.originEvents, search->second.dynamicLevelMap, search->second.paramMap);
+        PlaybackData& trackData = search->second;
+        PlaybackEventsChanges changes;
+
+        //! NOTE Send only the range of events touched by the update, the receivers patch their copies in place
+        auto boundaries = m_changedTimestampsMap.find(trackId);
+        if (boundaries != m_changedTimestampsMap.cend() && boundaries->second.isValid()) {
+            changes.from = boundaries->second.timestampFrom;
+            changes.to = boundaries->second.timestampTo;
+
+            if (changes.isFullReplace()) {
+                changes.events = trackData.originEvents;
+            } else {
+                changes.events.insert(trackData.originEvents.lower_bound(changes.from),
+                                      trackData.originEvents.upper_bound(changes.to));
+            }
+        } else {
+            //! NOTE Nothing but the dynamics and the params has changed
+            changes.from = std::numeric_limits<timestamp_t>::max();
+            changes.to = std::numeric_limits<timestamp_t>::min();
+        }
+
+        trackData.mainStream.send(std::move(changes), trackData.dynamicLevelMap, trackData.paramMap);
     }
 
+    m_changedTimestampsMap.clear();
+
     for (auto it = m_playbackDataMap.cbegin(); it != m_playbackDataMap.cend(); ++it) {
         if (!muse::contains(oldTracks, it->first)) {
             m_trackAdded.send(it->first);
@@ -757,6 +1101,7 @@ void PlaybackModel::removeTrackEvents(const InstrumentTrackId& trackId, const mu
 
     if (timestampFrom == -1 && timestampTo == -1) {
         search->second.originEvents.clear();
+        collectChangedTimestamps(trackId, std::numeric_limits<timestamp_t>::min(), std::numeric_limits<timestamp_t>::max());
         return;
     }
 
@@ -766,8 +1111,10 @@ void PlaybackModel::removeTrackEvents(const InstrumentTrackId& trackId, const mu
         //!Note Some events might be started RIGHT before the "official" start of the track
         //!     Need to make sure that we don't miss those events
         lowerBound = trackPlaybackData.originEvents.begin();
+        collectChangedTimestamps(trackId, std::numeric_limits<timestamp_t>::min(), timestampTo);
     } else {
         lowerBound = trackPlaybackData.originEvents.lower_bound(timestampFrom);
+        collectChangedTimestamps(trackId, timestampFrom, timestampTo);
     }
 
     auto upperBound = trackPlaybackData.originEvents.upper_bound(timestampTo);
@@ -907,12 +1254,22 @@ InstrumentTrackId PlaybackModel::idKey(const ID& partId, const String& instrumen
     return { partId, instrumentId };
 }
 
+void PlaybackModel::resolveArticulationProfiles()
+{
+    //! NOTE The profiles are resolved in advance: the repository isn't accessed by the rendering tasks
+    m_articulationProfiles.clear();
+
+    for (const auto& pair : m_playbackDataMap) {
+        m_articulationProfiles.emplace(pair.first, profilesRepository()->defaultProfile(pair.second.setupData.category));
+    }
+}
+
 muse::mpe::ArticulationsProfilePtr PlaybackModel::defaultActiculationProfile(const InstrumentTrackId& trackId) const
 {
-    auto it = m_playbackDataMap.find(trackId);
-    if (it == m_playbackDataMap.cend()) {
+    auto it = m_articulationProfiles.find(trackId);
+    if (it == m_articulationProfiles.cend()) {
         return nullptr;
     }
 
-    return profilesRepository()->defaultProfile(it->second.setupData.category);
+    return it->second;
 }
@@ -26,6 +26,7 @@
 #include <unordered_map>
 #include <map>
 #include <functional>
+#include <vector>
 
 #include "async/asyncable.h"
 #include "async/channel.h"
@@ -64,6 +65,21 @@ public:
     bool isPlayChordSymbolsEnabled() const;
     void setPlayChordSymbols(const bool isEnabled);
 
+    //! NOTE When enabled, load() renders only the first seconds of the score,
+    //! the rest is rendered window by window from the event loop and sent as changes of the tracks
+    bool isIncrementalLoadEnabled() const;
+    void setIncrementalLoadEnabled(const bool isEnabled);
+
+    //! NOTE When enabled (by default), every part is rendered by its own task of the task scheduler
+    bool isParallelRenderingEnabled() const;
+    void setParallelRenderingEnabled(const bool isEnabled);
+
+    //! NOTE The incremental load renders the score from the playback position first
+    void setPlaybackPosition(const int utick);
+
+    //! NOTE Renders the rest of the score right away, e.g. before it is exported
+    void finishIncrementalLoad();
+
     const InstrumentTrackId& metronomeTrackId() const;
     InstrumentTrackId chordSymbolsTrackId(const ID& partId) const;
     bool isChordSymbolsTrack(const InstrumentTrackId& trackId) const;
@@ -98,6 +114,53 @@ private:
         track_idx_t trackTo = muse::nidx;
     };
 
+    //! NOTE The range of the origin events which have been touched since the last notification, both ends inclusive
+    struct TimestampBoundaries
+    {
+        muse::mpe::timestamp_t timestampFrom = std::numeric_limits<muse::mpe::timestamp_t>::max();
+        muse::mpe::timestamp_t timestampTo = std::numeric_limits<muse::mpe::timestamp_t>::min();
+
+        bool isValid() const
+        {
+            return timestampFrom <= timestampTo;
+        }
+    };
+
+    struct MeasureToRender
+    {
+        const Measure* measure = nullptr;
+        int tickPositionOffset = 0;
+    };
+
+    //! NOTE The result of a rendering task, merged into the playback data by the calling thread
+    struct RenderedEvents
+    {
+        std::unordered_map<InstrumentTrackId, muse::mpe::PlaybackEventsMap> events;
+        ChangedTrackIdSet changedTracks;
+    };
+
+    struct UtickRange
+    {
+        int utickFrom = 0;
+        int utickTo = 0;
+
+        bool isEmpty() const
+        {
+            return utickFrom >= utickTo;
+        }
+    };
+
+    //! NOTE The ranges of the unfolded score which haven't been rendered by the incremental load yet, in order
+    struct PendingLoad
+    {
+        std::vector<UtickRange> ranges;
+
+        bool isEmpty() const
+        {
+            return ranges.empty();
+        }
+    };
+
     InstrumentTrackId idKey(const EngravingItem* item) const;
     InstrumentTrackId idKey(const std::vector<const EngravingItem*>& items) const;
     InstrumentTrackId idKey(const ID& partId, const String& instrumentId) const;
@@ -110,10 +173,24 @@ private:
     void updateEvents(const int tickFrom, const int tickTo, const track_idx_t trackFrom, const track_idx_t trackTo,
                       ChangedTrackIdSet* trackChanges = nullptr);
 
+    void startIncrementalLoad();
+    void loadNextWindow(const double secs, ChangedTrackIdSet* trackChanges);
+    void scheduleNextLoadWindow();
+    int measureUtick(const int utick) const;
+
+    std::vector<MeasureToRender> measuresToRender(const int tickFrom, const int tickTo) const;
+    std::vector<MeasureToRender> measuresToRenderInUtickRange(const int utickFrom, const int utickTo) const;
+
+    void renderMeasures(const std::vector<MeasureToRender>& measures, const int tickFrom, const int tickTo, const track_idx_t trackFrom,
+                        const track_idx_t trackTo, ChangedTrackIdSet* trackChanges);
+    void renderPartMeasures(const std::vector<MeasureToRender>& measures, const int tickFrom, const int tickTo,
+                            const std::set<staff_idx_t>& staffIdxSet, RenderedEvents& result) const;
+    void renderMetronome(const std::vector<MeasureToRender>& measures, RenderedEvents& result) const;
+
     void processSegment(const int tickPositionOffset, const Segment* segment, const std::set<staff_idx_t>& staffIdxSet,
-                        bool isFirstSegmentOfMeasure, ChangedTrackIdSet* trackChanges);
+                        bool isFirstSegmentOfMeasure, RenderedEvents& result) const;
     void processMeasureRepeat(const int tickPositionOffset, const MeasureRepeat* measureRepeat, const Measure* currentMeasure,
-                              const staff_idx_t staffIdx, ChangedTrackIdSet* trackChanges);
+                              const staff_idx_t staffIdx, RenderedEvents& result) const;
 
     bool hasToReloadTracks(const ScoreChangesRange& changesRange) const;
     bool hasToReloadScore(const ScoreChangesRange& changesRange) const;
@@ -123,6 +200,9 @@ private:
     void clearExpiredContexts(const track_idx_t trackFrom, const track_idx_t trackTo);
     void clearExpiredEvents(const int tickFrom, const int tickTo, const track_idx_t trackFrom, const track_idx_t trackTo);
     void collectChangesTracks(const InstrumentTrackId& trackId, ChangedTrackIdSet* result);
+    void collectChangedTimestamps(const InstrumentTrackId& trackId, const muse::mpe::timestamp_t timestampFrom,
+                                  const muse::mpe::timestamp_t timestampTo);
+    void appendRenderedEvents(const InstrumentTrackId& trackId, muse::mpe::PlaybackEventsMap&& events);
     void notifyAboutChanges(const InstrumentTrackIdSet& oldTracks, const InstrumentTrackIdSet& changedTracks);
 
     void removeEventsFromRange(const track_idx_t trackFrom, const track_idx_t trackTo, const muse::mpe::timestamp_t timestampFrom = -1,
@@ -137,17 +217,26 @@ private:
 
     std::vector<const EngravingItem*> filterPlayableItems(const std::vector<const EngravingItem*>& items) const;
 
+    void resolveArticulationProfiles();
     muse::mpe::ArticulationsProfilePtr defaultActiculationProfile(const InstrumentTrackId& trackId) const;
 
     Score* m_score = nullptr;
     bool m_expandRepeats = true;
     bool m_playChordSymbols = true;
+    bool m_incrementalLoadEnabled = false;
+    bool m_parallelRenderingEnabled = true;
+
+    PendingLoad m_pendingLoad;
+    bool m_isLoadWindowScheduled = false;
+    int m_playbackUtick = 0;
 
     PlaybackEventsRenderer m_renderer;
     PlaybackSetupDataResolver m_setupResolver;
 
     std::unordered_map<InstrumentTrackId, PlaybackContext> m_playbackCtxMap;
     std::unordered_map<InstrumentTrackId, muse::mpe::PlaybackData> m_playbackDataMap;
+    std::unordered_map<InstrumentTrackId, TimestampBoundaries> m_changedTimestampsMap;
+    std::unordered_map<InstrumentTrackId, muse::mpe::ArticulationsProfilePtr> m_articulationProfiles;
 
     muse::async::Notification m_dataChanged;
     muse::async::Channel<InstrumentTrackId> m_trackAdded;
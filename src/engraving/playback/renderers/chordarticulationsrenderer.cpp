@@ -38,16 +38,17 @@ using namespace muse::mpe;
 
 const mpe::ArticulationTypeSet& ChordArticulationsRenderer::supportedTypes()
 {
-    static mpe::ArticulationTypeSet SUPPORTED_TYPES;
-
-    if (SUPPORTED_TYPES.empty()) {
-        SUPPORTED_TYPES.insert(OrnamentsRenderer::supportedTypes().cbegin(),
-                               OrnamentsRenderer::supportedTypes().cend());
-        SUPPORTED_TYPES.insert(TremoloRenderer::supportedTypes().cbegin(),
-                               TremoloRenderer::supportedTypes().cend());
-        SUPPORTED_TYPES.insert(ArpeggioRenderer::supportedTypes().cbegin(),
-                               ArpeggioRenderer::supportedTypes().cend());
-    }
+    //! NOTE Initialized once and thread-safely: the playback model renders the parts concurrently
+    static const mpe::ArticulationTypeSet SUPPORTED_TYPES = []() {
+        mpe::ArticulationTypeSet types;
+        types.insert(OrnamentsRenderer::supportedTypes().cbegin(),
+                     OrnamentsRenderer::supportedTypes().cend());
+        types.insert(TremoloRenderer::supportedTypes().cbegin(),
+                     TremoloRenderer::supportedTypes().cend());
+        types.insert(ArpeggioRenderer::supportedTypes().cbegin(),
+                     ArpeggioRenderer::supportedTypes().cend());
+        return types;
+    }();
 
     return SUPPORTED_TYPES;
 }
@@ -372,12 +372,15 @@ void Autoplace::doAutoplace(const Articulation* item, Articulation::LayoutData*
 
         Shape thisShape = item->shape().translate(item->chordRest()->pos() + m->pos() + s->pos() + item->pos());
 
+        // one line for all the elements, clear() keeps its storage
+        const bool above = item->up();
+        SkylineLine sk(!above);
+
         for (const ShapeElement& shapeEl : thisShape.elements()) {
             RectF r = shapeEl;
 
             double d = 0.0;
-            bool above = item->up();
-            SkylineLine sk(!above);
+            sk.clear();
             if (above) {
                 sk.add(r.x(), r.bottom(), r.width());
                 d = sk.minDistance(ss->skyline().north());
@@ -44,42 +44,67 @@ using namespace mu::engraving::rendering::dev;
 //-------------------------------------------------------------------
 
 double HorizontalSpacing::minHorizontalDistance(const Shape& f, const Shape& s, double spatium, double squeezeFactor)
+{
+    return minHorizontalDistance(f, &s, 1, spatium, squeezeFactor);
+}
+
+double HorizontalSpacing::minHorizontalDistance(const Shape& f, const std::vector<Shape>& shapes, double spatium, double squeezeFactor)
+{
+    return minHorizontalDistance(f, shapes.data(), shapes.size(), spatium, squeezeFactor);
+}
+
+double HorizontalSpacing::minHorizontalDistance(const Shape& f, const Shape* shapes, size_t count, double spatium,
+                                                double squeezeFactor)
 {
     double dist = -DBL_MAX;        // min real
     double absoluteMinPadding = 0.1 * spatium * squeezeFactor;
     double verticalClearance = 0.2 * spatium * squeezeFactor;
-    for (const ShapeElement& r2 : s.elements()) {
-        if (r2.isNull()) {
-            continue;
+
+    // the elements of f are the same for all the shapes, collect them once
+    struct Element {
+        const ShapeElement* rect = nullptr;
+        const EngravingItem* item = nullptr;
+        double y1 = 0.0;
+        double y2 = 0.0;
+    };
+    thread_local std::vector<Element> fElements;
+    fElements.clear();
+    for (const ShapeElement& r1 : f.elements()) {
+        if (!r1.isNull()) {
+            fElements.push_back({ &r1, r1.item(), r1.top(), r1.bottom() });
         }
-        const EngravingItem* item2 = r2.item();
-        double by1 = r2.top();
-        double by2 = r2.bottom();
-        for (const ShapeElement& r1 : f.elements()) {
-            if (r1.isNull()) {
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        for (const ShapeElement& r2 : shapes[i].elements()) {
+            if (r2.isNull()) {
                 continue;
             }
-            const EngravingItem* item1 = r1.item();
-            double ay1 = r1.top();
-            double ay2 = r1.bottom();
-            bool intersection = mu::engraving::intersects(ay1, ay2, by1, by2, verticalClearance);
-            double padding = 0;
-            KerningType kerningType = KerningType::NON_KERNING;
-            if (item1 && item2) {
-                padding = computePadding(item1, item2);
-                padding *= squeezeFactor;
-                padding = std::max(padding, absoluteMinPadding);
-                kerningType = computeKerning(item1, item2);
-            }
-            if ((intersection && kerningType != KerningType::ALLOW_COLLISION)
-                || (r1.width() == 0 || r2.width() == 0)  // Temporary hack: shapes of zero-width are assumed to collide with everyghin
-                || (!item1 && item2 && item2->isLyrics())  // Temporary hack: avoids collision with melisma line
-                || kerningType == KerningType::NON_KERNING) {
-                dist = std::max(dist, r1.right() - r2.left() + padding);
-            }
-            if (kerningType == KerningType::KERNING_UNTIL_ORIGIN) { //prepared for future user option, for now always false
-                double origin = r1.left();
-                dist = std::max(dist, origin - r2.left());
+            const EngravingItem* item2 = r2.item();
+            double by1 = r2.top();
+            double by2 = r2.bottom();
+            for (const Element& e1 : fElements) {
+                const ShapeElement& r1 = *e1.rect;
+                const EngravingItem* item1 = e1.item;
+                bool intersection = mu::engraving::intersects(e1.y1, e1.y2, by1, by2, verticalClearance);
+                double padding = 0;
+                KerningType kerningType = KerningType::NON_KERNING;
+                if (item1 && item2) {
+                    padding = computePadding(item1, item2);
+                    padding *= squeezeFactor;
+                    padding = std::max(padding, absoluteMinPadding);
+                    kerningType = computeKerning(item1, item2);
+                }
+                if ((intersection && kerningType != KerningType::ALLOW_COLLISION)
+                    || (r1.width() == 0 || r2.width() == 0)  // Temporary hack: shapes of zero-width are assumed to collide with everyghin
+                    || (!item1 && item2 && item2->isLyrics())  // Temporary hack: avoids collision with melisma line
+                    || kerningType == KerningType::NON_KERNING) {
+                    dist = std::max(dist, r1.right() - r2.left() + padding);
+                }
+                if (kerningType == KerningType::KERNING_UNTIL_ORIGIN) { //prepared for future user option, for now always false
+                    double origin = r1.left();
+                    dist = std::max(dist, origin - r2.left());
+                }
             }
         }
     }
@@ -235,15 +260,8 @@ double HorizontalSpacing::minHorizontalCollidingDistance(const Segment* f, const
 
 double HorizontalSpacing::minLeft(const Segment* seg, const Shape& ls)
 {
-    double distance = 0.0;
     double sp = shapeSpatium(ls);
-    for (const Shape& sh : seg->shapes()) {
-        double d = minHorizontalDistance(ls, sh, sp, 1.0);
-        if (d > distance) {
-            distance = d;
-        }
-    }
-    return distance;
+    return std::max(minHorizontalDistance(ls, seg->shapes(), sp, 1.0), 0.0);
 }
 
 void HorizontalSpacing::spaceRightAlignedSegments(Measure* m, double segmentShapeSqueezeFactor)
@@ -379,7 +397,7 @@ void HorizontalSpacing::computeNotePadding(const Note* note, const EngravingItem
 
     bool sameVoiceNoteOrStem = (item2->isNote() || item2->isStem()) && note->track() == item2->track();
     if (sameVoiceNoteOrStem) {
-        bool intersection = note->shape().translate(note->pos()).intersects(item2->shape().translate(item2->pos()));
+        bool intersection = note->shape().intersects(item2->shape(), note->pos(), item2->pos());
         if (intersection) {
             padding = std::max(padding, static_cast<double>(style.styleMM(Sid::minNoteDistance)));
         }
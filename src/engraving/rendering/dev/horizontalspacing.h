@@ -22,6 +22,9 @@
 #ifndef MU_ENGRAVING_HORIZONTALSPACINGUTILS_DEV_H
 #define MU_ENGRAVING_HORIZONTALSPACINGUTILS_DEV_H
 
+#include <cstddef>
+#include <vector>
+
 namespace mu::engraving {
 class Chord;
 class EngravingItem;
@@ -41,6 +44,8 @@ class HorizontalSpacing
 public:
 
     static double minHorizontalDistance(const Shape& f, const Shape& s, double spatium, double squeezeFactor = 1.0);
+    //! NOTE The max of the distances from f to each of the shapes
+    static double minHorizontalDistance(const Shape& f, const std::vector<Shape>& shapes, double spatium, double squeezeFactor = 1.0);
     //! NOTE Temporary solution
     static double shapeSpatium(const Shape& s);
 
@@ -55,6 +60,8 @@ public:
     static KerningType computeKerning(const EngravingItem* item1, const EngravingItem* item2);
 
 private:
+    static double minHorizontalDistance(const Shape& f, const Shape* shapes, size_t count, double spatium, double squeezeFactor);
+
     static bool isSpecialNotePaddingType(ElementType type);
     static void computeNotePadding(const Note* note, const EngravingItem* item2, double& padding, double scaling);
     static void computeLedgerRestPadding(const Rest* rest2, double& padding);
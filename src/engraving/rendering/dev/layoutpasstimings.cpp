@@ -0,0 +1,90 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "layoutpasstimings.h"
+
+using namespace mu::engraving::rendering::dev;
+
+std::atomic<bool> LayoutPassTimings::s_enabled = false;
+std::array<std::atomic<int64_t>, LayoutPassTimings::PASS_COUNT> LayoutPassTimings::s_nanoseconds = {};
+
+//! NOTE The innermost active scope of the current thread
+static thread_local LayoutPassTimings::Scope* s_currentScope = nullptr;
+
+void LayoutPassTimings::Scope::begin(Pass pass)
+{
+    m_active = true;
+    m_pass = pass;
+    m_parent = s_currentScope;
+    s_currentScope = this;
+    m_start = std::chrono::steady_clock::now();
+}
+
+void LayoutPassTimings::Scope::end()
+{
+    const std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - m_start;
+
+    s_nanoseconds[static_cast<size_t>(m_pass)].fetch_add((elapsed - m_nested).count(), std::memory_order_relaxed);
+
+    if (m_parent) {
+        m_parent->m_nested += elapsed;
+    }
+
+    s_currentScope = m_parent;
+}
+
+void LayoutPassTimings::setEnabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void LayoutPassTimings::clear()
+{
+    for (std::atomic<int64_t>& ns : s_nanoseconds) {
+        ns.store(0, std::memory_order_relaxed);
+    }
+}
+
+LayoutPassTimings::Durations LayoutPassTimings::durations()
+{
+    Durations result;
+    for (size_t i = 0; i < PASS_COUNT; ++i) {
+        result[i] = std::chrono::nanoseconds(s_nanoseconds[i].load(std::memory_order_relaxed));
+    }
+
+    return result;
+}
+
+const char* LayoutPassTimings::passName(Pass pass)
+{
+    switch (pass) {
+    case Pass::Other: return "Other";
+    case Pass::ResetLayoutData: return "ResetLayoutData";
+    case Pass::LayoutIndependentItems: return "LayoutIndependentItems";
+    case Pass::MeasureLayout: return "MeasureLayout";
+    case Pass::SystemLayout: return "SystemLayout";
+    case Pass::PageLayout: return "PageLayout";
+    case Pass::SlurTieLayout: return "SlurTieLayout";
+    case Pass::Count: break;
+    }
+
+    return "";
+}
@@ -0,0 +1,102 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MU_ENGRAVING_LAYOUTPASSTIMINGS_DEV_H
+#define MU_ENGRAVING_LAYOUTPASSTIMINGS_DEV_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace mu::engraving::rendering::dev {
+//! NOTE Lightweight accumulated timings of the layout passes, used by the layout benchmark.
+//! The kors profiler and LAYOUT_CALL are only available in special builds,
+//! these timings are compiled in and cost a single atomic load while disabled.
+//! The time of a pass is exclusive: the time spent in the nested passes is not counted,
+//! e.g. the measures laid out while collecting a system are counted in MeasureLayout.
+//! The times of all the threads are summed.
+class LayoutPassTimings
+{
+public:
+    enum class Pass : uint8_t {
+        Other = 0, // the part of ScoreLayout::layoutRange not covered by the other passes
+        ResetLayoutData,
+        LayoutIndependentItems,
+        MeasureLayout,
+        SystemLayout,
+        PageLayout,
+        SlurTieLayout,
+
+        Count
+    };
+
+    static constexpr size_t PASS_COUNT = static_cast<size_t>(Pass::Count);
+
+    using Durations = std::array<std::chrono::nanoseconds, PASS_COUNT>;
+
+    class Scope
+    {
+    public:
+        Scope(Pass pass)
+        {
+            if (LayoutPassTimings::enabled()) {
+                begin(pass);
+            }
+        }
+
+        ~Scope()
+        {
+            if (m_active) {
+                end();
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        void begin(Pass pass);
+        void end();
+
+        bool m_active = false;
+        Pass m_pass = Pass::Other;
+        Scope* m_parent = nullptr;
+        std::chrono::steady_clock::time_point m_start;
+        std::chrono::nanoseconds m_nested { 0 };
+    };
+
+    static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool enabled);
+
+    static void clear();
+    static Durations durations();
+
+    static const char* passName(Pass pass);
+
+private:
+    static std::atomic<bool> s_enabled;
+    static std::array<std::atomic<int64_t>, PASS_COUNT> s_nanoseconds;
+};
+}
+
+#endif // MU_ENGRAVING_LAYOUTPASSTIMINGS_DEV_H
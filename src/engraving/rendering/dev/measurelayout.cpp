@@ -54,6 +54,7 @@
 
 #include "tlayout.h"
 #include "layoutcontext.h"
+#include "layoutpasstimings.h"
 #include "arpeggiolayout.h"
 #include "beamlayout.h"
 #include "chordlayout.h"
@@ -999,6 +1000,7 @@ void MeasureLayout::getNextMeasure(LayoutContext& ctx)
 {
     TRACEFUNC;
     LAYOUT_CALL();
+    LayoutPassTimings::Scope passTimings(LayoutPassTimings::Pass::MeasureLayout);
 
     moveToNextMeasure(ctx);
 
@@ -2174,8 +2176,153 @@ void MeasureLayout::computeWidth(Measure* m, LayoutContext& ctx, Fraction minTic
     x = HorizontalSpacing::computeFirstSegmentXPosition(m, s, ctx.state().segmentShapeSqueezeFactor());
     bool isSystemHeader = s->header();
 
+    const uint64_t cacheKey = spacingCacheKey(m, ctx, x, isSystemHeader, minTicks, maxTicks, stretchCoeff, overrideMinMeasureWidth);
+    if (restoreSpacingFromCache(m, cacheKey)) {
+        m->score()->spacingCacheStats().hits++;
+        return;
+    }
+
+    m->score()->spacingCacheStats().misses++;
+
     m->setSqueezableSpace(0.0);
     computeWidth(m, ctx, s, x, isSystemHeader, minTicks, maxTicks, stretchCoeff, overrideMinMeasureWidth);
+
+    storeSpacingToCache(m, cacheKey);
+}
+
+namespace {
+struct KeyHasher {
+    uint64_t hash = 14695981039346656037ULL; // FNV-1a
+
+    template<typename T>
+    void add(const T& val)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&val);
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    void add(const Fraction& f)
+    {
+        add(f.numerator());
+        add(f.denominator());
+    }
+};
+}
+
+//! NOTE: Everything that the horizontal spacing of the measure depends on:
+//! the segments with their shapes and the parameters of the spacing
+uint64_t MeasureLayout::spacingCacheKey(const Measure* m, const LayoutContext& ctx, double x, bool isSystemHeader, Fraction minTicks,
+                                        Fraction maxTicks, double stretchCoeff, bool overrideMinMeasureWidth)
+{
+    KeyHasher h;
+
+    h.add(m->score()->spacingCacheGeneration());
+    h.add(x);
+    h.add(isSystemHeader);
+    h.add(minTicks);
+    h.add(maxTicks);
+    h.add(stretchCoeff);
+    h.add(overrideMinMeasureWidth);
+    h.add(ctx.state().segmentShapeSqueezeFactor());
+
+    h.add(m->isFirstInSystem());
+    h.add(m->userStretch());
+    h.add(m->spatium());
+    h.add(m->mag());
+    h.add(m->ticks());
+    h.add(m->timesig());
+
+    const System* system = m->system();
+    h.add(system ? system->width() : 0.0);
+    h.add(system ? system->leftMargin() : 0.0);
+
+    const MeasureBase* pmb = m->prev();
+    h.add(pmb && pmb->isMeasure() && pmb->system() == system && pmb->repeatEnd());
+
+    for (const Segment& s : m->segments()) {
+        h.add(&s);
+        h.add(s.segmentType());
+        h.add(s.rtick());
+        h.add(s.ticks());
+        h.add(s.enabled());
+        h.add(s.visible());
+        h.add(s.header());
+        h.add(s.extraLeadingSpace().val());
+
+        for (const Shape& shape : s.shapes()) {
+            h.add(shape.elements().size());
+            for (const ShapeElement& e : shape.elements()) {
+                h.add(e.x());
+                h.add(e.y());
+                h.add(e.width());
+                h.add(e.height());
+                h.add(e.item());
+                h.add(e.ignoreForLayout());
+            }
+        }
+    }
+
+    return h.hash;
+}
+
+bool MeasureLayout::restoreSpacingFromCache(Measure* m, uint64_t key)
+{
+    std::vector<Measure::SpacingCache::Entry>& entries = m->spacingCache().entries;
+
+    auto it = std::find_if(entries.begin(), entries.end(), [key](const Measure::SpacingCache::Entry& e) {
+        return e.key == key;
+    });
+
+    if (it == entries.end()) {
+        return false;
+    }
+
+    const Measure::SpacingCache::Entry& entry = *it;
+    IF_ASSERT_FAILED(entry.segments.size() == static_cast<size_t>(m->segments().size())) {
+        entries.erase(it);
+        return false;
+    }
+
+    size_t idx = 0;
+    for (Segment& s : m->segments()) {
+        const Measure::SpacingCache::SegmentSpacing& spacing = entry.segments[idx++];
+        s.mutldata()->setPosX(spacing.x);
+        s.setWidth(spacing.width);
+        s.setWidthOffset(spacing.widthOffset);
+        s.setStretch(spacing.stretch);
+    }
+
+    m->setSqueezableSpace(entry.squeezableSpace);
+    m->setLayoutStretch(entry.layoutStretch);
+    m->setWidth(entry.width);
+    m->setWidthLocked(entry.widthLocked);
+
+    return true;
+}
+
+void MeasureLayout::storeSpacingToCache(Measure* m, uint64_t key)
+{
+    std::vector<Measure::SpacingCache::Entry>& entries = m->spacingCache().entries;
+
+    if (entries.size() >= Measure::SpacingCache::MAX_ENTRIES) {
+        entries.erase(entries.begin());
+    }
+
+    Measure::SpacingCache::Entry& entry = entries.emplace_back();
+    entry.key = key;
+    entry.width = m->width();
+    entry.squeezableSpace = m->squeezableSpace();
+    entry.layoutStretch = m->layoutStretch();
+    entry.widthLocked = m->isWidthLocked();
+
+    entry.segments.reserve(static_cast<size_t>(m->segments().size()));
+    for (const Segment& s : m->segments()) {
+        entry.segments.push_back({ s.x(), s.width(LD_ACCESS::BAD), s.widthOffset(), s.stretch() });
+    }
 }
 
 void MeasureLayout::layoutTimeTickAnchors(Measure* m, LayoutContext& ctx)
@@ -79,6 +79,11 @@ private:
 
     static double computeMinMeasureWidth(Measure* m, LayoutContext& ctx);
 
+    static uint64_t spacingCacheKey(const Measure* m, const LayoutContext& ctx, double x, bool isSystemHeader, Fraction minTicks,
+                                    Fraction maxTicks, double stretchCoeff, bool overrideMinMeasureWidth);
+    static bool restoreSpacingFromCache(Measure* m, uint64_t key);
+    static void storeSpacingToCache(Measure* m, uint64_t key);
+
     static void layoutPartialWidth(StaffLines* lines, LayoutContext& ctx, double w, double wPartial, bool alignLeft);
 
     //
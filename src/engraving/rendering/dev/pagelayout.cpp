@@ -56,6 +56,7 @@
 #include "tupletlayout.h"
 #include "verticalgapdata.h"
 #include "arpeggiolayout.h"
+#include "layoutpasstimings.h"
 
 #include "log.h"
 
@@ -68,6 +69,8 @@ using namespace mu::engraving::rendering::dev;
 
 void PageLayout::getNextPage(LayoutContext& ctx)
 {
+    LayoutPassTimings::Scope passTimings(LayoutPassTimings::Pass::PageLayout);
+
     LayoutState& state = ctx.mutState();
     DomAccessor& dom = ctx.mutDom();
 
@@ -116,6 +119,7 @@ void PageLayout::getNextPage(LayoutContext& ctx)
 void PageLayout::collectPage(LayoutContext& ctx)
 {
     TRACEFUNC;
+    LayoutPassTimings::Scope passTimings(LayoutPassTimings::Pass::PageLayout);
 
     Page* page = ctx.mutState().page();
     const LayoutConfiguration& conf = ctx.conf();
@@ -75,6 +75,9 @@ void Paint::paintScore(Painter* painter, Score* score, const IScoreRenderer::Pai
     int fromPage = opt.fromPage >= 0 ? opt.fromPage : 0;
     int toPage = (opt.toPage >= 0 && opt.toPage < int(pages.size())) ? opt.toPage : (int(pages.size()) - 1);
 
+    // reused for all the pages
+    std::vector<EngravingItem*> elements;
+
     for (int copy = 0; copy < opt.copyCount; ++copy) {
         bool firstPage = true;
         for (int pi = fromPage; pi <= toPage; ++pi) {
@@ -138,7 +141,7 @@ void Paint::paintScore(Painter* painter, Score* score, const IScoreRenderer::Pai
                 disableClipping = true;
             }
 
-            std::vector<EngravingItem*> elements = page->items(drawRect.translated(-pagePos));
+            page->items(drawRect.translated(-pagePos), elements);
             paintItems(*painter, elements);
             //DebugPaint::paintPageTree(*painter, page);
 
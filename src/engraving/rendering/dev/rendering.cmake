@@ -69,4 +69,6 @@ set(RENDERING_DEV_SRC
 
     ${CMAKE_CURRENT_LIST_DIR}/dumplayoutdata.cpp
     ${CMAKE_CURRENT_LIST_DIR}/dumplayoutdata.h
+    ${CMAKE_CURRENT_LIST_DIR}/layoutpasstimings.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/layoutpasstimings.h
 )
@@ -41,6 +41,7 @@
 #include "dom/box.h"
 
 #include "passresetlayoutdata.h"
+#include "layoutpasstimings.h"
 
 #include "tlayout.h"
 #include "systemlayout.h"
@@ -92,8 +93,11 @@ void ScoreHorizontalViewLayout::layoutHorizontalView(Score* score, LayoutContext
     ctx.mutState().setNextMeasure(m);             //_showVBox ? first() : firstMeasure();
     ctx.mutState().setStartTick(m->tick());
 
-    PassResetLayoutData resetPass;
-    resetPass.run(score, ctx);
+    {
+        LayoutPassTimings::Scope passTimings(LayoutPassTimings::Pass::ResetLayoutData);
+        PassResetLayoutData resetPass;
+        resetPass.run(score, ctx);
+    }
 
     layoutLinear(ctx, ctx.state().isLayoutAll());
 }
@@ -25,6 +25,7 @@
 #include "dom/masterscore.h"
 #include "dom/system.h"
 #include "dom/page.h"
+#include "dom/measure.h"
 
 #include "layoutcontext.h"
 
@@ -34,6 +35,7 @@
 #include "scoreverticalviewlayout.h"
 
 #include "dumplayoutdata.h"
+#include "layoutpasstimings.h"
 
 using namespace mu::engraving;
 using namespace mu::engraving::rendering::dev;
@@ -50,6 +52,7 @@ public:
 void ScoreLayout::layoutRange(Score* score, const Fraction& st, const Fraction& et)
 {
     TRACEFUNC;
+    LayoutPassTimings::Scope passTimings(LayoutPassTimings::Pass::Other);
 
     CmdStateLocker cmdStateLocker(score);
     LayoutContext ctx(score);
@@ -80,6 +83,17 @@ void ScoreLayout::layoutRange(Score* score, const Fraction& st, const Fraction&
 
     ctx.mutState().setIsLayoutAll(isLayoutAll);
 
+    // The spacing of the changed measures must be recomputed,
+    // the other measures reuse the cached spacing while their content is the same
+    score->spacingCacheStats() = Score::SpacingCacheStats();
+    if (isLayoutAll) {
+        score->invalidateSpacingCache();
+    } else {
+        for (Measure* m = score->tick2measure(stick); m && m->tick() <= etick; m = m->nextMeasure()) {
+            m->invalidateSpacingCache();
+        }
+    }
+
     // Init context and layout
     switch (ctx.conf().viewMode()) {
     case LayoutMode::PAGE:
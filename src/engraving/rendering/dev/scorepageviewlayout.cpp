@@ -31,6 +31,7 @@
 
 #include "passresetlayoutdata.h"
 #include "passlayoutindependentitems.h"
+#include "layoutpasstimings.h"
 
 #include "measurelayout.h"
 #include "systemlayout.h"
@@ -176,12 +177,16 @@ void ScorePageViewLayout::layoutPageView(Score* score, LayoutContext& ctx, const
 
     //! NOTE Reset pass need anyway
 //#ifdef MUE_ENABLE_ENGRAVING_LD_PASSES
-    PassResetLayoutData resetPass;
-    resetPass.run(score, ctx);
+    {
+        LayoutPassTimings::Scope passTimings(LayoutPassTimings::Pass::ResetLayoutData);
+        PassResetLayoutData resetPass;
+        resetPass.run(score, ctx);
+    }
 //#endif
 
 #ifdef MUE_ENABLE_ENGRAVING_LD_PASSES
     if (ctx.state().isLayoutAll()) {
+        LayoutPassTimings::Scope passTimings(LayoutPassTimings::Pass::LayoutIndependentItems);
         PassLayoutIndependentItems independentPass;
         independentPass.run(score, ctx);
     }
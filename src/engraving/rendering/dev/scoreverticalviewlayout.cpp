@@ -31,6 +31,7 @@
 
 #include "passresetlayoutdata.h"
 #include "passlayoutindependentitems.h"
+#include "layoutpasstimings.h"
 
 #include "measurelayout.h"
 #include "systemlayout.h"
@@ -141,13 +142,17 @@ void ScoreVerticalViewLayout::layoutVerticalView(Score* score, LayoutContext& ct
 
     ctx.mutState().setPrevMeasure(nullptr);
 
-    PassResetLayoutData resetPass;
-    resetPass.run(score, ctx);
+    {
+        LayoutPassTimings::Scope passTimings(LayoutPassTimings::Pass::ResetLayoutData);
+        PassResetLayoutData resetPass;
+        resetPass.run(score, ctx);
+    }
 
     MeasureLayout::getNextMeasure(ctx);
     ctx.mutState().setCurSystem(SystemLayout::collectSystem(ctx));
 
     if (ctx.state().isLayoutAll()) {
+        LayoutPassTimings::Scope passTimings(LayoutPassTimings::Pass::LayoutIndependentItems);
         PassLayoutIndependentItems independedPass;
         independedPass.run(score, ctx);
     }
@@ -45,6 +45,7 @@
 #include "tlayout.h"
 #include "chordlayout.h"
 #include "tremololayout.h"
+#include "layoutpasstimings.h"
 #include "../engraving/types/symnames.h"
 
 #include "draw/types/transform.h"
@@ -55,6 +56,8 @@ using namespace mu::engraving::rendering::dev;
 
 void SlurTieLayout::layout(Slur* item, LayoutContext& ctx)
 {
+    LayoutPassTimings::Scope passTimings(LayoutPassTimings::Pass::SlurTieLayout);
+
     if (item->track2() == muse::nidx) {
         item->setTrack2(item->track());
     }
@@ -211,6 +214,8 @@ void SlurTieLayout::layout(Slur* item, LayoutContext& ctx)
 
 SpannerSegment* SlurTieLayout::layoutSystem(Slur* item, System* system, LayoutContext& ctx)
 {
+    LayoutPassTimings::Scope passTimings(LayoutPassTimings::Pass::SlurTieLayout);
+
     const double horizontalTieClearance = 0.35 * item->spatium();
     const double tieClearance = 0.65 * item->spatium();
     const double continuedSlurOffsetY = item->spatium() * .4;
@@ -1458,6 +1463,8 @@ static bool tieSegmentShouldBeSkipped(Tie* item)
 
 TieSegment* SlurTieLayout::tieLayoutFor(Tie* item, System* system)
 {
+    LayoutPassTimings::Scope passTimings(LayoutPassTimings::Pass::SlurTieLayout);
+
     item->setPos(0, 0);
 
     if (!item->startNote()) {
@@ -1530,6 +1537,8 @@ TieSegment* SlurTieLayout::tieLayoutFor(Tie* item, System* system)
 
 TieSegment* SlurTieLayout::tieLayoutBack(Tie* item, System* system, LayoutContext& ctx)
 {
+    LayoutPassTimings::Scope passTimings(LayoutPassTimings::Pass::SlurTieLayout);
+
     Chord* chord = item->endNote() ? item->endNote()->chord() : nullptr;
 
     if (item->staffType() && item->staffType()->isTabStaff()) {
@@ -2004,6 +2013,8 @@ bool SlurTieLayout::hasEndPointAboveNote(TieSegment* tieSegment)
 
 void SlurTieLayout::resolveVerticalTieCollisions(const std::vector<TieSegment*>& stackedTies)
 {
+    LayoutPassTimings::Scope passTimings(LayoutPassTimings::Pass::SlurTieLayout);
+
     if (stackedTies.size() < 2) {
         return;
     }
@@ -70,6 +70,7 @@
 #include "tupletlayout.h"
 #include "slurtielayout.h"
 #include "horizontalspacing.h"
+#include "layoutpasstimings.h"
 
 #include "log.h"
 
@@ -83,6 +84,7 @@ using namespace mu::engraving::rendering::dev;
 System* SystemLayout::collectSystem(LayoutContext& ctx)
 {
     TRACEFUNC;
+    LayoutPassTimings::Scope passTimings(LayoutPassTimings::Pass::SystemLayout);
 
     if (!ctx.state().curMeasure()) {
         return nullptr;
@@ -738,6 +740,8 @@ void SystemLayout::hideEmptyStaves(System* system, LayoutContext& ctx, bool isFi
 
 void SystemLayout::layoutSystemElements(System* system, LayoutContext& ctx)
 {
+    LayoutPassTimings::Scope passTimings(LayoutPassTimings::Pass::SystemLayout);
+
     if (ctx.dom().nstaves() == 0) {
         return;
     }
@@ -2212,6 +2216,7 @@ void SystemLayout::layout2(System* system, LayoutContext& ctx)
 {
     TRACEFUNC;
     LAYOUT_CALL() << LAYOUT_ITEM_INFO(system);
+    LayoutPassTimings::Scope passTimings(LayoutPassTimings::Pass::SystemLayout);
 
     Box* vb = system->vbox();
     if (vb) {
@@ -81,7 +81,9 @@ ConnectorInfoReader::ConnectorInfoReader(XmlReader& e, ReadContext* ctx, Score*
 bool ConnectorInfoReader::read()
 {
     XmlReader& e = *m_reader;
-    const AsciiStringView name(e.asciiAttribute("type"));
+    //! NOTE: Owned, the type is compared after the children are read
+    const std::string type(e.asciiAttribute("type"));
+    const AsciiStringView name(type);
     m_type = TConv::fromXml(name, ElementType::INVALID);
 
     m_ctx->fillLocation(m_currentLoc);
@@ -22,6 +22,8 @@
 
 #include "xmlreader.h"
 
+#include <charconv>
+
 #include "log.h"
 
 using namespace mu;
@@ -125,9 +127,12 @@ Fraction XmlReader::readFraction()
         if (i == muse::nidx) {
             return Fraction::fromTicks(s.toInt());
         } else {
-            String str = String::fromAscii(s.ascii());
-            z = str.left(i).toInt();
-            n = str.mid(i + 1).toInt();
+            //! NOTE: Called for every duration in a score, so parse the view without creating a String
+            const char* str = s.ascii();
+            z = 0;
+            n = 0;
+            std::from_chars(str, str + i, z);
+            std::from_chars(str + i + 1, str + s.size(), n);
         }
     }
     return Fraction(z, n);
@@ -0,0 +1,518 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <map>
+
+#include "global/io/dir.h"
+#include "global/io/file.h"
+#include "global/io/fileinfo.h"
+#include "global/serialization/json.h"
+
+#include "draw/painter.h"
+#include "draw/types/drawdata.h"
+
+#include "engraving/compat/scoreaccess.h"
+#include "engraving/infrastructure/localfileinfoprovider.h"
+#include "engraving/infrastructure/mscio.h"
+#include "engraving/rw/mscloader.h"
+#include "engraving/rendering/dev/layoutpasstimings.h"
+
+#include "dom/chord.h"
+#include "dom/masterscore.h"
+#include "dom/note.h"
+#include "dom/segment.h"
+
+#include "testing/allocationcounter.h"
+
+#include "nullpaintprovider.h"
+
+#include "log.h"
+
+using namespace muse;
+using namespace mu::engraving;
+using namespace mu::engraving::rendering::dev;
+
+//! NOTE The benchmark is disabled by default, run it with:
+//! engraving_layout_bench --gtest_also_run_disabled_tests
+//!
+//! Each score is read, laid out, relaid out after a single note edit and painted to a null device,
+//! the phases and the layout passes are timed separately and their p50/p95 are written as JSON,
+//! together with the number of heap allocations of the read, layout and relayout phases
+//! and the hit rate of the measure spacing cache in the layout and relayout phases.
+//! Options (environment variables):
+//!     MUE_LAYOUT_BENCH_SCORES_DIR - an additional directory of scores, measured after vtest/scores
+//!     MUE_LAYOUT_BENCH_SKIP_VTEST - if set, the scores of vtest/scores are not measured
+//!     MUE_LAYOUT_BENCH_ITERATIONS - the number of runs of each score, 5 by default
+//!     MUE_LAYOUT_BENCH_OUTPUT     - the path of the JSON report, layout_bench.json by default
+//!
+//! DISABLED_ReadScores only reads the same scores and prints the read time and the peak RSS of each read.
+
+static const std::vector<std::string> SCORE_FILTERS = { "*.mscz", "*.mscx" };
+
+static const int DEFAULT_ITERATIONS = 5;
+
+class Engraving_LayoutBenchmark : public ::testing::Test
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using Samples = std::vector<double>;
+    using PassSamples = std::map<LayoutPassTimings::Pass, Samples>;
+
+    enum class Phase {
+        Read,
+        Layout,
+        Relayout,
+        Paint
+    };
+
+    struct ScoreSamples {
+        std::map<Phase, Samples> phases;
+        std::map<Phase, Samples> allocations;
+        std::map<Phase, Score::SpacingCacheStats> spacingCache; // summed over the runs
+        PassSamples layoutPasses;
+        PassSamples relayoutPasses;
+    };
+
+    static std::string envValue(const char* name, const std::string& def = std::string())
+    {
+        const char* value = std::getenv(name);
+        return value ? std::string(value) : def;
+    }
+
+    static double elapsedMs(const Clock::time_point& start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    static const char* phaseName(Phase phase)
+    {
+        switch (phase) {
+        case Phase::Read: return "read";
+        case Phase::Layout: return "layout";
+        case Phase::Relayout: return "relayout";
+        case Phase::Paint: return "paint";
+        }
+
+        return "";
+    }
+
+    //! NOTE Nearest-rank percentile
+    static double percentile(Samples samples, double p)
+    {
+        if (samples.empty()) {
+            return 0.0;
+        }
+
+        std::sort(samples.begin(), samples.end());
+
+        size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * samples.size()));
+        rank = std::clamp(rank, size_t(1), samples.size());
+
+        return samples.at(rank - 1);
+    }
+
+    //! NOTE The peak RSS (VmHWM) is reset before each read, so it is the peak of that read only,
+    //! not of the whole process (which getrusage reports). Only supported on Linux, 0 otherwise
+    static void resetPeakRss()
+    {
+#ifdef __linux__
+        std::ofstream clearRefs("/proc/self/clear_refs");
+        clearRefs << "5";
+#endif
+    }
+
+    static size_t statusValueKb(const std::string& key)
+    {
+#ifdef __linux__
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.compare(0, key.size(), key) == 0) {
+                return static_cast<size_t>(std::strtoull(line.c_str() + key.size(), nullptr, 10));
+            }
+        }
+#else
+        UNUSED(key);
+#endif
+        return 0;
+    }
+
+    static JsonObject stats(const Samples& samples)
+    {
+        JsonObject obj;
+        obj.set("p50", percentile(samples, 50.0));
+        obj.set("p95", percentile(samples, 95.0));
+        return obj;
+    }
+
+    static JsonObject passesStats(const PassSamples& samples)
+    {
+        JsonObject obj;
+        for (const auto& pair : samples) {
+            obj.set(LayoutPassTimings::passName(pair.first), stats(pair.second));
+        }
+
+        return obj;
+    }
+
+    static void addSpacingCacheStats(Score::SpacingCacheStats& total, const Score::SpacingCacheStats& stats)
+    {
+        total.hits += stats.hits;
+        total.misses += stats.misses;
+    }
+
+    static JsonObject spacingCacheStats(const Score::SpacingCacheStats& stats)
+    {
+        JsonObject obj;
+        obj.set("hits", static_cast<int>(stats.hits));
+        obj.set("misses", static_cast<int>(stats.misses));
+        obj.set("hitRate", stats.hitRate());
+        return obj;
+    }
+
+    //! NOTE Adds the samples of each run to the sums of the runs of the same index
+    static void addToTotal(Samples& total, const Samples& samples)
+    {
+        if (total.size() < samples.size()) {
+            total.resize(samples.size(), 0.0);
+        }
+
+        for (size_t i = 0; i < samples.size(); ++i) {
+            total[i] += samples[i];
+        }
+    }
+
+    static io::paths_t scoreFiles()
+    {
+        std::vector<io::path_t> dirs;
+        if (envValue("MUE_LAYOUT_BENCH_SKIP_VTEST").empty()) {
+            dirs.push_back(LAYOUT_BENCH_VTEST_SCORES_DIR);
+        }
+
+        std::string userDir = envValue("MUE_LAYOUT_BENCH_SCORES_DIR");
+        if (!userDir.empty()) {
+            dirs.push_back(userDir);
+        }
+
+        io::paths_t result;
+        for (const io::path_t& dir : dirs) {
+            RetVal<io::paths_t> files = io::Dir::scanFiles(dir, SCORE_FILTERS);
+            if (!files.ret) {
+                LOGE() << "failed to scan: " << dir << ", err: " << files.ret.toString();
+                continue;
+            }
+
+            std::sort(files.val.begin(), files.val.end());
+
+            for (const io::path_t& file : files.val) {
+                std::string path = file.toStdString();
+                if (path.find("disabled") != std::string::npos || path.find("DISABLED") != std::string::npos) {
+                    continue;
+                }
+
+                result.push_back(file);
+            }
+        }
+
+        return result;
+    }
+
+    static bool loadScore(MasterScore* score, const io::path_t& path)
+    {
+        score->setFileInfoProvider(std::make_shared<LocalFileInfoProvider>(path));
+
+        MscReader::Params params;
+        params.filePath = path;
+        params.mode = mscIoModeBySuffix(io::suffix(path));
+
+        MscReader reader(params);
+        if (!reader.open()) {
+            return false;
+        }
+
+        MscLoader loader;
+        SettingsCompat settingsCompat;
+        Ret ret = loader.loadMscz(score, reader, settingsCompat, true);
+        return ret;
+    }
+
+    //! NOTE The note to edit is taken from the middle of the score,
+    //! so that the relayout has systems before and after the changed measure
+    static Note* noteToEdit(const MasterScore* score)
+    {
+        const Fraction middleTick = score->endTick() / 2;
+
+        Note* firstNote = nullptr;
+        for (Segment* s = score->firstSegment(SegmentType::ChordRest); s; s = s->next1(SegmentType::ChordRest)) {
+            for (EngravingItem* item : s->elist()) {
+                if (!item || !item->isChord()) {
+                    continue;
+                }
+
+                Note* note = toChord(item)->upNote();
+                if (s->tick() >= middleTick) {
+                    return note;
+                }
+
+                if (!firstNote) {
+                    firstNote = note;
+                }
+            }
+        }
+
+        return firstNote;
+    }
+
+    static void addPassSamples(PassSamples& samples)
+    {
+        const LayoutPassTimings::Durations durations = LayoutPassTimings::durations();
+        for (size_t i = 0; i < LayoutPassTimings::PASS_COUNT; ++i) {
+            double ms = std::chrono::duration<double, std::milli>(durations[i]).count();
+            samples[static_cast<LayoutPassTimings::Pass>(i)].push_back(ms);
+        }
+    }
+
+    static bool measureScore(const io::path_t& path, ScoreSamples& samples)
+    {
+        MasterScore* score = compat::ScoreAccess::createMasterScoreWithBaseStyle();
+
+        muse::testing::startCountingAllocations();
+        Clock::time_point start = Clock::now();
+        if (!loadScore(score, path)) {
+            muse::testing::stopCountingAllocations();
+            delete score;
+            return false;
+        }
+        samples.phases[Phase::Read].push_back(elapsedMs(start));
+        samples.allocations[Phase::Read].push_back(static_cast<double>(muse::testing::stopCountingAllocations()));
+
+        LayoutPassTimings::clear();
+        LayoutPassTimings::setEnabled(true);
+
+        muse::testing::startCountingAllocations();
+        start = Clock::now();
+        for (Score* s : score->scoreList()) {
+            s->doLayoutRange(Fraction(0, 1), Fraction(-1, 1));
+        }
+        samples.phases[Phase::Layout].push_back(elapsedMs(start));
+        samples.allocations[Phase::Layout].push_back(static_cast<double>(muse::testing::stopCountingAllocations()));
+        addPassSamples(samples.layoutPasses);
+
+        for (const Score* s : score->scoreList()) {
+            addSpacingCacheStats(samples.spacingCache[Phase::Layout], s->spacingCacheStats());
+        }
+
+        if (Note* note = noteToEdit(score)) {
+            score->select(note);
+            score->startCmd();
+            score->upDown(true, UpDownMode::CHROMATIC);
+
+            LayoutPassTimings::clear();
+
+            muse::testing::startCountingAllocations();
+            start = Clock::now();
+            score->endCmd();
+            samples.phases[Phase::Relayout].push_back(elapsedMs(start));
+            samples.allocations[Phase::Relayout].push_back(static_cast<double>(muse::testing::stopCountingAllocations()));
+            addPassSamples(samples.relayoutPasses);
+
+            //! NOTE The parts aren't open, only the master score is laid out again
+            addSpacingCacheStats(samples.spacingCache[Phase::Relayout], score->spacingCacheStats());
+
+            score->deselectAll();
+        }
+
+        LayoutPassTimings::setEnabled(false);
+
+        std::shared_ptr<NullPaintProvider> provider = std::make_shared<NullPaintProvider>();
+
+        start = Clock::now();
+        {
+            muse::draw::Painter painter(provider, "LayoutBenchmark");
+
+            rendering::IScoreRenderer::PaintOptions opt;
+            opt.isMultiPage = true;
+            opt.isPrinting = true;
+            opt.deviceDpi = muse::draw::DrawData::CANVAS_DPI;
+
+            EngravingItem::renderer()->paintScore(&painter, score, opt);
+        }
+        samples.phases[Phase::Paint].push_back(elapsedMs(start));
+
+        delete score;
+
+        return true;
+    }
+};
+
+TEST_F(Engraving_LayoutBenchmark, DISABLED_LayoutScores)
+{
+    //! [GIVEN] The scores and the number of runs of each one
+    const io::paths_t files = scoreFiles();
+    ASSERT_FALSE(files.empty());
+
+    const int iterations = std::max(1, std::atoi(envValue("MUE_LAYOUT_BENCH_ITERATIONS",
+                                                          std::to_string(DEFAULT_ITERATIONS)).c_str()));
+
+    //! [WHEN] Each score is read, laid out, edited and painted
+    JsonArray scoresJson;
+    std::map<Phase, Samples> totals;
+    std::map<Phase, Samples> allocationTotals;
+    std::map<Phase, Score::SpacingCacheStats> spacingCacheTotals;
+    PassSamples layoutPassTotals;
+
+    for (size_t i = 0; i < files.size(); ++i) {
+        const io::path_t& file = files.at(i);
+        LOGI() << "measure: " << (i + 1) << "/" << files.size() << " " << file;
+
+        JsonObject scoreJson;
+        scoreJson.set("name", io::FileInfo(file).fileName());
+        scoreJson.set("path", file.toStdString());
+
+        ScoreSamples samples;
+        bool ok = true;
+        for (int it = 0; it < iterations && ok; ++it) {
+            ok = measureScore(file, samples);
+        }
+
+        if (!ok) {
+            LOGE() << "failed to load: " << file;
+            scoreJson.set("error", "failed to load");
+            scoresJson.append(scoreJson);
+            continue;
+        }
+
+        for (const auto& pair : samples.phases) {
+            scoreJson.set(phaseName(pair.first), stats(pair.second));
+            addToTotal(totals[pair.first], pair.second);
+        }
+
+        JsonObject allocationsJson;
+        for (const auto& pair : samples.allocations) {
+            allocationsJson.set(phaseName(pair.first), stats(pair.second));
+            addToTotal(allocationTotals[pair.first], pair.second);
+        }
+        scoreJson.set("allocations", allocationsJson);
+
+        JsonObject spacingCacheJson;
+        for (const auto& pair : samples.spacingCache) {
+            spacingCacheJson.set(phaseName(pair.first), spacingCacheStats(pair.second));
+            addSpacingCacheStats(spacingCacheTotals[pair.first], pair.second);
+        }
+        scoreJson.set("spacingCache", spacingCacheJson);
+
+        for (const auto& pair : samples.layoutPasses) {
+            addToTotal(layoutPassTotals[pair.first], pair.second);
+        }
+
+        scoreJson.set("layoutPasses", passesStats(samples.layoutPasses));
+        scoreJson.set("relayoutPasses", passesStats(samples.relayoutPasses));
+
+        scoresJson.append(scoreJson);
+    }
+
+    //! [THEN] The report is written, the totals are the sums over the scores of each run
+    JsonObject totalJson;
+    for (const auto& pair : totals) {
+        totalJson.set(phaseName(pair.first), stats(pair.second));
+    }
+    totalJson.set("layoutPasses", passesStats(layoutPassTotals));
+
+    JsonObject allocationTotalJson;
+    for (const auto& pair : allocationTotals) {
+        allocationTotalJson.set(phaseName(pair.first), stats(pair.second));
+    }
+    totalJson.set("allocations", allocationTotalJson);
+
+    JsonObject spacingCacheTotalJson;
+    for (const auto& pair : spacingCacheTotals) {
+        spacingCacheTotalJson.set(phaseName(pair.first), spacingCacheStats(pair.second));
+    }
+    totalJson.set("spacingCache", spacingCacheTotalJson);
+
+    JsonObject root;
+    root.set("unit", "ms");
+    root.set("iterations", iterations);
+    root.set("total", totalJson);
+    root.set("scores", scoresJson);
+
+    const io::path_t outPath = envValue("MUE_LAYOUT_BENCH_OUTPUT", "layout_bench.json");
+    Ret ret = io::File::writeFile(outPath, JsonDocument(root).toJson());
+    EXPECT_TRUE(ret);
+
+    std::cout << "layout benchmark: " << files.size() << " scores, " << iterations << " runs each, report: "
+              << outPath.toStdString() << std::endl;
+}
+
+TEST_F(Engraving_LayoutBenchmark, DISABLED_ReadScores)
+{
+    //! [GIVEN] The scores
+    const io::paths_t files = scoreFiles();
+    ASSERT_FALSE(files.empty());
+
+    //! [WHEN] Each score is read, with the peak RSS reset before the read
+    double totalMs = 0.0;
+    size_t maxPeakRssKb = 0;
+    size_t failed = 0;
+
+    for (const io::path_t& file : files) {
+        MasterScore* score = compat::ScoreAccess::createMasterScoreWithBaseStyle();
+
+        const size_t rssBeforeKb = statusValueKb("VmRSS:");
+        resetPeakRss();
+
+        Clock::time_point start = Clock::now();
+        const bool ok = loadScore(score, file);
+        const double ms = elapsedMs(start);
+
+        const size_t peakRssKb = statusValueKb("VmHWM:");
+        delete score;
+
+        if (!ok) {
+            LOGE() << "failed to load: " << file;
+            ++failed;
+            continue;
+        }
+
+        totalMs += ms;
+        maxPeakRssKb = std::max(maxPeakRssKb, peakRssKb);
+
+        std::cout << io::FileInfo(file).fileName().toStdString() << ": read " << ms << " ms, peak RSS "
+                  << peakRssKb / 1024 << " MB (+" << (peakRssKb > rssBeforeKb ? peakRssKb - rssBeforeKb : 0) / 1024
+                  << " MB over the RSS before the read)" << std::endl;
+    }
+
+    //! [THEN] All scores are read
+    EXPECT_EQ(failed, size_t(0));
+
+    std::cout << "read benchmark: " << files.size() << " scores, total " << totalMs << " ms, max peak RSS "
+              << maxPeakRssKb / 1024 << " MB" << std::endl;
+}
@@ -0,0 +1,113 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MU_ENGRAVING_NULLPAINTPROVIDER_H
+#define MU_ENGRAVING_NULLPAINTPROVIDER_H
+
+#include <vector>
+
+#include "draw/ipaintprovider.h"
+
+namespace mu::engraving {
+//! NOTE Paints nothing, only keeps the painter state,
+//! so that painting a score measures the traversal of the items and not a paint device
+class NullPaintProvider : public muse::draw::IPaintProvider
+{
+public:
+    NullPaintProvider() = default;
+
+    bool isActive() const override { return m_isActive; }
+    void beginTarget(const std::string&) override { m_isActive = true; }
+    void beforeEndTargetHook(muse::draw::Painter*) override {}
+    bool endTarget(bool) override
+    {
+        m_isActive = false;
+        return true;
+    }
+
+    void beginObject(const std::string&) override {}
+    void endObject() override {}
+
+    void setAntialiasing(bool) override {}
+    void setCompositionMode(muse::draw::CompositionMode) override {}
+    void setWindow(const muse::RectF&) override {}
+    void setViewport(const muse::RectF&) override {}
+
+    void setFont(const muse::draw::Font& font) override { m_state.font = font; }
+    const muse::draw::Font& font() const override { return m_state.font; }
+
+    void setPen(const muse::draw::Pen& pen) override { m_state.pen = pen; }
+    void setNoPen() override { m_state.pen.setStyle(muse::draw::PenStyle::NoPen); }
+    const muse::draw::Pen& pen() const override { return m_state.pen; }
+
+    void setBrush(const muse::draw::Brush& brush) override { m_state.brush = brush; }
+    const muse::draw::Brush& brush() const override { return m_state.brush; }
+
+    void save() override { m_savedStates.push_back(m_state); }
+    void restore() override
+    {
+        if (!m_savedStates.empty()) {
+            m_state = m_savedStates.back();
+            m_savedStates.pop_back();
+        }
+    }
+
+    void setTransform(const muse::draw::Transform& transform) override { m_state.transform = transform; }
+    const muse::draw::Transform& transform() const override { return m_state.transform; }
+
+    void drawPath(const muse::draw::PainterPath&) override {}
+    void drawPolygon(const muse::PointF*, size_t, muse::draw::PolygonMode) override {}
+
+    void drawText(const muse::PointF&, const muse::String&) override {}
+    void drawText(const muse::RectF&, int, const muse::String&) override {}
+    void drawTextWorkaround(const muse::draw::Font&, const muse::PointF&, const muse::String&) override {}
+
+    void drawSymbol(const muse::PointF&, char32_t) override {}
+
+    void drawPixmap(const muse::PointF&, const muse::draw::Pixmap&) override {}
+    void drawTiledPixmap(const muse::RectF&, const muse::draw::Pixmap&, const muse::PointF&) override {}
+
+#ifndef NO_QT_SUPPORT
+    void drawPixmap(const muse::PointF&, const QPixmap&) override {}
+    void drawTiledPixmap(const muse::RectF&, const QPixmap&, const muse::PointF&) override {}
+#endif
+
+    bool hasClipping() const override { return m_state.hasClipping; }
+
+    void setClipRect(const muse::RectF&) override { m_state.hasClipping = true; }
+    void setClipping(bool enable) override { m_state.hasClipping = enable; }
+
+private:
+    struct State {
+        muse::draw::Font font;
+        muse::draw::Pen pen;
+        muse::draw::Brush brush;
+        muse::draw::Transform transform;
+        bool hasClipping = false;
+    };
+
+    bool m_isActive = false;
+    State m_state;
+    std::vector<State> m_savedStates;
+};
+}
+
+#endif // MU_ENGRAVING_NULLPAINTPROVIDER_H
@@ -0,0 +1,315 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <random>
+
+#include "dom/bsp.h"
+#include "dom/masterscore.h"
+#include "dom/page.h"
+
+#include "utils/scorerw.h"
+
+using namespace mu;
+using namespace mu::engraving;
+
+static const String ALL_ELEMENTS_DATA_DIR(u"all_elements_data/");
+
+namespace {
+//! NOTE: The previous implementation of BspTree (list leaves, items inserted one by one),
+//! kept here as the reference for the equivalence test and the benchmark
+class RefBspTree
+{
+public:
+    void initialize(const RectF& rect, int n)
+    {
+        m_depth = n > 0 ? std::max(int(std::ceil(std::log(double(n)) / std::log(2.0))), 5) : 0;
+        m_leafCnt = 0;
+        m_nodes.resize((1 << (m_depth + 1)) - 1);
+        m_leaves.assign(size_t(1) << m_depth, std::list<EngravingItem*>());
+        initialize(rect, m_depth, 0);
+    }
+
+    void insert(EngravingItem* item)
+    {
+        climbTree(item->pageBoundingRect(), [item](std::list<EngravingItem*>& leaf) { leaf.push_front(item); });
+    }
+
+    std::vector<EngravingItem*> items(const RectF& rect)
+    {
+        std::list<EngravingItem*> found;
+        climbTree(rect, [&found](std::list<EngravingItem*>& leaf) { visit(leaf, found); });
+        std::vector<EngravingItem*> result;
+        for (EngravingItem* e : found) {
+            e->itemDiscovered = false;
+            if (e->pageBoundingRect().intersects(rect)) {
+                result.push_back(e);
+            }
+        }
+        return result;
+    }
+
+    std::vector<EngravingItem*> items(const PointF& pos)
+    {
+        std::list<EngravingItem*> found;
+        climbTree(RectF(pos, pos), [&found](std::list<EngravingItem*>& leaf) { visit(leaf, found); }, true);
+        std::vector<EngravingItem*> result;
+        for (EngravingItem* e : found) {
+            e->itemDiscovered = false;
+            if (e->contains(pos)) {
+                result.push_back(e);
+            }
+        }
+        return result;
+    }
+
+private:
+    using Node = BspTree::Node;
+
+    static void visit(std::list<EngravingItem*>& leaf, std::list<EngravingItem*>& found)
+    {
+        for (EngravingItem* item : leaf) {
+            if (!item->itemDiscovered) {
+                item->itemDiscovered = true;
+                found.push_front(item);
+            }
+        }
+    }
+
+    void initialize(const RectF& rec, int dep, int index)
+    {
+        Node* node = &m_nodes[index];
+        if (index == 0) {
+            node->type = Node::Type::HORIZONTAL;
+            node->offset = rec.center().x();
+        }
+
+        if (dep) {
+            Node::Type type;
+            RectF rect1, rect2;
+            double offset1, offset2;
+
+            if (node->type == Node::Type::HORIZONTAL) {
+                type = Node::Type::VERTICAL;
+                rect1.setRect(rec.left(), rec.top(), rec.width(), rec.height() * .5);
+                rect2.setRect(rect1.left(), rect1.bottom(), rect1.width(), rec.height() - rect1.height());
+                offset1 = rect1.center().x();
+                offset2 = rect2.center().x();
+            } else {
+                type = Node::Type::HORIZONTAL;
+                rect1.setRect(rec.left(), rec.top(), rec.width() * .5, rec.height());
+                rect2.setRect(rect1.right(), rect1.top(), rec.width() - rect1.width(), rect1.height());
+                offset1 = rect1.center().y();
+                offset2 = rect2.center().y();
+            }
+
+            int childIndex = index * 2 + 1;
+            m_nodes[childIndex].offset = offset1;
+            m_nodes[childIndex].type = type;
+            m_nodes[childIndex + 1].offset = offset2;
+            m_nodes[childIndex + 1].type = type;
+
+            initialize(rect1, dep - 1, childIndex);
+            initialize(rect2, dep - 1, childIndex + 1);
+        } else {
+            node->type = Node::Type::LEAF;
+            node->leafIndex = m_leafCnt++;
+        }
+    }
+
+    template<typename Func>
+    void climbTree(const RectF& rec, const Func& func, bool point = false, int index = 0)
+    {
+        if (m_nodes.empty()) {
+            return;
+        }
+
+        const Node* node = &m_nodes[index];
+        int childIndex = index * 2 + 1;
+
+        switch (node->type) {
+        case Node::Type::LEAF:
+            func(m_leaves[node->leafIndex]);
+            break;
+        case Node::Type::VERTICAL:
+            if (rec.left() < node->offset) {
+                climbTree(rec, func, point, childIndex);
+                if (!point && rec.right() >= node->offset) {
+                    climbTree(rec, func, point, childIndex + 1);
+                }
+            } else {
+                climbTree(rec, func, point, childIndex + 1);
+            }
+            break;
+        case Node::Type::HORIZONTAL:
+            if (rec.top() < node->offset) {
+                climbTree(rec, func, point, childIndex);
+                if (!point && rec.bottom() >= node->offset) {
+                    climbTree(rec, func, point, childIndex + 1);
+                }
+            } else {
+                climbTree(rec, func, point, childIndex + 1);
+            }
+        }
+    }
+
+    int m_depth = 0;
+    int m_leafCnt = 0;
+    std::vector<Node> m_nodes;
+    std::vector<std::list<EngravingItem*> > m_leaves;
+};
+
+std::vector<EngravingItem*> pageElements(Page* page)
+{
+    std::vector<EngravingItem*> elements;
+    page->scanElements(&elements, collectElements, false);
+    return elements;
+}
+}
+
+class Engraving_BspTests : public ::testing::Test
+{
+};
+
+TEST_F(Engraving_BspTests, sameAsInsert)
+{
+    MasterScore* score = ScoreRW::readScore(ALL_ELEMENTS_DATA_DIR + u"moonlight.mscx");
+    ASSERT_TRUE(score);
+
+    std::mt19937 rng(5);
+
+    for (Page* page : score->pages()) {
+        //! [GIVEN] The trees of a page, built at once and with an insert per item
+        const std::vector<EngravingItem*> elements = pageElements(page);
+        const RectF pageRect = page->abbox();
+
+        BspTree tree;
+        tree.rebuild(pageRect, elements);
+
+        RefBspTree ref;
+        ref.initialize(pageRect, static_cast<int>(elements.size()));
+        for (EngravingItem* e : elements) {
+            ref.insert(e);
+        }
+
+        std::uniform_real_distribution<double> x(pageRect.left(), pageRect.right());
+        std::uniform_real_distribution<double> y(pageRect.top(), pageRect.bottom());
+        std::uniform_real_distribution<double> size(0.0, pageRect.width() / 4);
+
+        //! [THEN] The queries give the same items in the same order
+        std::vector<EngravingItem*> buffer;
+        for (int i = 0; i < 200; ++i) {
+            const RectF rect(x(rng), y(rng), size(rng), size(rng));
+            tree.items(rect, buffer);
+            EXPECT_EQ(buffer, ref.items(rect));
+
+            const PointF pos(x(rng), y(rng));
+            tree.items(pos, buffer);
+            EXPECT_EQ(buffer, ref.items(pos));
+        }
+
+        // on the items themselves
+        for (EngravingItem* e : elements) {
+            const RectF rect = e->pageBoundingRect();
+            EXPECT_EQ(tree.items(rect), ref.items(rect));
+            EXPECT_EQ(tree.items(rect.center()), ref.items(rect.center()));
+        }
+
+        EXPECT_EQ(page->items(pageRect), ref.items(pageRect));
+    }
+
+    delete score;
+}
+
+TEST_F(Engraving_BspTests, DISABLED_benchmark)
+{
+    MasterScore* score = ScoreRW::readScore(ALL_ELEMENTS_DATA_DIR + u"moonlight.mscx");
+    ASSERT_TRUE(score);
+
+    Page* page = score->pages().front();
+    const std::vector<EngravingItem*> elements = pageElements(page);
+    const RectF pageRect = page->abbox();
+
+    auto measure = [](const std::function<void()>& func) {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    constexpr int REBUILDS = 100;
+    constexpr int QUERIES = 10000;
+
+    RefBspTree ref;
+    const auto refRebuild = measure([&]() {
+        for (int i = 0; i < REBUILDS; ++i) {
+            ref.initialize(pageRect, static_cast<int>(elements.size()));
+            for (EngravingItem* e : elements) {
+                ref.insert(e);
+            }
+        }
+    });
+
+    BspTree tree;
+    const auto rebuild = measure([&]() {
+        for (int i = 0; i < REBUILDS; ++i) {
+            tree.rebuild(pageRect, elements);
+        }
+    });
+
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<double> x(pageRect.left(), pageRect.right());
+    std::uniform_real_distribution<double> y(pageRect.top(), pageRect.bottom());
+    std::vector<PointF> points;
+    for (int i = 0; i < QUERIES; ++i) {
+        points.emplace_back(x(rng), y(rng));
+    }
+
+    size_t refFound = 0;
+    const auto refQueries = measure([&]() {
+        for (const PointF& p : points) {
+            refFound += ref.items(p).size();
+        }
+    });
+
+    size_t found = 0;
+    std::vector<EngravingItem*> buffer;
+    const auto queries = measure([&]() {
+        for (const PointF& p : points) {
+            tree.items(p, buffer);
+            found += buffer.size();
+        }
+    });
+
+    EXPECT_EQ(found, refFound);
+
+    std::cout << "items: " << elements.size() << std::endl;
+    std::cout << "rebuild x" << REBUILDS << ": " << refRebuild << " us (previous), " << rebuild << " us" << std::endl;
+    std::cout << "point queries x" << QUERIES << ": " << refQueries << " us (previous), " << queries << " us" << std::endl;
+
+    delete score;
+}
@@ -0,0 +1,124 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "engraving/internal/engravingfont.h"
+
+#include "global/io/dir.h"
+
+using namespace mu;
+using namespace mu::engraving;
+using namespace muse;
+
+static const io::path_t METRICS_CACHE_PATH("EngravingFontTests_metrics_cache");
+
+static const std::vector<std::tuple<std::string, std::string, io::path_t> > FONTS = {
+    { "Leland", "Leland", ":/fonts/leland/Leland.otf" },
+    { "Bravura", "Bravura", ":/fonts/bravura/Bravura.otf" },
+    { "Petaluma", "Petaluma", ":/fonts/petaluma/Petaluma.otf" },
+};
+
+class Engraving_EngravingFontTests : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        io::Dir(METRICS_CACHE_PATH).removeRecursively();
+    }
+
+    void TearDown() override
+    {
+        io::Dir(METRICS_CACHE_PATH).removeRecursively();
+    }
+
+    static std::unique_ptr<EngravingFont> loadFont(const std::tuple<std::string, std::string, io::path_t>& font, bool useCache)
+    {
+        auto result = std::make_unique<EngravingFont>(std::get<0>(font), std::get<1>(font), std::get<2>(font));
+        if (useCache) {
+            result->setMetricsCachePath(METRICS_CACHE_PATH);
+        }
+
+        result->ensureLoad();
+        return result;
+    }
+};
+
+TEST_F(Engraving_EngravingFontTests, MetricsCache)
+{
+    for (const auto& font : FONTS) {
+        //! [GIVEN] The font loaded from its metadata
+        std::unique_ptr<EngravingFont> ref = loadFont(font, false);
+
+        //! [WHEN] The font is loaded twice with the cache: the first load writes it, the second one reads it
+        std::unique_ptr<EngravingFont> written = loadFont(font, true);
+        std::unique_ptr<EngravingFont> read = loadFont(font, true);
+
+        //! [THEN] All the symbol metrics, anchors, cutouts and engraving defaults are the same
+        for (EngravingFont* f : { written.get(), read.get() }) {
+            for (size_t i = 0; i <= static_cast<size_t>(SymId::lastSym); ++i) {
+                SymId id = static_cast<SymId>(i);
+
+                ASSERT_EQ(f->isValid(id), ref->isValid(id)) << std::get<0>(font) << ", sym: " << i;
+                ASSERT_EQ(f->symCode(id), ref->symCode(id));
+                ASSERT_EQ(f->bbox(id, 1.0), ref->bbox(id, 1.0));
+                ASSERT_EQ(f->advance(id, 1.0), ref->advance(id, 1.0));
+
+                for (int anchor = 0; anchor <= static_cast<int>(SmuflAnchorId::opticalCenter); ++anchor) {
+                    SmuflAnchorId anchorId = static_cast<SmuflAnchorId>(anchor);
+                    ASSERT_EQ(f->smuflAnchor(id, anchorId, 1.0), ref->smuflAnchor(id, anchorId, 1.0));
+                }
+
+                ASSERT_EQ(f->shapeWithCutouts(id, 1.0).bbox(), ref->shapeWithCutouts(id, 1.0).bbox());
+            }
+
+            EXPECT_EQ(f->engravingDefaults(), ref->engravingDefaults());
+            EXPECT_EQ(f->textEnclosureThickness(), ref->textEnclosureThickness());
+        }
+    }
+}
+
+TEST_F(Engraving_EngravingFontTests, DISABLED_Benchmark_ColdStart)
+{
+    auto measure = [](bool useCache) {
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& font : FONTS) {
+            loadFont(font, useCache);
+        }
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    const auto metadata = measure(false);
+    const auto write = measure(true);
+    const auto cached = measure(true);
+
+    std::cout << "Leland, Bravura, Petaluma:" << std::endl;
+    std::cout << "  from the metadata: " << metadata << " us" << std::endl;
+    std::cout << "  writing the cache: " << write << " us" << std::endl;
+    std::cout << "  from the cache:    " << cached << " us" << std::endl;
+}
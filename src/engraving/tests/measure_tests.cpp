@@ -567,3 +567,40 @@ TEST_F(Engraving_MeasureTests, measureNumbers)
 
     delete score;
 }
+
+TEST_F(Engraving_MeasureTests, spacingCacheReuse)
+{
+    //! [GIVEN] Laid out score
+    MasterScore* score = ScoreRW::readScore(MEASURE_DATA_DIR + u"measure-1.mscx");
+    ASSERT_TRUE(score);
+
+    std::vector<double> widths;
+    for (Measure* m = score->firstMeasure(); m; m = m->nextMeasure()) {
+        widths.push_back(m->width());
+        EXPECT_FALSE(m->spacingCache().entries.empty());
+    }
+
+    //! [WHEN] Layout of the first measure only
+    Measure* first = score->firstMeasure();
+    score->doLayoutRange(first->tick(), first->endTick());
+
+    //! [THEN] The measures keep their widths, the spacing of the not changed measures is taken from the cache
+    size_t idx = 0;
+    for (Measure* m = score->firstMeasure(); m; m = m->nextMeasure()) {
+        ASSERT_LT(idx, widths.size());
+        EXPECT_DOUBLE_EQ(m->width(), widths.at(idx++));
+    }
+
+    //! [THEN] Only the changed measure is respaced, the others of its system hit the cache
+    const Score::SpacingCacheStats& stats = score->spacingCacheStats();
+    EXPECT_GT(stats.hits, 0u);
+    EXPECT_GE(stats.misses, 1u);
+
+    //! [WHEN] Full layout
+    score->doLayout();
+
+    //! [THEN] The cache of all measures is dropped, each measure is respaced at least once
+    EXPECT_GE(score->spacingCacheStats().misses, widths.size());
+
+    delete score;
+}
@@ -21,6 +21,8 @@
  */
 #include <gtest/gtest.h>
 
+#include <thread>
+
 #include <QByteArray>
 
 #include "io/buffer.h"
@@ -35,6 +37,67 @@ using namespace mu::engraving;
 class Engraving_MsczFileTests : public ::testing::Test
 {
 public:
+    static void writeFiles(MscWriter& writer)
+    {
+        ByteArray scoreData;
+        for (int i = 0; i < 1000; ++i) {
+            scoreData.push_back(ByteArray("<Chord><durationType>quarter</durationType><Note><pitch>60</pitch></Note></Chord>\n"));
+        }
+
+        writer.writeStyleFile(ByteArray("style"));
+        writer.writeScoreFile(scoreData);
+        writer.addExcerptFile(u"Part", scoreData);
+        writer.writeAudioSettingsJsonFile(ByteArray("{}"));
+        writer.writeViewSettingsJsonFile(ByteArray("{}"));
+    }
+
+    //! NOTE Writes the files synchronously and from a snapshot on another thread
+    static std::pair<ByteArray, ByteArray> writeSyncAndSnapshot(MscIoMode mode)
+    {
+        //! NOTE The same modification time of the files, otherwise the zip containers can differ
+        const std::time_t fileTime = std::time(nullptr);
+
+        ByteArray syncData;
+        {
+            Buffer buf(&syncData);
+            MscWriter::Params params;
+            params.device = &buf;
+            params.filePath = "simple1.mscz";
+            params.mode = mode;
+            params.fileTime = fileTime;
+
+            MscWriter writer(params);
+            writer.open();
+            writeFiles(writer);
+        }
+
+        ByteArray snapshotData;
+        {
+            Buffer buf(&snapshotData);
+            MscWriter::Params params;
+            params.device = &buf;
+            params.filePath = "simple1.mscz";
+            params.mode = mode;
+            params.fileTime = fileTime;
+            params.snapshot = true;
+
+            MscWriter writer(params);
+            writer.open();
+            writeFiles(writer);
+
+            MscWriter::Snapshot snapshot = writer.takeSnapshot();
+
+            Ret ret;
+            std::thread thread([&snapshot, &ret]() {
+                ret = MscWriter::writeSnapshot(snapshot);
+            });
+            thread.join();
+
+            EXPECT_TRUE(ret);
+        }
+
+        return { syncData, snapshotData };
+    }
 };
 
 TEST_F(Engraving_MsczFileTests, MsczFile_WriteRead)
@@ -88,3 +151,31 @@ TEST_F(Engraving_MsczFileTests, MsczFile_WriteRead)
         EXPECT_EQ(imageData, originImageData);
     }
 }
+
+TEST_F(Engraving_MsczFileTests, MsczFile_SnapshotIsIdenticalToSyncWrite)
+{
+    //! CASE The project is written to a snapshot in memory, then the snapshot is written on another thread (background autosave)
+
+    //! DO Write the same datas synchronously and from a snapshot
+    auto [syncZip, snapshotZip] = writeSyncAndSnapshot(MscIoMode::Zip);
+    auto [syncXml, snapshotXml] = writeSyncAndSnapshot(MscIoMode::XmlFile);
+
+    //! CHECK The files are byte-identical
+    EXPECT_FALSE(syncZip.empty());
+    EXPECT_EQ(snapshotZip, syncZip);
+
+    EXPECT_FALSE(syncXml.empty());
+    EXPECT_EQ(snapshotXml, syncXml);
+
+    //! CHECK The snapshot is readable
+    Buffer buf(&snapshotZip);
+    MscReader::Params params;
+    params.device = &buf;
+    params.filePath = "simple1.mscz";
+    params.mode = MscIoMode::Zip;
+
+    MscReader reader(params);
+    reader.open();
+    EXPECT_EQ(reader.readStyleFile(), ByteArray("style"));
+    EXPECT_EQ(reader.excerptFileNames().size(), 1);
+}
@@ -23,9 +23,12 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include <memory>
+#include <chrono>
+#include <iostream>
 
 #include "async/asyncable.h"
 #include "async/channel.h"
+#include "async/processevents.h"
 #include "mpe/tests/utils/articulationutils.h"
 #include "mpe/tests/mocks/articulationprofilesrepositorymock.h"
 
@@ -814,7 +817,7 @@ TEST_F(Engraving_PlaybackModelTests, Multi_Measure_Repeat)
  *          Additionally, there is a simple repeat from measure 2 up to measure 3. In total, we'll be playing 6 measures overall
  *
  *          When the model will be loaded we'll emulate a change notification on the 2-nd measure, so that there will be updated events
- *          on the main stream channel
+ *          on the main stream channel. Only the range of the changed events is expected to be sent
  */
 TEST_F(Engraving_PlaybackModelTests, SimpleRepeat_Changes_Notification)
 {
@@ -831,9 +834,6 @@ TEST_F(Engraving_PlaybackModelTests, SimpleRepeat_Changes_Notification)
     // [GIVEN] The articulation profiles repository will be returning profiles for StringsArticulation family
     ON_CALL(*m_repositoryMock, defaultProfile(ArticulationFamily::Strings)).WillByDefault(Return(m_defaultProfile));
 
-    // [GIVEN] Expected amount of changed events
-    int expectedChangedEventsCount = 24;
-
     // [GIVEN] The playback model requested to be loaded
     PlaybackModel model;
     model.setprofilesRepository(m_repositoryMock);
@@ -841,10 +841,20 @@ TEST_F(Engraving_PlaybackModelTests, SimpleRepeat_Changes_Notification)
 
     PlaybackData result = model.resolveTrackPlaybackData(part->id(), part->instrumentId());
 
-    // [THEN] Updated events map will match our expectations
-    result.mainStream.onReceive(this, [expectedChangedEventsCount](const PlaybackEventsMap& updatedEvents, const DynamicLevelMap&,
-                                                                   const PlaybackParamMap&) {
-        EXPECT_EQ(updatedEvents.size(), expectedChangedEventsCount);
+    // [GIVEN] The receiver keeps its own copy of the events
+    PlaybackEventsMap receivedEvents = result.originEvents;
+    size_t totalEventsCount = receivedEvents.size();
+    bool notified = false;
+
+    result.mainStream.onReceive(this, [&](const PlaybackEventsChanges& changes, const DynamicLevelMap&, const PlaybackParamMap&) {
+        notified = true;
+
+        // [THEN] Only the changed range has been sent
+        EXPECT_FALSE(changes.isFullReplace());
+        EXPECT_FALSE(changes.events.empty());
+        EXPECT_LT(changes.events.size(), totalEventsCount);
+
+        changes.applyTo(receivedEvents);
     });
 
     // [WHEN] Notation has been changed on the 2-nd measure
@@ -856,6 +866,251 @@ TEST_F(Engraving_PlaybackModelTests, SimpleRepeat_Changes_Notification)
     range.changedTypes = { ElementType::NOTE };
 
     score->changesChannel().send(range);
+
+    // [THEN] The patched copy of the receiver matches the events of the model
+    EXPECT_TRUE(notified);
+    EXPECT_EQ(receivedEvents, model.resolveTrackPlaybackData(part->id(), part->instrumentId()).originEvents);
+}
+
+/**
+ * @brief PlaybackModelTests_DISABLED_Changes_Notification_Benchmark
+ * @details Measures the time between a change of a single measure and the moment the receiver has patched its copy of the events,
+ *          compared to a change of the whole score, which makes the receiver replace all of its events
+ */
+TEST_F(Engraving_PlaybackModelTests, DISABLED_Changes_Notification_Benchmark)
+{
+    Score* score = ScoreRW::readScore(u"midimapping_data/test2.mscx");
+    ASSERT_TRUE(score);
+
+    ON_CALL(*m_repositoryMock, defaultProfile(_)).WillByDefault(Return(m_defaultProfile));
+
+    PlaybackModel model;
+    model.setprofilesRepository(m_repositoryMock);
+    model.load(score);
+
+    const Part* part = score->parts().front();
+    PlaybackData result = model.resolveTrackPlaybackData(part->id(), part->instrumentId());
+
+    PlaybackEventsMap receivedEvents = result.originEvents;
+    size_t sentEventsCount = 0;
+
+    result.mainStream.onReceive(this, [&](const PlaybackEventsChanges& changes, const DynamicLevelMap&, const PlaybackParamMap&) {
+        sentEventsCount += changes.events.size();
+        changes.applyTo(receivedEvents);
+    });
+
+    auto measure = [&](int tickFrom, int tickTo) {
+        ScoreChangesRange range;
+        range.tickFrom = tickFrom;
+        range.tickTo = tickTo;
+        range.staffIdxFrom = 0;
+        range.staffIdxTo = 0;
+        range.changedTypes = { ElementType::NOTE };
+
+        auto start = std::chrono::steady_clock::now();
+        score->changesChannel().send(range);
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    int64_t deltaTime = 0;
+    int changesCount = 0;
+
+    for (const Measure* m = score->firstMeasure(); m; m = m->nextMeasure()) {
+        deltaTime += measure(m->tick().ticks(), m->endTick().ticks());
+        ++changesCount;
+    }
+
+    size_t deltaEventsCount = sentEventsCount;
+    sentEventsCount = 0;
+
+    int64_t fullTime = 0;
+    for (int i = 0; i < changesCount; ++i) {
+        fullTime += measure(0, score->lastMeasure()->endTick().ticks());
+    }
+
+    EXPECT_EQ(receivedEvents, model.resolveTrackPlaybackData(part->id(), part->instrumentId()).originEvents);
+
+    std::cout << "changes: " << changesCount
+              << ", per measure: " << deltaTime / changesCount << " us, " << deltaEventsCount / changesCount << " events sent"
+              << ", whole score: " << fullTime / changesCount << " us, " << sentEventsCount / changesCount << " events sent"
+              << std::endl;
+}
+
+/**
+ * @brief PlaybackModelTests_SimpleRepeat_Incremental_Load
+ * @details The score is the same as in SimpleRepeat: 6 measures of 4/4 at 120 bpm are played, 2 seconds each.
+ *          With the incremental load enabled, only the first 10 seconds are rendered by load(),
+ *          the rest is rendered from the event loop and sent as a change of the track
+ */
+TEST_F(Engraving_PlaybackModelTests, SimpleRepeat_Incremental_Load)
+{
+    // [GIVEN] Simple piece of score (Violin, 4/4, 120 bpm, Treble Cleff)
+    Score* score = ScoreRW::readScore(PLAYBACK_MODEL_TEST_FILES_DIR + "repeat_range/repeat_range.mscx");
+
+    ASSERT_TRUE(score);
+    ASSERT_EQ(score->parts().size(), 1);
+
+    const Part* part = score->parts().at(0);
+    ASSERT_TRUE(part);
+
+    // [GIVEN] The articulation profiles repository will be returning profiles for StringsArticulation family
+    ON_CALL(*m_repositoryMock, defaultProfile(_)).WillByDefault(Return(m_defaultProfile));
+
+    // [GIVEN] The events of the whole score
+    PlaybackModel fullModel;
+    fullModel.setprofilesRepository(m_repositoryMock);
+    fullModel.load(score);
+
+    PlaybackEventsMap expectedEvents = fullModel.resolveTrackPlaybackData(part->id(), part->instrumentId()).originEvents;
+    ASSERT_EQ(expectedEvents.size(), 24);
+
+    // [WHEN] The playback model requested to be loaded incrementally
+    PlaybackModel model;
+    model.setprofilesRepository(m_repositoryMock);
+    model.setIncrementalLoadEnabled(true);
+    model.load(score);
+
+    PlaybackData result = model.resolveTrackPlaybackData(part->id(), part->instrumentId());
+
+    // [THEN] Only the first 5 measures have been rendered
+    EXPECT_EQ(result.originEvents.size(), 20);
+
+    PlaybackEventsMap receivedEvents = result.originEvents;
+    timestamp_t sixthMeasureTimestamp = std::next(expectedEvents.cbegin(), 20)->first;
+    bool notified = false;
+
+    result.mainStream.onReceive(this, [&](const PlaybackEventsChanges& changes, const DynamicLevelMap&, const PlaybackParamMap&) {
+        notified = true;
+
+        // [THEN] Only the rest of the score has been sent
+        EXPECT_FALSE(changes.isFullReplace());
+        EXPECT_EQ(changes.from, sixthMeasureTimestamp);
+        EXPECT_EQ(changes.events.size(), 4);
+
+        changes.applyTo(receivedEvents);
+    });
+
+    // [WHEN] The event loop is running
+    muse::async::processEvents();
+
+    // [THEN] The events match the events of the whole score
+    EXPECT_TRUE(notified);
+    EXPECT_EQ(receivedEvents, expectedEvents);
+    EXPECT_EQ(model.resolveTrackPlaybackData(part->id(), part->instrumentId()).originEvents, expectedEvents);
+}
+
+/**
+ * @brief PlaybackModelTests_SimpleRepeat_Incremental_Load_From_Playback_Position
+ * @details The score is the same as in SimpleRepeat: 6 measures of 4/4 at 120 bpm are played, 2 seconds each.
+ *          The playback position is in the 4th played measure (the second pass of the repeat),
+ *          so the incremental load renders the score from the start of this measure first, and the beginning of the score after
+ */
+TEST_F(Engraving_PlaybackModelTests, SimpleRepeat_Incremental_Load_From_Playback_Position)
+{
+    // [GIVEN] Simple piece of score (Violin, 4/4, 120 bpm, Treble Cleff)
+    Score* score = ScoreRW::readScore(PLAYBACK_MODEL_TEST_FILES_DIR + "repeat_range/repeat_range.mscx");
+
+    ASSERT_TRUE(score);
+    ASSERT_EQ(score->parts().size(), 1);
+
+    const Part* part = score->parts().at(0);
+    ASSERT_TRUE(part);
+
+    // [GIVEN] The articulation profiles repository will be returning profiles for StringsArticulation family
+    ON_CALL(*m_repositoryMock, defaultProfile(_)).WillByDefault(Return(m_defaultProfile));
+
+    // [GIVEN] The events of the whole score
+    PlaybackModel fullModel;
+    fullModel.setprofilesRepository(m_repositoryMock);
+    fullModel.load(score);
+
+    PlaybackEventsMap expectedEvents = fullModel.resolveTrackPlaybackData(part->id(), part->instrumentId()).originEvents;
+    ASSERT_EQ(expectedEvents.size(), 24);
+
+    // [GIVEN] The playback position is on the second beat of the 4th played measure
+    const int measureTicks = 4 * Constants::DIVISION;
+    const int playbackUtick = 3 * measureTicks + Constants::DIVISION;
+
+    // [WHEN] The playback model requested to be loaded incrementally
+    PlaybackModel model;
+    model.setprofilesRepository(m_repositoryMock);
+    model.setIncrementalLoadEnabled(true);
+    model.setPlaybackPosition(playbackUtick);
+    model.load(score);
+
+    PlaybackData result = model.resolveTrackPlaybackData(part->id(), part->instrumentId());
+
+    // [THEN] The last 3 measures have been rendered, from the start of the measure of the playback position
+    PlaybackEventsMap lastMeasuresEvents(std::next(expectedEvents.cbegin(), 12), expectedEvents.cend());
+    EXPECT_EQ(result.originEvents, lastMeasuresEvents);
+
+    PlaybackEventsMap receivedEvents = result.originEvents;
+    bool notified = false;
+
+    result.mainStream.onReceive(this, [&](const PlaybackEventsChanges& changes, const DynamicLevelMap&, const PlaybackParamMap&) {
+        notified = true;
+
+        // [THEN] The beginning of the score has been sent
+        EXPECT_FALSE(changes.isFullReplace());
+        EXPECT_EQ(changes.from, expectedEvents.cbegin()->first);
+        EXPECT_EQ(changes.events.size(), 12);
+
+        changes.applyTo(receivedEvents);
+    });
+
+    // [WHEN] The event loop is running
+    muse::async::processEvents();
+
+    // [THEN] The events match the events of the whole score
+    EXPECT_TRUE(notified);
+    EXPECT_EQ(receivedEvents, expectedEvents);
+}
+
+/**
+ * @brief PlaybackModelTests_Parallel_Rendering_MultiInstrument
+ * @details Every part is rendered by its own task. The events of a score with 12 instruments
+ *          must be the same as the ones rendered part after part on the calling thread
+ */
+TEST_F(Engraving_PlaybackModelTests, Parallel_Rendering_MultiInstrument)
+{
+    // [GIVEN] Score with 12 instruments
+    Score* score = ScoreRW::readScore(
+        PLAYBACK_MODEL_TEST_FILES_DIR + "playback_setup_instruments/playback_setup_instruments.mscx");
+
+    ASSERT_TRUE(score);
+    ASSERT_EQ(score->parts().size(), 12);
+
+    // [GIVEN] The articulation profiles repository will be returning profiles for StringsArticulation family
+    ON_CALL(*m_repositoryMock, defaultProfile(_)).WillByDefault(Return(m_defaultProfile));
+
+    // [GIVEN] The events rendered serially
+    PlaybackModel serialModel;
+    serialModel.setprofilesRepository(m_repositoryMock);
+    serialModel.setParallelRenderingEnabled(false);
+    serialModel.load(score);
+
+    // [WHEN] The playback model renders the parts in parallel
+    PlaybackModel parallelModel;
+    parallelModel.setprofilesRepository(m_repositoryMock);
+    ASSERT_TRUE(parallelModel.isParallelRenderingEnabled());
+    parallelModel.load(score);
+
+    // [THEN] Both models have the same tracks, with the same events
+    InstrumentTrackIdSet trackIdSet = serialModel.existingTrackIdSet();
+    EXPECT_EQ(parallelModel.existingTrackIdSet(), trackIdSet);
+    EXPECT_GT(trackIdSet.size(), score->parts().size()); // + metronome
+
+    size_t eventsCount = 0;
+
+    for (const InstrumentTrackId& trackId : trackIdSet) {
+        const PlaybackEventsMap& expectedEvents = serialModel.resolveTrackPlaybackData(trackId).originEvents;
+        const PlaybackEventsMap& events = parallelModel.resolveTrackPlaybackData(trackId).originEvents;
+
+        EXPECT_EQ(events, expectedEvents) << trackId.partId.toUint64() << " " << trackId.instrumentId.toStdString();
+        eventsCount += expectedEvents.size();
+    }
+
+    EXPECT_GT(eventsCount, 0);
 }
 
 /**
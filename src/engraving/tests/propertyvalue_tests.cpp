@@ -0,0 +1,229 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "types/propertyvalue.h"
+
+using namespace mu;
+using namespace mu::engraving;
+
+class Engraving_PropertyValueTests : public ::testing::Test
+{
+};
+
+TEST_F(Engraving_PropertyValueTests, InlineValues)
+{
+    //! [GIVEN] Values of the small types
+    PropertyValue b(true);
+    PropertyValue i(42);
+    PropertyValue r(1.5);
+    PropertyValue sp(Spatium(2.5));
+    PropertyValue pt(PointF(1.0, 2.0));
+    PropertyValue c(Color(10, 20, 30));
+    PropertyValue f(Fraction(3, 8));
+    PropertyValue a(Align(AlignH::HCENTER, AlignV::BOTTOM));
+    PropertyValue d(DirectionV::UP);
+    PropertyValue s(String(u"text"));
+
+    //! [THEN] The types and the values are kept
+    EXPECT_EQ(b.type(), P_TYPE::BOOL);
+    EXPECT_EQ(b.value<bool>(), true);
+    EXPECT_EQ(i.type(), P_TYPE::INT);
+    EXPECT_EQ(i.value<int>(), 42);
+    EXPECT_EQ(r.type(), P_TYPE::REAL);
+    EXPECT_DOUBLE_EQ(r.value<double>(), 1.5);
+    EXPECT_EQ(sp.type(), P_TYPE::SPATIUM);
+    EXPECT_DOUBLE_EQ(sp.value<Spatium>().val(), 2.5);
+    EXPECT_EQ(pt.type(), P_TYPE::POINT);
+    EXPECT_EQ(pt.value<PointF>(), PointF(1.0, 2.0));
+    EXPECT_EQ(c.type(), P_TYPE::COLOR);
+    EXPECT_EQ(c.value<Color>(), Color(10, 20, 30));
+    EXPECT_EQ(f.type(), P_TYPE::FRACTION);
+    EXPECT_EQ(f.value<Fraction>(), Fraction(3, 8));
+    EXPECT_EQ(a.type(), P_TYPE::ALIGN);
+    EXPECT_EQ(a.value<Align>(), Align(AlignH::HCENTER, AlignV::BOTTOM));
+    EXPECT_EQ(d.type(), P_TYPE::DIRECTION_V);
+    EXPECT_EQ(d.value<DirectionV>(), DirectionV::UP);
+    EXPECT_EQ(s.type(), P_TYPE::STRING);
+    EXPECT_EQ(s.value<String>(), String(u"text"));
+}
+
+TEST_F(Engraving_PropertyValueTests, HeapValues)
+{
+    //! [GIVEN] Values of the large types
+    const std::vector<int> vec = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    const PitchValues pitches = { PitchValue(0, 0), PitchValue(60, 100), PitchValue(120, 0) };
+
+    PropertyValue v(vec);
+    PropertyValue p(pitches);
+
+    //! [WHEN] They are copied
+    PropertyValue vCopy = v;
+    PropertyValue pCopy(p);
+
+    //! [THEN] The copies are equal to the originals
+    EXPECT_EQ(vCopy.type(), P_TYPE::INT_VEC);
+    EXPECT_EQ(vCopy.value<std::vector<int> >(), vec);
+    EXPECT_EQ(vCopy, v);
+    EXPECT_EQ(pCopy.type(), P_TYPE::PITCH_VALUES);
+    EXPECT_EQ(pCopy.value<PitchValues>(), pitches);
+    EXPECT_EQ(pCopy, p);
+
+    //! [WHEN] A different value is assigned to the copy
+    vCopy = PropertyValue(std::vector<int> { 1 });
+
+    //! [THEN] The original is not changed
+    EXPECT_EQ(v.value<std::vector<int> >(), vec);
+    EXPECT_NE(vCopy, v);
+}
+
+TEST_F(Engraving_PropertyValueTests, CopyAndMove)
+{
+    //! [GIVEN] A string value and a heap value
+    PropertyValue s(String(u"text"));
+    PropertyValue v(std::vector<int> { 1, 2, 3 });
+
+    //! [WHEN] They are moved
+    PropertyValue movedS = std::move(s);
+    PropertyValue movedV;
+    movedV = std::move(v);
+
+    //! [THEN] The values are moved, the sources become undefined
+    EXPECT_EQ(movedS.value<String>(), String(u"text"));
+    EXPECT_EQ(movedV.value<std::vector<int> >(), std::vector<int>({ 1, 2, 3 }));
+    EXPECT_FALSE(s.isValid());
+    EXPECT_FALSE(v.isValid());
+
+    //! [WHEN] Values of different storages are assigned to each other
+    PropertyValue value(42);
+    value = movedV;
+    EXPECT_EQ(value.value<std::vector<int> >(), std::vector<int>({ 1, 2, 3 }));
+    value = movedS;
+    EXPECT_EQ(value.value<String>(), String(u"text"));
+    value = PropertyValue(Spatium(1.0));
+    EXPECT_EQ(value.type(), P_TYPE::SPATIUM);
+
+    //! [THEN] The self assignment keeps the value
+    const PropertyValue& self = value;
+    value = self;
+    EXPECT_DOUBLE_EQ(value.value<Spatium>().val(), 1.0);
+}
+
+TEST_F(Engraving_PropertyValueTests, Conversions)
+{
+    //! [THEN] The conversions between the compatible types are kept
+    EXPECT_EQ(PropertyValue(2).value<DirectionV>(), DirectionV::DOWN);
+    EXPECT_EQ(PropertyValue(DirectionV::DOWN).value<int>(), 2);
+    EXPECT_TRUE(PropertyValue(DirectionV::DOWN).isEnum());
+    EXPECT_FALSE(PropertyValue(2).isEnum());
+    EXPECT_EQ(PropertyValue(true).value<int>(), 1);
+    EXPECT_EQ(PropertyValue(1).value<bool>(), true);
+    EXPECT_EQ(PropertyValue(size_t(7)).value<int>(), 7);
+    EXPECT_DOUBLE_EQ(PropertyValue(1.5).value<Spatium>().val(), 1.5);
+    EXPECT_DOUBLE_EQ(PropertyValue(Spatium(1.5)).value<double>(), 1.5);
+    EXPECT_DOUBLE_EQ(PropertyValue(1.5).value<Millimetre>().val(), 1.5);
+    EXPECT_DOUBLE_EQ(PropertyValue(Millimetre(1.5)).value<double>(), 1.5);
+    EXPECT_EQ(PropertyValue(Fraction(1, 4)).value<String>(), Fraction(1, 4).toString());
+    EXPECT_EQ(PropertyValue().value<int>(), 0);
+}
+
+TEST_F(Engraving_PropertyValueTests, Equality)
+{
+    //! [THEN] The values of the same type are compared by value
+    EXPECT_EQ(PropertyValue(Color(1, 2, 3)), PropertyValue(Color(1, 2, 3)));
+    EXPECT_NE(PropertyValue(Color(1, 2, 3)), PropertyValue(Color(3, 2, 1)));
+    EXPECT_EQ(PropertyValue(String(u"a")), PropertyValue(String(u"a")));
+    EXPECT_NE(PropertyValue(String(u"a")), PropertyValue(String(u"b")));
+    EXPECT_NE(PropertyValue(Fraction(2, 8)), PropertyValue(Fraction(1, 4)));
+
+    //! [THEN] The compatible types are compared with the conversions
+    EXPECT_EQ(PropertyValue(1), PropertyValue(true));
+    EXPECT_EQ(PropertyValue(2), PropertyValue(DirectionV::DOWN));
+    EXPECT_EQ(PropertyValue(Spatium(1.0)), PropertyValue(1.0));
+
+    //! [THEN] The undefined value is equal only to an undefined value
+    EXPECT_EQ(PropertyValue(), PropertyValue());
+    EXPECT_NE(PropertyValue(), PropertyValue(0));
+
+    //! [THEN] The values of different types are not equal
+    EXPECT_NE(PropertyValue(PointF(1.0, 1.0)), PropertyValue(SizeF(1.0, 1.0)));
+}
+
+//! NOTE: The benchmarks are disabled by default, run them with:
+//! engraving_tests --gtest_also_run_disabled_tests --gtest_filter=*PropertyValue*Benchmark*
+//! For the numbers of a full layout and file load, see engraving_layout_bench
+TEST_F(Engraving_PropertyValueTests, DISABLED_Benchmark_CopyAndRead)
+{
+    constexpr int ITERATIONS = 200;
+
+    //! [GIVEN] A style-like set of values
+    std::vector<PropertyValue> values;
+    for (int i = 0; i < 1000; ++i) {
+        switch (i % 6) {
+        case 0: values.emplace_back(i % 2 == 0);
+            break;
+        case 1: values.emplace_back(i);
+            break;
+        case 2: values.emplace_back(Spatium(i * 0.5));
+            break;
+        case 3: values.emplace_back(PointF(i, i));
+            break;
+        case 4: values.emplace_back(PlacementV::ABOVE);
+            break;
+        case 5: values.emplace_back(double(i));
+            break;
+        }
+    }
+
+    //! [WHEN] They are copied and read many times
+    double sum = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (int it = 0; it < ITERATIONS; ++it) {
+        std::vector<PropertyValue> copy = values;
+        for (const PropertyValue& v : copy) {
+            switch (v.type()) {
+            case P_TYPE::BOOL: sum += v.value<bool>();
+                break;
+            case P_TYPE::INT: sum += v.value<int>();
+                break;
+            case P_TYPE::SPATIUM: sum += v.value<double>();
+                break;
+            case P_TYPE::POINT: sum += v.value<PointF>().x();
+                break;
+            case P_TYPE::PLACEMENT_V: sum += v.value<int>();
+                break;
+            default: sum += v.toDouble();
+                break;
+            }
+        }
+    }
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    //! [THEN] Print the time
+    std::cout << "PropertyValue copy and read of " << values.size() << " values x " << ITERATIONS << ": "
+              << us << " us (" << sum << ")" << std::endl;
+}
@@ -0,0 +1,176 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cfloat>
+#include <iostream>
+#include <random>
+
+#include "dom/masterscore.h"
+#include "infrastructure/shape.h"
+#include "rendering/dev/horizontalspacing.h"
+
+#include "testing/allocationcounter.h"
+
+#include "utils/scorerw.h"
+
+using namespace mu;
+using namespace mu::engraving;
+using namespace mu::engraving::rendering::dev;
+
+static const String ALL_ELEMENTS_DATA_DIR(u"all_elements_data/");
+
+namespace {
+Shape randomShape(std::mt19937& rng, size_t count)
+{
+    std::uniform_real_distribution<double> pos(-20.0, 20.0);
+    std::uniform_real_distribution<double> size(0.0, 6.0);
+
+    Shape shape;
+    for (size_t i = 0; i < count; ++i) {
+        shape.add(RectF(pos(rng), pos(rng), size(rng), size(rng)));
+    }
+    return shape;
+}
+}
+
+class Engraving_ShapeTests : public ::testing::Test
+{
+};
+
+TEST_F(Engraving_ShapeTests, smallVector)
+{
+    //! [GIVEN] An inline vector
+    SmallVector<int, 2> v;
+    v.push_back(1);
+    v.push_back(2);
+    EXPECT_TRUE(v.isInline());
+
+    //! [WHEN] It grows beyond the inline storage
+    v.push_back(3);
+    v.emplace_back(v.front());
+
+    //! [THEN] The elements are moved to the heap
+    EXPECT_FALSE(v.isInline());
+    EXPECT_EQ(v.size(), 4);
+    EXPECT_EQ(v.back(), 1);
+
+    //! [WHEN] Insert a range of the same vector and erase
+    v.insert(v.begin() + 1, v.begin(), v.begin() + 2);
+    EXPECT_EQ(v, (SmallVector<int, 2>(v)));
+    EXPECT_EQ(v.size(), 6);
+    EXPECT_EQ(v[0], 1);
+    EXPECT_EQ(v[1], 1);
+    EXPECT_EQ(v[2], 2);
+    EXPECT_EQ(v[3], 2);
+
+    v.erase(v.begin(), v.begin() + 3);
+    EXPECT_EQ(v.size(), 3);
+    EXPECT_EQ(v[0], 2);
+    EXPECT_EQ(v[1], 3);
+    EXPECT_EQ(v[2], 1);
+
+    //! [THEN] A moved vector takes the heap storage, a small one stays inline
+    SmallVector<int, 2> moved = std::move(v);
+    EXPECT_EQ(moved.size(), 3);
+    EXPECT_TRUE(v.empty());
+    EXPECT_TRUE(v.isInline());
+
+    SmallVector<int, 2> small;
+    small.push_back(5);
+    SmallVector<int, 2> movedSmall = std::move(small);
+    EXPECT_TRUE(movedSmall.isInline());
+    EXPECT_EQ(movedSmall.front(), 5);
+}
+
+TEST_F(Engraving_ShapeTests, noHeapForSmallShapes)
+{
+    //! [GIVEN] A shape with a few elements
+    Shape shape(RectF(0.0, 0.0, 10.0, 4.0));
+    shape.add(RectF(10.0, 2.0, 1.0, 20.0));
+
+    //! [WHEN] Copy, translate and merge it
+    muse::testing::startCountingAllocations();
+
+    Shape copy = shape;
+    Shape moved = Shape(shape).translate(PointF(5.0, 5.0));
+    Shape translated = shape.translated(PointF(1.0, 1.0));
+    copy.add(moved);
+
+    size_t allocationsCount = muse::testing::stopCountingAllocations();
+
+    //! [THEN] Nothing is allocated
+    EXPECT_EQ(allocationsCount, 0);
+    EXPECT_EQ(copy.size(), 4);
+    EXPECT_TRUE(moved.equal(shape.translated(PointF(5.0, 5.0))));
+    EXPECT_EQ(translated.elements().front(), RectF(1.0, 1.0, 10.0, 4.0));
+}
+
+TEST_F(Engraving_ShapeTests, batchedQueries)
+{
+    std::mt19937 rng(3);
+
+    for (int i = 0; i < 300; ++i) {
+        //! [GIVEN] Random shapes
+        const Shape shape1 = randomShape(rng, 1 + rng() % 12);
+        const Shape shape2 = randomShape(rng, 1 + rng() % 12);
+        const PointF pos1(rng() % 10, rng() % 10);
+        const PointF pos2(rng() % 10, rng() % 10);
+
+        //! [THEN] The queries give the same results as on the translated copies
+        bool expected = false;
+        for (const ShapeElement& r : shape2.elements()) {
+            expected = expected || shape1.intersects(r);
+        }
+        std::vector<RectF> rects(shape2.elements().begin(), shape2.elements().end());
+        EXPECT_EQ(shape1.intersects(rects.data(), rects.size()), expected);
+        EXPECT_EQ(shape1.intersects(shape2), expected);
+
+        EXPECT_EQ(shape1.intersects(shape2, pos1, pos2), shape1.translated(pos1).intersects(shape2.translated(pos2)));
+
+        std::vector<Shape> shapes = { shape2, randomShape(rng, 3), Shape() };
+        double dist = -DBL_MAX;
+        for (const Shape& s : shapes) {
+            dist = std::max(dist, HorizontalSpacing::minHorizontalDistance(shape1, s, 1.0));
+        }
+        EXPECT_DOUBLE_EQ(HorizontalSpacing::minHorizontalDistance(shape1, shapes, 1.0), dist);
+    }
+}
+
+//! NOTE: Prints the number of the heap allocations of a full layout,
+//! to compare it between the revisions
+TEST_F(Engraving_ShapeTests, DISABLED_layoutAllocations)
+{
+    MasterScore* score = ScoreRW::readScore(ALL_ELEMENTS_DATA_DIR + u"moonlight.mscx");
+    ASSERT_TRUE(score);
+
+    muse::testing::startCountingAllocations();
+
+    score->doLayout();
+
+    size_t allocationsCount = muse::testing::stopCountingAllocations();
+
+    std::cout << "allocations per full layout: " << allocationsCount << std::endl;
+
+    delete score;
+}
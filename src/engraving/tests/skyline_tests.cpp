@@ -0,0 +1,441 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+
+#include "io/dir.h"
+
+#include "dom/masterscore.h"
+#include "dom/measure.h"
+#include "dom/segment.h"
+#include "dom/system.h"
+#include "infrastructure/skyline.h"
+
+#include "utils/scorerw.h"
+
+using namespace mu;
+using namespace mu::engraving;
+
+static const String ALL_ELEMENTS_DATA_DIR(u"all_elements_data/");
+static const String MEASURE_DATA_DIR(u"measure_data/");
+
+static const double MAXIMUM_Y = 1000000.0;
+static const double MINIMUM_Y = -1000000.0;
+
+namespace {
+//! NOTE: The previous implementation of SkylineLine (a vector of segments,
+//! one insert per element), kept here as the reference for the equivalence tests
+class RefSkylineLine
+{
+public:
+    RefSkylineLine(bool north)
+        : m_north(north) {}
+
+    void add(const Shape& s)
+    {
+        for (const ShapeElement& r : s.elements()) {
+            if (!r.ignoreForLayout()) {
+                add(r.x(), m_north ? r.top() : r.bottom(), r.width());
+            }
+        }
+    }
+
+    void add(double x, double y, double w)
+    {
+        if (x < 0.0) {
+            w -= -x;
+            x = 0.0;
+            if (w <= 0.0) {
+                return;
+            }
+        }
+
+        SegIter i = find(x);
+        double cx = m_seg.empty() ? 0.0 : i->x;
+        for (; i != m_seg.end(); ++i) {
+            double cy = i->y;
+            if ((x + w) <= cx) {
+                return;
+            }
+            if (x > (cx + i->w)) {
+                cx += i->w;
+                continue;
+            }
+            if ((m_north && (cy <= y)) || (!m_north && (cy >= y))) {
+                cx += i->w;
+                continue;
+            }
+            if ((x >= cx) && ((x + w) < (cx + i->w))) {
+                double w1 = x - cx;
+                double w2 = w;
+                double w3 = i->w - (w1 + w2);
+                if (w1 > 0.0000001) {
+                    i->w = w1;
+                    ++i;
+                    i = insert(i, x, y, w2);
+                } else {
+                    i->w = w2;
+                    i->y = y;
+                }
+                if (w3 > 0.0000001) {
+                    ++i;
+                    insert(i, x + w2, cy, w3);
+                }
+                return;
+            } else if ((x <= cx) && ((x + w) >= (cx + i->w))) {
+                i->y = y;
+            } else if (x < cx) {
+                double w1 = x + w - cx;
+                i->w -= w1;
+                insert(i, cx, y, w1);
+                return;
+            } else {
+                double w1 = x - cx;
+                double w2 = i->w - w1;
+                if (w2 > 0.0000001) {
+                    i->w = w1;
+                    cx += w1;
+                    ++i;
+                    i = insert(i, cx, y, w2);
+                }
+            }
+            cx += i->w;
+        }
+        if (x >= cx) {
+            if (x > cx) {
+                m_seg.emplace_back(cx, m_north ? MAXIMUM_Y : MINIMUM_Y, x - cx);
+            }
+            m_seg.emplace_back(x, y, w);
+        } else if (x + w > cx) {
+            m_seg.emplace_back(cx, y, x + w - cx);
+        }
+    }
+
+    double minDistance(const RefSkylineLine& sl) const
+    {
+        double dist = MINIMUM_Y;
+
+        double x1 = 0.0;
+        double x2 = 0.0;
+        auto k = sl.m_seg.begin();
+        for (auto i = m_seg.begin(); i != m_seg.end(); ++i) {
+            while (k != sl.m_seg.end() && (x2 + k->w) < x1) {
+                x2 += k->w;
+                ++k;
+            }
+            if (k == sl.m_seg.end()) {
+                break;
+            }
+            for (;;) {
+                if ((x1 + i->w > x2) && (x1 < x2 + k->w)) {
+                    dist = std::max(dist, i->y - k->y);
+                }
+                if (x2 + k->w < x1 + i->w) {
+                    x2 += k->w;
+                    ++k;
+                    if (k == sl.m_seg.end()) {
+                        break;
+                    }
+                } else {
+                    break;
+                }
+            }
+            if (k == sl.m_seg.end()) {
+                break;
+            }
+            x1 += i->w;
+        }
+        return dist;
+    }
+
+    double max() const
+    {
+        double result = m_north ? MAXIMUM_Y : MINIMUM_Y;
+        for (const SkylineSegment& s : m_seg) {
+            result = m_north ? std::min(result, s.y) : std::max(result, s.y);
+        }
+        return result;
+    }
+
+    double valueAt(double x) const
+    {
+        double cx = 0.0;
+        for (const SkylineSegment& s : m_seg) {
+            if (x >= cx && x < cx + s.w) {
+                return s.y;
+            }
+            cx += s.w;
+        }
+        return m_north ? MAXIMUM_Y : MINIMUM_Y;
+    }
+
+    double end() const
+    {
+        double cx = 0.0;
+        for (const SkylineSegment& s : m_seg) {
+            cx += s.w;
+        }
+        return cx;
+    }
+
+private:
+    using SegIter = std::vector<SkylineSegment>::iterator;
+
+    SegIter find(double x)
+    {
+        auto it = std::upper_bound(m_seg.begin(), m_seg.end(), x, [](double x, const SkylineSegment& s) { return x < s.x; });
+        if (it == m_seg.begin()) {
+            return it;
+        }
+        return --it;
+    }
+
+    SegIter insert(SegIter i, double x, double y, double w)
+    {
+        const double xr = x + w;
+        if (i != m_seg.end() && xr > i->x) {
+            i->x = xr;
+        }
+        return m_seg.emplace(i, x, y, w);
+    }
+
+    bool m_north = true;
+    std::vector<SkylineSegment> m_seg;
+};
+
+double valueAt(const SkylineLine& line, double x)
+{
+    for (SkylineSegment s : line) {
+        if (x >= s.x && x < s.x + s.w) {
+            return s.y;
+        }
+    }
+    return line.isNorth() ? MAXIMUM_Y : MINIMUM_Y;
+}
+
+//! NOTE: The lines may be split into segments differently,
+//! so they are compared by their values
+void compareLines(const SkylineLine& line, const RefSkylineLine& ref)
+{
+    EXPECT_DOUBLE_EQ(line.max(), ref.max());
+
+    const double end = ref.end();
+    const double step = std::max(end / 997.0, 0.001);
+    for (double x = step / 2; x < end; x += step) {
+        EXPECT_NEAR(valueAt(line, x), ref.valueAt(x), 1e-6) << "x: " << x;
+    }
+}
+
+Shape randomShape(std::mt19937& rng, size_t count, double width)
+{
+    std::uniform_real_distribution<double> xDist(-5.0, width);
+    std::uniform_real_distribution<double> wDist(0.01, 20.0);
+    std::uniform_real_distribution<double> yDist(-10.0, 10.0);
+    std::uniform_real_distribution<double> hDist(0.0, 5.0);
+
+    Shape shape;
+    for (size_t i = 0; i < count; ++i) {
+        shape.add(RectF(xDist(rng), yDist(rng), wDist(rng), hDist(rng)));
+    }
+    return shape;
+}
+
+void compareScore(MasterScore* score)
+{
+    for (System* system : score->systems()) {
+        std::vector<SkylineLine> norths;
+        std::vector<SkylineLine> souths;
+        std::vector<RefSkylineLine> refNorths;
+        std::vector<RefSkylineLine> refSouths;
+
+        for (staff_idx_t staffIdx = 0; staffIdx < score->nstaves(); ++staffIdx) {
+            norths.emplace_back(true);
+            souths.emplace_back(false);
+            refNorths.emplace_back(true);
+            refSouths.emplace_back(false);
+
+            for (MeasureBase* mb : system->measures()) {
+                if (!mb->isMeasure()) {
+                    continue;
+                }
+                Measure* m = toMeasure(mb);
+                for (Segment* s = m->first(); s; s = s->next()) {
+                    const Shape shape = s->staffShape(staffIdx).translated(s->pos() + m->pos());
+                    norths.back().add(shape);
+                    souths.back().add(shape);
+                    refNorths.back().add(shape);
+                    refSouths.back().add(shape);
+                }
+            }
+
+            compareLines(norths.back(), refNorths.back());
+            compareLines(souths.back(), refSouths.back());
+        }
+
+        for (size_t i = 1; i < norths.size(); ++i) {
+            EXPECT_NEAR(souths[i - 1].minDistance(norths[i]), refSouths[i - 1].minDistance(refNorths[i]), 1e-6);
+        }
+    }
+}
+}
+
+class Engraving_SkylineTests : public ::testing::Test
+{
+};
+
+TEST_F(Engraving_SkylineTests, randomShapes)
+{
+    std::mt19937 rng(7);
+
+    for (int i = 0; i < 500; ++i) {
+        //! [GIVEN] Random shapes, added to the skyline one by one and as a whole
+        const Shape shape1 = randomShape(rng, 1 + rng() % 40, 100.0);
+        const Shape shape2 = randomShape(rng, 1 + rng() % 40, 100.0).translated(PointF(0.0, 20.0));
+
+        for (bool north : { true, false }) {
+            SkylineLine line(north);
+            SkylineLine batchLine(north);
+            RefSkylineLine ref(north);
+
+            //! [WHEN] Add the rects
+            for (const ShapeElement& r : shape1.elements()) {
+                line.add(r);
+            }
+            batchLine.add(shape1);
+            ref.add(shape1);
+
+            //! [THEN] The line is the same as the one of the previous implementation
+            compareLines(line, ref);
+            compareLines(batchLine, ref);
+        }
+
+        //! [THEN] The distances are the same
+        SkylineLine south(false);
+        SkylineLine north(true);
+        RefSkylineLine refSouth(false);
+        RefSkylineLine refNorth(true);
+        south.add(shape1);
+        north.add(shape2);
+        refSouth.add(shape1);
+        refNorth.add(shape2);
+
+        EXPECT_NEAR(south.minDistance(north), refSouth.minDistance(refNorth), 1e-6);
+    }
+}
+
+TEST_F(Engraving_SkylineTests, scoreShapes)
+{
+    for (const String& file : { ALL_ELEMENTS_DATA_DIR + u"layout_elements.mscx",
+                                ALL_ELEMENTS_DATA_DIR + u"moonlight.mscx",
+                                MEASURE_DATA_DIR + u"measure-1.mscx" }) {
+        //! [GIVEN] The segment shapes of a laid out score
+        MasterScore* score = ScoreRW::readScore(file);
+        ASSERT_TRUE(score);
+
+        //! [THEN] The skylines and the distances between the staves are the same as before
+        compareScore(score);
+
+        delete score;
+    }
+}
+
+//! NOTE: Takes a while, run it after changes in the skyline
+TEST_F(Engraving_SkylineTests, DISABLED_vtestShapes)
+{
+    const muse::io::path_t vtestScores = ScoreRW::rootPath() + u"/../../../vtest/scores";
+    const muse::RetVal<muse::io::paths_t> files = muse::io::Dir::scanFiles(vtestScores, { "*.mscz", "*.mscx" },
+                                                                           muse::io::ScanMode::FilesInCurrentDir);
+    ASSERT_TRUE(files.ret);
+
+    for (const muse::io::path_t& file : files.val) {
+        MasterScore* score = ScoreRW::readScore(file.toString(), true);
+        if (!score) {
+            continue;
+        }
+
+        SCOPED_TRACE(file.toStdString());
+        compareScore(score);
+
+        delete score;
+    }
+}
+
+TEST_F(Engraving_SkylineTests, DISABLED_benchmark)
+{
+    std::mt19937 rng(11);
+
+    std::vector<Shape> shapes;
+    for (int i = 0; i < 2000; ++i) {
+        shapes.push_back(randomShape(rng, 16, 2000.0));
+    }
+
+    auto measure = [](const std::function<void()>& func) {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    SkylineLine south(false);
+    SkylineLine north(true);
+    RefSkylineLine refSouth(false);
+    RefSkylineLine refNorth(true);
+
+    const auto refAdd = measure([&]() {
+        for (const Shape& s : shapes) {
+            refSouth.add(s);
+            refNorth.add(s.translated(PointF(0.0, 20.0)));
+        }
+    });
+
+    const auto add = measure([&]() {
+        for (const Shape& s : shapes) {
+            south.add(s);
+            north.add(s.translated(PointF(0.0, 20.0)));
+        }
+    });
+
+    double refDist = 0.0;
+    const auto refMinDistance = measure([&]() {
+        for (int i = 0; i < 1000; ++i) {
+            refDist += refSouth.minDistance(refNorth);
+        }
+    });
+
+    double dist = 0.0;
+    const auto minDistance = measure([&]() {
+        for (int i = 0; i < 1000; ++i) {
+            dist += south.minDistance(north);
+        }
+    });
+
+    EXPECT_NEAR(dist, refDist, 1e-3);
+
+    std::cout << "segments: " << south.size() << " / " << north.size() << std::endl;
+    std::cout << "add: " << refAdd << " us (previous), " << add << " us" << std::endl;
+    std::cout << "minDistance: " << refMinDistance << " us (previous), " << minDistance << " us" << std::endl;
+}
@@ -23,7 +23,10 @@
 #define MU_ENGRAVING_PROPERTYVALUE_H
 
 #include <memory>
+#include <new>
+#include <cstring>
 #include <cassert>
+#include <type_traits>
 
 #ifndef NO_QT_SUPPORT
 #include <QVariant>
@@ -114,173 +117,206 @@ class PropertyValue
 public:
     PropertyValue() = default;
 
+    PropertyValue(const PropertyValue& v)
+    {
+        copyFrom(v);
+    }
+
+    PropertyValue(PropertyValue&& v) noexcept
+    {
+        moveFrom(v);
+    }
+
+    ~PropertyValue()
+    {
+        destroy();
+    }
+
+    PropertyValue& operator=(const PropertyValue& v)
+    {
+        if (this != &v) {
+            destroy();
+            copyFrom(v);
+        }
+        return *this;
+    }
+
+    PropertyValue& operator=(PropertyValue&& v) noexcept
+    {
+        if (this != &v) {
+            destroy();
+            moveFrom(v);
+        }
+        return *this;
+    }
+
     // Base
     PropertyValue(bool v)
-        : m_type(P_TYPE::BOOL), m_data(make_data<bool>(v)) {}
+        : m_type(P_TYPE::BOOL), m_ops(make_data<bool>(v)) {}
 
     PropertyValue(int v)
-        : m_type(P_TYPE::INT), m_data(make_data<int>(v)) {}
+        : m_type(P_TYPE::INT), m_ops(make_data<int>(v)) {}
 
     PropertyValue(const std::vector<int>& v)
-        : m_type(P_TYPE::INT_VEC), m_data(make_data<std::vector<int> >(v)) {}
+        : m_type(P_TYPE::INT_VEC), m_ops(make_data<std::vector<int> >(v)) {}
 
     PropertyValue(size_t v)
-        : m_type(P_TYPE::SIZE_T), m_data(make_data<size_t>(v)) {}
+        : m_type(P_TYPE::SIZE_T), m_ops(make_data<size_t>(v)) {}
 
     PropertyValue(double v)
-        : m_type(P_TYPE::REAL), m_data(make_data<double>(v)) {}
+        : m_type(P_TYPE::REAL), m_ops(make_data<double>(v)) {}
 
     PropertyValue(const char* v)
-        : m_type(P_TYPE::STRING), m_data(make_data<String>(String::fromUtf8(v))) {}
+        : m_type(P_TYPE::STRING), m_ops(make_data<String>(String::fromUtf8(v))) {}
 
     PropertyValue(const String& v)
-        : m_type(P_TYPE::STRING), m_data(make_data<String>(v)) {}
+        : m_type(P_TYPE::STRING), m_ops(make_data<String>(v)) {}
 
 #ifndef NO_QT_SUPPORT
     PropertyValue(const QString& v)
-        : m_type(P_TYPE::STRING), m_data(make_data<String>(String::fromQString(v))) {}
+        : m_type(P_TYPE::STRING), m_ops(make_data<String>(String::fromQString(v))) {}
 #endif
 
     // Geometry
     PropertyValue(const PointF& v)
-        : m_type(P_TYPE::POINT), m_data(make_data<PointF>(v)) {}
+        : m_type(P_TYPE::POINT), m_ops(make_data<PointF>(v)) {}
 
     PropertyValue(const PairF& v)
-        : m_type(P_TYPE::PAIR_REAL), m_data(make_data<PairF>(v)) {}
+        : m_type(P_TYPE::PAIR_REAL), m_ops(make_data<PairF>(v)) {}
 
     PropertyValue(const SizeF& v)
-        : m_type(P_TYPE::SIZE), m_data(make_data<SizeF>(v)) {}
+        : m_type(P_TYPE::SIZE), m_ops(make_data<SizeF>(v)) {}
 
     PropertyValue(const PainterPath& v)
-        : m_type(P_TYPE::DRAW_PATH), m_data(make_data<PainterPath>(v)) {}
+        : m_type(P_TYPE::DRAW_PATH), m_ops(make_data<PainterPath>(v)) {}
 
     PropertyValue(const ScaleF& v)
-        : m_type(P_TYPE::SCALE), m_data(make_data<ScaleF>(v)) {}
+        : m_type(P_TYPE::SCALE), m_ops(make_data<ScaleF>(v)) {}
 
     PropertyValue(const Spatium& v)
-        : m_type(P_TYPE::SPATIUM), m_data(make_data<Spatium>(v)) {}
+        : m_type(P_TYPE::SPATIUM), m_ops(make_data<Spatium>(v)) {}
 
     PropertyValue(const Millimetre& v)
-        : m_type(P_TYPE::MILLIMETRE), m_data(make_data<Millimetre>(v)) {}
+        : m_type(P_TYPE::MILLIMETRE), m_ops(make_data<Millimetre>(v)) {}
 
     // Draw
     PropertyValue(SymId v)
-        : m_type(P_TYPE::SYMID), m_data(make_data<SymId>(v)) {}
+        : m_type(P_TYPE::SYMID), m_ops(make_data<SymId>(v)) {}
 
     PropertyValue(const Color& v)
-        : m_type(P_TYPE::COLOR), m_data(make_data<Color>(v)) {}
+        : m_type(P_TYPE::COLOR), m_ops(make_data<Color>(v)) {}
 
     PropertyValue(OrnamentStyle v)
-        : m_type(P_TYPE::ORNAMENT_STYLE), m_data(make_data<OrnamentStyle>(v)) {}
+        : m_type(P_TYPE::ORNAMENT_STYLE), m_ops(make_data<OrnamentStyle>(v)) {}
 
     PropertyValue(GlissandoStyle v)
-        : m_type(P_TYPE::GLISS_STYLE), m_data(make_data<GlissandoStyle>(v)) {}
+        : m_type(P_TYPE::GLISS_STYLE), m_ops(make_data<GlissandoStyle>(v)) {}
 
     // Layout
     PropertyValue(Align v)
-        : m_type(P_TYPE::ALIGN), m_data(make_data<Align>(v)) {}
+        : m_type(P_TYPE::ALIGN), m_ops(make_data<Align>(v)) {}
 
     PropertyValue(PlacementV v)
-        : m_type(P_TYPE::PLACEMENT_V), m_data(make_data<PlacementV>(v)) {}
+        : m_type(P_TYPE::PLACEMENT_V), m_ops(make_data<PlacementV>(v)) {}
     PropertyValue(PlacementH v)
-        : m_type(P_TYPE::PLACEMENT_H), m_data(make_data<PlacementH>(v)) {}
+        : m_type(P_TYPE::PLACEMENT_H), m_ops(make_data<PlacementH>(v)) {}
 
     PropertyValue(TextPlace v)
-        : m_type(P_TYPE::TEXT_PLACE), m_data(make_data<TextPlace>(v)) {}
+        : m_type(P_TYPE::TEXT_PLACE), m_ops(make_data<TextPlace>(v)) {}
 
     PropertyValue(DirectionV v)
-        : m_type(P_TYPE::DIRECTION_V), m_data(make_data<DirectionV>(v)) {}
+        : m_type(P_TYPE::DIRECTION_V), m_ops(make_data<DirectionV>(v)) {}
     PropertyValue(DirectionH v)
-        : m_type(P_TYPE::DIRECTION_H), m_data(make_data<DirectionH>(v)) {}
+        : m_type(P_TYPE::DIRECTION_H), m_ops(make_data<DirectionH>(v)) {}
 
     PropertyValue(Orientation v)
-        : m_type(P_TYPE::ORIENTATION), m_data(make_data<Orientation>(v)) {}
+        : m_type(P_TYPE::ORIENTATION), m_ops(make_data<Orientation>(v)) {}
 
     PropertyValue(BeamMode v)
-        : m_type(P_TYPE::BEAM_MODE), m_data(make_data<BeamMode>(v)) {}
+        : m_type(P_TYPE::BEAM_MODE), m_ops(make_data<BeamMode>(v)) {}
 
     PropertyValue(const AccidentalRole& v)
-        : m_type(P_TYPE::ACCIDENTAL_ROLE), m_data(make_data<AccidentalRole>(v)) {}
+        : m_type(P_TYPE::ACCIDENTAL_ROLE), m_ops(make_data<AccidentalRole>(v)) {}
 
     PropertyValue(TiePlacement v)
-        : m_type(P_TYPE::TIE_PLACEMENT), m_data(make_data<TiePlacement>(v)) {}
+        : m_type(P_TYPE::TIE_PLACEMENT), m_ops(make_data<TiePlacement>(v)) {}
 
     // Sound
     PropertyValue(const Fraction& v)
-        : m_type(P_TYPE::FRACTION), m_data(make_data<Fraction>(v)) {}
+        : m_type(P_TYPE::FRACTION), m_ops(make_data<Fraction>(v)) {}
     PropertyValue(const DurationTypeWithDots& v)
-        : m_type(P_TYPE::DURATION_TYPE_WITH_DOTS), m_data(make_data<DurationTypeWithDots>(v)) {}
+        : m_type(P_TYPE::DURATION_TYPE_WITH_DOTS), m_ops(make_data<DurationTypeWithDots>(v)) {}
     PropertyValue(ChangeMethod v)
-        : m_type(P_TYPE::CHANGE_METHOD), m_data(make_data<ChangeMethod>(v)) {}
+        : m_type(P_TYPE::CHANGE_METHOD), m_ops(make_data<ChangeMethod>(v)) {}
     PropertyValue(const PitchValues& v)
-        : m_type(P_TYPE::PITCH_VALUES), m_data(make_data<PitchValues>(v)) {}
+        : m_type(P_TYPE::PITCH_VALUES), m_ops(make_data<PitchValues>(v)) {}
     PropertyValue(const BeatsPerSecond& v)
-        : m_type(P_TYPE::TEMPO), m_data(make_data<BeatsPerSecond>(v)) {}
+        : m_type(P_TYPE::TEMPO), m_ops(make_data<BeatsPerSecond>(v)) {}
 
     // Types
     PropertyValue(LayoutBreakType v)
-        : m_type(P_TYPE::LAYOUTBREAK_TYPE), m_data(make_data<LayoutBreakType>(v)) {}
+        : m_type(P_TYPE::LAYOUTBREAK_TYPE), m_ops(make_data<LayoutBreakType>(v)) {}
 
     PropertyValue(VeloType v)
-        : m_type(P_TYPE::VELO_TYPE), m_data(make_data<VeloType>(v)) {}
+        : m_type(P_TYPE::VELO_TYPE), m_ops(make_data<VeloType>(v)) {}
 
     PropertyValue(BarLineType v)
-        : m_type(P_TYPE::BARLINE_TYPE), m_data(make_data<BarLineType>(v)) {}
+        : m_type(P_TYPE::BARLINE_TYPE), m_ops(make_data<BarLineType>(v)) {}
 
     PropertyValue(NoteHeadType v)
-        : m_type(P_TYPE::NOTEHEAD_TYPE), m_data(make_data<NoteHeadType>(v)) {}
+        : m_type(P_TYPE::NOTEHEAD_TYPE), m_ops(make_data<NoteHeadType>(v)) {}
     PropertyValue(NoteHeadScheme v)
-        : m_type(P_TYPE::NOTEHEAD_SCHEME), m_data(make_data<NoteHeadScheme>(v)) {}
+        : m_type(P_TYPE::NOTEHEAD_SCHEME), m_ops(make_data<NoteHeadScheme>(v)) {}
     PropertyValue(NoteHeadGroup v)
-        : m_type(P_TYPE::NOTEHEAD_GROUP), m_data(make_data<NoteHeadGroup>(v)) {}
+        : m_type(P_TYPE::NOTEHEAD_GROUP), m_ops(make_data<NoteHeadGroup>(v)) {}
 
     PropertyValue(ClefType v)
-        : m_type(P_TYPE::CLEF_TYPE), m_data(make_data<ClefType>(v)) {}
+        : m_type(P_TYPE::CLEF_TYPE), m_ops(make_data<ClefType>(v)) {}
 
     PropertyValue(ClefToBarlinePosition v)
-        : m_type(P_TYPE::CLEF_TO_BARLINE_POS), m_data(make_data<ClefToBarlinePosition>(v)) {}
+        : m_type(P_TYPE::CLEF_TO_BARLINE_POS), m_ops(make_data<ClefToBarlinePosition>(v)) {}
 
     PropertyValue(DynamicType v)
-        : m_type(P_TYPE::DYNAMIC_TYPE), m_data(make_data<DynamicType>(v)) {}
+        : m_type(P_TYPE::DYNAMIC_TYPE), m_ops(make_data<DynamicType>(v)) {}
     PropertyValue(DynamicRange v)
-        : m_type(P_TYPE::DYNAMIC_RANGE), m_data(make_data<DynamicRange>(v)) {}
+        : m_type(P_TYPE::DYNAMIC_RANGE), m_ops(make_data<DynamicRange>(v)) {}
     PropertyValue(DynamicSpeed v)
-        : m_type(P_TYPE::DYNAMIC_SPEED), m_data(make_data<DynamicSpeed>(v)) {}
+        : m_type(P_TYPE::DYNAMIC_SPEED), m_ops(make_data<DynamicSpeed>(v)) {}
 
     PropertyValue(LineType v)
-        : m_type(P_TYPE::LINE_TYPE), m_data(make_data<LineType>(v)) {}
+        : m_type(P_TYPE::LINE_TYPE), m_ops(make_data<LineType>(v)) {}
     PropertyValue(HookType v)
-        : m_type(P_TYPE::HOOK_TYPE), m_data(make_data<HookType>(v)) {}
+        : m_type(P_TYPE::HOOK_TYPE), m_ops(make_data<HookType>(v)) {}
 
     PropertyValue(KeyMode v)
-        : m_type(P_TYPE::KEY_MODE), m_data(make_data<KeyMode>(v)) {}
+        : m_type(P_TYPE::KEY_MODE), m_ops(make_data<KeyMode>(v)) {}
 
     PropertyValue(TextStyleType v)
-        : m_type(P_TYPE::TEXT_STYLE), m_data(make_data<TextStyleType>(v)) {}
+        : m_type(P_TYPE::TEXT_STYLE), m_ops(make_data<TextStyleType>(v)) {}
 
     PropertyValue(PlayingTechniqueType v)
-        : m_type(P_TYPE::PLAYTECH_TYPE), m_data(make_data<PlayingTechniqueType>(v)) {}
+        : m_type(P_TYPE::PLAYTECH_TYPE), m_ops(make_data<PlayingTechniqueType>(v)) {}
 
     PropertyValue(GradualTempoChangeType v)
-        : m_type(P_TYPE::TEMPOCHANGE_TYPE), m_data(make_data<GradualTempoChangeType>(v)) {}
+        : m_type(P_TYPE::TEMPOCHANGE_TYPE), m_ops(make_data<GradualTempoChangeType>(v)) {}
 
     PropertyValue(SlurStyleType v)
-        : m_type(P_TYPE::SLUR_STYLE_TYPE), m_data(make_data<SlurStyleType>(v)) {}
+        : m_type(P_TYPE::SLUR_STYLE_TYPE), m_ops(make_data<SlurStyleType>(v)) {}
 
     // Other
     PropertyValue(const GroupNodes& v)
-        : m_type(P_TYPE::GROUPS), m_data(make_data<GroupNodes>(v)) {}
+        : m_type(P_TYPE::GROUPS), m_ops(make_data<GroupNodes>(v)) {}
 
     PropertyValue(const OrnamentInterval& v)
-        : m_type(P_TYPE::ORNAMENT_INTERVAL), m_data(make_data<OrnamentInterval>(v)) {}
+        : m_type(P_TYPE::ORNAMENT_INTERVAL), m_ops(make_data<OrnamentInterval>(v)) {}
 
     PropertyValue(const OrnamentShowAccidental& v)
-        : m_type(P_TYPE::ORNAMENT_SHOW_ACCIDENTAL), m_data(make_data<OrnamentShowAccidental>(v)) {}
+        : m_type(P_TYPE::ORNAMENT_SHOW_ACCIDENTAL), m_ops(make_data<OrnamentShowAccidental>(v)) {}
 
     bool isValid() const;
 
     P_TYPE type() const;
-    bool isEnum() const { return m_data ? m_data->isEnum() : false; }
+    bool isEnum() const { return m_ops ? m_ops->isEnum : false; }
 
     template<typename T>
     T value() const
@@ -289,12 +325,12 @@ public:
             return T();
         }
 
-        assert(m_data);
-        if (!m_data) {
+        assert(m_ops);
+        if (!m_ops) {
             return T();
         }
 
-        Arg<T>* at = get<T>();
+        const T* at = get<T>();
         if (!at) {
             //! HACK Temporary hack for int to enum
             if constexpr (std::is_enum<T>::value) {
@@ -305,8 +341,8 @@ public:
 
             //! HACK Temporary hack for enum to int
             if constexpr (std::is_same<T, int>::value) {
-                if (m_data->isEnum()) {
-                    return m_data->enumToInt();
+                if (m_ops->isEnum) {
+                    return m_ops->enumToInt(m_storage);
                 }
             }
 
@@ -332,9 +368,9 @@ public:
             //! HACK Temporary hack for real to Spatium
             if constexpr (std::is_same<T, Spatium>::value) {
                 if (P_TYPE::REAL == m_type) {
-                    Arg<double>* srv = get<double>();
+                    const double* srv = get<double>();
                     assert(srv);
-                    return srv ? Spatium(srv->v) : Spatium();
+                    return srv ? Spatium(*srv) : Spatium();
                 }
             }
 
@@ -348,9 +384,9 @@ public:
             //! HACK Temporary hack for real to Millimetre
             if constexpr (std::is_same<T, Millimetre>::value) {
                 if (P_TYPE::REAL == m_type) {
-                    Arg<double>* mrv = get<double>();
+                    const double* mrv = get<double>();
                     assert(mrv);
-                    return mrv ? Millimetre(mrv->v) : Millimetre();
+                    return mrv ? Millimetre(*mrv) : Millimetre();
                 }
             }
 
@@ -387,7 +423,7 @@ public:
         if (!at) {
             return T();
         }
-        return at->v;
+        return *at;
     }
 
     bool toBool() const { return value<bool>(); }
@@ -408,59 +444,152 @@ public:
 #endif
 
 private:
-    struct IArg {
-        virtual ~IArg() = default;
+    //! NOTE Values that fit into the inline storage (bool, int, real, enums, geometry, Fraction, String...)
+    //! are kept in PropertyValue itself, the others (vectors, PainterPath...) are shared on the heap,
+    //! so copying and reading the common values costs neither an allocation nor a reference count
+    static constexpr size_t INLINE_STORAGE_SIZE = 16;
+    static constexpr size_t INLINE_STORAGE_ALIGN = alignof(double) > alignof(void*) ? alignof(double) : alignof(void*);
+
+    template<typename T>
+    struct Storage {
+        static constexpr bool IS_INLINE = sizeof(T) <= INLINE_STORAGE_SIZE && alignof(T) <= INLINE_STORAGE_ALIGN;
+        static constexpr bool IS_TRIVIAL = IS_INLINE && std::is_trivially_copyable<T>::value;
+        using type = std::conditional_t<IS_INLINE, T, std::shared_ptr<const T> >;
+    };
 
-        virtual bool equal(const IArg* a) const = 0;
+    struct Ops {
+        bool isEnum = false;
+        int (*enumToInt)(const void* storage) = nullptr;
+        bool (*equal)(const void* storage, const void* otherStorage) = nullptr;
 
-        virtual bool isEnum() const = 0;
-        virtual int enumToInt() const = 0;
+        //! NOTE Not set for trivially copyable values, they are copied by memcpy
+        void (*copy)(void* storage, const void* otherStorage) = nullptr;
+        void (*move)(void* storage, void* otherStorage) = nullptr;
+        void (*destroy)(void* storage) = nullptr;
     };
 
     template<typename T>
-    struct Arg : public IArg {
-        T v;
-        Arg(const T& v)
-            : IArg(), v(v) {}
-
-        bool equal(const IArg* a) const override
-        {
-            assert(a);
-            const Arg<T>* at = dynamic_cast<const Arg<T>*>(a);
-            assert(at);
-            return at ? at->v == v : false;
+    static const T* data(const void* storage)
+    {
+        using S = typename Storage<T>::type;
+        const S* s = std::launder(static_cast<const S*>(storage));
+        if constexpr (Storage<T>::IS_INLINE) {
+            return s;
+        } else {
+            return s->get();
         }
+    }
 
-        //! HACK Temporary hack for enum to int
-        bool isEnum() const override
-        {
-            return std::is_enum<T>::value;
-        }
+    template<typename T>
+    static bool equalValues(const void* storage, const void* otherStorage)
+    {
+        return *data<T>(storage) == *data<T>(otherStorage);
+    }
 
-        int enumToInt() const override
-        {
-            if constexpr (std::is_enum<T>::value) {
-                return static_cast<int>(v);
-            } else {
-                return -1;
-            }
+    //! HACK Temporary hack for enum to int
+    template<typename T>
+    static int enumToIntValue(const void* storage)
+    {
+        if constexpr (std::is_enum<T>::value) {
+            return static_cast<int>(*data<T>(storage));
+        } else {
+            return -1;
         }
-    };
+    }
+
+    template<typename T>
+    static void copyValue(void* storage, const void* otherStorage)
+    {
+        using S = typename Storage<T>::type;
+        new (storage) S(*std::launder(static_cast<const S*>(otherStorage)));
+    }
+
+    template<typename T>
+    static void moveValue(void* storage, void* otherStorage)
+    {
+        using S = typename Storage<T>::type;
+        new (storage) S(std::move(*std::launder(static_cast<S*>(otherStorage))));
+    }
+
+    template<typename T>
+    static void destroyValue(void* storage)
+    {
+        using S = typename Storage<T>::type;
+        std::launder(static_cast<S*>(storage))->~S();
+    }
 
+    //! NOTE One instance per type, its address identifies the type of the stored value
     template<typename T>
-    inline std::shared_ptr<IArg> make_data(const T& v) const
+    static const Ops* ops()
     {
-        return std::shared_ptr<IArg>(new Arg<T>(v));
+        static constexpr Ops s_ops = {
+            std::is_enum<T>::value,
+            &enumToIntValue<T>,
+            &equalValues<T>,
+            Storage<T>::IS_TRIVIAL ? nullptr : &copyValue<T>,
+            Storage<T>::IS_TRIVIAL ? nullptr : &moveValue<T>,
+            Storage<T>::IS_TRIVIAL ? nullptr : &destroyValue<T>,
+        };
+        return &s_ops;
     }
 
     template<typename T>
-    inline Arg<T>* get() const
+    inline const Ops* make_data(const T& v)
     {
-        return dynamic_cast<Arg<T>*>(m_data.get());
+        using S = typename Storage<T>::type;
+        if constexpr (Storage<T>::IS_INLINE) {
+            new (m_storage) S(v);
+        } else {
+            new (m_storage) S(std::make_shared<const T>(v));
+        }
+        return ops<T>();
+    }
+
+    template<typename T>
+    inline const T* get() const
+    {
+        if (m_ops != ops<T>()) {
+            return nullptr;
+        }
+        return data<T>(m_storage);
+    }
+
+    inline void copyFrom(const PropertyValue& v)
+    {
+        m_type = v.m_type;
+        m_ops = v.m_ops;
+        if (m_ops && m_ops->copy) {
+            m_ops->copy(m_storage, v.m_storage);
+        } else {
+            std::memcpy(m_storage, v.m_storage, INLINE_STORAGE_SIZE);
+        }
+    }
+
+    inline void moveFrom(PropertyValue& v)
+    {
+        m_type = v.m_type;
+        m_ops = v.m_ops;
+        if (m_ops && m_ops->move) {
+            m_ops->move(m_storage, v.m_storage);
+            v.destroy();
+        } else {
+            std::memcpy(m_storage, v.m_storage, INLINE_STORAGE_SIZE);
+        }
+        v.m_type = P_TYPE::UNDEFINED;
+        v.m_ops = nullptr;
+    }
+
+    inline void destroy()
+    {
+        if (m_ops && m_ops->destroy) {
+            m_ops->destroy(m_storage);
+        }
     }
 
+    //! NOTE The storage is declared first, it is filled by make_data in the initialization of m_ops
+    alignas(INLINE_STORAGE_ALIGN) unsigned char m_storage[INLINE_STORAGE_SIZE] = {};
     P_TYPE m_type = P_TYPE::UNDEFINED;
-    std::shared_ptr<IArg> m_data = nullptr;
+    const Ops* m_ops = nullptr;
 };
 }
 
@@ -212,6 +212,10 @@ void AudioModule::onInit(const IApplication::RunMode& mode)
     m_audioBuffer->init(m_configuration->audioChannelsCount(),
                         m_configuration->renderStep());
 
+    m_audioBuffer->setOnDataRequested([this]() {
+        m_audioWorker->wakeup();
+    });
+
     m_audioOutputController->init();
 
     // Setup audio driver
@@ -57,7 +57,9 @@ public:
     virtual void setSampleRate(unsigned int sampleRate) = 0;
     virtual async::Notification sampleRateChanged() const = 0;
 
-    virtual size_t minTrackCountForMultithreading() const = 0;
+    //! NOTE: Number of threads (including the audio worker) used to render the tracks, 0 means automatic
+    virtual size_t renderThreadCount() const = 0;
+    virtual void setRenderThreadCount(size_t count) = 0;
 
     // synthesizers
     virtual AudioInputParams defaultAudioInputParams() const = 0;
@@ -67,6 +69,9 @@ public:
     virtual void setUserSoundFontDirectories(const io::paths_t& paths) = 0;
     virtual async::Channel<io::paths_t> soundFontDirectoriesChanged() const = 0;
 
+    //! NOTE: Where the decompressed samples of SF3 soundfonts are kept between the runs
+    virtual io::path_t soundFontSamplesCachePath() const = 0;
+
     virtual io::path_t knownAudioPluginsFilePath() const = 0;
 };
 }
@@ -23,13 +23,16 @@
 #ifndef MUSE_AUDIO_ABSTRACTEVENTSEQUENCER_H
 #define MUSE_AUDIO_ABSTRACTEVENTSEQUENCER_H
 
+#include <algorithm>
+#include <limits>
 #include <map>
-#include <set>
+#include <vector>
 
 #include "global/async/asyncable.h"
 #include "mpe/events.h"
 
 #include "audiosanitizer.h"
+#include "eventtimeline.h"
 #include "../audiotypes.h"
 
 namespace muse::audio {
@@ -38,11 +41,8 @@ class AbstractEventSequencer : public async::Asyncable
 {
 public:
     using EventType = std::variant<Types...>;
-    using EventSequence = std::set<EventType>;
-    using EventSequenceMap = std::map<msecs_t, EventSequence>;
-
-    typedef typename EventSequenceMap::const_iterator SequenceIterator;
-    typedef typename EventSequence::const_iterator EventIterator;
+    using EventSequence = std::vector<EventType>;
+    using Timeline = EventTimeline<EventType>;
 
     virtual ~AbstractEventSequencer()
     {
@@ -58,22 +58,68 @@ public:
         m_offStreamChanges = data.offStream;
 
         m_mainStreamChanges.onReceive(this,
-                                      [this](const mpe::PlaybackEventsMap& events, const mpe::DynamicLevelMap& dynamics,
+                                      [this](const mpe::PlaybackEventsChanges& changes, const mpe::DynamicLevelMap& dynamics,
                                              const mpe::PlaybackParamMap& params) {
-            updateMainStreamEvents(events, dynamics, params);
+            applyMainStreamChanges(changes, dynamics, params);
         });
 
         m_offStreamChanges.onReceive(this, [this](const mpe::PlaybackEventsMap& events, const mpe::PlaybackParamMap& params) {
             updateOffStreamEvents(events, params);
         });
 
-        updateMainStreamEvents(data.originEvents, data.dynamicLevelMap, data.paramMap);
+        m_mainStreamOrigin = data.originEvents;
+        resetOriginSpan();
+
+        updateMainStreamEvents(m_mainStreamOrigin, data.dynamicLevelMap, data.paramMap);
     }
 
     virtual void updateOffStreamEvents(const mpe::PlaybackEventsMap& events, const mpe::PlaybackParamMap& params) = 0;
     virtual void updateMainStreamEvents(const mpe::PlaybackEventsMap& events, const mpe::DynamicLevelMap& dynamics,
                                         const mpe::PlaybackParamMap& params) = 0;
 
+    //! NOTE Called once the origin events have been patched, the sequencer events within [from, to] are outdated
+    //!      By default, the whole main stream gets rebuilt from the origin events
+    virtual void patchMainStreamEvents(const msecs_t /*from*/, const msecs_t /*to*/, const mpe::DynamicLevelMap& dynamics,
+                                       const mpe::PlaybackParamMap& params)
+    {
+        updateMainStreamEvents(m_mainStreamOrigin, dynamics, params);
+    }
+
+    void applyMainStreamChanges(const mpe::PlaybackEventsChanges& changes, const mpe::DynamicLevelMap& dynamics,
+                                const mpe::PlaybackParamMap& params)
+    {
+        ONLY_AUDIO_WORKER_THREAD;
+
+        if (changes.isFullReplace()) {
+            m_mainStreamOrigin = changes.events;
+            resetOriginSpan();
+
+            updateMainStreamEvents(m_mainStreamOrigin, dynamics, params);
+            return;
+        }
+
+        //! NOTE The outdated range covers everything the replaced and the new events produce
+        msecs_t from = std::numeric_limits<msecs_t>::max();
+        msecs_t to = std::numeric_limits<msecs_t>::min();
+
+        if (!changes.isEmptyRange()) {
+            auto removedBegin = m_mainStreamOrigin.lower_bound(changes.from);
+            auto removedEnd = m_mainStreamOrigin.upper_bound(changes.to);
+
+            for (auto it = removedBegin; it != removedEnd; ++it) {
+                expandOriginSpan(it->first, it->second, from, to);
+            }
+
+            for (const auto& pair : changes.events) {
+                expandOriginSpan(pair.first, pair.second, from, to);
+            }
+
+            changes.applyTo(m_mainStreamOrigin);
+        }
+
+        patchMainStreamEvents(from, to, dynamics, params);
+    }
+
     void setActive(const bool active)
     {
         m_isActive = active;
@@ -133,27 +179,33 @@ public:
         return std::prev(upper)->second;
     }
 
-    EventSequence eventsToBePlayed(const msecs_t nextMsecs)
+    //! NOTE The result is provided by the caller, so that its capacity is reused between the audio blocks
+    void eventsToBePlayed(const msecs_t nextMsecs, EventSequence& result)
     {
         ONLY_AUDIO_WORKER_THREAD;
 
-        EventSequence result;
+        result.clear();
 
         if (!m_isActive) {
             handleOffStream(result, nextMsecs);
-            return result;
+            return;
         }
 
-        if (m_currentMainSequenceIt == m_mainStreamEvents.cend()) {
-            return result;
+        if (m_currentMainSequenceIdx >= m_mainStreamEvents.size()) {
+            return;
         }
 
         m_playbackPosition += nextMsecs;
 
         handleMainStream(result);
+
+        size_t mainEventsCount = result.size();
         handleDynamicChanges(result);
 
-        return result;
+        //! NOTE Keep the events ordered the same way regardless of the stream they come from
+        if (mainEventsCount != 0 && mainEventsCount != result.size()) {
+            std::sort(result.begin(), result.end(), std::less<EventType> {});
+        }
     }
 
 protected:
@@ -166,69 +218,136 @@ protected:
 
     void updateMainSequenceIterator()
     {
-        m_currentMainSequenceIt = m_mainStreamEvents.lower_bound(m_playbackPosition);
+        m_currentMainSequenceIdx = m_mainStreamEvents.lowerBound(m_playbackPosition);
     }
 
     void updateOffSequenceIterator()
     {
-        m_currentOffSequenceIt = m_offStreamEvents.cbegin();
+        m_currentOffSequenceIdx = 0;
     }
 
     void updateDynamicChangesIterator()
     {
-        m_currentDynamicsIt = m_dynamicEvents.lower_bound(m_playbackPosition);
+        m_currentDynamicsIdx = m_dynamicEvents.lowerBound(m_playbackPosition);
+    }
+
+    //! NOTE Rebuilds the main stream events within [from, to] from the origin events which might produce them
+    //!      derive(destination, originBegin, originEnd) converts the origin events into the sequencer events
+    template<typename Derive>
+    void replaceMainStreamRange(const msecs_t from, const msecs_t to, Derive derive)
+    {
+        if (from > to) {
+            return;
+        }
+
+        m_patchEvents.clear();
+        derive(m_patchEvents, m_mainStreamOrigin.lower_bound(from - m_maxOriginTail),
+               m_mainStreamOrigin.upper_bound(to + m_maxOriginLead));
+        m_patchEvents.finalize();
+
+        m_mainStreamEvents.replaceRange(from, to, m_patchEvents);
+
+        //! NOTE Only the notes which might be sounding right now have to be stopped
+        if (from <= m_playbackPosition && m_playbackPosition <= to && m_onMainStreamFlushed) {
+            m_onMainStreamFlushed();
+        }
+
+        updateMainSequenceIterator();
     }
 
     void handleOffStream(EventSequence& result, const msecs_t nextMsecs)
     {
-        if (m_offStreamEvents.empty() || m_currentOffSequenceIt == m_offStreamEvents.cend()) {
+        if (m_currentOffSequenceIdx >= m_offStreamEvents.size()) {
             return;
         }
 
-        if (m_currentOffSequenceIt->first <= nextMsecs) {
-            result = m_currentOffSequenceIt->second;
-            m_currentOffSequenceIt = m_offStreamEvents.erase(m_currentOffSequenceIt);
+        size_t groupEnd = m_offStreamEvents.groupEnd(m_currentOffSequenceIdx);
+
+        if (m_offStreamEvents.at(m_currentOffSequenceIdx).timestamp <= nextMsecs) {
+            m_offStreamEvents.copyTo(m_currentOffSequenceIdx, groupEnd, result);
+            m_currentOffSequenceIdx = groupEnd;
         } else {
-            auto node = m_offStreamEvents.extract(m_currentOffSequenceIt);
-            node.key() -= nextMsecs;
-            m_offStreamEvents.insert(std::move(node));
-            updateOffSequenceIterator();
+            m_offStreamEvents.shift(m_currentOffSequenceIdx, groupEnd, nextMsecs);
         }
     }
 
     void handleMainStream(EventSequence& result)
     {
-        if (m_currentMainSequenceIt->first <= m_playbackPosition) {
-            result.insert(m_currentMainSequenceIt->second.cbegin(),
-                          m_currentMainSequenceIt->second.cend());
-
-            m_currentMainSequenceIt = std::next(m_currentMainSequenceIt);
+        if (m_mainStreamEvents.at(m_currentMainSequenceIdx).timestamp <= m_playbackPosition) {
+            size_t groupEnd = m_mainStreamEvents.groupEnd(m_currentMainSequenceIdx);
+            m_mainStreamEvents.copyTo(m_currentMainSequenceIdx, groupEnd, result);
+            m_currentMainSequenceIdx = groupEnd;
         }
     }
 
     void handleDynamicChanges(EventSequence& result)
     {
-        if (m_dynamicEvents.empty() || m_currentDynamicsIt == m_dynamicEvents.cend()) {
+        if (m_currentDynamicsIdx >= m_dynamicEvents.size()) {
             return;
         }
 
-        if (m_currentDynamicsIt->first <= m_playbackPosition) {
-            result.insert(m_currentDynamicsIt->second.cbegin(),
-                          m_currentDynamicsIt->second.cend());
+        if (m_dynamicEvents.at(m_currentDynamicsIdx).timestamp <= m_playbackPosition) {
+            size_t groupEnd = m_dynamicEvents.groupEnd(m_currentDynamicsIdx);
+            m_dynamicEvents.copyTo(m_currentDynamicsIdx, groupEnd, result);
+            m_currentDynamicsIdx = groupEnd;
+        }
+    }
+
+    void resetOriginSpan()
+    {
+        m_maxOriginLead = 0;
+        m_maxOriginTail = 0;
+
+        msecs_t from = 0;
+        msecs_t to = 0;
 
-            m_currentDynamicsIt = std::next(m_currentDynamicsIt);
+        for (const auto& pair : m_mainStreamOrigin) {
+            expandOriginSpan(pair.first, pair.second, from, to);
+        }
+    }
+
+    //! NOTE Expands [from, to] by the time span of the events produced by the given origin events
+    //!      and keeps track of how far those events might lie from their origin timestamp
+    void expandOriginSpan(const mpe::timestamp_t timestamp, const mpe::PlaybackEventList& events, msecs_t& from, msecs_t& to)
+    {
+        for (const mpe::PlaybackEvent& event : events) {
+            if (!std::holds_alternative<mpe::NoteEvent>(event)) {
+                continue;
+            }
+
+            const mpe::NoteEvent& noteEvent = std::get<mpe::NoteEvent>(event);
+            const mpe::ArrangementContext& arrangementCtx = noteEvent.arrangementCtx();
+
+            msecs_t eventFrom = arrangementCtx.actualTimestamp;
+            msecs_t eventTo = arrangementCtx.actualTimestamp + arrangementCtx.actualDuration;
+
+            for (const auto& pair : noteEvent.expressionCtx().articulations) {
+                const mpe::ArticulationMeta& meta = pair.second.meta;
+                eventTo = std::max(eventTo, meta.timestamp + meta.overallDuration);
+            }
+
+            from = std::min(from, eventFrom);
+            to = std::max(to, eventTo);
+
+            m_maxOriginLead = std::max(m_maxOriginLead, timestamp - eventFrom);
+            m_maxOriginTail = std::max(m_maxOriginTail, eventTo - timestamp);
         }
     }
 
     mutable msecs_t m_playbackPosition = 0;
 
-    SequenceIterator m_currentMainSequenceIt;
-    SequenceIterator m_currentOffSequenceIt;
-    SequenceIterator m_currentDynamicsIt;
+    size_t m_currentMainSequenceIdx = 0;
+    size_t m_currentOffSequenceIdx = 0;
+    size_t m_currentDynamicsIdx = 0;
+
+    mpe::PlaybackEventsMap m_mainStreamOrigin;
+    msecs_t m_maxOriginLead = 0;
+    msecs_t m_maxOriginTail = 0;
 
-    EventSequenceMap m_mainStreamEvents;
-    EventSequenceMap m_offStreamEvents;
-    EventSequenceMap m_dynamicEvents;
+    Timeline m_mainStreamEvents;
+    Timeline m_offStreamEvents;
+    Timeline m_dynamicEvents;
+    Timeline m_patchEvents;
 
     mpe::DynamicLevelMap m_dynamicLevelMap;
 
@@ -21,6 +21,8 @@
  */
 #include "audiobuffer.h"
 
+#include <algorithm>
+
 #include "audiosanitizer.h"
 #include "log.h"
 
@@ -28,6 +30,7 @@ using namespace muse::audio;
 
 static constexpr size_t DEFAULT_SIZE_PER_CHANNEL = 1024 * 8;
 static constexpr size_t DEFAULT_SIZE = DEFAULT_SIZE_PER_CHANNEL * 2;
+static constexpr size_t SAMPLES_TO_RESERVE = DEFAULT_SIZE / 2;
 
 static const std::vector<float> SILENT_FRAMES(DEFAULT_SIZE, 0.f);
 
@@ -114,6 +117,8 @@ void AudioBuffer::init(const audioch_t audioChannelsCount, const samples_t rende
     m_renderStep = renderStep;
 
     m_data.resize(m_samplesPerChannel * m_audioChannelsCount, 0.f);
+
+    updateLowWatermark();
 }
 
 void AudioBuffer::setSource(std::shared_ptr<IAudioSource> source)
@@ -139,9 +144,7 @@ void AudioBuffer::forward()
     const auto currentReadIdx = m_readIndex.load(std::memory_order_acquire);
     size_t nextWriteIdx = currentWriteIdx;
 
-    samples_t framesToReserve = DEFAULT_SIZE / 2;
-
-    while (reservedFrames(nextWriteIdx, currentReadIdx) < framesToReserve) {
+    while (reservedFrames(nextWriteIdx, currentReadIdx) < SAMPLES_TO_RESERVE) {
         m_source->process(m_data.data() + nextWriteIdx, m_renderStep);
 
         nextWriteIdx = incrementWriteIndex(nextWriteIdx, m_renderStep);
@@ -156,6 +159,11 @@ void AudioBuffer::pop(float* dest, size_t sampleCount)
     const auto currentWriteIdx = m_writeIndex.load(std::memory_order_acquire);
     if (currentReadIdx == currentWriteIdx) { // empty queue
         std::memcpy(dest, SILENT_FRAMES.data(), sampleCount * sizeof(float) * m_audioChannelsCount);
+
+        if (m_onDataRequested) {
+            m_onDataRequested();
+        }
+
         return;
     }
 
@@ -189,6 +197,10 @@ void AudioBuffer::pop(float* dest, size_t sampleCount)
     }
 
     m_readIndex.store(newReadIdx, std::memory_order_release);
+
+    if (m_onDataRequested && reservedFrames(currentWriteIdx, newReadIdx) < m_lowWatermark.load(std::memory_order_relaxed)) {
+        m_onDataRequested();
+    }
 }
 
 void AudioBuffer::setMinSamplesToReserve(size_t lag)
@@ -197,6 +209,22 @@ void AudioBuffer::setMinSamplesToReserve(size_t lag)
         lag = DEFAULT_SIZE;
     }
     m_minSamplesToReserve = lag;
+
+    updateLowWatermark();
+}
+
+void AudioBuffer::updateLowWatermark()
+{
+    //! NOTE: The worker is woken up when the reserve drops below the watermark: half of the reserve by default,
+    //! so that it refills several driver buffers at once, but never less than two driver reads
+    //! It is read by the driver's callback, while it is set from the worker
+    const size_t lowWatermark = std::clamp(2 * m_minSamplesToReserve * m_audioChannelsCount, SAMPLES_TO_RESERVE / 2, SAMPLES_TO_RESERVE);
+    m_lowWatermark.store(lowWatermark, std::memory_order_relaxed);
+}
+
+void AudioBuffer::setOnDataRequested(const OnDataRequested& f)
+{
+    m_onDataRequested = f;
 }
 
 void AudioBuffer::reset()
@@ -25,6 +25,7 @@
 #include <vector>
 #include <memory>
 #include <atomic>
+#include <functional>
 
 #include "iaudiosource.h"
 #include "audiotypes.h"
@@ -56,13 +57,21 @@ public:
     void pop(float* dest, size_t sampleCount);
     void setMinSamplesToReserve(size_t lag);
 
+    //! NOTE: Called from pop() (i.e. from the driver's callback) when the reserve runs low
+    //! and forward() should be called
+    using OnDataRequested = std::function<void ()>;
+    void setOnDataRequested(const OnDataRequested& f);
+
     void reset();
 
 private:
     size_t reservedFrames(const size_t writeIdx, const size_t readIdx) const;
     size_t incrementWriteIndex(const size_t writeIdx, const samples_t samplesPerChannel);
+    void updateLowWatermark();
 
     size_t m_minSamplesToReserve = 0;
+    std::atomic<size_t> m_lowWatermark = 0;
+    OnDataRequested m_onDataRequested;
 
     alignas(cache_line_size) std::atomic<size_t> m_writeIndex = 0;
     alignas(cache_line_size) std::atomic<size_t> m_readIndex = 0;
@@ -21,6 +21,8 @@
  */
 #include "audioconfiguration.h"
 
+#include <thread>
+
 //TODO: remove with global clearing of Q_OS_*** defines
 #include <QtGlobal>
 
@@ -41,6 +43,7 @@ static const Settings::Key AUDIO_API_KEY("audio", "io/audioApi");
 static const Settings::Key AUDIO_OUTPUT_DEVICE_ID_KEY("audio", "io/outputDevice");
 static const Settings::Key AUDIO_BUFFER_SIZE_KEY("audio", "io/bufferSize");
 static const Settings::Key AUDIO_SAMPLE_RATE_KEY("audio", "io/sampleRate");
+static const Settings::Key AUDIO_RENDER_THREAD_COUNT_KEY("audio", "render/threadCount");
 
 static const Settings::Key USER_SOUNDFONTS_PATHS("midi", "application/paths/mySoundfonts");
 
@@ -76,6 +79,8 @@ void AudioConfiguration::init()
         m_driverSampleRateChanged.notify();
     });
 
+    settings()->setDefaultValue(AUDIO_RENDER_THREAD_COUNT_KEY, Val(0));
+
     settings()->setDefaultValue(USER_SOUNDFONTS_PATHS, Val(globalConfiguration()->userDataPath() + "/SoundFonts"));
     settings()->valueChanged(USER_SOUNDFONTS_PATHS).onReceive(nullptr, [this](const Val&) {
         m_soundFontDirsChanged.send(soundFontDirectories());
@@ -163,10 +168,20 @@ async::Notification AudioConfiguration::sampleRateChanged() const
     return m_driverSampleRateChanged;
 }
 
-size_t AudioConfiguration::minTrackCountForMultithreading() const
+size_t AudioConfiguration::renderThreadCount() const
+{
+    int count = settings()->value(AUDIO_RENDER_THREAD_COUNT_KEY).toInt();
+    if (count > 0) {
+        return static_cast<size_t>(count);
+    }
+
+    // Leave the other half of the cores to the UI and the rest of the app
+    return std::max(std::thread::hardware_concurrency() / 2, 1u);
+}
+
+void AudioConfiguration::setRenderThreadCount(size_t count)
 {
-    // Start mutlithreading-processing only when there are more or equal number of tracks
-    return 3;
+    settings()->setSharedValue(AUDIO_RENDER_THREAD_COUNT_KEY, Val(static_cast<int>(count)));
 }
 
 AudioInputParams AudioConfiguration::defaultAudioInputParams() const
@@ -201,6 +216,11 @@ async::Channel<io::paths_t> AudioConfiguration::soundFontDirectoriesChanged() co
     return m_soundFontDirsChanged;
 }
 
+io::path_t AudioConfiguration::soundFontSamplesCachePath() const
+{
+    return globalConfiguration()->userAppDataPath() + "/soundfont_samples_cache";
+}
+
 io::path_t AudioConfiguration::knownAudioPluginsFilePath() const
 {
     return globalConfiguration()->userAppDataPath() + "/known_audio_plugins.json";
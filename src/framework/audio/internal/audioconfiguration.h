@@ -59,7 +59,8 @@ public:
     void setSampleRate(unsigned int sampleRate) override;
     async::Notification sampleRateChanged() const override;
 
-    size_t minTrackCountForMultithreading() const override;
+    size_t renderThreadCount() const override;
+    void setRenderThreadCount(size_t count) override;
 
     // synthesizers
     AudioInputParams defaultAudioInputParams() const override;
@@ -69,6 +70,8 @@ public:
     void setUserSoundFontDirectories(const io::paths_t& paths) override;
     async::Channel<io::paths_t> soundFontDirectoriesChanged() const override;
 
+    io::path_t soundFontSamplesCachePath() const override;
+
     io::path_t knownAudioPluginsFilePath() const override;
 
 private:
@@ -39,6 +39,9 @@ public:
     static void setupWorkerThread();
     static std::thread::id workerThread();
     static bool isWorkerThread();
+
+    //! NOTE: The threads of AudioRenderPool act on behalf of the worker thread
+    static void setupRenderThread();
 };
 }
 
@@ -63,6 +63,8 @@ void AudioThread::stop(const Runnable& onFinished)
 {
     m_onFinished = onFinished;
     m_running = false;
+    wakeup();
+
     if (m_thread) {
         m_thread->join();
     }
@@ -73,12 +75,37 @@ bool AudioThread::isRunning() const
     return m_running;
 }
 
+void AudioThread::wakeup()
+{
+    //! NOTE: The semaphore is signaled once per wakeup of the thread, whatever the number of requests,
+    //! so the driver's callback doesn't make a system call each time it asks for data
+    if (!m_wakeupRequested.exchange(true)) {
+        m_wakeupSemaphore.signal();
+    }
+}
+
+void AudioThread::waitForWakeup()
+{
+    m_wakeupSemaphore.wait();
+
+    //! NOTE: The requests made from now on signal the semaphore again,
+    //! the ones made before are served by the coming iteration of the loop
+    m_wakeupRequested = false;
+}
+
 void AudioThread::main()
 {
     runtime::setThreadName("audio_worker");
 
     AudioThread::ID = std::this_thread::get_id();
 
+    //! NOTE: Instead of polling, the thread sleeps until an event is queued for it
+    //! or the driver asks for more data (see AudioBuffer::setOnDataRequested),
+    //! so it doesn't use any cpu while idle
+    async::onQueuedInvoke([this]() {
+        wakeup();
+    });
+
     if (m_onStart) {
         m_onStart();
     }
@@ -90,9 +117,11 @@ void AudioThread::main()
             m_mainLoopBody();
         }
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        waitForWakeup();
     }
 
+    async::onQueuedInvoke(nullptr);
+
     if (m_onFinished) {
         m_onFinished();
     }
@@ -28,6 +28,8 @@
 #include <atomic>
 #include <functional>
 
+#include "wakeupsemaphore.h"
+
 namespace muse::audio {
 class AudioThread
 {
@@ -43,8 +45,14 @@ public:
     void stop(const Runnable& onFinished = nullptr);
     bool isRunning() const;
 
+    //! NOTE: Makes the thread run the loop body and process the queued events.
+    //! Can be called from any thread, including the driver's callback: it doesn't lock,
+    //! and only signals the semaphore if the thread hasn't been woken up yet
+    void wakeup();
+
 private:
     void main();
+    void waitForWakeup();
 
     Runnable m_onStart = nullptr;
     Runnable m_mainLoopBody = nullptr;
@@ -52,6 +60,9 @@ private:
 
     std::unique_ptr<std::thread> m_thread = nullptr;
     std::atomic<bool> m_running = false;
+
+    WakeupSemaphore m_wakeupSemaphore;
+    std::atomic<bool> m_wakeupRequested = false;
 };
 using AudioThreadPtr = std::shared_ptr<AudioThread>;
 }
@@ -23,7 +23,11 @@
 #ifndef MUSE_AUDIO_AUDIOMATHUTILS_H
 #define MUSE_AUDIO_AUDIOMATHUTILS_H
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <limits>
 
 #include "audiotypes.h"
@@ -44,6 +48,55 @@ inline volume_dbfs_t dbFromSample(const float signalValue)
     return 20 * std::log10(std::abs(signalValue));
 }
 
+//! NOTE: Approximations of log2 and exp2 for the per-block gain computations (dynamics, metering),
+//! the error of the derived decibel values is below 0.002 dB
+inline float fastLog2(const float value)
+{
+    uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    const float exponent = static_cast<float>(static_cast<int>((bits >> 23) & 0xff) - 127);
+
+    bits = (bits & 0x007fffff) | 0x3f800000;
+    float mantissa = 0.f;
+    std::memcpy(&mantissa, &bits, sizeof(mantissa));
+
+    //! NOTE: log2(m) = 2 / ln(2) * atanh((m - 1) / (m + 1)), m in [1, 2)
+    const float t = (mantissa - 1.f) / (mantissa + 1.f);
+    const float t2 = t * t;
+
+    return exponent + 2.8853901f * t * (1.f + t2 * (0.33333333f + t2 * 0.2f));
+}
+
+inline float fastExp2(float value)
+{
+    value = std::clamp(value, -126.f, 126.f);
+
+    const float integral = std::floor(value);
+    const float fraction = value - integral;
+
+    float result = 1.f + fraction * (0.6960656421f + fraction * (0.2244943193f + fraction * 0.0794402845f));
+
+    uint32_t bits = 0;
+    std::memcpy(&bits, &result, sizeof(bits));
+    bits += static_cast<uint32_t>(static_cast<int>(integral)) << 23;
+    std::memcpy(&result, &bits, sizeof(result));
+
+    return result;
+}
+
+inline float fastLinearFromDecibels(const volume_dbfs_t volumeLevelDb)
+{
+    //! NOTE: 10^(db / 20) = 2^(db * log2(10) / 20)
+    return fastExp2(volumeLevelDb * 0.16609640f);
+}
+
+inline volume_dbfs_t fastDbFromSample(const float signalValue)
+{
+    //! NOTE: 20 * log10(x) = 20 * log10(2) * log2(x)
+    return 6.0205999f * fastLog2(std::abs(signalValue));
+}
+
 inline float samplesRootMeanSquare(const float squaredSum, const samples_t sampleCount)
 {
     return std::sqrt(squaredSum / sampleCount);
@@ -59,17 +112,6 @@ inline float sampleReleaseTimeCoefficient(const unsigned int sampleRate, const f
     return std::exp(-std::log(9) / (sampleRate * releaseTimeInSecs));
 }
 
-inline void multiplySamples(float* buffer, const audioch_t& audioChannelsCount,
-                            const audioch_t& audioChannelNumber, const samples_t& samplesPerChannel,
-                            const float& multiplier)
-{
-    for (samples_t i = 0; i < samplesPerChannel; ++i) {
-        int idx = i * audioChannelsCount + audioChannelNumber;
-
-        buffer[idx] *= multiplier;
-    }
-}
-
 template<typename T>
 constexpr T convertFloatSamples(float value)
 {
@@ -22,6 +22,7 @@
 #include "compressor.h"
 
 #include "audiomathutils.h"
+#include "mixkernels.h"
 
 #include "log.h"
 
@@ -66,8 +67,9 @@ volume_db_t Compressor::computeGain(const volume_db_t& logarithmSample) const
     }
 
     if (logarithmSample >= m_softThresholdLower && logarithmSample <= m_softThresholdUpper) {
+        const volume_db_t overshoot = logarithmSample - m_softThresholdUpper;
         return logarithmSample
-               + ((((1 / m_filterConfig.ratio()) - 1) * std::pow(logarithmSample - m_softThresholdUpper, 2))
+               + ((((1 / m_filterConfig.ratio()) - 1) * overshoot * overshoot)
                   / (2 * m_filterConfig.kneeWidth()));
     }
 
@@ -77,7 +79,7 @@ volume_db_t Compressor::computeGain(const volume_db_t& logarithmSample) const
 
 void Compressor::process(const float linearRms, float* buffer, const audioch_t& audioChannelsCount, const samples_t samplesPerChannel)
 {
-    float dbGain = dbFromSample(linearRms);
+    float dbGain = fastDbFromSample(linearRms);
 
     if (dbGain <= m_filterConfig.minimumOperableLevel()) {
         return;
@@ -89,14 +91,12 @@ void Compressor::process(const float linearRms, float* buffer, const audioch_t&
     float dbDiff = computeGain(dbGain) - dbGain;
 
     m_feedbackGain = dbDiff;
-    float gainFact = linearFromDecibels(dbDiff * (1.f + m_feedbackFactor));
+    float gainFact = fastLinearFromDecibels(dbDiff * (1.f + m_feedbackFactor));
 
     float currentGainReduction = std::min(gainFact, m_previousGainReduction);
 
     // apply gain
-    for (audioch_t audioChNum = 0; audioChNum < audioChannelsCount; ++audioChNum) {
-        multiplySamples(buffer, audioChannelsCount, audioChNum, samplesPerChannel, currentGainReduction);
-    }
+    multiplySamples(buffer, currentGainReduction, samplesPerChannel * audioChannelsCount);
 
     m_previousGainReduction = currentGainReduction;
 }
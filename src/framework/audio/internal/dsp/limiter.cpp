@@ -22,6 +22,7 @@
 #include "limiter.h"
 
 #include "audiomathutils.h"
+#include "mixkernels.h"
 
 using namespace muse::audio;
 using namespace muse::audio::dsp;
@@ -63,9 +64,8 @@ volume_db_t Limiter::computeGain(const volume_db_t& logarithmSample) const
     }
 
     if (logarithmSample >= m_filterConfig.softThresholdLower() && logarithmSample <= m_filterConfig.softThresholdUpper()) {
-        return logarithmSample
-               - (std::pow((logarithmSample - m_filterConfig.softThresholdUpper()), 2)
-                  / (2 * m_filterConfig.kneeWidth()));
+        const volume_db_t overshoot = logarithmSample - m_filterConfig.softThresholdUpper();
+        return logarithmSample - (overshoot * overshoot / (2 * m_filterConfig.kneeWidth()));
     }
 
     return m_filterConfig.logarithmicThreshold();
@@ -74,7 +74,7 @@ volume_db_t Limiter::computeGain(const volume_db_t& logarithmSample) const
 void Limiter::process(const float& linearRms, float* buffer, const audioch_t& audioChannelsCount,
                       const samples_t samplesPerChannel)
 {
-    volume_db_t rmsDb = dbFromSample(linearRms);
+    volume_db_t rmsDb = fastDbFromSample(linearRms);
 
     if (rmsDb <= m_filterConfig.minimumOperableLevel()) {
         return;
@@ -91,10 +91,8 @@ void Limiter::process(const float& linearRms, float* buffer, const audioch_t& au
     float makeUpGain = smoothedGain + m_filterConfig.makeUpGain();
 
     // total linear gain
-    float totalLinearGain = linearFromDecibels(makeUpGain);
+    float totalLinearGain = fastLinearFromDecibels(makeUpGain);
 
     // apply linear gain
-    for (audioch_t audioChNum = 0; audioChNum < audioChannelsCount; ++audioChNum) {
-        multiplySamples(buffer, audioChannelsCount, audioChNum, samplesPerChannel, totalLinearGain);
-    }
+    multiplySamples(buffer, totalLinearGain, samplesPerChannel * audioChannelsCount);
 }
@@ -0,0 +1,162 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2021 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUSE_AUDIO_MIXKERNELS_H
+#define MUSE_AUDIO_MIXKERNELS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "internal/fx/reverb/simdtypes.h"
+
+#include "global/realfn.h"
+
+/*
+  Kernels used by the mixer to sum and scale interleaved buffers.
+  They operate on the whole interleaved buffer at once (all the audio channels):
+  a gain which depends on the channel is repeated across the lanes of a vector,
+  which is possible when the number of channels divides the vector size.
+ */
+
+namespace muse::audio::dsp {
+//! NOTE: outBuffer[i] += inBuffer[i]
+//! Returns true if the input buffer contains only null samples
+inline bool mixSamples(float* outBuffer, const float* inBuffer, size_t samplesCount)
+{
+    using namespace muse::audio::fx::simd;
+
+    constexpr size_t STEP = 4;
+    const size_t vectorizedCount = samplesCount - samplesCount % STEP;
+
+    float_x4 peak = 0.f;
+
+    for (size_t i = 0; i < vectorizedCount; i += STEP) {
+        float_x4 in = load_unaligned(inBuffer + i);
+        store_unaligned(outBuffer + i, load_unaligned(outBuffer + i) + in);
+        peak = maximum(peak, absolute(in));
+    }
+
+    const float_x4& p = peak;
+    float maxAbsSample = std::max({ p[0], p[1], p[2], p[3] });
+
+    for (size_t i = vectorizedCount; i < samplesCount; ++i) {
+        outBuffer[i] += inBuffer[i];
+        maxAbsSample = std::max(maxAbsSample, std::fabs(inBuffer[i]));
+    }
+
+    return RealIsNull(maxAbsSample);
+}
+
+//! NOTE: outBuffer[i] += inBuffer[i] * gain
+inline void mixSamplesWithGain(float* outBuffer, const float* inBuffer, float gain, size_t samplesCount)
+{
+    using namespace muse::audio::fx::simd;
+
+    constexpr size_t STEP = 4;
+    const size_t vectorizedCount = samplesCount - samplesCount % STEP;
+
+    const float_x4 gainVec = gain;
+
+    for (size_t i = 0; i < vectorizedCount; i += STEP) {
+        float_x4 in = load_unaligned(inBuffer + i);
+        store_unaligned(outBuffer + i, load_unaligned(outBuffer + i) + in * gainVec);
+    }
+
+    for (size_t i = vectorizedCount; i < samplesCount; ++i) {
+        outBuffer[i] += inBuffer[i] * gain;
+    }
+}
+
+//! NOTE: buffer[i] *= gain
+inline void multiplySamples(float* buffer, float gain, size_t samplesCount)
+{
+    using namespace muse::audio::fx::simd;
+
+    constexpr size_t STEP = 4;
+    const size_t vectorizedCount = samplesCount - samplesCount % STEP;
+
+    const float_x4 gainVec = gain;
+
+    for (size_t i = 0; i < vectorizedCount; i += STEP) {
+        store_unaligned(buffer + i, load_unaligned(buffer + i) * gainVec);
+    }
+
+    for (size_t i = vectorizedCount; i < samplesCount; ++i) {
+        buffer[i] *= gain;
+    }
+}
+
+//! NOTE: buffer[i] *= channelGains[channel of i], the squares of the results are added to channelSquaredSums[channel of i]
+//! Returns the maximum absolute value of the results
+inline float applyChannelGains(float* buffer, size_t channelsCount, size_t samplesPerChannel, const float* channelGains,
+                               float* channelSquaredSums)
+{
+    using namespace muse::audio::fx::simd;
+
+    constexpr size_t STEP = 4;
+    const size_t samplesCount = samplesPerChannel * channelsCount;
+
+    size_t vectorizedCount = 0;
+    float maxAbsSample = 0.f;
+
+    if (channelsCount > 0 && STEP % channelsCount == 0) {
+        vectorizedCount = samplesCount - samplesCount % STEP;
+
+        const float_x4 gainVec = { channelGains[0 % channelsCount], channelGains[1 % channelsCount],
+                                   channelGains[2 % channelsCount], channelGains[3 % channelsCount] };
+
+        float_x4 squaredSums = 0.f;
+        float_x4 peak = 0.f;
+
+        for (size_t i = 0; i < vectorizedCount; i += STEP) {
+            float_x4 result = load_unaligned(buffer + i) * gainVec;
+            store_unaligned(buffer + i, result);
+
+            squaredSums = squaredSums + result * result;
+            peak = maximum(peak, absolute(result));
+        }
+
+        const float_x4& sums = squaredSums;
+        for (size_t lane = 0; lane < STEP; ++lane) {
+            channelSquaredSums[lane % channelsCount] += sums[lane];
+        }
+
+        const float_x4& p = peak;
+        maxAbsSample = std::max({ p[0], p[1], p[2], p[3] });
+    }
+
+    for (size_t i = vectorizedCount; i < samplesCount; ++i) {
+        const size_t channel = i % channelsCount;
+
+        float result = buffer[i] * channelGains[channel];
+        buffer[i] = result;
+
+        channelSquaredSums[channel] += result * result;
+        maxAbsSample = std::max(maxAbsSample, std::fabs(result));
+    }
+
+    return maxAbsSample;
+}
+}
+
+#endif // MUSE_AUDIO_MIXKERNELS_H
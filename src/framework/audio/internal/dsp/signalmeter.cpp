@@ -0,0 +1,103 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "signalmeter.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "audiomathutils.h"
+
+using namespace muse::audio;
+using namespace muse::audio::dsp;
+
+void SignalMeter::setSampleRate(const unsigned int sampleRate)
+{
+    m_samplesPerUpdate = std::max(sampleRate / UPDATES_PER_SECOND, 1u);
+}
+
+float* SignalMeter::beginBlock(const audioch_t audioChannelsCount)
+{
+    //! NOTE: Allocates only when the number of channels changes
+    if (m_audioChannelsCount != audioChannelsCount) {
+        m_audioChannelsCount = audioChannelsCount;
+
+        m_blockSquaredSums.assign(audioChannelsCount, 0.f);
+        m_periodSquaredSums.assign(audioChannelsCount, 0.f);
+        m_rms.assign(audioChannelsCount, 0.f);
+        m_periodSamplesPerChannel = 0;
+    }
+
+    std::fill(m_blockSquaredSums.begin(), m_blockSquaredSums.end(), 0.f);
+
+    return m_blockSquaredSums.data();
+}
+
+bool SignalMeter::endBlock(const samples_t samplesPerChannel)
+{
+    m_blockSamplesPerChannel = samplesPerChannel;
+
+    for (audioch_t audioChNum = 0; audioChNum < m_audioChannelsCount; ++audioChNum) {
+        m_periodSquaredSums[audioChNum] += m_blockSquaredSums[audioChNum];
+    }
+
+    m_periodSamplesPerChannel += samplesPerChannel;
+
+    if (m_periodSamplesPerChannel < m_samplesPerUpdate || m_periodSamplesPerChannel == 0) {
+        return false;
+    }
+
+    for (audioch_t audioChNum = 0; audioChNum < m_audioChannelsCount; ++audioChNum) {
+        m_rms[audioChNum] = samplesRootMeanSquare(m_periodSquaredSums[audioChNum], m_periodSamplesPerChannel);
+    }
+
+    std::fill(m_periodSquaredSums.begin(), m_periodSquaredSums.end(), 0.f);
+    m_periodSamplesPerChannel = 0;
+
+    return true;
+}
+
+void SignalMeter::reset()
+{
+    std::fill(m_periodSquaredSums.begin(), m_periodSquaredSums.end(), 0.f);
+    std::fill(m_rms.begin(), m_rms.end(), 0.f);
+    m_periodSamplesPerChannel = 0;
+}
+
+float SignalMeter::blockRms() const
+{
+    if (m_blockSamplesPerChannel == 0 || m_audioChannelsCount == 0) {
+        return 0.f;
+    }
+
+    float totalSquaredSum = std::accumulate(m_blockSquaredSums.cbegin(), m_blockSquaredSums.cend(), 0.f);
+
+    return samplesRootMeanSquare(totalSquaredSum, m_blockSamplesPerChannel * m_audioChannelsCount);
+}
+
+float SignalMeter::rms(const audioch_t audioChannelNumber) const
+{
+    if (audioChannelNumber >= m_rms.size()) {
+        return 0.f;
+    }
+
+    return m_rms[audioChannelNumber];
+}
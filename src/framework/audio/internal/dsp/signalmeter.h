@@ -0,0 +1,65 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUSE_AUDIO_SIGNALMETER_H
+#define MUSE_AUDIO_SIGNALMETER_H
+
+#include <vector>
+
+#include "audiotypes.h"
+
+namespace muse::audio::dsp {
+//! NOTE: Collects the squared samples of the channels block by block.
+//! The RMS of a block is used by the dynamics processors, while the RMS of every channel
+//! is reported only UPDATES_PER_SECOND times per second: the meters don't need the rate of the audio blocks
+class SignalMeter
+{
+public:
+    static constexpr unsigned int UPDATES_PER_SECOND = 30;
+
+    void setSampleRate(const unsigned int sampleRate);
+
+    //! NOTE: Returns the squared sums of the new block (one per channel, zeroed) to be filled by the caller
+    float* beginBlock(const audioch_t audioChannelsCount);
+
+    //! NOTE: Returns true if the values of the meters are ready, see rms()
+    bool endBlock(const samples_t samplesPerChannel);
+
+    void reset();
+
+    float blockRms() const;
+    float rms(const audioch_t audioChannelNumber) const;
+
+private:
+    samples_t m_samplesPerUpdate = 0;
+
+    audioch_t m_audioChannelsCount = 0;
+    samples_t m_blockSamplesPerChannel = 0;
+    std::vector<float> m_blockSquaredSums;
+
+    samples_t m_periodSamplesPerChannel = 0;
+    std::vector<float> m_periodSquaredSums;
+    std::vector<float> m_rms;
+};
+}
+
+#endif // MUSE_AUDIO_SIGNALMETER_H
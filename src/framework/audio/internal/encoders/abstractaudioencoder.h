@@ -55,7 +55,7 @@ public:
             return false;
         }
 
-        prepareOutputBuffer(totalSamplesNumber);
+        m_totalSamplesNumber = totalSamplesNumber;
 
         return true;
     }
@@ -65,6 +65,9 @@ public:
         return m_format;
     }
 
+    //! NOTE: Encodes the next chunk of interleaved samples. The whole track is passed
+    //! chunk by chunk through consecutive calls, flush() finishes the stream.
+    //! Returns the number of encoded samples, 0 on failure
     virtual size_t encode(samples_t samplesPerChannel, const float* input) = 0;
     virtual size_t flush() = 0;
 
@@ -74,7 +77,7 @@ public:
     }
 
 protected:
-    virtual size_t requiredOutputBufferSize(samples_t totalSamplesNumber) const = 0;
+    virtual size_t requiredOutputBufferSize(samples_t samplesPerChannel) const = 0;
 
     virtual void prepareWriting()
     {
@@ -105,9 +108,13 @@ protected:
         return true;
     }
 
-    virtual void prepareOutputBuffer(const samples_t totalSamplesNumber)
+    //! NOTE: The buffer only grows, so encoding chunks of the same size doesn't allocate
+    virtual void prepareOutputBuffer(const samples_t samplesPerChannel)
     {
-        m_outputBuffer.resize(requiredOutputBufferSize(totalSamplesNumber));
+        size_t requiredSize = requiredOutputBufferSize(samplesPerChannel);
+        if (m_outputBuffer.size() < requiredSize) {
+            m_outputBuffer.resize(requiredSize);
+        }
     }
 
     virtual void closeDestination()
@@ -123,6 +130,7 @@ protected:
     std::vector<unsigned char> m_outputBuffer;
 
     SoundTrackFormat m_format;
+    samples_t m_totalSamplesNumber = 0;
     Progress m_progress;
 
     std::string m_locale;
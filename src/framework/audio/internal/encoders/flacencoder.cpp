@@ -91,7 +91,7 @@ bool FlacEncoder::init(const io::path_t& path, const SoundTrackFormat& format, c
         return false;
     }
 
-    prepareOutputBuffer(totalSamplesNumber);
+    m_totalSamplesNumber = totalSamplesNumber;
 
     return true;
 }
@@ -102,30 +102,22 @@ size_t FlacEncoder::encode(samples_t samplesPerChannel, const float* input)
         return 0;
     }
 
-    size_t result = 0;
-    size_t totalSamplesNumber = samplesPerChannel * m_format.audioChannelsNumber;
-    uint32_t frameSize = 1024;
-    size_t stepSize = frameSize * m_format.audioChannelsNumber;
+    size_t samplesNumber = samplesPerChannel * m_format.audioChannelsNumber;
 
-    std::vector<FLAC__int32> buff(samplesPerChannel * sizeof(float));
-
-    for (size_t i = 0; i < buff.size(); ++i) {
-        buff[i] = static_cast<FLAC__int32>(dsp::convertFloatSamples<FLAC__int16>(input[i]));
+    //! NOTE: The buffer only grows, so encoding chunks of the same size doesn't allocate
+    if (m_intermBuffer.size() < samplesNumber) {
+        m_intermBuffer.resize(samplesNumber);
     }
 
-    std::vector<FLAC__int32> intermBuff(stepSize);
-
-    for (size_t i = 0; i < totalSamplesNumber; i += stepSize) {
-        std::copy(buff.data() + i, buff.data() + i + stepSize, intermBuff.data());
+    for (size_t i = 0; i < samplesNumber; ++i) {
+        m_intermBuffer[i] = static_cast<FLAC__int32>(dsp::convertFloatSamples<FLAC__int16>(input[i]));
+    }
 
-        if (m_flac->process_interleaved(intermBuff.data(), frameSize)) {
-            result += stepSize;
-        } else {
-            break;
-        }
+    if (!m_flac->process_interleaved(m_intermBuffer.data(), static_cast<uint32_t>(samplesPerChannel))) {
+        return 0;
     }
 
-    return result;
+    return samplesNumber;
 }
 
 size_t FlacEncoder::flush()
@@ -134,9 +126,9 @@ size_t FlacEncoder::flush()
     return 0;
 }
 
-size_t FlacEncoder::requiredOutputBufferSize(samples_t totalSamplesNumber) const
+size_t FlacEncoder::requiredOutputBufferSize(samples_t /*samplesPerChannel*/) const
 {
-    return totalSamplesNumber;
+    return 0;
 }
 
 bool FlacEncoder::openDestination(const io::path_t& path)
@@ -37,12 +37,13 @@ public:
     size_t flush() override;
 
 protected:
-    size_t requiredOutputBufferSize(samples_t totalSamplesNumber) const override;
+    size_t requiredOutputBufferSize(samples_t samplesPerChannel) const override;
     bool openDestination(const io::path_t& path) override;
     void closeDestination() override;
 
 private:
     FlacHandler* m_flac = nullptr;
+    std::vector<int32_t> m_intermBuffer;
 };
 }
 
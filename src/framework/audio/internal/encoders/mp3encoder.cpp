@@ -80,30 +80,40 @@ bool Mp3Encoder::init(const io::path_t& path, const SoundTrackFormat& format, co
     return true;
 }
 
-size_t Mp3Encoder::requiredOutputBufferSize(samples_t totalSamplesNumber) const
+size_t Mp3Encoder::requiredOutputBufferSize(samples_t samplesPerChannel) const
 {
-    //!Note See thirdparty/lame/API
+    //!Note See thirdparty/lame/API, the worst case is 1.25 * samplesPerChannel + 7200 bytes
 
-    return totalSamplesNumber;
+    return samplesPerChannel + samplesPerChannel / 4 + 7200;
 }
 
 size_t Mp3Encoder::encode(samples_t samplesPerChannel, const float* input)
 {
-    m_progress.progressChanged.send(0, 100, "");
+    prepareOutputBuffer(samplesPerChannel);
 
     int encodedBytes = lame_encode_buffer_interleaved_ieee_float(m_handler->flags, input, samplesPerChannel,
                                                                  m_outputBuffer.data(),
                                                                  static_cast<int>(m_outputBuffer.size()));
 
-    m_progress.progressChanged.send(50, 100, "");
-    size_t result = std::fwrite(m_outputBuffer.data(), sizeof(unsigned char), encodedBytes, m_fileStream);
-    m_progress.progressChanged.send(100, 100, "");
+    if (encodedBytes < 0) {
+        LOGE() << "lame encoding error: " << encodedBytes;
+        return 0;
+    }
+
+    //! NOTE: Lame may keep the samples for the next frames and output nothing yet, which isn't a failure
+    size_t writtenBytes = std::fwrite(m_outputBuffer.data(), sizeof(unsigned char), encodedBytes, m_fileStream);
+    if (writtenBytes != static_cast<size_t>(encodedBytes)) {
+        LOGE() << "failed to write the encoded audio";
+        return 0;
+    }
 
-    return result;
+    return samplesPerChannel * m_format.audioChannelsNumber;
 }
 
 size_t Mp3Encoder::flush()
 {
+    prepareOutputBuffer(0);
+
     int encodedBytes = lame_encode_flush(m_handler->flags,
                                          m_outputBuffer.data(),
                                          static_cast<int>(m_outputBuffer.size()));
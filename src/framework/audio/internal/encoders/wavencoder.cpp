@@ -87,48 +87,52 @@ size_t WavEncoder::encode(samples_t samplesPerChannel, const float* input)
         return 0;
     }
 
-    WavHeader header;
-    header.chunkSize = 18; // 18 is 2 bytes more to include cbsize field / extension size
-    header.bitsPerSample = 32;
-    header.code = 3; // IEEE_FLOAT = 3, PCM = 1
-    header.audioChannelsNumber = m_format.audioChannelsNumber;
-    header.sampleRate = m_format.sampleRate;
-    header.samplesPerChannel = samplesPerChannel;
+    //! NOTE: The header is written with the expected length and rewritten in flush() if the actual one differs
+    if (!m_headerWritten) {
+        writeHeader(m_totalSamplesNumber);
+        m_headerWritten = true;
+    }
 
-    header.write(m_fileStream);
+    size_t samplesNumber = samplesPerChannel * m_format.audioChannelsNumber;
+    m_fileStream.write(reinterpret_cast<const char*>(input), samplesNumber * sizeof(float));
+    m_samplesPerChannelWritten += samplesPerChannel;
 
-    int total = header.samplesPerChannel;
-    int progressStep = (total * 5) / 100; // every 5%
-    QVector<samples_t> progressValues;
-    for (samples_t sampleIdx = 0; sampleIdx < header.samplesPerChannel;) {
-        progressValues << sampleIdx;
-        sampleIdx += progressStep;
-    }
+    return m_fileStream.good() ? samplesNumber : 0;
+}
 
-    for (samples_t sampleIdx = 0; sampleIdx < header.samplesPerChannel; ++sampleIdx) {
-        for (audioch_t audioChNum = 0; audioChNum < m_format.audioChannelsNumber; ++audioChNum) {
-            int idx = sampleIdx * m_format.audioChannelsNumber + audioChNum;
-            m_fileStream.write(reinterpret_cast<const char*>(input + idx), 4);
-        }
+size_t WavEncoder::flush()
+{
+    if (!m_fileStream.is_open() || !m_headerWritten) {
+        return 0;
+    }
 
-        if (progressValues.contains(sampleIdx)) {
-            m_progress.progressChanged.send(sampleIdx, total, "");
-        }
+    if (m_samplesPerChannelWritten != m_totalSamplesNumber) {
+        m_fileStream.seekp(0);
+        writeHeader(m_samplesPerChannelWritten);
+        m_fileStream.seekp(0, std::ios_base::end);
     }
 
-    return samplesPerChannel * m_format.audioChannelsNumber;
+    m_fileStream.flush();
+
+    return m_samplesPerChannelWritten * m_format.audioChannelsNumber;
 }
 
-size_t WavEncoder::flush()
+void WavEncoder::writeHeader(samples_t samplesPerChannel)
 {
-    NOT_SUPPORTED;
+    WavHeader header;
+    header.chunkSize = 18; // 18 is 2 bytes more to include cbsize field / extension size
+    header.bitsPerSample = 32;
+    header.code = 3; // IEEE_FLOAT = 3, PCM = 1
+    header.audioChannelsNumber = m_format.audioChannelsNumber;
+    header.sampleRate = m_format.sampleRate;
+    header.samplesPerChannel = samplesPerChannel;
 
-    return 0;
+    header.write(m_fileStream);
 }
 
-size_t WavEncoder::requiredOutputBufferSize(samples_t totalSamplesNumber) const
+size_t WavEncoder::requiredOutputBufferSize(samples_t /*samplesPerChannel*/) const
 {
-    return totalSamplesNumber;
+    return 0;
 }
 
 bool WavEncoder::openDestination(const io::path_t& path)
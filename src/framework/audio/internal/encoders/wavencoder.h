@@ -40,7 +40,11 @@ protected:
     void closeDestination() override;
 
 private:
+    void writeHeader(samples_t samplesPerChannel);
+
     std::ofstream m_fileStream;
+    bool m_headerWritten = false;
+    samples_t m_samplesPerChannelWritten = 0;
 };
 }
 
@@ -0,0 +1,176 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUSE_AUDIO_EVENTTIMELINE_H
+#define MUSE_AUDIO_EVENTTIMELINE_H
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "../audiotypes.h"
+
+namespace muse::audio {
+//! NOTE Contiguous storage of the sequencer events sorted by their timestamps
+//!      The events might be added in any order, finalize() sorts them and removes the duplicates
+//!      The storage keeps its capacity when cleared, so rebuilding a timeline of the same size doesn't allocate
+template<class EventType>
+class EventTimeline
+{
+public:
+    struct Entry {
+        msecs_t timestamp = 0;
+        EventType event;
+    };
+
+    using Entries = std::vector<Entry>;
+    using const_iterator = typename Entries::const_iterator;
+
+    void add(const msecs_t timestamp, const EventType& event)
+    {
+        m_entries.push_back({ timestamp, event });
+    }
+
+    void add(const msecs_t timestamp, EventType&& event)
+    {
+        m_entries.push_back({ timestamp, std::move(event) });
+    }
+
+    void finalize()
+    {
+        std::sort(m_entries.begin(), m_entries.end(), &EventTimeline::less);
+        m_entries.erase(std::unique(m_entries.begin(), m_entries.end(), &EventTimeline::equal), m_entries.end());
+    }
+
+    void clear()
+    {
+        m_entries.clear();
+    }
+
+    void reserve(const size_t size)
+    {
+        m_entries.reserve(size);
+    }
+
+    bool empty() const
+    {
+        return m_entries.empty();
+    }
+
+    size_t size() const
+    {
+        return m_entries.size();
+    }
+
+    const Entry& at(const size_t idx) const
+    {
+        return m_entries[idx];
+    }
+
+    const_iterator begin() const
+    {
+        return m_entries.cbegin();
+    }
+
+    const_iterator end() const
+    {
+        return m_entries.cend();
+    }
+
+    //! NOTE Index of the first event at or after the timestamp
+    size_t lowerBound(const msecs_t timestamp) const
+    {
+        auto it = std::lower_bound(m_entries.cbegin(), m_entries.cend(), timestamp, [](const Entry& entry, const msecs_t value) {
+            return entry.timestamp < value;
+        });
+
+        return std::distance(m_entries.cbegin(), it);
+    }
+
+    //! NOTE Index of the first event after the timestamp
+    size_t upperBound(const msecs_t timestamp) const
+    {
+        auto it = std::upper_bound(m_entries.cbegin(), m_entries.cend(), timestamp, [](const msecs_t value, const Entry& entry) {
+            return value < entry.timestamp;
+        });
+
+        return std::distance(m_entries.cbegin(), it);
+    }
+
+    //! NOTE Index right after the events sharing the timestamp of the given one
+    size_t groupEnd(const size_t idx) const
+    {
+        size_t result = idx + 1;
+
+        while (result < m_entries.size() && m_entries[result].timestamp == m_entries[idx].timestamp) {
+            ++result;
+        }
+
+        return result;
+    }
+
+    template<class Container>
+    void copyTo(const size_t from, const size_t to, Container& destination) const
+    {
+        for (size_t i = from; i < to; ++i) {
+            destination.push_back(m_entries[i].event);
+        }
+    }
+
+    //! NOTE Moves the events within [from, to) earlier by the offset
+    void shift(const size_t from, const size_t to, const msecs_t offset)
+    {
+        for (size_t i = from; i < to; ++i) {
+            m_entries[i].timestamp -= offset;
+        }
+    }
+
+    //! NOTE Replaces the events within [from, to] by the ones of the source within the same range
+    void replaceRange(const msecs_t from, const msecs_t to, const EventTimeline& source)
+    {
+        auto sourceBegin = source.m_entries.cbegin() + source.lowerBound(from);
+        auto sourceEnd = source.m_entries.cbegin() + source.upperBound(to);
+
+        auto it = m_entries.erase(m_entries.cbegin() + lowerBound(from), m_entries.cbegin() + upperBound(to));
+        m_entries.insert(it, sourceBegin, sourceEnd);
+    }
+
+private:
+    static bool less(const Entry& first, const Entry& second)
+    {
+        if (first.timestamp != second.timestamp) {
+            return first.timestamp < second.timestamp;
+        }
+
+        return std::less<EventType> {}(first.event, second.event);
+    }
+
+    static bool equal(const Entry& first, const Entry& second)
+    {
+        return !less(first, second) && !less(second, first);
+    }
+
+    Entries m_entries;
+};
+}
+
+#endif // MUSE_AUDIO_EVENTTIMELINE_H
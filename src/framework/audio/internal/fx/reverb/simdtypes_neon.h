@@ -139,6 +139,28 @@ __finl float_x4 __vecc operator*(float_x4 a, float_x4 b)
 {
     return vmulq_f32(a.s, b.s);
 }
+
+/// loads 4 consecutive floats, the pointer doesn't need to be aligned
+__finl float_x4 __vecc load_unaligned(const float* p)
+{
+    return vld1q_f32(p);
+}
+
+/// stores 4 consecutive floats, the pointer doesn't need to be aligned
+__finl void __vecc store_unaligned(float* p, float_x4 a)
+{
+    vst1q_f32(p, a.s);
+}
+
+__finl float_x4 __vecc absolute(float_x4 a)
+{
+    return vabsq_f32(a.s);
+}
+
+__finl float_x4 __vecc maximum(float_x4 a, float_x4 b)
+{
+    return vmaxq_f32(a.s, b.s);
+}
 } // namespace muse::audio::fx
 
 #endif // MUSE_AUDIO_SIMDTYPES_NEON_H
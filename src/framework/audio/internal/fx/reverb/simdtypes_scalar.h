@@ -83,6 +83,31 @@ __finl float_x4 __vecc operator*(float_x4 a, float_x4 b)
 {
     return { a[0] * b[0], a[1] * b[1], a[2] * b[2], a[3] * b[3] };
 }
+
+/// loads 4 consecutive floats, the pointer doesn't need to be aligned
+__finl float_x4 __vecc load_unaligned(const float* p)
+{
+    return { p[0], p[1], p[2], p[3] };
+}
+
+/// stores 4 consecutive floats, the pointer doesn't need to be aligned
+__finl void __vecc store_unaligned(float* p, float_x4 a)
+{
+    p[0] = a[0];
+    p[1] = a[1];
+    p[2] = a[2];
+    p[3] = a[3];
+}
+
+__finl float_x4 __vecc absolute(float_x4 a)
+{
+    return { std::fabs(a[0]), std::fabs(a[1]), std::fabs(a[2]), std::fabs(a[3]) };
+}
+
+__finl float_x4 __vecc maximum(float_x4 a, float_x4 b)
+{
+    return { std::max(a[0], b[0]), std::max(a[1], b[1]), std::max(a[2], b[2]), std::max(a[3], b[3]) };
+}
 } // namespace muse::audio::fx
 
 #endif // MUSE_AUDIO_SIMDTYPES_SCALAR_H
@@ -134,6 +134,28 @@ __finl float_x4 __vecc operator*(float_x4 a, float_x4 b)
 {
     return _mm_mul_ps(a.s, b.s);
 }
+
+/// loads 4 consecutive floats, the pointer doesn't need to be aligned
+__finl float_x4 __vecc load_unaligned(const float* p)
+{
+    return _mm_loadu_ps(p);
+}
+
+/// stores 4 consecutive floats, the pointer doesn't need to be aligned
+__finl void __vecc store_unaligned(float* p, float_x4 a)
+{
+    _mm_storeu_ps(p, a.s);
+}
+
+__finl float_x4 __vecc absolute(float_x4 a)
+{
+    return _mm_andnot_ps(_mm_set1_ps(-0.f), a.s);
+}
+
+__finl float_x4 __vecc maximum(float_x4 a, float_x4 b)
+{
+    return _mm_max_ps(a.s, b.s);
+}
 } // namespace muse::audio::fx
 
 #endif // MUSE_AUDIO_SIMDTYPES_SSE2_H
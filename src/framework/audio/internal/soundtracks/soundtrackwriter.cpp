@@ -22,7 +22,20 @@
 
 #include "soundtrackwriter.h"
 
+#include <chrono>
+#include <cstdio>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#endif
+
 #include "global/defer.h"
+#include "global/concurrency/taskscheduler.h"
 
 #include "internal/worker/audioengine.h"
 #include "internal/encoders/mp3encoder.h"
@@ -38,8 +51,49 @@ using namespace muse;
 using namespace muse::audio;
 using namespace muse::audio::soundtrack;
 
-static constexpr int PREPARE_STEP = 0;
-static constexpr int ENCODE_STEP = 1;
+//! NOTE: The size of the chunks passed to the encoder, about 0.75 sec with the default render step.
+//! Only two chunks are kept in memory, whatever the duration of the track
+static constexpr samples_t RENDER_STEPS_PER_CHUNK = 64;
+
+//! NOTE: The current RSS of the process, it is sampled while exporting.
+//! The peak RSS reported by the system covers the whole lifetime of the process, not the export
+static size_t residentSetSizeKb()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.WorkingSetSize / 1024;
+    }
+
+    return 0;
+#elif defined(__APPLE__)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS) {
+        return 0;
+    }
+
+    return info.resident_size / 1024;
+#elif defined(__linux__)
+    FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (!statm) {
+        return 0;
+    }
+
+    long totalPages = 0;
+    long residentPages = 0;
+    const int count = std::fscanf(statm, "%ld %ld", &totalPages, &residentPages);
+    std::fclose(statm);
+
+    if (count != 2) {
+        return 0;
+    }
+
+    return static_cast<size_t>(residentPages) * static_cast<size_t>(sysconf(_SC_PAGESIZE)) / 1024;
+#else
+    return 0;
+#endif
+}
 
 SoundTrackWriter::SoundTrackWriter(const io::path_t& destination, const SoundTrackFormat& format, const msecs_t totalDuration,
                                    IAudioSourcePtr source)
@@ -49,9 +103,15 @@ SoundTrackWriter::SoundTrackWriter(const io::path_t& destination, const SoundTra
         return;
     }
 
-    samples_t totalSamplesNumber = (totalDuration / 1000000.f) * sizeof(float) * format.sampleRate;
-    m_inputBuffer.resize(totalSamplesNumber);
-    m_intermBuffer.resize(config()->renderStep() * config()->audioChannelsCount());
+    samples_t renderStep = config()->renderStep();
+    audioch_t audioChannelsCount = config()->audioChannelsCount();
+
+    m_totalSamplesPerChannel = (totalDuration / 1000000.f) * format.sampleRate;
+    m_intermBuffer.resize(renderStep * audioChannelsCount);
+
+    for (std::vector<float>& chunk : m_chunks) {
+        chunk.resize(RENDER_STEPS_PER_CHUNK * renderStep * audioChannelsCount);
+    }
 
     m_encoderPtr = createEncoder(format.type);
 
@@ -59,10 +119,7 @@ SoundTrackWriter::SoundTrackWriter(const io::path_t& destination, const SoundTra
         return;
     }
 
-    m_encoderPtr->init(destination, format, totalSamplesNumber);
-    m_encoderPtr->progress().progressChanged.onReceive(this, [this](int64_t current, int64_t total, std::string) {
-        sendStepProgress(ENCODE_STEP, current, total);
-    });
+    m_encoderPtr->init(destination, format, m_totalSamplesPerChannel);
 }
 
 Ret SoundTrackWriter::write()
@@ -89,20 +146,21 @@ Ret SoundTrackWriter::write()
         m_isAborted = false;
     };
 
-    Ret ret = generateAudioData();
+    auto startTime = std::chrono::steady_clock::now();
+    m_startRssKb = residentSetSizeKb();
+    m_peakRssKb = m_startRssKb;
+
+    Ret ret = generateAndEncodeAudioData();
     if (!ret) {
         return ret;
     }
 
-    size_t bytes = m_encoderPtr->encode(m_inputBuffer.size() / sizeof(float), m_inputBuffer.data());
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+    double audioDurationSecs = static_cast<double>(m_totalSamplesPerChannel) / m_encoderPtr->format().sampleRate;
 
-    if (m_isAborted) {
-        return make_ret(Ret::Code::Cancel);
-    }
-
-    if (bytes == 0) {
-        return make_ret(Err::ErrorEncode);
-    }
+    LOGI() << "Rendered " << audioDurationSecs << " sec of audio in " << elapsed.count() << " sec"
+           << " (" << audioDurationSecs / std::max(elapsed.count(), 1e-6) << "x realtime)"
+           << ", RSS: " << m_startRssKb / 1024 << " MB before, " << m_peakRssKb / 1024 << " MB at peak";
 
     return muse::make_ok();
 }
@@ -131,46 +189,96 @@ encode::AbstractAudioEncoderPtr SoundTrackWriter::createEncoder(const SoundTrack
     return nullptr;
 }
 
-Ret SoundTrackWriter::generateAudioData()
+Ret SoundTrackWriter::generateAndEncodeAudioData()
 {
     TRACEFUNC;
 
-    size_t inputBufferOffset = 0;
-    size_t inputBufferMaxOffset = m_inputBuffer.size();
+    if (m_totalSamplesPerChannel == 0) {
+        LOGI() << "No audio to export";
+        return make_ret(Err::NoAudioToExport);
+    }
 
-    sendStepProgress(PREPARE_STEP, inputBufferOffset, inputBufferMaxOffset);
+    //! NOTE: The chunks are encoded in the background while the next one is being rendered,
+    //! the tracks themselves are rendered in parallel by the mixer in the offline mode
+    const samples_t chunkSamplesPerChannel = m_chunks[0].size() / config()->audioChannelsCount();
 
-    samples_t renderStep = config()->renderStep();
+    std::future<size_t> pendingEncoding;
+
+    //! NOTE: An encoder returns 0 when it fails to encode a chunk, the rest of the track isn't worth rendering then
+    auto waitForEncoding = [&pendingEncoding]() {
+        return !pendingEncoding.valid() || pendingEncoding.get() > 0;
+    };
 
-    while (inputBufferOffset < inputBufferMaxOffset && !m_isAborted) {
-        m_source->process(m_intermBuffer.data(), renderStep);
+    bool encoded = true;
 
-        size_t samplesToCopy = std::min(m_intermBuffer.size(), inputBufferMaxOffset - inputBufferOffset);
+    samples_t renderedSamplesPerChannel = 0;
+    size_t chunkIdx = 0;
 
-        std::copy(m_intermBuffer.begin(),
-                  m_intermBuffer.begin() + samplesToCopy,
-                  m_inputBuffer.begin() + inputBufferOffset);
+    sendProgress(renderedSamplesPerChannel, m_totalSamplesPerChannel);
+
+    while (renderedSamplesPerChannel < m_totalSamplesPerChannel && !m_isAborted) {
+        samples_t samplesToRender = std::min(chunkSamplesPerChannel, m_totalSamplesPerChannel - renderedSamplesPerChannel);
+        samples_t renderedSamples = renderChunk(m_chunks[chunkIdx], samplesToRender);
+        m_peakRssKb = std::max(m_peakRssKb, residentSetSizeKb());
+
+        //! NOTE: Encoding of the previous chunk must be finished, the encoder consumes the chunks in order
+        encoded = waitForEncoding();
+        if (!encoded || m_isAborted) {
+            break;
+        }
+
+        const float* chunkData = m_chunks[chunkIdx].data();
+        pendingEncoding = TaskScheduler::instance()->submit([this, renderedSamples, chunkData]() {
+            return m_encoderPtr->encode(renderedSamples, chunkData);
+        });
+
+        chunkIdx = (chunkIdx + 1) % std::size(m_chunks);
+        renderedSamplesPerChannel += renderedSamples;
+
+        sendProgress(renderedSamplesPerChannel, m_totalSamplesPerChannel);
+    }
 
-        inputBufferOffset += samplesToCopy;
-        sendStepProgress(PREPARE_STEP, inputBufferOffset, inputBufferMaxOffset);
+    if (encoded) {
+        encoded = waitForEncoding();
     }
 
     if (m_isAborted) {
         return make_ret(Ret::Code::Cancel);
     }
 
-    if (inputBufferOffset == 0) {
-        LOGI() << "No audio to export";
-        return make_ret(Err::NoAudioToExport);
+    if (!encoded) {
+        LOGE() << "Failed to encode the audio at " << renderedSamplesPerChannel << " of " << m_totalSamplesPerChannel << " samples";
+        return make_ret(Err::ErrorEncode);
     }
 
     return muse::make_ok();
 }
 
-void SoundTrackWriter::sendStepProgress(int step, int64_t current, int64_t total)
+samples_t SoundTrackWriter::renderChunk(std::vector<float>& chunk, samples_t samplesPerChannel)
+{
+    const samples_t renderStep = config()->renderStep();
+    const audioch_t audioChannelsCount = config()->audioChannelsCount();
+
+    samples_t renderedSamples = 0;
+
+    while (renderedSamples < samplesPerChannel && !m_isAborted) {
+        float* destination = chunk.data() + renderedSamples * audioChannelsCount;
+        samples_t samplesToCopy = std::min(renderStep, samplesPerChannel - renderedSamples);
+
+        if (samplesToCopy == renderStep) {
+            m_source->process(destination, renderStep);
+        } else {
+            m_source->process(m_intermBuffer.data(), renderStep);
+            std::copy(m_intermBuffer.begin(), m_intermBuffer.begin() + samplesToCopy * audioChannelsCount, destination);
+        }
+
+        renderedSamples += samplesToCopy;
+    }
+
+    return renderedSamples;
+}
+
+void SoundTrackWriter::sendProgress(int64_t current, int64_t total)
 {
-    int stepRange = step == PREPARE_STEP ? 80 : 20;
-    int stepProgressStart = step == PREPARE_STEP ? 0 : 80;
-    int stepCurrentProgress = stepProgressStart + ((current * 100 / total) * stepRange) / 100;
-    m_progress.progressChanged.send(stepCurrentProgress, 100, "");
+    m_progress.progressChanged.send(current * 100 / total, 100, "");
 }
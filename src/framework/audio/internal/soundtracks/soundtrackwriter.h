@@ -23,6 +23,7 @@
 #ifndef MUSE_AUDIO_SOUNDTRACKWRITER_H
 #define MUSE_AUDIO_SOUNDTRACKWRITER_H
 
+#include <atomic>
 #include <vector>
 
 #include "global/async/asyncable.h"
@@ -47,19 +48,27 @@ public:
 
 private:
     encode::AbstractAudioEncoderPtr createEncoder(const SoundTrackType& type) const;
-    Ret generateAudioData();
+    Ret generateAndEncodeAudioData();
+    samples_t renderChunk(std::vector<float>& chunk, samples_t samplesPerChannel);
 
-    void sendStepProgress(int step, int64_t current, int64_t total);
+    void sendProgress(int64_t current, int64_t total);
 
     IAudioSourcePtr m_source = nullptr;
 
-    std::vector<float> m_inputBuffer;
+    samples_t m_totalSamplesPerChannel = 0;
+
+    //! NOTE: While one chunk is being encoded, the next one is rendered into the other one
+    std::vector<float> m_chunks[2];
     std::vector<float> m_intermBuffer;
 
     encode::AbstractAudioEncoderPtr m_encoderPtr = nullptr;
 
     Progress m_progress;
     std::atomic<bool> m_isAborted = false;
+
+    //! NOTE: The RSS of the process before the export and its peak during the export (sampled after each chunk)
+    size_t m_startRssKb = 0;
+    size_t m_peakRssKb = 0;
 };
 }
 
@@ -23,6 +23,7 @@
 #include "fluidresolver.h"
 
 #include "internal/audiosanitizer.h"
+#include "sfsamplestore.h"
 
 #include "log.h"
 
@@ -35,6 +36,8 @@ FluidResolver::FluidResolver()
 {
     ONLY_AUDIO_WORKER_THREAD;
 
+    SoundFontSampleStore::instance()->init(configuration()->soundFontSamplesCachePath());
+
     refresh();
     soundFontRepository()->soundFontsChanged().onNotify(this, [this]() {
         refresh();
@@ -30,6 +30,7 @@
 #include "global/modularity/ioc.h"
 
 #include "isoundfontrepository.h"
+#include "iaudioconfiguration.h"
 #include "isynthresolver.h"
 #include "fluidsynth.h"
 
@@ -37,6 +38,7 @@ namespace muse::audio::synth {
 class FluidResolver : public ISynthResolver::IResolver, public async::Asyncable
 {
     INJECT(ISoundFontRepository, soundFontRepository)
+    INJECT(IAudioConfiguration, configuration)
 public:
     explicit FluidResolver();
 
@@ -52,7 +52,8 @@ void FluidSequencer::updateOffStreamEvents(const mpe::PlaybackEventsMap& events,
         m_onOffStreamFlushed();
     }
 
-    updatePlaybackEvents(m_offStreamEvents, events);
+    updatePlaybackEvents(m_offStreamEvents, events.cbegin(), events.cend());
+    m_offStreamEvents.finalize();
     updateOffSequenceIterator();
 }
 
@@ -68,10 +69,28 @@ void FluidSequencer::updateMainStreamEvents(const mpe::PlaybackEventsMap& events
         m_onMainStreamFlushed();
     }
 
-    updatePlaybackEvents(m_mainStreamEvents, events);
+    updatePlaybackEvents(m_mainStreamEvents, events.cbegin(), events.cend());
+    m_mainStreamEvents.finalize();
     updateMainSequenceIterator();
 
     updateDynamicEvents(m_dynamicEvents, dynamics);
+    m_dynamicEvents.finalize();
+    updateDynamicChangesIterator();
+}
+
+void FluidSequencer::patchMainStreamEvents(const msecs_t from, const msecs_t to, const mpe::DynamicLevelMap& dynamics,
+                                           const mpe::PlaybackParamMap&)
+{
+    replaceMainStreamRange(from, to, [this](Timeline& destination, PlaybackEventsMap::const_iterator begin,
+                                            PlaybackEventsMap::const_iterator end) {
+        updatePlaybackEvents(destination, begin, end);
+    });
+
+    m_dynamicLevelMap = dynamics;
+
+    m_dynamicEvents.clear();
+    updateDynamicEvents(m_dynamicEvents, dynamics);
+    m_dynamicEvents.finalize();
     updateDynamicChangesIterator();
 }
 
@@ -85,10 +104,11 @@ const ChannelMap& FluidSequencer::channels() const
     return m_channels;
 }
 
-void FluidSequencer::updatePlaybackEvents(EventSequenceMap& destination, const mpe::PlaybackEventsMap& changes)
+void FluidSequencer::updatePlaybackEvents(Timeline& destination, PlaybackEventsMap::const_iterator begin,
+                                          PlaybackEventsMap::const_iterator end)
 {
-    for (const auto& pair : changes) {
-        for (const mpe::PlaybackEvent& event : pair.second) {
+    for (auto it = begin; it != end; ++it) {
+        for (const mpe::PlaybackEvent& event : it->second) {
             if (!std::holds_alternative<mpe::NoteEvent>(event)) {
                 continue;
             }
@@ -109,14 +129,14 @@ void FluidSequencer::updatePlaybackEvents(EventSequenceMap& destination, const m
             noteOn.setVelocity(velocity);
             noteOn.setPitchNote(noteIdx, tuning);
 
-            destination[timestampFrom].emplace(std::move(noteOn));
+            destination.add(timestampFrom, std::move(noteOn));
 
             midi::Event noteOff(Event::Opcode::NoteOff, Event::MessageType::ChannelVoice20);
             noteOff.setChannel(channelIdx);
             noteOff.setNote(noteIdx);
             noteOff.setPitchNote(noteIdx, tuning);
 
-            destination[timestampTo].emplace(std::move(noteOff));
+            destination.add(timestampTo, std::move(noteOff));
 
             appendControlSwitch(destination, noteEvent, PEDAL_CC_SUPPORTED_TYPES, 64);
             appendPitchBend(destination, noteEvent, BEND_SUPPORTED_TYPES, channelIdx);
@@ -124,18 +144,18 @@ void FluidSequencer::updatePlaybackEvents(EventSequenceMap& destination, const m
     }
 }
 
-void FluidSequencer::updateDynamicEvents(EventSequenceMap& destination, const mpe::DynamicLevelMap& changes)
+void FluidSequencer::updateDynamicEvents(Timeline& destination, const mpe::DynamicLevelMap& changes)
 {
     for (const auto& pair : changes) {
         muse::midi::Event event(muse::midi::Event::Opcode::ControlChange, Event::MessageType::ChannelVoice10);
         event.setIndex(muse::midi::EXPRESSION_CONTROLLER);
         event.setData(expressionLevel(pair.second));
 
-        destination[pair.first].emplace(std::move(event));
+        destination.add(pair.first, std::move(event));
     }
 }
 
-void FluidSequencer::appendControlSwitch(EventSequenceMap& destination, const mpe::NoteEvent& noteEvent,
+void FluidSequencer::appendControlSwitch(Timeline& destination, const mpe::NoteEvent& noteEvent,
                                          const mpe::ArticulationTypeSet& appliableTypes, const int midiControlIdx)
 {
     mpe::ArticulationType currentType = mpe::ArticulationType::Undefined;
@@ -155,23 +175,23 @@ void FluidSequencer::appendControlSwitch(EventSequenceMap& destination, const mp
         start.setIndex(midiControlIdx);
         start.setData(127);
 
-        destination[noteEvent.arrangementCtx().actualTimestamp].emplace(std::move(start));
+        destination.add(noteEvent.arrangementCtx().actualTimestamp, std::move(start));
 
         midi::Event end(Event::Opcode::ControlChange, Event::MessageType::ChannelVoice10);
         end.setIndex(midiControlIdx);
         end.setData(0);
 
-        destination[articulationMeta.timestamp + articulationMeta.overallDuration].emplace(std::move(end));
+        destination.add(articulationMeta.timestamp + articulationMeta.overallDuration, std::move(end));
     } else {
         midi::Event cc(Event::Opcode::ControlChange, Event::MessageType::ChannelVoice10);
         cc.setIndex(midiControlIdx);
         cc.setData(0);
 
-        destination[noteEvent.arrangementCtx().actualTimestamp].emplace(std::move(cc));
+        destination.add(noteEvent.arrangementCtx().actualTimestamp, std::move(cc));
     }
 }
 
-void FluidSequencer::appendPitchBend(EventSequenceMap& destination, const mpe::NoteEvent& noteEvent,
+void FluidSequencer::appendPitchBend(Timeline& destination, const mpe::NoteEvent& noteEvent,
                                      const mpe::ArticulationTypeSet& appliableTypes, const channel_t channelIdx)
 {
     mpe::ArticulationType currentType = mpe::ArticulationType::Undefined;
@@ -189,7 +209,7 @@ void FluidSequencer::appendPitchBend(EventSequenceMap& destination, const mpe::N
 
     if (currentType == mpe::ArticulationType::Undefined || noteEvent.pitchCtx().pitchCurve.empty()) {
         event.setData(8192);
-        destination[timestampFrom].emplace(std::move(event));
+        destination.add(timestampFrom, std::move(event));
         return;
     }
 
@@ -203,7 +223,7 @@ void FluidSequencer::appendPitchBend(EventSequenceMap& destination, const mpe::N
         int bendValue = pitchBendLevel(currIt->second);
         timestamp_t time = timestampFrom + duration * percentageToFactor(currIt->first);
         event.setData(bendValue);
-        destination[time].insert(std::move(event));
+        destination.add(time, std::move(event));
         return;
     }
 
@@ -237,7 +257,7 @@ void FluidSequencer::appendPitchBend(EventSequenceMap& destination, const mpe::N
             int bendValue = static_cast<int>(std::round(point.y));
 
             event.setData(bendValue);
-            destination[time].insert(event);
+            destination.add(time, event);
         }
     }
 }
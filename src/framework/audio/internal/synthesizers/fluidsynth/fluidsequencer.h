@@ -41,19 +41,22 @@ public:
     void updateOffStreamEvents(const mpe::PlaybackEventsMap& events, const mpe::PlaybackParamMap& params) override;
     void updateMainStreamEvents(const mpe::PlaybackEventsMap& events, const mpe::DynamicLevelMap& dynamics,
                                 const mpe::PlaybackParamMap& params) override;
+    void patchMainStreamEvents(const msecs_t from, const msecs_t to, const mpe::DynamicLevelMap& dynamics,
+                               const mpe::PlaybackParamMap& params) override;
 
     async::Channel<midi::channel_t, midi::Program> channelAdded() const;
 
     const ChannelMap& channels() const;
 
 private:
-    void updatePlaybackEvents(EventSequenceMap& destination, const mpe::PlaybackEventsMap& changes);
-    void updateDynamicEvents(EventSequenceMap& destination, const mpe::DynamicLevelMap& changes);
+    void updatePlaybackEvents(Timeline& destination, mpe::PlaybackEventsMap::const_iterator begin,
+                              mpe::PlaybackEventsMap::const_iterator end);
+    void updateDynamicEvents(Timeline& destination, const mpe::DynamicLevelMap& changes);
 
-    void appendControlSwitch(EventSequenceMap& destination, const mpe::NoteEvent& noteEvent, const mpe::ArticulationTypeSet& appliableTypes,
+    void appendControlSwitch(Timeline& destination, const mpe::NoteEvent& noteEvent, const mpe::ArticulationTypeSet& appliableTypes,
                              const int midiControlIdx);
 
-    void appendPitchBend(EventSequenceMap& destination, const mpe::NoteEvent& noteEvent, const mpe::ArticulationTypeSet& appliableTypes,
+    void appendPitchBend(Timeline& destination, const mpe::NoteEvent& noteEvent, const mpe::ArticulationTypeSet& appliableTypes,
                          const midi::channel_t channelIdx);
 
     midi::channel_t channel(const mpe::NoteEvent& noteEvent) const;
@@ -333,13 +333,13 @@ samples_t FluidSynth::process(float* buffer, samples_t samplesPerChannel)
     }
 
     msecs_t nextMsecs = samplesToMsecs(samplesPerChannel, m_sampleRate);
-    FluidSequencer::EventSequence sequence = m_sequencer.eventsToBePlayed(nextMsecs);
+    m_sequencer.eventsToBePlayed(nextMsecs, m_eventsToBePlayed);
 
-    if (!sequence.empty()) {
+    if (!m_eventsToBePlayed.empty()) {
         m_tuning.reset();
     }
 
-    for (const FluidSequencer::EventType& event : sequence) {
+    for (const FluidSequencer::EventType& event : m_eventsToBePlayed) {
         handleEvent(std::get<midi::Event>(event));
     }
 
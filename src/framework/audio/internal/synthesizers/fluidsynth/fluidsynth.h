@@ -109,6 +109,7 @@ private:
     async::Channel<unsigned int> m_streamsCountChanged;
 
     FluidSequencer m_sequencer;
+    FluidSequencer::EventSequence m_eventsToBePlayed;
     std::set<io::path_t> m_sfontPaths;
     std::optional<midi::Program> m_preset;
 
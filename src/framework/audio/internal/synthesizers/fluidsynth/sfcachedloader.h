@@ -24,15 +24,17 @@
 #define MUSE_AUDIO_SFCACHEDLOADER_H
 
 #include <cstdio>
+#include <cstring>
 
 #include <sfloader/fluid_sfont.h>
 #include <sfloader/fluid_defsfont.h>
 
+#include "sfsamplestore.h"
+
 namespace muse::audio::synth {
 struct SoundFontData
 {
     fluid_sfont_t* soundFontPtr = nullptr;
-    std::FILE* fileStream = nullptr;
 };
 
 struct SoundFontCache : public std::map<std::string, SoundFontData> {
@@ -54,55 +56,73 @@ private:
             }
 
             delete_fluid_sfont(pair.second.soundFontPtr);
-
-            if (pair.second.fileStream) {
-                std::fclose(pair.second.fileStream);
-            }
         }
     }
 };
 
-void* openSoundFont(const char* filename)
+//! NOTE: The soundfont files are read from their memory mapping (shared by all the Fluid instances),
+//!       every opened handle has its own position, so the handles can be used from different threads
+struct SoundFontReader
 {
-    auto search = SoundFontCache::instance()->find(filename);
+    std::shared_ptr<const io::MappedFile> file;
+    size_t position = 0;
+};
 
-    if (search != SoundFontCache::instance()->cend()
-        && search->second.fileStream) {
-        return search->second.fileStream;
+void* openSoundFont(const char* filename)
+{
+    std::shared_ptr<const io::MappedFile> file = SoundFontSampleStore::instance()->soundFontFile(filename);
+    if (!file) {
+        return nullptr;
     }
 
-    std::FILE* stream = std::fopen(filename, "r");
-
-    SoundFontData sfData;
-    sfData.fileStream = stream;
-
-    SoundFontCache::instance()->emplace(filename, std::move(sfData));
-
-    return stream;
+    return new SoundFontReader { std::move(file), 0 };
 }
 
 int readSoundFont(void* buf, fluid_long_long_t count, void* handle)
 {
-    return static_cast<int>(std::fread(buf, count, 1, static_cast<std::FILE*>(handle)));
+    SoundFontReader* reader = static_cast<SoundFontReader*>(handle);
+
+    if (count < 0 || reader->position + static_cast<size_t>(count) > reader->file->size()) {
+        return FLUID_FAILED;
+    }
+
+    std::memcpy(buf, reader->file->data() + reader->position, static_cast<size_t>(count));
+    reader->position += static_cast<size_t>(count);
+
+    return FLUID_OK;
 }
 
 int seekSoundFont(void* handle, fluid_long_long_t offset, int origin)
 {
-    return std::fseek(static_cast<std::FILE*>(handle), offset, origin);
+    SoundFontReader* reader = static_cast<SoundFontReader*>(handle);
+
+    fluid_long_long_t newPosition = offset;
+    if (origin == SEEK_CUR) {
+        newPosition += static_cast<fluid_long_long_t>(reader->position);
+    } else if (origin == SEEK_END) {
+        newPosition += static_cast<fluid_long_long_t>(reader->file->size());
+    }
+
+    if (newPosition < 0 || static_cast<size_t>(newPosition) > reader->file->size()) {
+        return FLUID_FAILED;
+    }
+
+    reader->position = static_cast<size_t>(newPosition);
+
+    return FLUID_OK;
 }
 
-int closeSoundFont(void* /*handle*/)
+int closeSoundFont(void* handle)
 {
-    //!Note Prevent closing of sound-font files by Fluid instances,
-    //!     instead the actual closing of cached sound-font files will happen in SoundFontCache.
-    //!     However, we still need to provide "some" callback for Fluid's API
+    //!Note The mapping of the file is closed if no loaded sample points into it (see SoundFontSampleStore)
+    delete static_cast<SoundFontReader*>(handle);
 
     return FLUID_OK;
 }
 
 fluid_long_long_t tellSoundFont(void* handle)
 {
-    return std::ftell(static_cast<std::FILE*>(handle));
+    return static_cast<fluid_long_long_t>(static_cast<SoundFontReader*>(handle)->position);
 }
 
 int deleteSoundFont(fluid_sfont_t* /*sfont*/)
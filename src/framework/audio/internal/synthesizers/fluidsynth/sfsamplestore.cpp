@@ -0,0 +1,475 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "sfsamplestore.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <sstream>
+
+#include <sfloader/fluid_samplecache.h>
+
+#include "log.h"
+
+using namespace muse;
+using namespace muse::audio::synth;
+
+static constexpr char DECODED_SAMPLE_MAGIC[4] = { 'M', 'S', 'F', 'S' };
+static constexpr uint32_t DECODED_SAMPLE_VERSION = 1;
+
+static const std::string DECODED_SAMPLE_SUFFIX = ".pcm";
+static const std::string USED_MARK_SUFFIX = ".used";
+static const std::string TEMP_FILE_SUFFIX = ".tmp";
+
+//! NOTE: The sample words follow the header, its size keeps them aligned
+struct DecodedSampleHeader {
+    char magic[4] = {};
+    uint32_t version = 0;
+    int64_t modificationTime = 0;
+    uint32_t samplePos = 0;
+    uint32_t sampleStart = 0;
+    uint32_t sampleEnd = 0;
+    int32_t sampleCount = 0;
+};
+
+//! NOTE: Unique across the threads and the processes writing to the same cache
+static std::string tempFileSuffix()
+{
+    static const std::string processKey = std::to_string(std::random_device {}());
+    static std::atomic<uint64_t> lastIndex = 0;
+
+    return "." + processKey + "_" + std::to_string(++lastIndex) + TEMP_FILE_SUFFIX;
+}
+
+static bool endsWith(const std::string& str, const std::string& suffix)
+{
+    return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+//! NOTE: The decoded sample files are named <version key>_<start>_<end>.pcm, where the version key is <hash>_<mtime>
+static std::string versionKeyOfFile(const std::string& fileName)
+{
+    if (endsWith(fileName, USED_MARK_SUFFIX)) {
+        return fileName.substr(0, fileName.size() - USED_MARK_SUFFIX.size());
+    }
+
+    size_t hashEnd = fileName.find('_');
+    size_t keyEnd = hashEnd == std::string::npos ? std::string::npos : fileName.find('_', hashEnd + 1);
+
+    return keyEnd == std::string::npos ? std::string() : fileName.substr(0, keyEnd);
+}
+
+static std::string hashOfVersionKey(const std::string& versionKey)
+{
+    return versionKey.substr(0, versionKey.find('_'));
+}
+
+static int loadSampleCallback(void* /*data*/, const char* filename, time_t mtime, unsigned int samplepos, unsigned int samplesize,
+                              unsigned int sample_start, unsigned int sample_end, int sample_type, short** sample_data)
+{
+    return SoundFontSampleStore::instance()->loadSample(filename, mtime, samplepos, samplesize, sample_start, sample_end,
+                                                        sample_type, sample_data);
+}
+
+static void storeSampleCallback(void* /*data*/, const char* filename, time_t mtime, unsigned int samplepos, unsigned int /*samplesize*/,
+                                unsigned int sample_start, unsigned int sample_end, int sample_type,
+                                const short* sample_data, int sample_count)
+{
+    SoundFontSampleStore::instance()->storeSample(filename, mtime, samplepos, sample_start, sample_end, sample_type,
+                                                  sample_data, sample_count);
+}
+
+static void releaseSampleCallback(void* /*data*/, const short* sample_data)
+{
+    SoundFontSampleStore::instance()->releaseSample(sample_data);
+}
+
+SoundFontSampleStore* SoundFontSampleStore::instance()
+{
+    static SoundFontSampleStore s;
+    return &s;
+}
+
+void SoundFontSampleStore::init(const io::path_t& decodedSamplesCachePath, uint64_t decodedSamplesCacheMaxSize)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_decodedSamplesCachePath = decodedSamplesCachePath;
+        m_decodedSamplesCacheMaxSize = decodedSamplesCacheMaxSize;
+
+        //! NOTE: Indexed on the first use of the cache
+        m_cacheIndexed = false;
+        m_cachedVersions.clear();
+        m_cachedSize = 0;
+    }
+
+    fluid_samplecache_provider_t provider;
+    provider.data = this;
+    provider.load = loadSampleCallback;
+    provider.store = storeSampleCallback;
+    provider.release = releaseSampleCallback;
+
+    fluid_samplecache_set_provider(&provider);
+}
+
+std::shared_ptr<const io::MappedFile> SoundFontSampleStore::soundFontFile(const std::string& fileName)
+{
+    std::lock_guard lock(m_mutex);
+
+    return soundFontFileLocked(fileName);
+}
+
+std::shared_ptr<const io::MappedFile> SoundFontSampleStore::soundFontFileLocked(const std::string& fileName)
+{
+    std::weak_ptr<const io::MappedFile>& cached = m_soundFontFiles[fileName];
+    if (std::shared_ptr<const io::MappedFile> file = cached.lock()) {
+        return file;
+    }
+
+    auto file = std::make_shared<io::MappedFile>();
+    if (!file->open(io::path_t(fileName))) {
+        LOGE() << "failed to map soundfont: " << fileName;
+        m_soundFontFiles.erase(fileName);
+        return nullptr;
+    }
+
+    cached = file;
+
+    return file;
+}
+
+int SoundFontSampleStore::loadSample(const std::string& fileName, time_t modificationTime, unsigned int samplePos,
+                                     unsigned int sampleSize, unsigned int sampleStart, unsigned int sampleEnd, int sampleType,
+                                     short** sampleData)
+{
+    if (!(sampleType & FLUID_SAMPLETYPE_OGG_VORBIS)) {
+        //! NOTE: The same checks as in fluid_sffile_read_wav
+        if (sampleEnd < sampleStart || sampleStart * sizeof(short) > sampleSize || sampleEnd * sizeof(short) > sampleSize) {
+            return -1;
+        }
+
+        std::lock_guard lock(m_mutex);
+
+        std::shared_ptr<const io::MappedFile> file = soundFontFileLocked(fileName);
+        size_t endOffset = static_cast<size_t>(samplePos) + (static_cast<size_t>(sampleEnd) + 1) * sizeof(short);
+
+        if (!file || endOffset > file->size()) {
+            return -1;
+        }
+
+        const uint8_t* data = file->data() + samplePos + static_cast<size_t>(sampleStart) * sizeof(short);
+
+        //! NOTE: Fluid never writes into the sample data
+        *sampleData = reinterpret_cast<short*>(const_cast<uint8_t*>(data));
+
+        m_loadedSamples.emplace(*sampleData, std::move(file));
+
+        return static_cast<int>(sampleEnd - sampleStart + 1);
+    }
+
+    std::lock_guard lock(m_mutex);
+
+    if (m_decodedSamplesCachePath.empty()) {
+        return -1;
+    }
+
+    std::string versionKey = decodedSampleVersionKey(fileName, modificationTime);
+
+    auto file = std::make_shared<io::MappedFile>();
+    if (!file->open(decodedSampleFilePath(versionKey, sampleStart, sampleEnd))) {
+        return -1;
+    }
+
+    if (file->size() < sizeof(DecodedSampleHeader)) {
+        return -1;
+    }
+
+    DecodedSampleHeader header;
+    std::memcpy(&header, file->data(), sizeof(header));
+
+    bool valid = std::memcmp(header.magic, DECODED_SAMPLE_MAGIC, sizeof(header.magic)) == 0
+                 && header.version == DECODED_SAMPLE_VERSION
+                 && header.modificationTime == static_cast<int64_t>(modificationTime)
+                 && header.samplePos == samplePos
+                 && header.sampleStart == sampleStart
+                 && header.sampleEnd == sampleEnd
+                 && header.sampleCount > 0
+                 && file->size() == sizeof(header) + static_cast<size_t>(header.sampleCount) * sizeof(short);
+
+    if (!valid) {
+        return -1;
+    }
+
+    const uint8_t* data = file->data() + sizeof(header);
+    *sampleData = reinterpret_cast<short*>(const_cast<uint8_t*>(data));
+
+    m_loadedSamples.emplace(*sampleData, std::move(file));
+
+    ensureCacheIndexedLocked();
+    if (markVersionUsedLocked(versionKey)) {
+        fileSystem()->writeFile(usedMarkFilePath(versionKey), ByteArray());
+    }
+
+    return header.sampleCount;
+}
+
+void SoundFontSampleStore::storeSample(const std::string& fileName, time_t modificationTime, unsigned int samplePos,
+                                       unsigned int sampleStart, unsigned int sampleEnd, int sampleType,
+                                       const short* sampleData, int sampleCount)
+{
+    //! NOTE: Only the decompressed samples are worth keeping, the SF2 ones are mapped from the soundfont itself
+    if (!(sampleType & FLUID_SAMPLETYPE_OGG_VORBIS) || sampleCount <= 0) {
+        return;
+    }
+
+    std::string versionKey = decodedSampleVersionKey(fileName, modificationTime);
+    io::path_t cachePath;
+    io::path_t filePath;
+    {
+        std::lock_guard lock(m_mutex);
+
+        if (m_decodedSamplesCachePath.empty()) {
+            return;
+        }
+
+        cachePath = m_decodedSamplesCachePath;
+        filePath = decodedSampleFilePath(versionKey, sampleStart, sampleEnd);
+
+        //! NOTE: Before the temporary file is written, the indexing removes the ones left
+        ensureCacheIndexedLocked();
+    }
+
+    if (!fileSystem()->makePath(cachePath)) {
+        return;
+    }
+
+    DecodedSampleHeader header;
+    std::memcpy(header.magic, DECODED_SAMPLE_MAGIC, sizeof(header.magic));
+    header.version = DECODED_SAMPLE_VERSION;
+    header.modificationTime = static_cast<int64_t>(modificationTime);
+    header.samplePos = samplePos;
+    header.sampleStart = sampleStart;
+    header.sampleEnd = sampleEnd;
+    header.sampleCount = sampleCount;
+
+    size_t samplesSize = static_cast<size_t>(sampleCount) * sizeof(short);
+    ByteArray data(sizeof(header) + samplesSize);
+    std::memcpy(data.data(), &header, sizeof(header));
+    std::memcpy(data.data() + sizeof(header), sampleData, samplesSize);
+
+    //! NOTE: Written to a temporary file first, so that a concurrent or interrupted write never leaves a broken cache file
+    io::path_t tempFilePath = filePath + tempFileSuffix();
+
+    Ret ret = fileSystem()->writeFile(tempFilePath, data);
+    if (!ret) {
+        LOGW() << "failed to write decoded sample: " << tempFilePath << ", " << ret.toString();
+        fileSystem()->remove(tempFilePath);
+        return;
+    }
+
+    std::lock_guard lock(m_mutex);
+
+    //! NOTE: Another thread or process may have stored the same sample meanwhile
+    RetVal<uint64_t> replacedSize = fileSystem()->fileSize(filePath);
+
+    ret = fileSystem()->move(tempFilePath, filePath, true);
+    if (!ret) {
+        LOGW() << "failed to store decoded sample: " << filePath << ", " << ret.toString();
+        fileSystem()->remove(tempFilePath);
+        return;
+    }
+
+    CachedVersion& version = m_cachedVersions[versionKey];
+    if (replacedSize.ret) {
+        version.size -= std::min(version.size, replacedSize.val);
+        m_cachedSize -= std::min(m_cachedSize, replacedSize.val);
+    }
+
+    version.size += data.size();
+    m_cachedSize += data.size();
+
+    if (markVersionUsedLocked(versionKey)) {
+        fileSystem()->writeFile(usedMarkFilePath(versionKey), ByteArray());
+    }
+
+    for (const std::string& removedVersionKey : takeVersionsToRemoveLocked(versionKey)) {
+        removeVersionFiles(removedVersionKey);
+    }
+}
+
+void SoundFontSampleStore::releaseSample(const short* sampleData)
+{
+    std::lock_guard lock(m_mutex);
+
+    //! NOTE: The mapping is closed with its last sample (and reader)
+    auto it = m_loadedSamples.find(sampleData);
+    if (it != m_loadedSamples.end()) {
+        m_loadedSamples.erase(it);
+    }
+}
+
+std::string SoundFontSampleStore::decodedSampleVersionKey(const std::string& fileName, time_t modificationTime)
+{
+    std::stringstream key;
+    key << std::hex << std::hash<std::string> {}(fileName) << std::dec << "_" << static_cast<int64_t>(modificationTime);
+
+    return key.str();
+}
+
+io::path_t SoundFontSampleStore::decodedSampleFilePath(const std::string& versionKey, unsigned int sampleStart,
+                                                       unsigned int sampleEnd) const
+{
+    std::stringstream name;
+    name << versionKey << "_" << sampleStart << "_" << sampleEnd << DECODED_SAMPLE_SUFFIX;
+
+    return m_decodedSamplesCachePath + "/" + name.str();
+}
+
+io::path_t SoundFontSampleStore::usedMarkFilePath(const std::string& versionKey) const
+{
+    return m_decodedSamplesCachePath + "/" + versionKey + USED_MARK_SUFFIX;
+}
+
+void SoundFontSampleStore::ensureCacheIndexedLocked()
+{
+    if (m_cacheIndexed) {
+        return;
+    }
+
+    m_cacheIndexed = true;
+
+    RetVal<io::paths_t> paths = fileSystem()->scanFiles(m_decodedSamplesCachePath,
+                                                        { "*" + DECODED_SAMPLE_SUFFIX, "*" + USED_MARK_SUFFIX, "*" + TEMP_FILE_SUFFIX },
+                                                        io::ScanMode::FilesInCurrentDir);
+    if (!paths.ret) {
+        return;
+    }
+
+    for (const io::path_t& path : paths.val) {
+        std::string name = io::filename(path).toStdString();
+
+        //! NOTE: Left by an interrupted write (or being written by another process, which then just doesn't cache its sample)
+        if (endsWith(name, TEMP_FILE_SUFFIX)) {
+            fileSystem()->remove(path);
+            continue;
+        }
+
+        std::string versionKey = versionKeyOfFile(name);
+        if (versionKey.empty()) {
+            continue;
+        }
+
+        CachedVersion& version = m_cachedVersions[versionKey];
+
+        if (endsWith(name, USED_MARK_SUFFIX)) {
+            version.lastUsed = fileSystem()->lastModified(path).toString().toStdString();
+            continue;
+        }
+
+        RetVal<uint64_t> size = fileSystem()->fileSize(path);
+        if (size.ret) {
+            version.size += size.val;
+            m_cachedSize += size.val;
+        }
+    }
+}
+
+bool SoundFontSampleStore::markVersionUsedLocked(const std::string& versionKey)
+{
+    CachedVersion& version = m_cachedVersions[versionKey];
+    if (version.useOrder != 0) {
+        return false;
+    }
+
+    version.useOrder = ++m_lastUseOrder;
+
+    return true;
+}
+
+std::vector<std::string> SoundFontSampleStore::takeVersionsToRemoveLocked(const std::string& versionKey)
+{
+    std::vector<std::string> result;
+
+    auto take = [this, &result](std::map<std::string, CachedVersion>::iterator it) {
+        m_cachedSize -= std::min(m_cachedSize, it->second.size);
+        result.push_back(it->first);
+        m_cachedVersions.erase(it);
+    };
+
+    //! NOTE: The samples of the previous versions of the soundfont will never be used again
+    const std::string hash = hashOfVersionKey(versionKey);
+    for (auto it = m_cachedVersions.begin(); it != m_cachedVersions.end();) {
+        auto next = std::next(it);
+        if (it->first != versionKey && hashOfVersionKey(it->first) == hash) {
+            take(it);
+        }
+        it = next;
+    }
+
+    //! NOTE: The least recently used first: the ones not used in this run by their last use, then the ones used in this run
+    auto lessRecentlyUsed = [](const CachedVersion& v1, const CachedVersion& v2) {
+        if ((v1.useOrder == 0) != (v2.useOrder == 0)) {
+            return v1.useOrder == 0;
+        }
+
+        return v1.useOrder == 0 ? v1.lastUsed < v2.lastUsed : v1.useOrder < v2.useOrder;
+    };
+
+    while (m_cachedSize > m_decodedSamplesCacheMaxSize) {
+        auto leastRecentlyUsed = m_cachedVersions.end();
+        for (auto it = m_cachedVersions.begin(); it != m_cachedVersions.end(); ++it) {
+            if (it->first == versionKey) {
+                continue;
+            }
+
+            if (leastRecentlyUsed == m_cachedVersions.end() || lessRecentlyUsed(it->second, leastRecentlyUsed->second)) {
+                leastRecentlyUsed = it;
+            }
+        }
+
+        //! NOTE: The soundfont being stored alone exceeds the cache size, it is kept anyway
+        if (leastRecentlyUsed == m_cachedVersions.end()) {
+            break;
+        }
+
+        take(leastRecentlyUsed);
+    }
+
+    return result;
+}
+
+void SoundFontSampleStore::removeVersionFiles(const std::string& versionKey)
+{
+    //! NOTE: The mapped samples stay readable after their files are removed
+    RetVal<io::paths_t> paths = fileSystem()->scanFiles(m_decodedSamplesCachePath,
+                                                        { versionKey + "_*" + DECODED_SAMPLE_SUFFIX, versionKey + USED_MARK_SUFFIX },
+                                                        io::ScanMode::FilesInCurrentDir);
+    if (!paths.ret) {
+        return;
+    }
+
+    for (const io::path_t& path : paths.val) {
+        fileSystem()->remove(path);
+    }
+}
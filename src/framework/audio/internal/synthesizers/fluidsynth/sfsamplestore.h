@@ -0,0 +1,105 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MUSE_AUDIO_SFSAMPLESTORE_H
+#define MUSE_AUDIO_SFSAMPLESTORE_H
+
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "global/modularity/ioc.h"
+#include "global/io/ifilesystem.h"
+#include "global/io/mappedfile.h"
+#include "global/io/path.h"
+
+namespace muse::audio::synth {
+//! NOTE: Provides the sample data of soundfonts to all the Fluid instances without copying it into the heap.
+//! The samples of SF2 files point directly into a memory mapping of the soundfont, shared by all instances,
+//! whose pages are only loaded when a preset using them is selected (see synth.dynamic-sample-loading).
+//! The Ogg Vorbis samples of SF3 files are decompressed once, written to a cache on disk and mapped from there
+//! on the next runs.
+//! A soundfont is mapped while it is being read or any of its samples is loaded, and unmapped after that.
+//! The cache keeps the samples of each version (modification time) of a soundfont: the samples of the previous versions
+//! are removed when a new one is stored, and the least recently used versions are removed when the cache exceeds its size
+class SoundFontSampleStore
+{
+    Inject<io::IFileSystem> fileSystem;
+
+public:
+    static SoundFontSampleStore* instance();
+
+    static constexpr uint64_t DEFAULT_DECODED_SAMPLES_CACHE_MAX_SIZE = 1024ull * 1024 * 1024;
+
+    void init(const io::path_t& decodedSamplesCachePath, uint64_t decodedSamplesCacheMaxSize = DEFAULT_DECODED_SAMPLES_CACHE_MAX_SIZE);
+
+    //! NOTE: The mapping of the whole soundfont file, shared by all its users until the last one releases it
+    std::shared_ptr<const io::MappedFile> soundFontFile(const std::string& fileName);
+
+    int loadSample(const std::string& fileName, time_t modificationTime, unsigned int samplePos, unsigned int sampleSize,
+                   unsigned int sampleStart, unsigned int sampleEnd, int sampleType, short** sampleData);
+    void storeSample(const std::string& fileName, time_t modificationTime, unsigned int samplePos,
+                     unsigned int sampleStart, unsigned int sampleEnd, int sampleType, const short* sampleData, int sampleCount);
+    void releaseSample(const short* sampleData);
+
+private:
+    SoundFontSampleStore() = default;
+
+    //! NOTE: The decoded samples of a version of a soundfont
+    struct CachedVersion {
+        uint64_t size = 0;
+        std::string lastUsed; // ISO date and time of the last use in a previous run
+        uint64_t useOrder = 0; // the order of the first use in this run, 0 if not used yet
+    };
+
+    static std::string decodedSampleVersionKey(const std::string& fileName, time_t modificationTime);
+    io::path_t decodedSampleFilePath(const std::string& versionKey, unsigned int sampleStart, unsigned int sampleEnd) const;
+    io::path_t usedMarkFilePath(const std::string& versionKey) const;
+
+    void ensureCacheIndexedLocked();
+    bool markVersionUsedLocked(const std::string& versionKey);
+    std::vector<std::string> takeVersionsToRemoveLocked(const std::string& versionKey);
+    void removeVersionFiles(const std::string& versionKey);
+
+    std::mutex m_mutex;
+    io::path_t m_decodedSamplesCachePath;
+    uint64_t m_decodedSamplesCacheMaxSize = DEFAULT_DECODED_SAMPLES_CACHE_MAX_SIZE;
+
+    bool m_cacheIndexed = false;
+    std::map<std::string, CachedVersion> m_cachedVersions;
+    uint64_t m_cachedSize = 0;
+    uint64_t m_lastUseOrder = 0;
+
+    std::shared_ptr<const io::MappedFile> soundFontFileLocked(const std::string& fileName);
+
+    std::map<std::string, std::weak_ptr<const io::MappedFile> > m_soundFontFiles;
+
+    //! NOTE: The mapping each loaded sample points into: the soundfont for SF2 samples, the cache file for the decoded ones.
+    //! Fluid caches the samples by range, so two of them may start at the same address
+    std::unordered_multimap<const short*, std::shared_ptr<const io::MappedFile> > m_loadedSamples;
+};
+}
+
+#endif // MUSE_AUDIO_SFSAMPLESTORE_H
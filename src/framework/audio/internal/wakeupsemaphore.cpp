@@ -0,0 +1,91 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "wakeupsemaphore.h"
+
+#include <cerrno>
+#include <climits>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <dispatch/dispatch.h>
+#else
+#include <semaphore.h>
+#endif
+
+using namespace muse::audio;
+
+struct WakeupSemaphore::Handle
+{
+#if defined(_WIN32)
+    HANDLE handle = CreateSemaphore(nullptr, 0, LONG_MAX, nullptr);
+
+    ~Handle() { CloseHandle(handle); }
+#elif defined(__APPLE__)
+    dispatch_semaphore_t handle = dispatch_semaphore_create(0);
+
+    ~Handle() { dispatch_release(handle); }
+#else
+    sem_t handle;
+
+    Handle() { sem_init(&handle, 0, 0); }
+    ~Handle() { sem_destroy(&handle); }
+#endif
+};
+
+WakeupSemaphore::WakeupSemaphore()
+    : m_handle(std::make_unique<Handle>())
+{
+}
+
+WakeupSemaphore::~WakeupSemaphore() = default;
+
+void WakeupSemaphore::signal(size_t count)
+{
+    if (count == 0) {
+        return;
+    }
+
+#if defined(_WIN32)
+    ReleaseSemaphore(m_handle->handle, static_cast<LONG>(count), nullptr);
+#else
+    for (size_t i = 0; i < count; ++i) {
+#if defined(__APPLE__)
+        dispatch_semaphore_signal(m_handle->handle);
+#else
+        sem_post(&m_handle->handle);
+#endif
+    }
+#endif
+}
+
+void WakeupSemaphore::wait()
+{
+#if defined(_WIN32)
+    WaitForSingleObject(m_handle->handle, INFINITE);
+#elif defined(__APPLE__)
+    dispatch_semaphore_wait(m_handle->handle, DISPATCH_TIME_FOREVER);
+#else
+    while (sem_wait(&m_handle->handle) != 0 && errno == EINTR) {
+    }
+#endif
+}
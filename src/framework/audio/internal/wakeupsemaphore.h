@@ -0,0 +1,50 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUSE_AUDIO_WAKEUPSEMAPHORE_H
+#define MUSE_AUDIO_WAKEUPSEMAPHORE_H
+
+#include <cstddef>
+#include <memory>
+
+namespace muse::audio {
+//! NOTE: A system semaphore (POSIX, dispatch on macOS, Win32 on Windows).
+//! Signaling it doesn't take any lock in the user space, so it can be done from the real-time threads
+class WakeupSemaphore
+{
+public:
+    WakeupSemaphore();
+    ~WakeupSemaphore();
+
+    WakeupSemaphore(const WakeupSemaphore&) = delete;
+    WakeupSemaphore& operator=(const WakeupSemaphore&) = delete;
+
+    void signal(size_t count = 1);
+    void wait();
+
+private:
+    struct Handle;
+    std::unique_ptr<Handle> m_handle;
+};
+}
+
+#endif // MUSE_AUDIO_WAKEUPSEMAPHORE_H
@@ -145,14 +145,17 @@ void AudioEngine::setMode(const RenderMode newMode)
     case RenderMode::RealTimeMode:
         m_buffer->setSource(m_mixer->mixedSource());
         m_mixer->setIsIdle(false);
+        m_mixer->setIsOffline(false);
         break;
     case RenderMode::IdleMode:
         m_buffer->setSource(m_mixer->mixedSource());
         m_mixer->setIsIdle(true);
+        m_mixer->setIsOffline(false);
         break;
     case RenderMode::OfflineMode:
         m_buffer->setSource(nullptr);
         m_mixer->setIsIdle(false);
+        m_mixer->setIsOffline(true);
         break;
     case RenderMode::Undefined:
         UNREACHABLE;
@@ -22,6 +22,8 @@
 
 #include "audiooutputhandler.h"
 
+#include <limits>
+
 #include "global/async/async.h"
 #include "global/containers.h"
 
@@ -50,6 +52,10 @@ AudioOutputHandler::AudioOutputHandler(IGetTrackSequence* getSequence)
 {
     ONLY_AUDIO_MAIN_OR_WORKER_THREAD;
 
+    if (mixer()) {
+        m_controlCommands = mixer()->controlCommands();
+    }
+
     Async::call(this, [this]() {
         ensureMixerSubscriptions();
     }, AudioThread::ID);
@@ -60,6 +66,8 @@ Promise<AudioOutputParams> AudioOutputHandler::outputParams(const TrackSequenceI
     return Promise<AudioOutputParams>([this, sequenceId, trackId](auto resolve, auto reject) {
         ONLY_AUDIO_WORKER_THREAD;
 
+        processControlCommands();
+
         ITrackSequencePtr s = sequence(sequenceId);
 
         if (!s) {
@@ -78,14 +86,32 @@ Promise<AudioOutputParams> AudioOutputHandler::outputParams(const TrackSequenceI
 
 void AudioOutputHandler::setOutputParams(const TrackSequenceId sequenceId, const TrackId trackId, const AudioOutputParams& params)
 {
-    Async::call(this, [this, sequenceId, trackId, params]() {
+    ensureRemovalSubscriptions();
+
+    auto key = std::make_pair(sequenceId, trackId);
+    auto it = m_sentOutputParams.find(key);
+    bool sent = it != m_sentOutputParams.end() && sendControlCommands(it->second, params, false /*isMaster*/, trackId);
+
+    m_sentOutputParams.insert_or_assign(key, params);
+
+    if (sent) {
+        return;
+    }
+
+    uint64_t syncId = beginFullUpdate();
+
+    Async::call(this, [this, sequenceId, trackId, params, syncId]() {
         ONLY_AUDIO_WORKER_THREAD;
 
+        processControlCommands();
+
         ITrackSequencePtr s = sequence(sequenceId);
 
         if (s) {
             s->audioIO()->setOutputParams(trackId, params);
         }
+
+        endFullUpdate(syncId);
     }, AudioThread::ID);
 }
 
@@ -105,33 +131,55 @@ Promise<AudioOutputParams> AudioOutputHandler::masterOutputParams() const
             return reject(static_cast<int>(Err::Undefined), "undefined reference to a mixer");
         }
 
+        processControlCommands();
+
         return resolve(mixer()->masterOutputParams());
     }, AudioThread::ID);
 }
 
 void AudioOutputHandler::setMasterOutputParams(const AudioOutputParams& params)
 {
-    Async::call(this, [this, params]() {
+    bool sent = m_sentMasterOutputParams && sendControlCommands(m_sentMasterOutputParams.value(), params, true /*isMaster*/, -1);
+
+    m_sentMasterOutputParams = params;
+
+    if (sent) {
+        return;
+    }
+
+    uint64_t syncId = beginFullUpdate();
+
+    Async::call(this, [this, params, syncId]() {
         ONLY_AUDIO_WORKER_THREAD;
 
         IF_ASSERT_FAILED(mixer()) {
             return;
         }
 
+        mixer()->processControlCommands();
         mixer()->setMasterOutputParams(params);
+
+        endFullUpdate(syncId);
     }, AudioThread::ID);
 }
 
 void AudioOutputHandler::clearMasterOutputParams()
 {
-    Async::call(this, [this]() {
+    m_sentMasterOutputParams = AudioOutputParams();
+
+    uint64_t syncId = beginFullUpdate();
+
+    Async::call(this, [this, syncId]() {
         ONLY_AUDIO_WORKER_THREAD;
 
         IF_ASSERT_FAILED(mixer()) {
             return;
         }
 
+        mixer()->processControlCommands();
         mixer()->clearMasterOutputParams();
+
+        endFullUpdate(syncId);
     }, AudioThread::ID);
 }
 
@@ -250,6 +298,74 @@ void AudioOutputHandler::clearAllFx()
     fxResolver()->clearAllFx();
 }
 
+bool AudioOutputHandler::sendControlCommands(const AudioOutputParams& sentParams, const AudioOutputParams& params, bool isMaster,
+                                             TrackId trackId)
+{
+    if (!m_controlCommands) {
+        return false;
+    }
+
+    //! NOTE: The fx chain and the aux sends require to rebuild the processors, they are sent as a full update
+    if (!(sentParams.fxChain == params.fxChain) || !(sentParams.auxSends == params.auxSends)) {
+        return false;
+    }
+
+    //! NOTE: All the values are sent, not only the changed ones: the params sent before
+    //! might not be the current params of the channel (e.g. the track has been recreated in between)
+    auto makeCommand = [isMaster, trackId](ControlCommand::Type type) {
+        ControlCommand command;
+        command.type = type;
+        command.isMaster = isMaster;
+        command.trackId = trackId;
+        return command;
+    };
+
+    ControlCommand volume = makeCommand(ControlCommand::Type::SetVolume);
+    volume.value = params.volume;
+
+    ControlCommand balance = makeCommand(ControlCommand::Type::SetBalance);
+    balance.value = params.balance;
+
+    ControlCommand solo = makeCommand(ControlCommand::Type::SetSolo);
+    solo.flag = params.solo;
+
+    ControlCommand muted = makeCommand(ControlCommand::Type::SetMuted);
+    muted.flag = params.muted;
+
+    ControlCommand forceMute = makeCommand(ControlCommand::Type::SetForceMute);
+    forceMute.flag = params.forceMute;
+
+    //! NOTE: If the queue is full, the commands pushed so far are older than the full update which follows
+    return m_controlCommands->push(volume)
+           && m_controlCommands->push(balance)
+           && m_controlCommands->push(solo)
+           && m_controlCommands->push(muted)
+           && m_controlCommands->push(forceMute);
+}
+
+uint64_t AudioOutputHandler::beginFullUpdate()
+{
+    return m_controlCommands ? m_controlCommands->beginFullUpdate() : 0;
+}
+
+void AudioOutputHandler::endFullUpdate(uint64_t syncId) const
+{
+    ONLY_AUDIO_WORKER_THREAD;
+
+    if (m_controlCommands) {
+        m_controlCommands->endFullUpdate(syncId);
+    }
+}
+
+void AudioOutputHandler::processControlCommands() const
+{
+    ONLY_AUDIO_WORKER_THREAD;
+
+    if (mixer()) {
+        mixer()->processControlCommands();
+    }
+}
+
 std::shared_ptr<Mixer> AudioOutputHandler::mixer() const
 {
     return AudioEngine::instance()->mixer();
@@ -286,6 +402,30 @@ void AudioOutputHandler::ensureSeqSubscriptions(const ITrackSequencePtr s) const
     }
 }
 
+void AudioOutputHandler::ensureRemovalSubscriptions()
+{
+    ONLY_AUDIO_MAIN_THREAD;
+
+    //! NOTE: Subscribed before the first params are kept, the removals are received on the main thread in order
+    //! with the other replies of the worker, so a new track never finds the params of a removed one with the same id
+    if (m_isSubscribedToRemovals || !m_getSequence) {
+        return;
+    }
+
+    m_isSubscribedToRemovals = true;
+
+    m_getSequence->trackRemoved().onReceive(this, [this](const TrackSequenceId sequenceId, const TrackId trackId) {
+        m_sentOutputParams.erase(std::make_pair(sequenceId, trackId));
+    });
+
+    m_getSequence->sequenceRemoved().onReceive(this, [this](const TrackSequenceId sequenceId) {
+        auto it = m_sentOutputParams.lower_bound(std::make_pair(sequenceId, std::numeric_limits<TrackId>::min()));
+        while (it != m_sentOutputParams.end() && it->first.first == sequenceId) {
+            it = m_sentOutputParams.erase(it);
+        }
+    });
+}
+
 void AudioOutputHandler::ensureMixerSubscriptions() const
 {
     ONLY_AUDIO_WORKER_THREAD;
@@ -23,12 +23,16 @@
 #ifndef MUSE_AUDIO_AUDIOIOHANDLER_H
 #define MUSE_AUDIO_AUDIOIOHANDLER_H
 
+#include <map>
+#include <optional>
+
 #include "global/modularity/ioc.h"
 #include "global/async/asyncable.h"
 
 #include "ifxresolver.h"
 #include "iaudiooutput.h"
 #include "igettracksequence.h"
+#include "controlcommandqueue.h"
 
 namespace muse::audio {
 class Mixer;
@@ -72,9 +76,23 @@ private:
     ITrackSequencePtr sequence(const TrackSequenceId id) const;
     void ensureSeqSubscriptions(const ITrackSequencePtr s) const;
     void ensureMixerSubscriptions() const;
+    void ensureRemovalSubscriptions();
+
+    bool sendControlCommands(const AudioOutputParams& sentParams, const AudioOutputParams& params, bool isMaster, TrackId trackId);
+    uint64_t beginFullUpdate();
+    void endFullUpdate(uint64_t syncId) const;
+    void processControlCommands() const;
 
     IGetTrackSequence* m_getSequence = nullptr;
 
+    //! NOTE: The volume, balance and mute/solo changes are sent to the mixer via the control commands queue (main thread -> audio worker),
+    //! the params last sent by the main thread are kept to detect such changes.
+    //! They are forgotten with their track or sequence, since the ids are reused by the next ones
+    ControlCommandQueuePtr m_controlCommands = nullptr;
+    std::map<std::pair<TrackSequenceId, TrackId>, AudioOutputParams> m_sentOutputParams;
+    bool m_isSubscribedToRemovals = false;
+    std::optional<AudioOutputParams> m_sentMasterOutputParams;
+
     mutable async::Channel<AudioOutputParams> m_masterOutputParamsChanged;
     mutable async::Channel<TrackSequenceId, TrackId, AudioOutputParams> m_outputParamsChanged;
 
@@ -0,0 +1,276 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "audiorenderpool.h"
+
+#include <algorithm>
+
+#if defined(__linux__)
+#include <pthread.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_AMD64) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#include "global/runtime.h"
+
+#include "internal/audiosanitizer.h"
+
+#include "log.h"
+
+using namespace muse::audio;
+
+using Clock = std::chrono::steady_clock;
+
+//! NOTE: A few microseconds of busy spinning, enough for the next block of a chain of parallelFor calls,
+//! then the workers yield the cpu between the checks until the spin duration is over
+static constexpr int BUSY_SPIN_COUNT = 200;
+
+//! NOTE: Covers an audio block of up to 1024 frames at 48 kHz, the longer pauses (e.g. no playback) park the workers
+static constexpr std::chrono::nanoseconds MAX_SPIN_DURATION = std::chrono::milliseconds(25);
+
+static inline void cpuRelax()
+{
+#if defined(__SSE2__) || defined(_M_AMD64) || defined(_M_X64)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm64__)
+    asm volatile ("yield");
+#endif
+}
+
+//! NOTE: The cpus the process is allowed to run on (e.g. restricted by taskset or a container)
+static std::vector<size_t> allowedCpus()
+{
+    std::vector<size_t> cpus;
+
+#if defined(__linux__)
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) != 0) {
+        LOGW() << "failed to get the cpu affinity of the process";
+        return cpus;
+    }
+
+    for (size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &cpuset)) {
+            cpus.push_back(cpu);
+        }
+    }
+#elif defined(_WIN32)
+    DWORD_PTR processMask = 0;
+    DWORD_PTR systemMask = 0;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+        LOGW() << "failed to get the cpu affinity of the process, error: " << GetLastError();
+        return cpus;
+    }
+
+    for (size_t cpu = 0; cpu < sizeof(DWORD_PTR) * 8; ++cpu) {
+        if (processMask & (DWORD_PTR(1) << cpu)) {
+            cpus.push_back(cpu);
+        }
+    }
+#endif
+
+    return cpus;
+}
+
+static void pinThreadToCpu(std::thread& thread, size_t cpu)
+{
+#if defined(__linux__)
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+
+    int err = pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuset);
+    if (err != 0) {
+        LOGW() << "failed to pin the render thread to cpu " << cpu << ", error: " << err;
+    }
+#elif defined(_WIN32)
+    if (!SetThreadAffinityMask(static_cast<HANDLE>(thread.native_handle()), DWORD_PTR(1) << cpu)) {
+        LOGW() << "failed to pin the render thread to cpu " << cpu << ", error: " << GetLastError();
+    }
+#else
+    //! NOTE: macOS doesn't allow explicit pinning, the scheduler keeps the threads where it wants
+    UNUSED(thread);
+    UNUSED(cpu);
+#endif
+}
+
+AudioRenderPool::AudioRenderPool(size_t threadCount)
+{
+    m_running = true;
+
+    //! NOTE: The workers spin, more threads than cores would only make them fight for the cpu
+    size_t hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    threadCount = std::min(threadCount, hardwareThreads);
+
+    //! NOTE: The calling thread is one of the threads, it isn't pinned.
+    //! The worker i goes to the i-th allowed cpu, the workers beyond the allowed cpus aren't pinned
+    const std::vector<size_t> cpus = allowedCpus();
+
+    for (size_t i = 1; i < threadCount; ++i) {
+        m_workers.emplace_back(&AudioRenderPool::workerLoop, this, i);
+
+        if (i < cpus.size()) {
+            pinThreadToCpu(m_workers.back(), cpus[i]);
+        }
+    }
+}
+
+AudioRenderPool::~AudioRenderPool()
+{
+    m_running = false;
+    m_block.fetch_add(1);
+    m_parkSemaphore.signal(m_workers.size());
+
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+size_t AudioRenderPool::threadCount() const
+{
+    return m_workers.size() + 1;
+}
+
+void AudioRenderPool::run(size_t count, void* context, TaskFunc func)
+{
+    if (m_workers.empty() || count < 2) {
+        for (size_t i = 0; i < count; ++i) {
+            func(context, i);
+        }
+
+        return;
+    }
+
+    m_count = count;
+    m_context = context;
+    m_func = func;
+    m_nextIndex.store(0, std::memory_order_relaxed);
+    m_remainingWorkers.store(m_workers.size(), std::memory_order_relaxed);
+
+    updateSpinDuration();
+
+    m_block.fetch_add(1);
+
+    //! NOTE: Both the increment of m_block and the load are sequentially consistent, like the ones of the parking worker,
+    //! so either the worker sees the new block, or it is counted here. An extra signal only makes a worker check again
+    size_t parkedWorkers = m_parkedWorkers.load();
+    if (parkedWorkers > 0) {
+        m_parkSemaphore.signal(parkedWorkers);
+    }
+
+    processItems();
+
+    while (m_remainingWorkers.load(std::memory_order_acquire) > 0) {
+        cpuRelax();
+    }
+}
+
+void AudioRenderPool::processItems()
+{
+    size_t index = m_nextIndex.fetch_add(1, std::memory_order_relaxed);
+
+    while (index < m_count) {
+        m_func(m_context, index);
+        index = m_nextIndex.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AudioRenderPool::workerLoop(size_t workerIdx)
+{
+    runtime::setThreadName("audio_render_" + std::to_string(workerIdx));
+    AudioSanitizer::setupRenderThread();
+
+    //! NOTE: Not m_block.load(), the first block may have been started before this thread
+    uint64_t lastBlock = 0;
+
+    while (true) {
+        lastBlock = waitForNextBlock(lastBlock);
+
+        if (!m_running) {
+            return;
+        }
+
+        processItems();
+
+        m_remainingWorkers.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void AudioRenderPool::updateSpinDuration()
+{
+    //! NOTE: The longest recent gap between the blocks, it decays slowly when the blocks get closer.
+    //! The gaps longer than the maximum are pauses, they don't change the duration
+    Clock::time_point now = Clock::now();
+    int64_t gapNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_lastRunTime).count();
+    m_lastRunTime = now;
+
+    if (gapNs > MAX_SPIN_DURATION.count()) {
+        return;
+    }
+
+    int64_t durationNs = m_spinDurationNs.load(std::memory_order_relaxed);
+    durationNs = std::max(gapNs, durationNs - durationNs / 8);
+    m_spinDurationNs.store(durationNs, std::memory_order_relaxed);
+}
+
+uint64_t AudioRenderPool::waitForNextBlock(uint64_t lastBlock)
+{
+    uint64_t block = lastBlock;
+
+    for (int i = 0; i < BUSY_SPIN_COUNT; ++i) {
+        block = m_block.load();
+        if (block != lastBlock) {
+            return block;
+        }
+
+        cpuRelax();
+    }
+
+    //! NOTE: A slightly longer spin than the expected gap, so that a block coming a bit late still finds the workers awake
+    const int64_t spinDurationNs = m_spinDurationNs.load(std::memory_order_relaxed);
+    const Clock::time_point deadline = Clock::now() + std::chrono::nanoseconds(spinDurationNs + spinDurationNs / 4);
+
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+
+        block = m_block.load();
+        if (block != lastBlock) {
+            return block;
+        }
+    }
+
+    m_parkedWorkers.fetch_add(1);
+
+    block = m_block.load();
+    while (block == lastBlock) {
+        m_parkSemaphore.wait();
+        block = m_block.load();
+    }
+
+    m_parkedWorkers.fetch_sub(1);
+
+    return block;
+}
@@ -0,0 +1,92 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MUSE_AUDIO_AUDIORENDERPOOL_H
+#define MUSE_AUDIO_AUDIORENDERPOOL_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "internal/wakeupsemaphore.h"
+
+namespace muse::audio {
+//! NOTE: A dedicated pool of threads for rendering audio tracks in parallel.
+//! The thread that calls parallelFor takes part in the work and waits
+//! for all the workers at the end of the call (a barrier per audio block).
+//! After a block, the workers spin (with a back-off) for about the time between the last blocks,
+//! capped to a few milliseconds, then they park on a semaphore until the next block.
+//! Waking them up doesn't take any lock, so the calling (real-time) thread never waits for a mutex.
+class AudioRenderPool
+{
+public:
+    explicit AudioRenderPool(size_t threadCount);
+    ~AudioRenderPool();
+
+    //! NOTE: Including the calling thread
+    size_t threadCount() const;
+
+    //! NOTE: Calls func(index) for every index in [0, count) and returns when all calls are finished
+    template<typename Func>
+    void parallelFor(size_t count, Func& func)
+    {
+        run(count, &func, [](void* context, size_t index) {
+            (*static_cast<Func*>(context))(index);
+        });
+    }
+
+private:
+    using TaskFunc = void (*)(void* context, size_t index);
+
+    void run(size_t count, void* context, TaskFunc func);
+    void processItems();
+
+    void updateSpinDuration();
+
+    void workerLoop(size_t workerIdx);
+    uint64_t waitForNextBlock(uint64_t lastBlock);
+
+    std::vector<std::thread> m_workers;
+    std::atomic<bool> m_running = false;
+
+    std::atomic<uint64_t> m_block = 0;
+    std::atomic<size_t> m_nextIndex = 0;
+    std::atomic<size_t> m_remainingWorkers = 0;
+
+    //! NOTE: Written by the caller before m_block is incremented
+    size_t m_count = 0;
+    void* m_context = nullptr;
+    TaskFunc m_func = nullptr;
+
+    //! NOTE: How long the workers spin before parking, written by the caller of parallelFor
+    std::atomic<int64_t> m_spinDurationNs = 0;
+    std::chrono::steady_clock::time_point m_lastRunTime;
+
+    WakeupSemaphore m_parkSemaphore;
+    std::atomic<size_t> m_parkedWorkers = 0;
+};
+
+using AudioRenderPoolPtr = std::unique_ptr<AudioRenderPool>;
+}
+
+#endif // MUSE_AUDIO_AUDIORENDERPOOL_H
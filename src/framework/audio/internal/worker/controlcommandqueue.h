@@ -0,0 +1,215 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUSE_AUDIO_CONTROLCOMMANDQUEUE_H
+#define MUSE_AUDIO_CONTROLCOMMANDQUEUE_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+
+#include "global/concurrency/spscqueue.h"
+
+#include "audiotypes.h"
+
+namespace muse::audio {
+//! NOTE: A real-time parameter change of a mixer channel (or of the master channel),
+//! the changes which don't require to rebuild the fx chain of the channel
+struct ControlCommand {
+    enum class Type : uint8_t {
+        Undefined = 0,
+        SetVolume,
+        SetBalance,
+        SetSolo,
+        SetMuted,
+        SetForceMute,
+    };
+
+    Type type = Type::Undefined;
+    bool isMaster = false;
+    TrackId trackId = -1;
+
+    float value = 0.f;
+    bool flag = false;
+
+    //! NOTE: Set by ControlCommandQueue::push, see beginFullUpdate()
+    uint64_t syncId = 0;
+
+    bool hasSameTarget(const ControlCommand& other) const
+    {
+        return type == other.type && isMaster == other.isMaster && trackId == other.trackId;
+    }
+};
+
+//! NOTE: Returns true if the params have been changed
+inline bool applyControlCommand(const ControlCommand& command, AudioOutputParams& params)
+{
+    auto applyFlag = [&command](bool& flag) {
+        if (flag == command.flag) {
+            return false;
+        }
+        flag = command.flag;
+        return true;
+    };
+
+    auto applyValue = [&command](float& value) {
+        if (RealIsEqual(value, command.value)) {
+            return false;
+        }
+        value = command.value;
+        return true;
+    };
+
+    switch (command.type) {
+    case ControlCommand::Type::SetVolume: return applyValue(params.volume);
+    case ControlCommand::Type::SetBalance: return applyValue(params.balance);
+    case ControlCommand::Type::SetSolo: return applyFlag(params.solo);
+    case ControlCommand::Type::SetMuted: return applyFlag(params.muted);
+    case ControlCommand::Type::SetForceMute: return applyFlag(params.forceMute);
+    case ControlCommand::Type::Undefined: break;
+    }
+
+    return false;
+}
+
+//! NOTE: Passes the control commands from the main thread (the only producer) to the audio worker (the only consumer)
+//! without locks and allocations, so that a burst of fader moves doesn't block the audio worker.
+//! The changes which can't be expressed as commands (e.g. the fx chain) are still sent as a full AudioOutputParams
+//! update via async::Async::call; the commands sent after such an update are held until it's applied
+//! (see beginFullUpdate/endFullUpdate), so the order of the changes is kept
+class ControlCommandQueue
+{
+public:
+    static constexpr size_t CAPACITY = 1024;
+
+    // Main thread
+
+    //! NOTE: Returns false if the queue is full, the change should be sent as a full update then
+    bool push(ControlCommand command)
+    {
+        command.syncId = m_lastFullUpdateId;
+        return m_queue.push(command);
+    }
+
+    //! NOTE: Returns the id to be passed to endFullUpdate() by the audio worker when the full update is applied
+    uint64_t beginFullUpdate()
+    {
+        return ++m_lastFullUpdateId;
+    }
+
+    // Audio worker
+
+    void endFullUpdate(uint64_t id)
+    {
+        m_appliedFullUpdateId = std::max(m_appliedFullUpdateId, id);
+    }
+
+    //! NOTE: Calls apply(command) for the pending commands, a command is skipped
+    //! if a later one with the same target (see ControlCommand::hasSameTarget) is pending as well
+    template<typename Apply>
+    void process(Apply&& apply)
+    {
+        size_t count = 0;
+
+        while (const ControlCommand* command = m_queue.front()) {
+            if (command->syncId > m_appliedFullUpdateId) {
+                break;
+            }
+
+            m_batch[count++] = *command;
+            m_queue.pop();
+        }
+
+        //! NOTE: Only the latest command of each target is kept, the targets are looked up in a hash table,
+        //! so the batch is coalesced in linear time whatever the number of targets
+        ++m_batchId;
+
+        for (size_t i = 0; i < count; ++i) {
+            TargetSlot& slot = targetSlot(m_batch[i]);
+
+            if (slot.batchId == m_batchId) {
+                m_isLatest[slot.latestIdx] = false;
+            } else {
+                slot.batchId = m_batchId;
+                slot.target = m_batch[i];
+            }
+
+            slot.latestIdx = i;
+            m_isLatest[i] = true;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            if (m_isLatest[i]) {
+                apply(m_batch[i]);
+            }
+        }
+    }
+
+private:
+    //! NOTE: A slot of the hash table is only used by the batch it was taken in (see m_batchId),
+    //! so the table never needs to be cleared
+    struct TargetSlot {
+        uint64_t batchId = 0;
+        ControlCommand target;
+        size_t latestIdx = 0;
+    };
+
+    //! NOTE: A batch has at most CAPACITY targets, so the table is at most half full
+    static constexpr size_t TARGET_SLOTS_COUNT = CAPACITY * 2;
+    static_assert((TARGET_SLOTS_COUNT & (TARGET_SLOTS_COUNT - 1)) == 0, "must be a power of 2");
+
+    TargetSlot& targetSlot(const ControlCommand& command)
+    {
+        uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(command.trackId)) << 8)
+                       | (static_cast<uint64_t>(command.type) << 1)
+                       | (command.isMaster ? 1 : 0);
+
+        size_t idx = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & (TARGET_SLOTS_COUNT - 1);
+
+        for (;;) {
+            TargetSlot& slot = m_targetSlots[idx];
+            if (slot.batchId != m_batchId || slot.target.hasSameTarget(command)) {
+                return slot;
+            }
+
+            idx = (idx + 1) & (TARGET_SLOTS_COUNT - 1);
+        }
+    }
+
+    SpscQueue<ControlCommand, CAPACITY> m_queue;
+
+    // Main thread
+    uint64_t m_lastFullUpdateId = 0;
+
+    // Audio worker
+    uint64_t m_appliedFullUpdateId = 0;
+    std::array<ControlCommand, CAPACITY> m_batch = {};
+    std::array<bool, CAPACITY> m_isLatest = {};
+    std::array<TargetSlot, TARGET_SLOTS_COUNT> m_targetSlots = {};
+    uint64_t m_batchId = 0;
+};
+
+using ControlCommandQueuePtr = std::shared_ptr<ControlCommandQueue>;
+}
+
+#endif // MUSE_AUDIO_CONTROLCOMMANDQUEUE_H
@@ -45,17 +45,29 @@ void Equaliser::setActive(bool active)
 
 void Equaliser::process(float* buffer, unsigned int sampleCount)
 {
+    //! NOTE: Transposed direct form II with the coefficients normalized by a0 (see calculate()),
+    //! the filter is recursive, so the samples are processed one by one
+    const float b0 = m_b[0];
+    const float b1 = m_b[1];
+    const float b2 = m_b[2];
+    const float a1 = m_a[1];
+    const float a2 = m_a[2];
+
+    float z1 = m_z[0];
+    float z2 = m_z[1];
+
     for (unsigned int i = 0; i < sampleCount; ++i) {
-        m_x[2] = m_x[1];
-        m_x[1] = m_x[0];
-        m_x[0] = buffer[i];
+        const float x = buffer[i];
+        const float y = b0 * x + z1;
 
-        m_y[2] = m_y[1];
-        m_y[1] = m_y[0];
-        m_y[0] = (m_b[2] * m_x[2] + m_b[1] * m_x[1] + m_b[0] * m_x[0] - m_a[1] * m_y[1] - m_a[2] * m_y[2]) / m_a[0];
+        z1 = b1 * x - a1 * y + z2;
+        z2 = b2 * x - a2 * y;
 
-        buffer[i] = m_y[0];
+        buffer[i] = y;
     }
+
+    m_z[0] = z1;
+    m_z[1] = z2;
 }
 
 void Equaliser::calculate()
@@ -67,13 +79,15 @@ void Equaliser::calculate()
     float w0 = 2 * M_PI * m_frequency / m_sampleRate;
     float alpha = std::sin(w0) * a / (2 * m_q);
 
-    m_b[0] = 1 + alpha * a;
-    m_b[1] = -2 * std::cos(w0);
-    m_b[2] = 1 - alpha * a;
+    float a0 = 1 + alpha / a;
+
+    m_b[0] = (1 + alpha * a) / a0;
+    m_b[1] = (-2 * std::cos(w0)) / a0;
+    m_b[2] = (1 - alpha * a) / a0;
 
-    m_a[0] = 1 + alpha / a;
-    m_a[1] = -2 * std::cos(w0);
-    m_a[2] = 1 - alpha / a;
+    m_a[0] = 1.f;
+    m_a[1] = (-2 * std::cos(w0)) / a0;
+    m_a[2] = (1 - alpha / a) / a0;
 }
 
 void Equaliser::setFrequency(float value)
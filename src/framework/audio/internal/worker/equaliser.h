@@ -50,8 +50,7 @@ private:
     float m_gain = 0, m_frequency = 1000.f, m_q = 1.f;
     float m_a[3] = { 0, 0, 0 };
     float m_b[3] = { 0, 0, 0 };
-    float m_x[3] = { 0, 0, 0 };
-    float m_y[3] = { 0, 0, 0 };
+    float m_z[2] = { 0, 0 };
 };
 }
 
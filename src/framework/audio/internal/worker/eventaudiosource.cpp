@@ -41,9 +41,9 @@ EventAudioSource::EventAudioSource(const TrackId trackId, const mpe::PlaybackDat
         onOffStreamReceived(trackId);
     });
 
-    m_playbackData.mainStream.onReceive(this, [this](const PlaybackEventsMap& events, const DynamicLevelMap& dynamics,
+    m_playbackData.mainStream.onReceive(this, [this](const PlaybackEventsChanges& changes, const DynamicLevelMap& dynamics,
                                                      const PlaybackParamMap& params) {
-        m_playbackData.originEvents = events;
+        changes.applyTo(m_playbackData.originEvents);
         m_playbackData.dynamicLevelMap = dynamics;
         m_playbackData.paramMap = params;
     });
@@ -23,6 +23,8 @@
 #ifndef MUSE_AUDIO_IGETTRACKSEQUENCE_H
 #define MUSE_AUDIO_IGETTRACKSEQUENCE_H
 
+#include "global/async/channel.h"
+
 #include "itracksequence.h"
 #include "audiotypes.h"
 
@@ -31,6 +33,9 @@ class IGetTrackSequence
 {
 public:
     virtual ITrackSequencePtr sequence(const TrackSequenceId id) const = 0;
+
+    virtual async::Channel<TrackSequenceId> sequenceRemoved() const = 0;
+    virtual async::Channel<TrackSequenceId, TrackId> trackRemoved() const = 0;
 };
 
 using IGetTrackSequencePtr = std::shared_ptr<IGetTrackSequence>;
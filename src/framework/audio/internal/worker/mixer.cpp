@@ -21,10 +21,11 @@
  */
 #include "mixer.h"
 
-#include "concurrency/taskscheduler.h"
+#include <thread>
 
 #include "internal/audiosanitizer.h"
 #include "internal/dsp/audiomathutils.h"
+#include "internal/dsp/mixkernels.h"
 #include "audioerrors.h"
 
 #include "log.h"
@@ -39,7 +40,8 @@ Mixer::Mixer()
 {
     ONLY_AUDIO_WORKER_THREAD;
 
-    m_minTrackCountForMultithreading = configuration()->minTrackCountForMultithreading();
+    m_renderPool = std::make_unique<AudioRenderPool>(configuration()->renderThreadCount());
+    m_controlCommands = std::make_shared<ControlCommandQueue>();
 }
 
 Mixer::~Mixer()
@@ -65,9 +67,14 @@ RetVal<MixerChannelPtr> Mixer::addChannel(const TrackId trackId, IAudioSourcePtr
         return result;
     }
 
-    m_trackChannels.emplace(trackId, std::make_shared<MixerChannel>(trackId, std::move(source), m_sampleRate));
+    TrackChannelInfo info;
+    info.channel = std::make_shared<MixerChannel>(trackId, std::move(source), m_sampleRate);
+    info.buffer = std::vector<float>(m_writeCacheBuff.size(), 0.f);
 
-    result.val = m_trackChannels[trackId];
+    m_trackChannels.emplace(trackId, std::move(info));
+    m_tracksToRender.reserve(m_trackChannels.size());
+
+    result.val = m_trackChannels.at(trackId).channel;
     result.ret = make_ret(Ret::Code::Ok);
 
     return result;
@@ -98,7 +105,7 @@ Ret Mixer::removeChannel(const TrackId trackId)
 
     auto search = m_trackChannels.find(trackId);
 
-    if (search != m_trackChannels.end() && search->second) {
+    if (search != m_trackChannels.end() && search->second.channel) {
         m_trackChannels.erase(trackId);
         return make_ret(Ret::Code::Ok);
     }
@@ -122,11 +129,12 @@ void Mixer::setSampleRate(unsigned int sampleRate)
     ONLY_AUDIO_WORKER_THREAD;
 
     m_limiter = std::make_unique<dsp::Limiter>(sampleRate);
+    m_signalMeter.setSampleRate(sampleRate);
 
     AbstractAudioSource::setSampleRate(sampleRate);
 
-    for (auto& channel : m_trackChannels) {
-        channel.second->setSampleRate(sampleRate);
+    for (auto& pair : m_trackChannels) {
+        pair.second.channel->setSampleRate(sampleRate);
     }
 }
 
@@ -141,6 +149,8 @@ samples_t Mixer::process(float* outBuffer, samples_t samplesPerChannel)
 {
     ONLY_AUDIO_WORKER_THREAD;
 
+    processControlCommands();
+
     for (IClockPtr clock : m_clocks) {
         clock->forward((samplesPerChannel * 1000000) / m_sampleRate);
     }
@@ -150,6 +160,7 @@ samples_t Mixer::process(float* outBuffer, samples_t samplesPerChannel)
 
     if (m_writeCacheBuff.size() != outBufferSize) {
         m_writeCacheBuff.resize(outBufferSize, 0.f);
+        prepareTrackBuffers(outBufferSize);
     }
 
     if (m_isIdle && m_tracksToProcessWhenIdle.empty() && m_isSilence) {
@@ -157,15 +168,19 @@ samples_t Mixer::process(float* outBuffer, samples_t samplesPerChannel)
         return 0;
     }
 
-    TracksData tracksData;
-    processTrackChannels(outBufferSize, samplesPerChannel, tracksData);
+    processTrackChannels(outBufferSize, samplesPerChannel);
 
     prepareAuxBuffers(outBufferSize);
 
     samples_t masterChannelSampleCount = 0;
 
-    for (auto& pair : tracksData) {
-        const std::vector<float>& trackBuffer = pair.second;
+    for (const auto& pair : m_trackChannels) {
+        const TrackChannelInfo& info = pair.second;
+        if (!info.processed) {
+            continue;
+        }
+
+        const std::vector<float>& trackBuffer = info.buffer;
 
         bool outBufferIsSilent = false;
         mixOutputFromChannel(outBuffer, trackBuffer.data(), samplesPerChannel, outBufferIsSilent);
@@ -177,7 +192,7 @@ samples_t Mixer::process(float* outBuffer, samples_t samplesPerChannel)
             continue;
         }
 
-        const AuxSendsParams& auxSends = m_trackChannels.at(pair.first)->outputParams().auxSends;
+        const AuxSendsParams& auxSends = info.channel->outputParams().auxSends;
         writeTrackToAuxBuffers(trackBuffer.data(), auxSends, samplesPerChannel);
     }
 
@@ -198,62 +213,50 @@ samples_t Mixer::process(float* outBuffer, samples_t samplesPerChannel)
     return masterChannelSampleCount;
 }
 
-void Mixer::processTrackChannels(size_t outBufferSize, size_t samplesPerChannel, TracksData& outTracksData)
+void Mixer::prepareTrackBuffers(size_t outBufferSize)
 {
-    auto processChannel = [outBufferSize, samplesPerChannel](MixerChannelPtr channel) -> std::vector<float> {
-        thread_local std::vector<float> buffer(outBufferSize, 0.f);
-        thread_local std::vector<float> silent_buffer(outBufferSize, 0.f);
+    for (auto& pair : m_trackChannels) {
+        std::vector<float>& buffer = pair.second.buffer;
 
-        buffer = silent_buffer;
-
-        if (channel) {
-            channel->process(buffer.data(), samplesPerChannel);
+        if (buffer.size() != outBufferSize) {
+            buffer.resize(outBufferSize, 0.f);
         }
+    }
+}
 
-        return buffer;
+void Mixer::processTrackChannels(size_t outBufferSize, size_t samplesPerChannel)
+{
+    //! NOTE: The buffers are preallocated in addChannel/prepareTrackBuffers,
+    //! so nothing is allocated here per audio block
+    auto processChannel = [outBufferSize, samplesPerChannel](TrackChannelInfo* info) {
+        float* buffer = info->buffer.data();
+        std::fill(buffer, buffer + outBufferSize, 0.f);
+        info->channel->process(buffer, samplesPerChannel);
     };
 
     bool filterTracks = m_isIdle && !m_tracksToProcessWhenIdle.empty();
 
-    if (useMultithreading()) {
-        std::map<TrackId, std::future<std::vector<float> > > futures;
+    m_tracksToRender.clear();
 
-        for (const auto& pair : m_trackChannels) {
-            if (filterTracks && !muse::contains(m_tracksToProcessWhenIdle, pair.second->trackId())) {
-                continue;
-            }
+    for (auto& pair : m_trackChannels) {
+        TrackChannelInfo& info = pair.second;
+        info.processed = info.channel && info.buffer.size() == outBufferSize;
 
-            std::future<std::vector<float> > future = TaskScheduler::instance()->submit(processChannel, pair.second);
-            futures.emplace(pair.first, std::move(future));
+        if (info.processed && filterTracks && !muse::contains(m_tracksToProcessWhenIdle, info.channel->trackId())) {
+            info.processed = false;
         }
 
-        for (auto& pair : futures) {
-            outTracksData.emplace(pair.first, pair.second.get());
-        }
-    } else {
-        for (const auto& pair : m_trackChannels) {
-            if (filterTracks && !muse::contains(m_tracksToProcessWhenIdle, pair.second->trackId())) {
-                continue;
-            }
-
-            outTracksData.emplace(pair.first, processChannel(pair.second));
+        if (info.processed) {
+            m_tracksToRender.push_back(&info);
         }
     }
-}
 
-bool Mixer::useMultithreading() const
-{
-    if (m_trackChannels.size() < m_minTrackCountForMultithreading) {
-        return false;
-    }
-
-    if (m_isIdle) {
-        if (m_tracksToProcessWhenIdle.size() < m_minTrackCountForMultithreading) {
-            return false;
-        }
-    }
+    auto processTrack = [this, &processChannel](size_t idx) {
+        processChannel(m_tracksToRender[idx]);
+    };
 
-    return true;
+    AudioRenderPool* renderPool = m_isOffline && m_offlineRenderPool ? m_offlineRenderPool.get() : m_renderPool.get();
+    renderPool->parallelFor(m_tracksToRender.size(), processTrack);
 }
 
 void Mixer::setIsActive(bool arg)
@@ -262,8 +265,8 @@ void Mixer::setIsActive(bool arg)
 
     AbstractAudioSource::setIsActive(arg);
 
-    for (const auto& channel : m_trackChannels) {
-        channel.second->setIsActive(arg);
+    for (const auto& pair : m_trackChannels) {
+        pair.second.channel->setIsActive(arg);
     }
 }
 
@@ -351,6 +354,39 @@ async::Channel<audioch_t, AudioSignalVal> Mixer::masterAudioSignalChanges() cons
     return m_audioSignalNotifier.audioSignalChanges;
 }
 
+ControlCommandQueuePtr Mixer::controlCommands() const
+{
+    return m_controlCommands;
+}
+
+void Mixer::processControlCommands()
+{
+    ONLY_AUDIO_WORKER_THREAD;
+
+    m_controlCommands->process([this](const ControlCommand& command) {
+        if (command.isMaster) {
+            if (applyControlCommand(command, m_masterParams)) {
+                m_masterOutputParamsChanged.send(m_masterParams);
+            }
+
+            return;
+        }
+
+        auto it = m_trackChannels.find(command.trackId);
+        if (it != m_trackChannels.end()) {
+            it->second.channel->applyControlCommand(command);
+            return;
+        }
+
+        for (AuxChannelInfo& aux : m_auxChannelInfoList) {
+            if (aux.channel->trackId() == command.trackId) {
+                aux.channel->applyControlCommand(command);
+                return;
+            }
+        }
+    });
+}
+
 void Mixer::setIsIdle(bool idle)
 {
     ONLY_AUDIO_WORKER_THREAD;
@@ -363,6 +399,25 @@ void Mixer::setIsIdle(bool idle)
     m_tracksToProcessWhenIdle.clear();
 }
 
+void Mixer::setIsOffline(bool offline)
+{
+    ONLY_AUDIO_WORKER_THREAD;
+
+    m_isOffline = offline;
+
+    //! NOTE: There is no real-time deadline when rendering offline (e.g. exporting),
+    //! so the tracks are rendered on all the cores instead of the configured share of them.
+    //! The pool is created by the first export and kept, its workers are parked between the exports
+    if (!offline || m_offlineRenderPool) {
+        return;
+    }
+
+    const size_t threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    if (threadCount > m_renderPool->threadCount()) {
+        m_offlineRenderPool = std::make_unique<AudioRenderPool>(threadCount);
+    }
+}
+
 void Mixer::setTracksToProcessWhenIdle(std::unordered_set<TrackId>&& trackIds)
 {
     ONLY_AUDIO_WORKER_THREAD;
@@ -382,18 +437,7 @@ void Mixer::mixOutputFromChannel(float* outBuffer, const float* inBuffer, unsign
         return;
     }
 
-    for (audioch_t audioChNum = 0; audioChNum < m_audioChannelsCount; ++audioChNum) {
-        for (samples_t s = 0; s < samplesCount; ++s) {
-            int idx = s * m_audioChannelsCount + audioChNum;
-            float sample = inBuffer[idx];
-
-            outBuffer[idx] += sample;
-
-            if (outBufferIsSilent && !RealIsNull(sample)) {
-                outBufferIsSilent = false;
-            }
-        }
-    }
+    outBufferIsSilent = dsp::mixSamples(outBuffer, inBuffer, samplesCount * m_audioChannelsCount);
 }
 
 void Mixer::prepareAuxBuffers(size_t outBufferSize)
@@ -430,16 +474,7 @@ void Mixer::writeTrackToAuxBuffers(const float* trackBuffer, const AuxSendsParam
             continue;
         }
 
-        float* auxBuffer = aux.buffer.data();
-        float signalAmount = auxSend.signalAmount;
-
-        for (audioch_t audioChNum = 0; audioChNum < m_audioChannelsCount; ++audioChNum) {
-            for (samples_t s = 0; s < samplesPerChannel; ++s) {
-                int idx = s * m_audioChannelsCount + audioChNum;
-
-                auxBuffer[idx] += trackBuffer[idx] * signalAmount;
-            }
-        }
+        dsp::mixSamplesWithGain(aux.buffer.data(), trackBuffer, auxSend.signalAmount, samplesPerChannel * m_audioChannelsCount);
 
         aux.receivedAudioSignal = true;
     }
@@ -455,7 +490,7 @@ void Mixer::processAuxChannels(float* buffer, samples_t samplesPerChannel)
         float* auxBuffer = aux.buffer.data();
         aux.channel->process(auxBuffer, samplesPerChannel);
 
-        static bool isSilent = false;
+        bool isSilent = false;
         mixOutputFromChannel(buffer, auxBuffer, samplesPerChannel, isSilent);
     }
 }
@@ -466,41 +501,29 @@ void Mixer::completeOutput(float* buffer, samples_t samplesPerChannel)
         return;
     }
 
-    m_isSilence = true;
-
-    float totalSquaredSum = 0.f;
     float volume = dsp::linearFromDecibels(m_masterParams.volume);
 
+    m_channelGains.resize(m_audioChannelsCount);
     for (audioch_t audioChNum = 0; audioChNum < m_audioChannelsCount; ++audioChNum) {
-        float singleChannelSquaredSum = 0.f;
-
-        gain_t totalGain = dsp::balanceGain(m_masterParams.balance, audioChNum) * volume;
-
-        for (samples_t s = 0; s < samplesPerChannel; ++s) {
-            int idx = s * m_audioChannelsCount + audioChNum;
+        m_channelGains[audioChNum] = dsp::balanceGain(m_masterParams.balance, audioChNum) * volume;
+    }
 
-            float resultSample = buffer[idx] * totalGain;
-            buffer[idx] = resultSample;
+    float* squaredSums = m_signalMeter.beginBlock(m_audioChannelsCount);
+    float maxAbsSample = dsp::applyChannelGains(buffer, m_audioChannelsCount, samplesPerChannel, m_channelGains.data(), squaredSums);
 
-            if (m_isSilence && !RealIsNull(resultSample)) {
-                m_isSilence = false;
-            }
+    m_isSilence = RealIsNull(maxAbsSample);
 
-            float squaredSample = resultSample * resultSample;
-            totalSquaredSum += squaredSample;
-            singleChannelSquaredSum += squaredSample;
+    if (m_signalMeter.endBlock(samplesPerChannel)) {
+        for (audioch_t audioChNum = 0; audioChNum < m_audioChannelsCount; ++audioChNum) {
+            notifyAboutAudioSignalChanges(audioChNum, m_signalMeter.rms(audioChNum));
         }
-
-        float rms = dsp::samplesRootMeanSquare(singleChannelSquaredSum, samplesPerChannel);
-        notifyAboutAudioSignalChanges(audioChNum, rms);
     }
 
     if (!m_limiter->isActive()) {
         return;
     }
 
-    float totalRms = dsp::samplesRootMeanSquare(totalSquaredSum, samplesPerChannel * m_audioChannelsCount);
-    m_limiter->process(totalRms, buffer, m_audioChannelsCount, samplesPerChannel);
+    m_limiter->process(m_signalMeter.blockRms(), buffer, m_audioChannelsCount, samplesPerChannel);
 }
 
 void Mixer::notifyNoAudioSignal()
@@ -508,9 +531,11 @@ void Mixer::notifyNoAudioSignal()
     for (audioch_t audioChNum = 0; audioChNum < m_audioChannelsCount; ++audioChNum) {
         notifyAboutAudioSignalChanges(audioChNum, 0);
     }
+
+    m_signalMeter.reset();
 }
 
 void Mixer::notifyAboutAudioSignalChanges(const audioch_t audioChannelNumber, const float linearRms) const
 {
-    m_audioSignalNotifier.updateSignalValues(audioChannelNumber, linearRms, dsp::dbFromSample(linearRms));
+    m_audioSignalNotifier.updateSignalValues(audioChannelNumber, linearRms, dsp::fastDbFromSample(linearRms));
 }
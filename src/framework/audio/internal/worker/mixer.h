@@ -31,7 +31,10 @@
 
 #include "abstractaudiosource.h"
 #include "mixerchannel.h"
+#include "audiorenderpool.h"
 #include "internal/dsp/limiter.h"
+#include "internal/dsp/signalmeter.h"
+#include "controlcommandqueue.h"
 #include "ifxresolver.h"
 #include "iaudioconfiguration.h"
 #include "iclock.h"
@@ -64,7 +67,12 @@ public:
 
     async::Channel<audioch_t, AudioSignalVal> masterAudioSignalChanges() const;
 
+    //! NOTE: The queue is filled by the main thread and processed at the beginning of every audio block
+    ControlCommandQueuePtr controlCommands() const;
+    void processControlCommands();
+
     void setIsIdle(bool idle);
+    void setIsOffline(bool offline);
     void setTracksToProcessWhenIdle(std::unordered_set<TrackId>&& trackIds);
 
     // IAudioSource
@@ -74,21 +82,25 @@ public:
     void setIsActive(bool arg) override;
 
 private:
-    using TracksData = std::map<TrackId, std::vector<float> >;
+    struct TrackChannelInfo {
+        MixerChannelPtr channel;
+        std::vector<float> buffer;
+        bool processed = false;
+    };
 
-    void processTrackChannels(size_t outBufferSize, size_t samplesPerChannel, TracksData& outTracksData);
+    void prepareTrackBuffers(size_t outBufferSize);
+    void processTrackChannels(size_t outBufferSize, size_t samplesPerChannel);
     void mixOutputFromChannel(float* outBuffer, const float* inBuffer, unsigned int samplesCount, bool& outBufferIsSilent);
     void prepareAuxBuffers(size_t outBufferSize);
     void writeTrackToAuxBuffers(const float* trackBuffer, const AuxSendsParams& auxSends, samples_t samplesPerChannel);
     void processAuxChannels(float* buffer, samples_t samplesPerChannel);
     void completeOutput(float* buffer, samples_t samplesPerChannel);
 
-    bool useMultithreading() const;
-
     void notifyNoAudioSignal();
     void notifyAboutAudioSignalChanges(const audioch_t audioChannelNumber, const float linearRms) const;
 
-    size_t m_minTrackCountForMultithreading = 0;
+    AudioRenderPoolPtr m_renderPool;
+    AudioRenderPoolPtr m_offlineRenderPool;
 
     std::vector<float> m_writeCacheBuff;
 
@@ -96,7 +108,10 @@ private:
     async::Channel<AudioOutputParams> m_masterOutputParamsChanged;
     std::vector<IFxProcessorPtr> m_masterFxProcessors = {};
 
-    std::map<TrackId, MixerChannelPtr> m_trackChannels = {};
+    ControlCommandQueuePtr m_controlCommands = nullptr;
+
+    std::map<TrackId, TrackChannelInfo> m_trackChannels = {};
+    std::vector<TrackChannelInfo*> m_tracksToRender;
     std::unordered_set<TrackId> m_tracksToProcessWhenIdle;
 
     struct AuxChannelInfo {
@@ -108,6 +123,8 @@ private:
     std::vector<AuxChannelInfo> m_auxChannelInfoList;
 
     dsp::LimiterPtr m_limiter = nullptr;
+    dsp::SignalMeter m_signalMeter;
+    std::vector<gain_t> m_channelGains;
 
     std::set<IClockPtr> m_clocks;
     audioch_t m_audioChannelsCount = 0;
@@ -116,6 +133,7 @@ private:
 
     bool m_isSilence = false;
     bool m_isIdle = false;
+    bool m_isOffline = false;
 };
 
 using MixerPtr = std::shared_ptr<Mixer>;
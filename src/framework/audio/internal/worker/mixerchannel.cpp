@@ -24,6 +24,7 @@
 #include <algorithm>
 
 #include "internal/dsp/audiomathutils.h"
+#include "internal/dsp/mixkernels.h"
 #include "internal/audiosanitizer.h"
 
 #include "log.h"
@@ -115,6 +116,15 @@ async::Channel<AudioOutputParams> MixerChannel::outputParamsChanged() const
     return m_paramsChanges;
 }
 
+void MixerChannel::applyControlCommand(const ControlCommand& command)
+{
+    ONLY_AUDIO_WORKER_THREAD;
+
+    if (audio::applyControlCommand(command, m_params)) {
+        m_paramsChanges.send(m_params);
+    }
+}
+
 async::Channel<audioch_t, AudioSignalVal> MixerChannel::audioSignalChanges() const
 {
     return m_audioSignalNotifier.audioSignalChanges;
@@ -147,6 +157,8 @@ void MixerChannel::setSampleRate(unsigned int sampleRate)
     for (IFxProcessorPtr fx : m_fxProcessors) {
         fx->setSampleRate(sampleRate);
     }
+
+    m_signalMeter.setSampleRate(sampleRate);
 }
 
 unsigned int MixerChannel::audioChannelsCount() const
@@ -181,6 +193,8 @@ samples_t MixerChannel::process(float* buffer, samples_t samplesPerChannel)
             notifyAboutAudioSignalChanges(audioChNum, 0.f);
         }
 
+        m_signalMeter.reset();
+
         return processedSamplesCount;
     }
 
@@ -196,42 +210,33 @@ samples_t MixerChannel::process(float* buffer, samples_t samplesPerChannel)
     return processedSamplesCount;
 }
 
-void MixerChannel::completeOutput(float* buffer, unsigned int samplesCount) const
+void MixerChannel::completeOutput(float* buffer, unsigned int samplesCount)
 {
     unsigned int channelsCount = audioChannelsCount();
     float volume = dsp::linearFromDecibels(m_params.volume);
-    float totalSquaredSum = 0.f;
 
+    m_channelGains.resize(channelsCount);
     for (audioch_t audioChNum = 0; audioChNum < channelsCount; ++audioChNum) {
-        float singleChannelSquaredSum = 0.f;
-
-        gain_t totalGain = dsp::balanceGain(m_params.balance, audioChNum) * volume;
-
-        for (unsigned int s = 0; s < samplesCount; ++s) {
-            int idx = s * channelsCount + audioChNum;
+        m_channelGains[audioChNum] = dsp::balanceGain(m_params.balance, audioChNum) * volume;
+    }
 
-            float resultSample = buffer[idx] * totalGain;
-            buffer[idx] = resultSample;
+    float* squaredSums = m_signalMeter.beginBlock(channelsCount);
+    dsp::applyChannelGains(buffer, channelsCount, samplesCount, m_channelGains.data(), squaredSums);
 
-            float squaredSample = resultSample * resultSample;
-            singleChannelSquaredSum += squaredSample;
-            totalSquaredSum += squaredSample;
+    if (m_signalMeter.endBlock(samplesCount)) {
+        for (audioch_t audioChNum = 0; audioChNum < channelsCount; ++audioChNum) {
+            notifyAboutAudioSignalChanges(audioChNum, m_signalMeter.rms(audioChNum));
         }
-
-        float rms = dsp::samplesRootMeanSquare(singleChannelSquaredSum, samplesCount);
-
-        notifyAboutAudioSignalChanges(audioChNum, rms);
     }
 
     if (!m_compressor->isActive()) {
         return;
     }
 
-    float totalRms = dsp::samplesRootMeanSquare(totalSquaredSum, samplesCount * channelsCount);
-    m_compressor->process(totalRms, buffer, channelsCount, samplesCount);
+    m_compressor->process(m_signalMeter.blockRms(), buffer, channelsCount, samplesCount);
 }
 
 void MixerChannel::notifyAboutAudioSignalChanges(const audioch_t audioChannelNumber, const float linearRms) const
 {
-    m_audioSignalNotifier.updateSignalValues(audioChannelNumber, linearRms, dsp::dbFromSample(linearRms));
+    m_audioSignalNotifier.updateSignalValues(audioChannelNumber, linearRms, dsp::fastDbFromSample(linearRms));
 }
@@ -29,6 +29,8 @@
 #include "ifxprocessor.h"
 #include "track.h"
 #include "internal/dsp/compressor.h"
+#include "internal/dsp/signalmeter.h"
+#include "controlcommandqueue.h"
 
 namespace muse::audio {
 class MixerChannel : public ITrackAudioOutput, public async::Asyncable
@@ -45,6 +47,8 @@ public:
     void applyOutputParams(const AudioOutputParams& requiredParams) override;
     async::Channel<AudioOutputParams> outputParamsChanged() const override;
 
+    void applyControlCommand(const ControlCommand& command);
+
     async::Channel<audioch_t, AudioSignalVal> audioSignalChanges() const override;
 
     bool isActive() const override;
@@ -56,7 +60,7 @@ public:
     samples_t process(float* buffer, samples_t samplesPerChannel) override;
 
 private:
-    void completeOutput(float* buffer, unsigned int samplesCount) const;
+    void completeOutput(float* buffer, unsigned int samplesCount);
     void notifyAboutAudioSignalChanges(const audioch_t audioChannelNumber, const float linearRms) const;
 
     TrackId m_trackId = -1;
@@ -69,6 +73,8 @@ private:
     std::vector<IFxProcessorPtr> m_fxProcessors = {};
 
     dsp::CompressorPtr m_compressor = nullptr;
+    dsp::SignalMeter m_signalMeter;
+    std::vector<gain_t> m_channelGains;
 
     mutable async::Channel<AudioOutputParams> m_paramsChanges;
     mutable AudioSignalsNotifier m_audioSignalNotifier;
@@ -159,3 +159,10 @@ ITrackSequencePtr Playback::sequence(const TrackSequenceId id) const
 
     return nullptr;
 }
+
+Channel<TrackSequenceId, TrackId> Playback::trackRemoved() const
+{
+    ONLY_AUDIO_MAIN_OR_WORKER_THREAD;
+
+    return m_trackHandlersPtr->trackRemoved();
+}
@@ -55,6 +55,7 @@ public:
 protected:
     // IGetTrackSequence
     ITrackSequencePtr sequence(const TrackSequenceId id) const override;
+    async::Channel<TrackSequenceId, TrackId> trackRemoved() const override;
 
 private:
     IPlayerPtr m_playerHandlersPtr = nullptr;
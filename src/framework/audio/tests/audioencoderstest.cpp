@@ -0,0 +1,284 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "FLAC++/decoder.h"
+
+#include "internal/encoders/wavencoder.h"
+#include "internal/encoders/flacencoder.h"
+#include "internal/encoders/oggencoder.h"
+
+using namespace muse;
+using namespace muse::audio;
+using namespace muse::audio::encode;
+
+namespace muse::audio {
+class Audio_EncodersTest : public ::testing::Test
+{
+protected:
+    void TearDown() override
+    {
+        std::remove(m_filePath.c_str());
+    }
+
+    static SoundTrackFormat format(SoundTrackType type)
+    {
+        SoundTrackFormat format;
+        format.type = type;
+        format.sampleRate = SAMPLE_RATE;
+        format.audioChannelsNumber = AUDIO_CHANNELS_COUNT;
+        format.bitRate = 128;
+        return format;
+    }
+
+    //! NOTE: A stereo sine of the given length, interleaved
+    static std::vector<float> sine(samples_t samplesPerChannel)
+    {
+        std::vector<float> samples(samplesPerChannel * AUDIO_CHANNELS_COUNT);
+        for (samples_t i = 0; i < samplesPerChannel; ++i) {
+            float value = 0.5f * std::sin(2.f * float(M_PI) * 440.f * i / SAMPLE_RATE);
+            samples[i * AUDIO_CHANNELS_COUNT] = value;
+            samples[i * AUDIO_CHANNELS_COUNT + 1] = -value;
+        }
+
+        return samples;
+    }
+
+    //! NOTE: Passes the samples to the encoder in chunks of different sizes, the way the writer streams them
+    static samples_t encodeInChunks(AbstractAudioEncoder& encoder, const std::vector<float>& samples)
+    {
+        static const samples_t CHUNK_SIZES[] = { 1000, 4096, 17, 2500 };
+
+        const samples_t totalSamplesPerChannel = samples.size() / AUDIO_CHANNELS_COUNT;
+        samples_t encodedSamplesPerChannel = 0;
+        size_t chunkIdx = 0;
+
+        while (encodedSamplesPerChannel < totalSamplesPerChannel) {
+            samples_t chunkSize = std::min(CHUNK_SIZES[chunkIdx], totalSamplesPerChannel - encodedSamplesPerChannel);
+            encoder.encode(chunkSize, samples.data() + encodedSamplesPerChannel * AUDIO_CHANNELS_COUNT);
+
+            encodedSamplesPerChannel += chunkSize;
+            chunkIdx = (chunkIdx + 1) % std::size(CHUNK_SIZES);
+        }
+
+        return encodedSamplesPerChannel;
+    }
+
+    std::vector<char> readFile() const
+    {
+        std::ifstream stream(m_filePath, std::ios_base::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+
+    template<typename T>
+    static T readValue(const std::vector<char>& data, size_t offset)
+    {
+        T value = 0;
+        std::memcpy(&value, data.data() + offset, sizeof(T)); // little endian
+        return value;
+    }
+
+    static constexpr audioch_t AUDIO_CHANNELS_COUNT = 2;
+    static constexpr unsigned int SAMPLE_RATE = 48000;
+    static constexpr samples_t SAMPLES_PER_CHANNEL = 48000;
+
+    //! NOTE: 18 bytes of the fmt chunk (with cbSize), see WavEncoder::writeHeader
+    static constexpr size_t WAV_HEADER_SIZE = 46;
+    static constexpr size_t WAV_DATA_SIZE_OFFSET = 42;
+
+    std::string m_filePath;
+};
+
+//! NOTE: Collects the decoded samples, normalized to [-1, 1]
+class FlacTestDecoder : public FLAC::Decoder::File
+{
+public:
+    std::vector<float> samples;
+    FLAC__uint64 totalSamples = 0;
+    unsigned int channels = 0;
+
+protected:
+    FLAC__StreamDecoderWriteStatus write_callback(const FLAC__Frame* frame, const FLAC__int32* const buffer[]) override
+    {
+        for (unsigned int i = 0; i < frame->header.blocksize; ++i) {
+            for (unsigned int c = 0; c < frame->header.channels; ++c) {
+                samples.push_back(static_cast<float>(buffer[c][i]) / 32767.f);
+            }
+        }
+
+        return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
+    }
+
+    void metadata_callback(const FLAC__StreamMetadata* metadata) override
+    {
+        if (metadata->type == FLAC__METADATA_TYPE_STREAMINFO) {
+            totalSamples = metadata->data.stream_info.total_samples;
+            channels = metadata->data.stream_info.channels;
+        }
+    }
+
+    void error_callback(FLAC__StreamDecoderErrorStatus) override
+    {
+        ADD_FAILURE() << "FLAC decoding error";
+    }
+};
+}
+
+TEST_F(Audio_EncodersTest, WavChunkedRoundTrip)
+{
+    m_filePath = "Audio_EncodersTest_WavChunkedRoundTrip.wav";
+
+    //! [GIVEN] A WAV encoder expecting the whole track
+    std::vector<float> samples = sine(SAMPLES_PER_CHANNEL);
+
+    WavEncoder encoder;
+    ASSERT_TRUE(encoder.init(m_filePath, format(SoundTrackType::WAV), SAMPLES_PER_CHANNEL));
+
+    //! [WHEN] The track is encoded chunk by chunk
+    EXPECT_EQ(encodeInChunks(encoder, samples), SAMPLES_PER_CHANNEL);
+    EXPECT_EQ(encoder.flush(), samples.size());
+
+    //! [THEN] The file has the header followed by all the samples, unchanged
+    std::vector<char> data = readFile();
+    const uint32_t dataSize = static_cast<uint32_t>(samples.size() * sizeof(float));
+
+    ASSERT_EQ(data.size(), WAV_HEADER_SIZE + dataSize);
+    EXPECT_EQ(std::string(data.data(), 4), "RIFF");
+    EXPECT_EQ(readValue<uint32_t>(data, 4), data.size() - 8);
+    EXPECT_EQ(readValue<uint32_t>(data, WAV_DATA_SIZE_OFFSET), dataSize);
+    EXPECT_EQ(std::memcmp(data.data() + WAV_HEADER_SIZE, samples.data(), dataSize), 0);
+}
+
+TEST_F(Audio_EncodersTest, WavHeaderIsFixedUpOnFlush)
+{
+    m_filePath = "Audio_EncodersTest_WavHeaderIsFixedUpOnFlush.wav";
+
+    //! [GIVEN] A WAV encoder expecting a longer track than the one it gets (e.g. the export was aborted)
+    std::vector<float> samples = sine(SAMPLES_PER_CHANNEL / 3);
+
+    WavEncoder encoder;
+    ASSERT_TRUE(encoder.init(m_filePath, format(SoundTrackType::WAV), SAMPLES_PER_CHANNEL));
+
+    //! [WHEN] The samples are encoded and the encoder is flushed
+    encodeInChunks(encoder, samples);
+    encoder.flush();
+
+    //! [THEN] The header describes the samples actually written
+    std::vector<char> data = readFile();
+    const uint32_t dataSize = static_cast<uint32_t>(samples.size() * sizeof(float));
+
+    ASSERT_EQ(data.size(), WAV_HEADER_SIZE + dataSize);
+    EXPECT_EQ(readValue<uint32_t>(data, 4), data.size() - 8);
+    EXPECT_EQ(readValue<uint32_t>(data, WAV_DATA_SIZE_OFFSET), dataSize);
+    EXPECT_EQ(std::memcmp(data.data() + WAV_HEADER_SIZE, samples.data(), dataSize), 0);
+}
+
+TEST_F(Audio_EncodersTest, FlacChunkedRoundTrip)
+{
+    m_filePath = "Audio_EncodersTest_FlacChunkedRoundTrip.flac";
+
+    //! [GIVEN] A FLAC encoder
+    std::vector<float> samples = sine(SAMPLES_PER_CHANNEL);
+
+    FlacEncoder encoder;
+    ASSERT_TRUE(encoder.init(m_filePath, format(SoundTrackType::FLAC), SAMPLES_PER_CHANNEL));
+
+    //! [WHEN] The track is encoded chunk by chunk and the encoder is flushed
+    encodeInChunks(encoder, samples);
+    encoder.flush();
+
+    //! [THEN] The decoded track has all the samples, within the 16 bit precision
+    FlacTestDecoder decoder;
+    ASSERT_EQ(decoder.init(m_filePath.c_str()), FLAC__STREAM_DECODER_INIT_STATUS_OK);
+    ASSERT_TRUE(decoder.process_until_end_of_stream());
+    decoder.finish();
+
+    EXPECT_EQ(decoder.totalSamples, SAMPLES_PER_CHANNEL);
+    EXPECT_EQ(decoder.channels, AUDIO_CHANNELS_COUNT);
+    ASSERT_EQ(decoder.samples.size(), samples.size());
+
+    for (size_t i = 0; i < samples.size(); ++i) {
+        ASSERT_NEAR(decoder.samples[i], samples[i], 1.f / 16384.f) << "sample " << i;
+    }
+}
+
+TEST_F(Audio_EncodersTest, OggDrainWritesWholeTrack)
+{
+    m_filePath = "Audio_EncodersTest_OggDrainWritesWholeTrack.ogg";
+
+    //! [GIVEN] An OGG encoder (48 kHz, so the granule positions are in samples of the track)
+    std::vector<float> samples = sine(SAMPLES_PER_CHANNEL);
+
+    OggEncoder encoder;
+    ASSERT_TRUE(encoder.init(m_filePath, format(SoundTrackType::OGG), SAMPLES_PER_CHANNEL));
+
+    //! [WHEN] The track is encoded chunk by chunk and the encoder is flushed
+    encodeInChunks(encoder, samples);
+    encoder.flush();
+
+    //! [THEN] The stream is finished: the last page ends the stream at the last sample of the track
+    std::vector<char> data = readFile();
+
+    size_t offset = 0;
+    size_t pagesCount = 0;
+    uint16_t preSkip = 0;
+    uint8_t lastHeaderType = 0;
+    int64_t lastGranulePosition = 0;
+
+    while (offset + 27 <= data.size()) {
+        ASSERT_EQ(std::string(data.data() + offset, 4), "OggS") << "page " << pagesCount;
+
+        const uint8_t headerType = static_cast<uint8_t>(data[offset + 5]);
+        const int64_t granulePosition = readValue<int64_t>(data, offset + 6);
+        const uint8_t segmentsCount = static_cast<uint8_t>(data[offset + 26]);
+
+        size_t bodySize = 0;
+        for (uint8_t s = 0; s < segmentsCount; ++s) {
+            bodySize += static_cast<uint8_t>(data[offset + 27 + s]);
+        }
+
+        const size_t bodyOffset = offset + 27 + segmentsCount;
+        if (pagesCount == 0) {
+            ASSERT_EQ(std::string(data.data() + bodyOffset, 8), "OpusHead");
+            preSkip = readValue<uint16_t>(data, bodyOffset + 10);
+        }
+
+        lastHeaderType = headerType;
+        lastGranulePosition = granulePosition;
+
+        offset = bodyOffset + bodySize;
+        ++pagesCount;
+    }
+
+    EXPECT_EQ(offset, data.size());
+    EXPECT_GT(pagesCount, 2);
+    EXPECT_TRUE(lastHeaderType & 0x04); // end of stream
+    EXPECT_EQ(lastGranulePosition - preSkip, static_cast<int64_t>(SAMPLES_PER_CHANNEL));
+}
@@ -0,0 +1,241 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "global/async/asyncable.h"
+#include "global/async/channel.h"
+
+#include "internal/audiothread.h"
+#include "internal/audiobuffer.h"
+
+using namespace muse;
+using namespace muse::audio;
+
+//! NOTE: The benchmarks are disabled by default, run them with:
+//! muse_audio_test --gtest_also_run_disabled_tests --gtest_filter=Audio_AudioThreadTest.DISABLED_*
+
+namespace muse::audio {
+class Audio_AudioThreadTest : public ::testing::Test, public async::Asyncable
+{
+protected:
+    //! NOTE: Outputs one block of non-silent samples after each trigger
+    class TriggeredSource : public IAudioSource
+    {
+    public:
+        bool isActive() const override { return true; }
+        void setIsActive(bool) override {}
+        void setSampleRate(unsigned int) override {}
+        unsigned int audioChannelsCount() const override { return 2; }
+        async::Channel<unsigned int> audioChannelsCountChanged() const override { return {}; }
+
+        samples_t process(float* buffer, samples_t samplesPerChannel) override
+        {
+            float value = triggered.exchange(false) ? 1.f : 0.f;
+            std::fill(buffer, buffer + samplesPerChannel * 2, value);
+            return samplesPerChannel;
+        }
+
+        std::atomic<bool> triggered = false;
+    };
+
+    template<typename Predicate>
+    static bool waitFor(Predicate predicate, std::chrono::milliseconds timeout = std::chrono::milliseconds(1000))
+    {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!predicate()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+
+        return true;
+    }
+
+    static constexpr samples_t RENDER_STEP = 512;
+    static constexpr samples_t DRIVER_BUFFER_SIZE = 512;
+};
+}
+
+TEST_F(Audio_AudioThreadTest, IdleThreadDoesNotPoll)
+{
+    std::atomic<size_t> loopCount = 0;
+
+    AudioThread thread;
+    thread.run(nullptr, [&loopCount]() {
+        ++loopCount;
+    });
+
+    //! [GIVEN] The thread has been started and nothing happens
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    //! [THEN] It has run the loop once and then slept
+    EXPECT_LE(loopCount.load(), 2u);
+
+    //! [WHEN] It is woken up
+    size_t countBeforeWakeup = loopCount;
+    thread.wakeup();
+
+    //! [THEN] The loop body is run again
+    EXPECT_TRUE(waitFor([&]() { return loopCount > countBeforeWakeup; }));
+
+    thread.stop();
+}
+
+TEST_F(Audio_AudioThreadTest, QueuedEventWakesUpThread)
+{
+    async::Channel<int> channel;
+    std::atomic<bool> subscribed = false;
+    std::atomic<int> received = 0;
+
+    AudioThread thread;
+    thread.run([this, &channel, &subscribed, &received]() {
+        channel.onReceive(this, [&received](int value) {
+            received = value;
+        });
+        subscribed = true;
+    }, nullptr);
+
+    //! [GIVEN] The thread has subscribed and is sleeping
+    ASSERT_TRUE(waitFor([&]() { return subscribed.load(); }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    //! [WHEN] A value is sent to a receiver on the thread
+    channel.send(42);
+
+    //! [THEN] It is received without waiting for any polling interval
+    EXPECT_TRUE(waitFor([&]() { return received == 42; }));
+
+    thread.stop();
+}
+
+TEST_F(Audio_AudioThreadTest, ConcurrentWakeupsAreNotLost)
+{
+    constexpr int THREAD_COUNT = 4;
+    constexpr int WAKEUPS_PER_THREAD = 10000;
+
+    std::atomic<int> requested = 0;
+    std::atomic<int> served = 0;
+
+    AudioThread thread;
+    thread.run(nullptr, [&requested, &served]() {
+        served = requested.load();
+    });
+
+    //! [WHEN] Several threads (e.g. the driver's callback and the event senders) request wakeups at once
+    std::vector<std::thread> requesters;
+    for (int t = 0; t < THREAD_COUNT; ++t) {
+        requesters.emplace_back([&thread, &requested]() {
+            for (int i = 0; i < WAKEUPS_PER_THREAD; ++i) {
+                ++requested;
+                thread.wakeup();
+            }
+        });
+    }
+
+    for (std::thread& requester : requesters) {
+        requester.join();
+    }
+
+    //! [THEN] The loop body runs after the last request, no wakeup is lost
+    EXPECT_TRUE(waitFor([&]() { return served == THREAD_COUNT * WAKEUPS_PER_THREAD; }));
+
+    thread.stop();
+}
+
+TEST_F(Audio_AudioThreadTest, DISABLED_TriggerLatency)
+{
+    constexpr int TRIGGER_COUNT = 50;
+
+    //! NOTE: Simulates a note preview: the trigger is sent from this thread (as triggerEventsForItems does),
+    //! received on the audio thread, rendered into the buffer, and read by a thread that plays the driver
+    auto source = std::make_shared<TriggeredSource>();
+    auto buffer = std::make_shared<AudioBuffer>();
+    buffer->init(2, RENDER_STEP);
+    buffer->setMinSamplesToReserve(DRIVER_BUFFER_SIZE);
+
+    AudioThread thread;
+    buffer->setOnDataRequested([&thread]() {
+        thread.wakeup();
+    });
+
+    async::Channel<bool> trigger;
+    thread.run([this, &trigger, source, buffer]() {
+        buffer->setSource(source);
+        trigger.onReceive(this, [source](bool) {
+            source->triggered = true;
+        });
+    }, [buffer]() {
+        buffer->forward();
+    });
+
+    using clock = std::chrono::steady_clock;
+    std::atomic<bool> driverRunning = true;
+    std::atomic<clock::rep> soundStart = 0;
+
+    std::thread driver([&]() {
+        std::vector<float> output(DRIVER_BUFFER_SIZE * 2);
+        auto period = std::chrono::microseconds(DRIVER_BUFFER_SIZE * 1000000 / 48000);
+
+        while (driverRunning) {
+            buffer->pop(output.data(), DRIVER_BUFFER_SIZE);
+
+            if (soundStart == 0 && std::any_of(output.begin(), output.end(), [](float v) { return v != 0.f; })) {
+                soundStart = clock::now().time_since_epoch().count();
+            }
+
+            std::this_thread::sleep_for(period);
+        }
+    });
+
+    double latencySum = 0.0;
+    double latencyMax = 0.0;
+
+    for (int i = 0; i < TRIGGER_COUNT; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+
+        soundStart = 0;
+        clock::time_point triggerTime = clock::now();
+        trigger.send(true);
+
+        ASSERT_TRUE(waitFor([&]() { return soundStart != 0; }));
+
+        std::chrono::duration<double, std::milli> latency = clock::duration(soundStart.load()) - triggerTime.time_since_epoch();
+        latencySum += latency.count();
+        latencyMax = std::max(latencyMax, latency.count());
+    }
+
+    driverRunning = false;
+    driver.join();
+    thread.stop();
+
+    std::cout << "trigger to first non-silent sample, average: " << latencySum / TRIGGER_COUNT
+              << " ms, max: " << latencyMax << " ms" << std::endl;
+}
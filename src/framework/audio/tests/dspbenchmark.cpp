@@ -0,0 +1,124 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include "internal/dsp/compressor.h"
+#include "internal/dsp/limiter.h"
+#include "internal/dsp/mixkernels.h"
+#include "internal/dsp/signalmeter.h"
+
+using namespace muse;
+using namespace muse::audio;
+using namespace muse::audio::dsp;
+
+//! NOTE: The benchmarks are disabled by default, run them with:
+//! muse_audio_test --gtest_also_run_disabled_tests --gtest_filter=Audio_DspBenchmark.*
+
+namespace muse::audio {
+class Audio_DspBenchmark : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_buffer.resize(SAMPLES_PER_CHANNEL * AUDIO_CHANNELS_COUNT);
+    }
+
+    //! NOTE: Refills the buffer before every block, so that the gains don't accumulate
+    void fillBuffer()
+    {
+        for (size_t i = 0; i < m_buffer.size(); ++i) {
+            m_buffer[i] = 0.9f * std::sin(0.01f * static_cast<float>(i));
+        }
+    }
+
+    void runBenchmark(const std::string& name, const std::function<void(float*)>& processBlock)
+    {
+        for (size_t i = 0; i < WARMUP_BLOCKS; ++i) {
+            fillBuffer();
+            processBlock(m_buffer.data());
+        }
+
+        std::chrono::duration<double, std::nano> total(0);
+
+        for (size_t i = 0; i < MEASURED_BLOCKS; ++i) {
+            fillBuffer();
+
+            auto start = std::chrono::steady_clock::now();
+            processBlock(m_buffer.data());
+            total += std::chrono::steady_clock::now() - start;
+        }
+
+        const double nsPerSample = total.count() / (static_cast<double>(MEASURED_BLOCKS) * SAMPLES_PER_CHANNEL * AUDIO_CHANNELS_COUNT);
+
+        std::cout << name << ": " << nsPerSample << " ns/sample" << std::endl;
+    }
+
+    static constexpr audioch_t AUDIO_CHANNELS_COUNT = 2;
+    static constexpr unsigned int SAMPLE_RATE = 48000;
+    static constexpr samples_t SAMPLES_PER_CHANNEL = 512;
+    static constexpr size_t WARMUP_BLOCKS = 100;
+    static constexpr size_t MEASURED_BLOCKS = 20000;
+
+    std::vector<float> m_buffer;
+};
+}
+
+TEST_F(Audio_DspBenchmark, DISABLED_ChannelGainsAndMetering)
+{
+    SignalMeter meter;
+    meter.setSampleRate(SAMPLE_RATE);
+
+    const float gains[AUDIO_CHANNELS_COUNT] = { 0.8f, 1.2f };
+
+    runBenchmark("channel gains + metering", [&meter, &gains](float* buffer) {
+        float* squaredSums = meter.beginBlock(AUDIO_CHANNELS_COUNT);
+        applyChannelGains(buffer, AUDIO_CHANNELS_COUNT, SAMPLES_PER_CHANNEL, gains, squaredSums);
+        meter.endBlock(SAMPLES_PER_CHANNEL);
+    });
+}
+
+TEST_F(Audio_DspBenchmark, DISABLED_Limiter)
+{
+    Limiter limiter(SAMPLE_RATE);
+    limiter.setIsActive(true);
+
+    runBenchmark("limiter", [&limiter](float* buffer) {
+        limiter.process(0.9f, buffer, AUDIO_CHANNELS_COUNT, SAMPLES_PER_CHANNEL);
+    });
+}
+
+TEST_F(Audio_DspBenchmark, DISABLED_Compressor)
+{
+    Compressor compressor(SAMPLE_RATE);
+    compressor.setIsActive(true);
+
+    runBenchmark("compressor", [&compressor](float* buffer) {
+        compressor.process(0.9f, buffer, AUDIO_CHANNELS_COUNT, SAMPLES_PER_CHANNEL);
+    });
+}
@@ -0,0 +1,155 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "internal/dsp/audiomathutils.h"
+#include "internal/dsp/mixkernels.h"
+#include "internal/dsp/signalmeter.h"
+
+using namespace muse;
+using namespace muse::audio;
+using namespace muse::audio::dsp;
+
+namespace muse::audio {
+class Audio_DspTest : public ::testing::Test
+{
+public:
+    static std::vector<float> makeBuffer(size_t samplesCount)
+    {
+        std::vector<float> buffer(samplesCount);
+        for (size_t i = 0; i < samplesCount; ++i) {
+            buffer[i] = std::sin(0.37f * static_cast<float>(i)) * (i % 3 == 0 ? -0.8f : 0.5f);
+        }
+
+        return buffer;
+    }
+};
+}
+
+TEST_F(Audio_DspTest, ApplyChannelGains_MatchesScalar)
+{
+    //! [GIVEN] Buffers with 1, 2 and 3 interleaved channels and a size which is not a multiple of the vector size
+    for (size_t channelsCount : { 1u, 2u, 3u }) {
+        constexpr size_t SAMPLES_PER_CHANNEL = 131;
+
+        const std::vector<float> gains = { 0.5f, 1.25f, 0.75f };
+
+        std::vector<float> buffer = makeBuffer(SAMPLES_PER_CHANNEL * channelsCount);
+        std::vector<float> expectedBuffer = buffer;
+        std::vector<float> expectedSums(channelsCount, 0.f);
+        float expectedPeak = 0.f;
+
+        for (size_t i = 0; i < expectedBuffer.size(); ++i) {
+            expectedBuffer[i] *= gains[i % channelsCount];
+            expectedSums[i % channelsCount] += expectedBuffer[i] * expectedBuffer[i];
+            expectedPeak = std::max(expectedPeak, std::fabs(expectedBuffer[i]));
+        }
+
+        //! [WHEN] Apply the gains
+        std::vector<float> sums(channelsCount, 0.f);
+        float peak = applyChannelGains(buffer.data(), channelsCount, SAMPLES_PER_CHANNEL, gains.data(), sums.data());
+
+        //! [THEN] The results are the same as the scalar ones
+        for (size_t i = 0; i < buffer.size(); ++i) {
+            EXPECT_FLOAT_EQ(buffer[i], expectedBuffer[i]);
+        }
+
+        for (size_t ch = 0; ch < channelsCount; ++ch) {
+            EXPECT_NEAR(sums[ch], expectedSums[ch], 1e-4f * expectedSums[ch]);
+        }
+
+        EXPECT_FLOAT_EQ(peak, expectedPeak);
+    }
+}
+
+TEST_F(Audio_DspTest, MultiplySamples)
+{
+    //! [GIVEN] A buffer
+    std::vector<float> buffer = makeBuffer(103);
+    std::vector<float> expectedBuffer = buffer;
+
+    //! [WHEN] Multiply it
+    multiplySamples(buffer.data(), 0.3f, buffer.size());
+
+    //! [THEN] Every sample is multiplied
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        EXPECT_FLOAT_EQ(buffer[i], expectedBuffer[i] * 0.3f);
+    }
+}
+
+TEST_F(Audio_DspTest, FastDecibels_Accuracy)
+{
+    //! [GIVEN] The whole operable range of the meters and the dynamics
+    for (float db = -120.f; db <= 24.f; db += 0.37f) {
+        //! [THEN] The approximations are close to the precise values
+        EXPECT_NEAR(fastLinearFromDecibels(db), linearFromDecibels(db), linearFromDecibels(db) * 0.0003f);
+
+        float sample = linearFromDecibels(db);
+        EXPECT_NEAR(fastDbFromSample(sample), dbFromSample(sample), 0.002f);
+        EXPECT_NEAR(fastDbFromSample(-sample), dbFromSample(-sample), 0.002f);
+    }
+}
+
+TEST_F(Audio_DspTest, SignalMeter_Decimation)
+{
+    //! [GIVEN] A meter, the meters are updated every 1600 samples
+    constexpr unsigned int SAMPLE_RATE = 48000;
+    constexpr samples_t SAMPLES_PER_CHANNEL = 512;
+    constexpr audioch_t CHANNELS_COUNT = 2;
+
+    SignalMeter meter;
+    meter.setSampleRate(SAMPLE_RATE);
+
+    //! [WHEN] Feed blocks with the constant values 0.5 (left) and 0.25 (right)
+    size_t updatesCount = 0;
+    size_t blocksCount = 0;
+
+    while (updatesCount == 0) {
+        float* sums = meter.beginBlock(CHANNELS_COUNT);
+        sums[0] += SAMPLES_PER_CHANNEL * 0.25f;
+        sums[1] += SAMPLES_PER_CHANNEL * 0.0625f;
+
+        ++blocksCount;
+        if (meter.endBlock(SAMPLES_PER_CHANNEL)) {
+            ++updatesCount;
+        }
+
+        //! [THEN] The RMS of the block is available after every block
+        EXPECT_FLOAT_EQ(meter.blockRms(), std::sqrt((0.25f + 0.0625f) / 2.f));
+    }
+
+    //! [THEN] The meters are updated only when the period is complete, with the RMS of the whole period
+    EXPECT_EQ(blocksCount, 4u);
+    EXPECT_FLOAT_EQ(meter.rms(0), 0.5f);
+    EXPECT_FLOAT_EQ(meter.rms(1), 0.25f);
+
+    //! [WHEN] Reset the meter
+    meter.reset();
+
+    //! [THEN] The values are zero
+    EXPECT_FLOAT_EQ(meter.rms(0), 0.f);
+    EXPECT_FLOAT_EQ(meter.rms(1), 0.f);
+}
@@ -0,0 +1,112 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+
+#include "internal/audiosanitizer.h"
+#include "internal/synthesizers/fluidsynth/fluidsequencer.h"
+
+using namespace muse;
+using namespace muse::audio;
+using namespace muse::mpe;
+
+//! NOTE: The benchmarks are disabled by default, run them with:
+//! muse_audio_test --gtest_also_run_disabled_tests --gtest_filter=Audio_EventSequencerBenchmark.*
+
+namespace muse::audio {
+class Audio_EventSequencerBenchmark : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        AudioSanitizer::setupWorkerThread();
+    }
+
+    static PlaybackEventsMap buildNoteEvents(size_t count)
+    {
+        static const ArticulationMap emptyArticulations;
+
+        PlaybackEventsMap result;
+
+        for (size_t i = 0; i < count; ++i) {
+            timestamp_t timestamp = static_cast<timestamp_t>(i) * NOTE_STEP;
+            pitch_level_t pitch = pitchLevel(PitchClass::C, 4) + static_cast<pitch_level_t>(i % 12) * PITCH_LEVEL_STEP;
+
+            result[timestamp].emplace_back(NoteEvent(timestamp, NOTE_STEP / 2, 0, 0, pitch,
+                                                     dynamicLevelFromType(DynamicType::Natural), emptyArticulations, 2.0));
+        }
+
+        return result;
+    }
+
+    static constexpr timestamp_t NOTE_STEP = 10000;
+    static constexpr msecs_t BLOCK_DURATION = 2667; // 128 samples at 48kHz
+};
+}
+
+TEST_F(Audio_EventSequencerBenchmark, DISABLED_Track100k)
+{
+    constexpr size_t NOTE_COUNT = 100000;
+    constexpr int REBUILD_COUNT = 10;
+
+    mpe::PlaybackData data;
+    data.originEvents = buildNoteEvents(NOTE_COUNT);
+
+    FluidSequencer sequencer;
+    sequencer.init(data.setupData, midi::Program(0, 0));
+
+    auto start = std::chrono::steady_clock::now();
+    sequencer.load(data);
+    double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < REBUILD_COUNT; ++i) {
+        sequencer.updateMainStreamEvents(data.originEvents, data.dynamicLevelMap, data.paramMap);
+    }
+    double rebuildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / REBUILD_COUNT;
+
+    sequencer.setPlaybackPosition(0);
+    sequencer.setActive(true);
+
+    FluidSequencer::EventSequence events;
+    size_t playedCount = 0;
+    size_t blockCount = 0;
+
+    start = std::chrono::steady_clock::now();
+    for (msecs_t position = 0; position < NOTE_COUNT * NOTE_STEP; position += BLOCK_DURATION) {
+        sequencer.eventsToBePlayed(BLOCK_DURATION, events);
+        playedCount += events.size();
+        ++blockCount;
+    }
+    double playMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "notes: " << NOTE_COUNT
+              << ", load: " << loadMs << " ms"
+              << ", rebuild: " << rebuildMs << " ms"
+              << ", played events: " << playedCount
+              << ", blocks: " << blockCount
+              << ", per block: " << 1000000.0 * playMs / blockCount << " ns"
+              << std::endl;
+}
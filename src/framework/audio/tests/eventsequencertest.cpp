@@ -0,0 +1,429 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "internal/audiosanitizer.h"
+#include "internal/audiothread.h"
+#include "internal/synthesizers/fluidsynth/fluidsequencer.h"
+
+#include "testing/allocationcounter.h"
+
+using namespace muse;
+using namespace muse::audio;
+using namespace muse::mpe;
+
+namespace muse::audio {
+class Audio_EventSequencerTest : public ::testing::Test
+{
+protected:
+    using PlayedEvents = std::vector<std::pair<msecs_t, midi::Event> >;
+
+    void SetUp() override
+    {
+        AudioSanitizer::setupWorkerThread();
+    }
+
+    static PlaybackEventsMap buildNoteEvents(size_t count, pitch_level_t pitchOffset = 0, duration_t duration = NOTE_STEP / 2)
+    {
+        static const ArticulationMap emptyArticulations;
+
+        PlaybackEventsMap result;
+
+        for (size_t i = 0; i < count; ++i) {
+            timestamp_t timestamp = static_cast<timestamp_t>(i) * NOTE_STEP;
+            pitch_level_t pitch = pitchLevel(PitchClass::C, 4) + static_cast<pitch_level_t>(i % 12) * PITCH_LEVEL_STEP + pitchOffset;
+
+            result[timestamp].emplace_back(NoteEvent(timestamp, duration, 0, 0, pitch,
+                                                     dynamicLevelFromType(DynamicType::Natural), emptyArticulations, 2.0));
+        }
+
+        return result;
+    }
+
+    static void load(FluidSequencer& sequencer, mpe::PlaybackData& data)
+    {
+        sequencer.init(data.setupData, midi::Program(0, 0));
+        sequencer.load(data);
+        sequencer.setPlaybackPosition(0);
+        sequencer.setActive(true);
+    }
+
+    static PlayedEvents playAll(FluidSequencer& sequencer, msecs_t duration)
+    {
+        PlayedEvents result;
+        FluidSequencer::EventSequence events;
+
+        sequencer.setPlaybackPosition(0);
+
+        for (msecs_t position = 0; position < duration; position += BLOCK_DURATION) {
+            sequencer.eventsToBePlayed(BLOCK_DURATION, events);
+
+            for (const FluidSequencer::EventType& event : events) {
+                result.emplace_back(position, std::get<midi::Event>(event));
+            }
+        }
+
+        return result;
+    }
+
+    static PlaybackEventsChanges rangeChanges(const PlaybackEventsMap& events, timestamp_t from, timestamp_t to)
+    {
+        PlaybackEventsChanges changes;
+        changes.from = from;
+        changes.to = to;
+        changes.events.insert(events.lower_bound(from), events.upper_bound(to));
+        return changes;
+    }
+
+    static constexpr timestamp_t NOTE_STEP = 10000;
+    static constexpr msecs_t BLOCK_DURATION = NOTE_STEP / 4;
+};
+}
+
+TEST_F(Audio_EventSequencerTest, PlaysAllNotes)
+{
+    //! [GIVEN] A track with many notes
+    constexpr size_t NOTE_COUNT = 1000;
+
+    mpe::PlaybackData data;
+    data.originEvents = buildNoteEvents(NOTE_COUNT);
+
+    FluidSequencer sequencer;
+    load(sequencer, data);
+
+    //! [WHEN] The whole track is played
+    PlayedEvents played = playAll(sequencer, NOTE_COUNT * NOTE_STEP);
+
+    //! [THEN] Every note has been started and stopped, in time order
+    size_t noteOnCount = 0;
+    size_t noteOffCount = 0;
+
+    for (size_t i = 0; i < played.size(); ++i) {
+        if (played[i].second.opcode() == midi::Event::Opcode::NoteOn) {
+            ++noteOnCount;
+        } else if (played[i].second.opcode() == midi::Event::Opcode::NoteOff) {
+            ++noteOffCount;
+        }
+
+        if (i > 0) {
+            EXPECT_LE(played[i - 1].first, played[i].first);
+        }
+    }
+
+    EXPECT_EQ(noteOnCount, NOTE_COUNT);
+    EXPECT_EQ(noteOffCount, NOTE_COUNT);
+}
+
+TEST_F(Audio_EventSequencerTest, PlaybackDoesNotAllocate)
+{
+    //! [GIVEN] A track with 100k notes
+    constexpr size_t NOTE_COUNT = 100000;
+
+    mpe::PlaybackData data;
+    data.originEvents = buildNoteEvents(NOTE_COUNT);
+
+    FluidSequencer sequencer;
+    load(sequencer, data);
+
+    //! [GIVEN] The playback has started (the first blocks may prepare the output)
+    FluidSequencer::EventSequence events;
+    for (int i = 0; i < 8; ++i) {
+        sequencer.eventsToBePlayed(BLOCK_DURATION, events);
+    }
+
+    //! [WHEN] Play the rest of the track
+    size_t playedCount = 0;
+
+    muse::testing::startCountingAllocations();
+
+    for (msecs_t position = 8 * BLOCK_DURATION; position < NOTE_COUNT * NOTE_STEP; position += BLOCK_DURATION) {
+        sequencer.eventsToBePlayed(BLOCK_DURATION, events);
+        playedCount += events.size();
+    }
+
+    size_t allocationsCount = muse::testing::stopCountingAllocations();
+
+    //! [THEN] The events have been played, but nothing has been allocated
+    EXPECT_GT(playedCount, NOTE_COUNT);
+    EXPECT_EQ(allocationsCount, 0);
+}
+
+TEST_F(Audio_EventSequencerTest, RebuildDoesNotAllocate)
+{
+    //! [GIVEN] A loaded track with 100k notes
+    constexpr size_t NOTE_COUNT = 100000;
+
+    mpe::PlaybackData data;
+    data.originEvents = buildNoteEvents(NOTE_COUNT);
+
+    FluidSequencer sequencer;
+    load(sequencer, data);
+
+    //! [WHEN] The same events are loaded once again
+    muse::testing::startCountingAllocations();
+    sequencer.updateMainStreamEvents(data.originEvents, data.dynamicLevelMap, data.paramMap);
+    size_t allocationsCount = muse::testing::stopCountingAllocations();
+
+    //! [THEN] The storage of the events has been reused
+    EXPECT_EQ(allocationsCount, 0);
+}
+
+TEST_F(Audio_EventSequencerTest, PatchedEventsMatchFullRebuild)
+{
+    //! [GIVEN] A loaded track
+    constexpr size_t NOTE_COUNT = 1000;
+
+    mpe::PlaybackData data;
+    data.originEvents = buildNoteEvents(NOTE_COUNT);
+
+    FluidSequencer patchedSequencer;
+    load(patchedSequencer, data);
+
+    //! [WHEN] The notes within a range get transposed
+    PlaybackEventsMap transposed = buildNoteEvents(NOTE_COUNT, 2 * PITCH_LEVEL_STEP);
+
+    PlaybackEventsChanges changes;
+    changes.from = 100 * NOTE_STEP;
+    changes.to = 200 * NOTE_STEP;
+    changes.events.insert(transposed.lower_bound(changes.from), transposed.upper_bound(changes.to));
+
+    data.mainStream.send(changes, data.dynamicLevelMap, data.paramMap);
+
+    //! [THEN] The patched sequencer plays exactly what a sequencer loaded with the resulting events plays
+    mpe::PlaybackData expectedData;
+    expectedData.originEvents = data.originEvents;
+    changes.applyTo(expectedData.originEvents);
+
+    FluidSequencer expectedSequencer;
+    load(expectedSequencer, expectedData);
+
+    EXPECT_EQ(playAll(patchedSequencer, NOTE_COUNT * NOTE_STEP), playAll(expectedSequencer, NOTE_COUNT * NOTE_STEP));
+}
+
+TEST_F(Audio_EventSequencerTest, PatchedOverlappingNotesMatchFullRebuild)
+{
+    //! [GIVEN] A loaded track, each note sounds over the next three ones
+    constexpr size_t NOTE_COUNT = 400;
+    constexpr duration_t LONG_DURATION = 3 * NOTE_STEP + NOTE_STEP / 2;
+    constexpr msecs_t TRACK_DURATION = (NOTE_COUNT + 30) * NOTE_STEP;
+
+    mpe::PlaybackData data;
+    data.originEvents = buildNoteEvents(NOTE_COUNT, 0, LONG_DURATION);
+
+    FluidSequencer patchedSequencer;
+    load(patchedSequencer, data);
+
+    PlaybackEventsMap expectedEvents = data.originEvents;
+
+    auto applyAndCompare = [&](const PlaybackEventsChanges& changes) {
+        data.mainStream.send(changes, data.dynamicLevelMap, data.paramMap);
+        changes.applyTo(expectedEvents);
+
+        mpe::PlaybackData expectedData;
+        expectedData.originEvents = expectedEvents;
+
+        FluidSequencer expectedSequencer;
+        load(expectedSequencer, expectedData);
+
+        EXPECT_EQ(playAll(patchedSequencer, TRACK_DURATION), playAll(expectedSequencer, TRACK_DURATION));
+    };
+
+    //! [WHEN] The notes of a range are transposed, the notes before the range still sound within it
+    //! [THEN] The patched sequencer plays what a sequencer loaded with the resulting events plays
+    PlaybackEventsMap transposed = buildNoteEvents(NOTE_COUNT, 2 * PITCH_LEVEL_STEP, LONG_DURATION);
+    applyAndCompare(rangeChanges(transposed, 100 * NOTE_STEP, 120 * NOTE_STEP));
+
+    //! [WHEN] The notes of a range are removed
+    //! [THEN] The same
+    applyAndCompare(rangeChanges(PlaybackEventsMap(), 200 * NOTE_STEP, 210 * NOTE_STEP));
+
+    //! [WHEN] A note sounding far past its range is added into the gap
+    //! [THEN] The same
+    PlaybackEventsMap longNotes = buildNoteEvents(NOTE_COUNT, PITCH_LEVEL_STEP, 20 * NOTE_STEP);
+    applyAndCompare(rangeChanges(longNotes, 205 * NOTE_STEP, 205 * NOTE_STEP));
+
+    //! [WHEN] The long note is replaced by a short one again
+    //! [THEN] The same, the tail of the long note is gone
+    applyAndCompare(rangeChanges(transposed, 205 * NOTE_STEP, 205 * NOTE_STEP));
+
+    //! [WHEN] The first and the last notes are changed
+    //! [THEN] The same
+    applyAndCompare(rangeChanges(transposed, 0, 0));
+    applyAndCompare(rangeChanges(longNotes, (NOTE_COUNT - 1) * NOTE_STEP, (NOTE_COUNT - 1) * NOTE_STEP));
+}
+
+TEST_F(Audio_EventSequencerTest, PatchFlushesOnlyWhenPlaybackIsWithinRange)
+{
+    //! [GIVEN] A loaded track
+    constexpr size_t NOTE_COUNT = 1000;
+
+    mpe::PlaybackData data;
+    data.originEvents = buildNoteEvents(NOTE_COUNT);
+
+    FluidSequencer sequencer;
+    load(sequencer, data);
+
+    size_t flushCount = 0;
+    sequencer.setOnMainStreamFlushed([&flushCount]() {
+        ++flushCount;
+    });
+
+    PlaybackEventsMap transposed = buildNoteEvents(NOTE_COUNT, 2 * PITCH_LEVEL_STEP);
+
+    //! [WHEN] The notes after the playback position are changed
+    sequencer.setPlaybackPosition(50 * NOTE_STEP);
+    data.mainStream.send(rangeChanges(transposed, 100 * NOTE_STEP, 200 * NOTE_STEP), data.dynamicLevelMap, data.paramMap);
+
+    //! [THEN] The sounding notes are kept
+    EXPECT_EQ(flushCount, 0);
+
+    //! [WHEN] The notes around the playback position are changed
+    sequencer.setPlaybackPosition(150 * NOTE_STEP);
+    data.mainStream.send(rangeChanges(data.originEvents, 100 * NOTE_STEP, 200 * NOTE_STEP), data.dynamicLevelMap, data.paramMap);
+
+    //! [THEN] The sounding notes are stopped, the playback continues with the new events
+    EXPECT_EQ(flushCount, 1);
+
+    FluidSequencer::EventSequence events;
+    sequencer.eventsToBePlayed(NOTE_STEP, events);
+
+    auto noteOn = std::find_if(events.begin(), events.end(), [](const FluidSequencer::EventType& event) {
+        return std::get<midi::Event>(event).opcode() == midi::Event::Opcode::NoteOn;
+    });
+
+    ASSERT_NE(noteOn, events.end());
+
+    mpe::PlaybackData expectedData;
+    expectedData.originEvents = data.originEvents;
+
+    FluidSequencer expectedSequencer;
+    load(expectedSequencer, expectedData);
+    expectedSequencer.setPlaybackPosition(150 * NOTE_STEP);
+
+    FluidSequencer::EventSequence expectedEvents;
+    expectedSequencer.eventsToBePlayed(NOTE_STEP, expectedEvents);
+
+    EXPECT_EQ(events, expectedEvents);
+}
+
+TEST_F(Audio_EventSequencerTest, DISABLED_EditToAudibleLatency)
+{
+    constexpr int EDIT_COUNT = 50;
+    constexpr size_t NOTE_COUNT = 10000;
+    constexpr timestamp_t EDIT_POSITION = (NOTE_COUNT / 2) * NOTE_STEP;
+    constexpr samples_t DRIVER_BUFFER_SIZE = 512;
+
+    //! NOTE: Simulates the edit of the note under the playback cursor: the changes are sent from this thread
+    //! (as PlaybackModel does), received on the audio thread, patched into the sequencer, and played by the next block.
+    //! The driver thread requests a block every period, as the output buffer does;
+    //! the time the block then spends in the output buffer is not included
+    mpe::PlaybackData data;
+    data.originEvents = buildNoteEvents(NOTE_COUNT);
+
+    const PlaybackEventsMap transposed = buildNoteEvents(NOTE_COUNT, 2 * PITCH_LEVEL_STEP);
+
+    FluidSequencer sequencer;
+    FluidSequencer::EventSequence events;
+    std::atomic<int> playedNote = -1;
+
+    AudioThread thread;
+    thread.run([&sequencer, &data]() {
+        AudioSanitizer::setupWorkerThread();
+        load(sequencer, data);
+    }, [&sequencer, &events, &playedNote]() {
+        //! NOTE: Each block plays the edited note again
+        sequencer.setPlaybackPosition(EDIT_POSITION - BLOCK_DURATION / 2);
+        sequencer.eventsToBePlayed(BLOCK_DURATION, events);
+
+        for (const FluidSequencer::EventType& event : events) {
+            const midi::Event& midiEvent = std::get<midi::Event>(event);
+            if (midiEvent.opcode() == midi::Event::Opcode::NoteOn) {
+                playedNote = midiEvent.note();
+            }
+        }
+    });
+
+    std::atomic<bool> driverRunning = true;
+    std::thread driver([&thread, &driverRunning]() {
+        auto period = std::chrono::microseconds(DRIVER_BUFFER_SIZE * 1000000 / 48000);
+
+        while (driverRunning) {
+            thread.wakeup();
+            std::this_thread::sleep_for(period);
+        }
+    });
+
+    auto waitForNote = [&playedNote](int note) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (playedNote != note) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+
+            std::this_thread::yield();
+        }
+
+        return true;
+    };
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (playedNote < 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    const int originNote = playedNote;
+    ASSERT_GE(originNote, 0);
+
+    double latencySum = 0.0;
+    double latencyMax = 0.0;
+
+    for (int i = 0; i < EDIT_COUNT; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        const bool isTransposed = i % 2 == 0;
+        PlaybackEventsChanges changes = rangeChanges(isTransposed ? transposed : data.originEvents, EDIT_POSITION, EDIT_POSITION);
+
+        auto editTime = std::chrono::steady_clock::now();
+        data.mainStream.send(changes, data.dynamicLevelMap, data.paramMap);
+
+        ASSERT_TRUE(waitForNote(isTransposed ? originNote + 2 : originNote));
+
+        std::chrono::duration<double, std::milli> latency = std::chrono::steady_clock::now() - editTime;
+        latencySum += latency.count();
+        latencyMax = std::max(latencyMax, latency.count());
+    }
+
+    driverRunning = false;
+    driver.join();
+    thread.stop();
+
+    std::cout << "edit to the first block playing the edited note, average: " << latencySum / EDIT_COUNT
+              << " ms, max: " << latencyMax << " ms (driver period: " << DRIVER_BUFFER_SIZE * 1000.0 / 48000 << " ms)"
+              << std::endl;
+}
@@ -0,0 +1,160 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2023 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#include "global/modularity/ioc.h"
+
+#include "internal/audiosanitizer.h"
+#include "internal/worker/mixer.h"
+#include "internal/worker/noisesource.h"
+#include "internal/worker/sinesource.h"
+
+#include "tests/mocks/audioconfigurationmock.h"
+
+using ::testing::NiceMock;
+using ::testing::Return;
+
+using namespace muse;
+using namespace muse::audio;
+
+//! NOTE: The benchmarks are disabled by default, run them with:
+//! muse_audio_test --gtest_also_run_disabled_tests --gtest_filter=Audio_MixerBenchmark.*
+
+namespace muse::audio {
+class Audio_MixerBenchmark : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        AudioSanitizer::setupWorkerThread();
+
+        m_configuration = std::make_shared<NiceMock<AudioConfigurationMock> >();
+        ON_CALL(*m_configuration, audioChannelsCount()).WillByDefault(Return(AUDIO_CHANNELS_COUNT));
+
+        modularity::ioc()->registerExport<IAudioConfiguration>("utests", m_configuration);
+    }
+
+    void TearDown() override
+    {
+        modularity::ioc()->unregisterIfRegistered<IAudioConfiguration>("utests", m_configuration);
+    }
+
+    void runBenchmark(size_t trackCount, size_t renderThreadCount)
+    {
+        ON_CALL(*m_configuration, renderThreadCount()).WillByDefault(Return(renderThreadCount));
+
+        MixerPtr mixer = std::make_shared<Mixer>();
+        mixer->setAudioChannelsCount(AUDIO_CHANNELS_COUNT);
+        mixer->setSampleRate(SAMPLE_RATE);
+
+        for (size_t i = 0; i < trackCount; ++i) {
+            IAudioSourcePtr source;
+
+            //! NOTE: Half sine, half noise
+            if (i % 2 == 0) {
+                source = std::make_shared<SineSource>();
+            } else {
+                source = std::make_shared<NoiseSource>();
+            }
+
+            source->setSampleRate(SAMPLE_RATE);
+            mixer->addChannel(static_cast<TrackId>(i), source);
+        }
+
+        std::vector<float> buffer(SAMPLES_PER_CHANNEL * AUDIO_CHANNELS_COUNT, 0.f);
+
+        for (size_t i = 0; i < WARMUP_BLOCKS; ++i) {
+            mixer->process(buffer.data(), SAMPLES_PER_CHANNEL);
+        }
+
+        std::vector<double> timesUs;
+        timesUs.reserve(MEASURED_BLOCKS);
+
+        for (size_t i = 0; i < MEASURED_BLOCKS; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            mixer->process(buffer.data(), SAMPLES_PER_CHANNEL);
+            auto end = std::chrono::steady_clock::now();
+
+            timesUs.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+        }
+
+        std::sort(timesUs.begin(), timesUs.end());
+
+        auto percentile = [&timesUs](double p) {
+            size_t idx = std::min(static_cast<size_t>(p * timesUs.size()), timesUs.size() - 1);
+            return timesUs[idx];
+        };
+
+        const double deadlineUs = 1000000.0 * SAMPLES_PER_CHANNEL / SAMPLE_RATE;
+        size_t missedDeadlines = std::count_if(timesUs.begin(), timesUs.end(), [deadlineUs](double t) {
+            return t > deadlineUs;
+        });
+
+        std::cout << "tracks: " << trackCount
+                  << ", render threads: " << renderThreadCount
+                  << ", p50: " << percentile(0.5) << " us"
+                  << ", p95: " << percentile(0.95) << " us"
+                  << ", p99: " << percentile(0.99) << " us"
+                  << ", max: " << timesUs.back() << " us"
+                  << ", deadline: " << deadlineUs << " us"
+                  << ", missed: " << missedDeadlines << "/" << MEASURED_BLOCKS
+                  << std::endl;
+    }
+
+    void runBenchmarks(size_t trackCount)
+    {
+        size_t maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+        for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+            runBenchmark(trackCount, threads);
+        }
+    }
+
+    static constexpr audioch_t AUDIO_CHANNELS_COUNT = 2;
+    static constexpr unsigned int SAMPLE_RATE = 48000;
+    static constexpr samples_t SAMPLES_PER_CHANNEL = 128;
+    static constexpr size_t WARMUP_BLOCKS = 100;
+    static constexpr size_t MEASURED_BLOCKS = 5000;
+
+    std::shared_ptr<AudioConfigurationMock> m_configuration;
+};
+}
+
+TEST_F(Audio_MixerBenchmark, DISABLED_CallbackTime_16Tracks)
+{
+    runBenchmarks(16);
+}
+
+TEST_F(Audio_MixerBenchmark, DISABLED_CallbackTime_64Tracks)
+{
+    runBenchmarks(64);
+}
+
+TEST_F(Audio_MixerBenchmark, DISABLED_CallbackTime_256Tracks)
+{
+    runBenchmarks(256);
+}
@@ -0,0 +1,315 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2023 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "global/modularity/ioc.h"
+
+#include "internal/audiosanitizer.h"
+#include "internal/worker/mixer.h"
+#include "internal/worker/sinesource.h"
+
+#include "tests/mocks/audioconfigurationmock.h"
+#include "testing/allocationcounter.h"
+
+using ::testing::NiceMock;
+using ::testing::Return;
+
+using namespace muse;
+using namespace muse::audio;
+
+namespace muse::audio {
+class Audio_MixerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        AudioSanitizer::setupWorkerThread();
+
+        m_configuration = std::make_shared<NiceMock<AudioConfigurationMock> >();
+        ON_CALL(*m_configuration, audioChannelsCount()).WillByDefault(Return(AUDIO_CHANNELS_COUNT));
+
+        ON_CALL(*m_configuration, renderThreadCount()).WillByDefault(Return(RENDER_THREAD_COUNT));
+
+        modularity::ioc()->registerExport<IAudioConfiguration>("utests", m_configuration);
+
+        m_mixer = std::make_shared<Mixer>();
+        m_mixer->setAudioChannelsCount(AUDIO_CHANNELS_COUNT);
+        m_mixer->setSampleRate(SAMPLE_RATE);
+    }
+
+    void TearDown() override
+    {
+        m_channels.clear();
+        m_mixer.reset();
+        modularity::ioc()->unregisterIfRegistered<IAudioConfiguration>("utests", m_configuration);
+    }
+
+    void addSineTracks(size_t count)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            auto source = std::make_shared<SineSource>();
+            source->setSampleRate(SAMPLE_RATE);
+
+            RetVal<MixerChannelPtr> channel = m_mixer->addChannel(static_cast<TrackId>(i), source);
+            ASSERT_TRUE(channel.ret);
+
+            m_channels.push_back(channel.val);
+        }
+    }
+
+    static ControlCommand volumeCommand(TrackId trackId, volume_db_t volume)
+    {
+        ControlCommand command;
+        command.type = ControlCommand::Type::SetVolume;
+        command.trackId = trackId;
+        command.value = volume;
+        return command;
+    }
+
+    static constexpr audioch_t AUDIO_CHANNELS_COUNT = 2;
+    static constexpr unsigned int SAMPLE_RATE = 48000;
+    static constexpr samples_t SAMPLES_PER_CHANNEL = 128;
+    static constexpr size_t RENDER_THREAD_COUNT = 4;
+
+    std::shared_ptr<AudioConfigurationMock> m_configuration;
+    MixerPtr m_mixer;
+    std::vector<MixerChannelPtr> m_channels;
+};
+}
+
+TEST_F(Audio_MixerTest, ProcessDoesNotAllocate)
+{
+    //! [GIVEN] A mixer with many tracks
+    addSineTracks(64);
+
+    std::vector<float> buffer(SAMPLES_PER_CHANNEL * AUDIO_CHANNELS_COUNT, 0.f);
+
+    //! [GIVEN] The playback has started: the first blocks may prepare the buffers,
+    //! and the first meter updates (see SignalMeter::UPDATES_PER_SECOND) register the signal values
+    for (samples_t samples = 0; samples < SAMPLE_RATE; samples += SAMPLES_PER_CHANNEL) {
+        m_mixer->process(buffer.data(), SAMPLES_PER_CHANNEL);
+    }
+
+    //! [WHEN] Process many audio blocks
+    muse::testing::startCountingAllocations();
+
+    samples_t processedSamples = 0;
+    for (int i = 0; i < 1000; ++i) {
+        processedSamples = m_mixer->process(buffer.data(), SAMPLES_PER_CHANNEL);
+    }
+
+    size_t allocationsCount = muse::testing::stopCountingAllocations();
+
+    //! [THEN] The signal is there, but nothing has been allocated
+    EXPECT_EQ(processedSamples, SAMPLES_PER_CHANNEL);
+    EXPECT_EQ(allocationsCount, 0);
+}
+
+TEST_F(Audio_MixerTest, MixSumsAllTracks)
+{
+    //! [GIVEN] A mixer with one track
+    addSineTracks(1);
+
+    std::vector<float> singleTrack(SAMPLES_PER_CHANNEL * AUDIO_CHANNELS_COUNT, 0.f);
+    m_mixer->process(singleTrack.data(), SAMPLES_PER_CHANNEL);
+
+    //! [GIVEN] Another mixer with the same track twice
+    m_mixer = std::make_shared<Mixer>();
+    m_mixer->setAudioChannelsCount(AUDIO_CHANNELS_COUNT);
+    m_mixer->setSampleRate(SAMPLE_RATE);
+    addSineTracks(2);
+
+    //! [WHEN] Process one block
+    std::vector<float> twoTracks(SAMPLES_PER_CHANNEL * AUDIO_CHANNELS_COUNT, 0.f);
+    m_mixer->process(twoTracks.data(), SAMPLES_PER_CHANNEL);
+
+    //! [THEN] The output is the sum of the tracks
+    for (size_t i = 0; i < twoTracks.size(); ++i) {
+        EXPECT_NEAR(twoTracks[i], 2.f * singleTrack[i], 1e-5f);
+    }
+}
+
+TEST_F(Audio_MixerTest, ControlCommands_LatestValueIsApplied)
+{
+    //! [GIVEN] A mixer with two tracks
+    addSineTracks(2);
+
+    //! [GIVEN] Many fader moves of both tracks and a mute of the first one
+    ControlCommandQueuePtr commands = m_mixer->controlCommands();
+
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(commands->push(volumeCommand(0, -0.5f * i)));
+        EXPECT_TRUE(commands->push(volumeCommand(1, -0.25f * i)));
+    }
+
+    ControlCommand mute;
+    mute.type = ControlCommand::Type::SetMuted;
+    mute.trackId = 0;
+    mute.flag = true;
+    EXPECT_TRUE(commands->push(mute));
+
+    //! [WHEN] Process one block
+    std::vector<float> buffer(SAMPLES_PER_CHANNEL * AUDIO_CHANNELS_COUNT, 0.f);
+    m_mixer->process(buffer.data(), SAMPLES_PER_CHANNEL);
+
+    //! [THEN] The channels have the latest values
+    EXPECT_FLOAT_EQ(m_channels[0]->outputParams().volume, -49.5f);
+    EXPECT_TRUE(m_channels[0]->outputParams().muted);
+    EXPECT_FLOAT_EQ(m_channels[1]->outputParams().volume, -24.75f);
+    EXPECT_FALSE(m_channels[1]->outputParams().muted);
+}
+
+TEST_F(Audio_MixerTest, ControlCommands_ManyTargetsAreCoalesced)
+{
+    //! [GIVEN] A mixer with many tracks
+    constexpr size_t TRACKS_COUNT = 64;
+    addSineTracks(TRACKS_COUNT);
+
+    //! [GIVEN] Several volume and balance changes of every track, interleaved
+    ControlCommandQueuePtr commands = m_mixer->controlCommands();
+
+    for (int i = 0; i < 4; ++i) {
+        for (size_t track = 0; track < TRACKS_COUNT; ++track) {
+            EXPECT_TRUE(commands->push(volumeCommand(static_cast<TrackId>(track), -static_cast<volume_db_t>(track + i))));
+
+            ControlCommand balance;
+            balance.type = ControlCommand::Type::SetBalance;
+            balance.trackId = static_cast<TrackId>(track);
+            balance.value = 0.1f * i;
+            EXPECT_TRUE(commands->push(balance));
+        }
+    }
+
+    //! [WHEN] Process one block
+    std::vector<float> buffer(SAMPLES_PER_CHANNEL * AUDIO_CHANNELS_COUNT, 0.f);
+    m_mixer->process(buffer.data(), SAMPLES_PER_CHANNEL);
+
+    //! [THEN] Every channel has its latest values
+    for (size_t track = 0; track < TRACKS_COUNT; ++track) {
+        EXPECT_FLOAT_EQ(m_channels[track]->outputParams().volume, -static_cast<volume_db_t>(track + 3));
+        EXPECT_FLOAT_EQ(m_channels[track]->outputParams().balance, 0.3f);
+    }
+}
+
+TEST_F(Audio_MixerTest, ControlCommands_WaitForFullUpdate)
+{
+    //! [GIVEN] A mixer with one track
+    addSineTracks(1);
+
+    ControlCommandQueuePtr commands = m_mixer->controlCommands();
+    std::vector<float> buffer(SAMPLES_PER_CHANNEL * AUDIO_CHANNELS_COUNT, 0.f);
+
+    //! [GIVEN] A command sent before and after a full update, which is not applied yet
+    EXPECT_TRUE(commands->push(volumeCommand(0, -3.f)));
+    uint64_t syncId = commands->beginFullUpdate();
+    EXPECT_TRUE(commands->push(volumeCommand(0, -6.f)));
+
+    //! [WHEN] Process one block
+    m_mixer->process(buffer.data(), SAMPLES_PER_CHANNEL);
+
+    //! [THEN] Only the command sent before the full update is applied
+    EXPECT_FLOAT_EQ(m_channels[0]->outputParams().volume, -3.f);
+
+    //! [WHEN] The full update is applied
+    //! NOTE: Its params aren't applied here, that would need the fx resolver
+    commands->endFullUpdate(syncId);
+
+    m_mixer->process(buffer.data(), SAMPLES_PER_CHANNEL);
+
+    //! [THEN] The later command is applied after it
+    EXPECT_FLOAT_EQ(m_channels[0]->outputParams().volume, -6.f);
+}
+
+TEST_F(Audio_MixerTest, ControlCommands_FaderAutomationStress)
+{
+    //! [GIVEN] A mixer with many tracks
+    constexpr size_t TRACKS_COUNT = 32;
+    constexpr size_t BLOCKS_COUNT = 2000;
+
+    addSineTracks(TRACKS_COUNT);
+
+    std::vector<float> buffer(SAMPLES_PER_CHANNEL * AUDIO_CHANNELS_COUNT, 0.f);
+    ControlCommandQueuePtr commands = m_mixer->controlCommands();
+
+    //! [GIVEN] The "main thread" moves all the faders as fast as it can
+    std::atomic<bool> stop = false;
+    std::vector<volume_db_t> lastVolumes(TRACKS_COUNT, 0.f);
+    size_t sentCount = 0;
+
+    std::thread producer([&]() {
+        for (size_t step = 0; !stop.load(std::memory_order_relaxed); ++step) {
+            for (size_t track = 0; track < TRACKS_COUNT; ++track) {
+                volume_db_t volume = -static_cast<volume_db_t>((step + track) % 60);
+
+                while (!commands->push(volumeCommand(static_cast<TrackId>(track), volume))) {
+                    if (stop.load(std::memory_order_relaxed)) {
+                        return;
+                    }
+
+                    std::this_thread::yield();
+                }
+
+                lastVolumes[track] = volume;
+                ++sentCount;
+            }
+        }
+    });
+
+    //! [WHEN] Process the audio blocks meanwhile
+    const double deadlineUs = 1000000.0 * SAMPLES_PER_CHANNEL / SAMPLE_RATE;
+    size_t missedDeadlines = 0;
+    double maxTimeUs = 0;
+
+    for (size_t i = 0; i < BLOCKS_COUNT; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        m_mixer->process(buffer.data(), SAMPLES_PER_CHANNEL);
+        double timeUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        maxTimeUs = std::max(maxTimeUs, timeUs);
+        if (timeUs > deadlineUs) {
+            ++missedDeadlines;
+        }
+    }
+
+    stop = true;
+    producer.join();
+
+    m_mixer->process(buffer.data(), SAMPLES_PER_CHANNEL);
+
+    std::cout << "fader commands: " << sentCount
+              << ", max block time: " << maxTimeUs << " us"
+              << ", deadline: " << deadlineUs << " us"
+              << ", missed: " << missedDeadlines << "/" << BLOCKS_COUNT
+              << std::endl;
+
+    //! [THEN] Every channel ends up with the last value sent to it
+    for (size_t track = 0; track < TRACKS_COUNT; ++track) {
+        EXPECT_FLOAT_EQ(m_channels[track]->outputParams().volume, lastVolumes[track]);
+    }
+}
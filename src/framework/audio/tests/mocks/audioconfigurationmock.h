@@ -50,7 +50,8 @@ public:
     MOCK_METHOD(void, setSampleRate, (unsigned int), (override));
     MOCK_METHOD(async::Notification, sampleRateChanged, (), (const, override));
 
-    MOCK_METHOD(size_t, minTrackCountForMultithreading, (), (const, override));
+    MOCK_METHOD(size_t, renderThreadCount, (), (const, override));
+    MOCK_METHOD(void, setRenderThreadCount, (size_t), (override));
 
     // synthesizers
     MOCK_METHOD(AudioInputParams, defaultAudioInputParams, (), (const, override));
@@ -60,6 +61,8 @@ public:
     MOCK_METHOD(void, setUserSoundFontDirectories, (const io::paths_t&), (override));
     MOCK_METHOD(async::Channel<io::paths_t>, soundFontDirectoriesChanged, (), (const, override));
 
+    MOCK_METHOD(io::path_t, soundFontSamplesCachePath, (), (const, override));
+
     MOCK_METHOD(io::path_t, knownAudioPluginsFilePath, (), (const, override));
 };
 }
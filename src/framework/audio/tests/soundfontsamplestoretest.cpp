@@ -0,0 +1,369 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <vector>
+
+#include <sfloader/fluid_samplecache.h>
+
+#include "global/io/dir.h"
+
+#include "internal/synthesizers/fluidsynth/sfsamplestore.h"
+
+using namespace muse;
+using namespace muse::audio;
+using namespace muse::audio::synth;
+
+namespace muse::audio {
+class Audio_SoundFontSampleStoreTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        //! NOTE: Some header bytes, then the sample chunk
+        m_soundFontData.assign(SAMPLE_POS / sizeof(short), 0);
+        for (short i = 0; i < SAMPLE_COUNT; ++i) {
+            m_soundFontData.push_back(i);
+        }
+
+        std::FILE* file = std::fopen(SOUNDFONT_PATH, "wb");
+        ASSERT_TRUE(file);
+        std::fwrite(m_soundFontData.data(), sizeof(short), m_soundFontData.size(), file);
+        std::fclose(file);
+
+        SoundFontSampleStore::instance()->init(CACHE_PATH);
+    }
+
+    void TearDown() override
+    {
+        std::remove(SOUNDFONT_PATH);
+        io::Dir(CACHE_PATH).removeRecursively();
+    }
+
+    static constexpr const char* SOUNDFONT_PATH = "Audio_SoundFontSampleStoreTest.sf2";
+    static constexpr const char* CACHE_PATH = "Audio_SoundFontSampleStoreTest_cache";
+
+    static constexpr unsigned int SAMPLE_POS = 64;
+    static constexpr short SAMPLE_COUNT = 1000;
+    static constexpr unsigned int SAMPLE_SIZE = SAMPLE_COUNT * sizeof(short);
+
+    std::vector<short> m_soundFontData;
+};
+
+//! NOTE: Records the calls Fluid makes to the sample provider
+struct ProviderCalls {
+    int loadCount = 0;
+    int storeCount = 0;
+    int releaseCount = 0;
+
+    int loadResult = -1;
+    std::vector<short> providedData;
+    std::vector<short> storedData;
+    const short* releasedData = nullptr;
+
+    static ProviderCalls* instance()
+    {
+        static ProviderCalls calls;
+        return &calls;
+    }
+
+    static int load(void*, const char*, time_t, unsigned int, unsigned int, unsigned int, unsigned int, int, short** sampleData)
+    {
+        ProviderCalls* calls = instance();
+        ++calls->loadCount;
+
+        if (calls->loadResult >= 0) {
+            *sampleData = calls->providedData.data();
+        }
+
+        return calls->loadResult;
+    }
+
+    static void store(void*, const char*, time_t, unsigned int, unsigned int, unsigned int, unsigned int, int,
+                      const short* sampleData, int sampleCount)
+    {
+        ProviderCalls* calls = instance();
+        ++calls->storeCount;
+        calls->storedData.assign(sampleData, sampleData + sampleCount);
+    }
+
+    static void release(void*, const short* sampleData)
+    {
+        ProviderCalls* calls = instance();
+        ++calls->releaseCount;
+        calls->releasedData = sampleData;
+    }
+};
+
+static void* openFile(const char* filename)
+{
+    return std::fopen(filename, "rb");
+}
+
+static int readFile(void* buf, fluid_long_long_t count, void* handle)
+{
+    return std::fread(buf, static_cast<size_t>(count), 1, static_cast<std::FILE*>(handle)) == 1 ? FLUID_OK : FLUID_FAILED;
+}
+
+static int seekFile(void* handle, fluid_long_long_t offset, int origin)
+{
+    return std::fseek(static_cast<std::FILE*>(handle), static_cast<long>(offset), origin) == 0 ? FLUID_OK : FLUID_FAILED;
+}
+
+static int closeFile(void* handle)
+{
+    return std::fclose(static_cast<std::FILE*>(handle)) == 0 ? FLUID_OK : FLUID_FAILED;
+}
+
+static fluid_long_long_t tellFile(void* handle)
+{
+    return std::ftell(static_cast<std::FILE*>(handle));
+}
+
+static const fluid_file_callbacks_t FILE_CALLBACKS { openFile, readFile, seekFile, closeFile, tellFile };
+}
+
+TEST_F(Audio_SoundFontSampleStoreTest, Sf2SamplePointsIntoSoundFont)
+{
+    SoundFontSampleStore* store = SoundFontSampleStore::instance();
+
+    //! [WHEN] A sample of a SF2 soundfont is loaded
+    short* sampleData = nullptr;
+    int sampleCount = store->loadSample(SOUNDFONT_PATH, 0, SAMPLE_POS, SAMPLE_SIZE, 100, 199, FLUID_SAMPLETYPE_MONO, &sampleData);
+
+    //! [THEN] Its data is the one of the soundfont file
+    ASSERT_EQ(sampleCount, 100);
+    ASSERT_TRUE(sampleData);
+    for (int i = 0; i < sampleCount; ++i) {
+        EXPECT_EQ(sampleData[i], 100 + i);
+    }
+
+    store->releaseSample(sampleData);
+
+    //! [WHEN] The sample is out of the sample chunk
+    sampleCount = store->loadSample(SOUNDFONT_PATH, 0, SAMPLE_POS, SAMPLE_SIZE, 900, SAMPLE_COUNT + 10, FLUID_SAMPLETYPE_MONO,
+                                    &sampleData);
+
+    //! [THEN] It isn't provided
+    EXPECT_EQ(sampleCount, -1);
+}
+
+TEST_F(Audio_SoundFontSampleStoreTest, SoundFontIsUnmappedWithLastUser)
+{
+    SoundFontSampleStore* store = SoundFontSampleStore::instance();
+
+    //! [GIVEN] The soundfont has been read (e.g. by the loader) and is not used anymore
+    std::weak_ptr<const io::MappedFile> mapping = store->soundFontFile(SOUNDFONT_PATH);
+    EXPECT_TRUE(mapping.expired());
+
+    //! [WHEN] Two samples starting at the same position are loaded
+    short* first = nullptr;
+    short* second = nullptr;
+    ASSERT_EQ(store->loadSample(SOUNDFONT_PATH, 0, SAMPLE_POS, SAMPLE_SIZE, 0, 99, FLUID_SAMPLETYPE_MONO, &first), 100);
+    ASSERT_EQ(store->loadSample(SOUNDFONT_PATH, 0, SAMPLE_POS, SAMPLE_SIZE, 0, 199, FLUID_SAMPLETYPE_MONO, &second), 200);
+    EXPECT_EQ(first, second);
+
+    //! [THEN] The soundfont is mapped once, and stays mapped while any of them is loaded
+    mapping = store->soundFontFile(SOUNDFONT_PATH);
+    EXPECT_EQ(mapping.lock()->data() + SAMPLE_POS, reinterpret_cast<const uint8_t*>(first));
+
+    store->releaseSample(first);
+    EXPECT_FALSE(mapping.expired());
+
+    //! [THEN] It is unmapped after the last one is released
+    store->releaseSample(second);
+    EXPECT_TRUE(mapping.expired());
+}
+
+TEST_F(Audio_SoundFontSampleStoreTest, DecodedSf3SampleRoundTrip)
+{
+    SoundFontSampleStore* store = SoundFontSampleStore::instance();
+
+    const int oggSample = FLUID_SAMPLETYPE_MONO | FLUID_SAMPLETYPE_OGG_VORBIS;
+    const time_t modificationTime = 1234;
+
+    std::vector<short> decoded(5000);
+    for (size_t i = 0; i < decoded.size(); ++i) {
+        decoded[i] = static_cast<short>(i * 7);
+    }
+
+    //! [GIVEN] No decoded sample has been stored yet
+    short* sampleData = nullptr;
+    EXPECT_EQ(store->loadSample(SOUNDFONT_PATH, modificationTime, SAMPLE_POS, SAMPLE_SIZE, 10, 20, oggSample, &sampleData), -1);
+
+    //! [WHEN] Fluid has decoded the sample and stored it
+    store->storeSample(SOUNDFONT_PATH, modificationTime, SAMPLE_POS, 10, 20, oggSample, decoded.data(), static_cast<int>(decoded.size()));
+
+    //! [THEN] It is provided from the cache next time
+    int sampleCount = store->loadSample(SOUNDFONT_PATH, modificationTime, SAMPLE_POS, SAMPLE_SIZE, 10, 20, oggSample, &sampleData);
+    ASSERT_EQ(sampleCount, static_cast<int>(decoded.size()));
+    EXPECT_EQ(std::vector<short>(sampleData, sampleData + sampleCount), decoded);
+
+    store->releaseSample(sampleData);
+
+    //! [THEN] But not if the soundfont has been modified since
+    EXPECT_EQ(store->loadSample(SOUNDFONT_PATH, modificationTime + 1, SAMPLE_POS, SAMPLE_SIZE, 10, 20, oggSample, &sampleData), -1);
+
+    //! [THEN] Nor for another sample of the soundfont
+    EXPECT_EQ(store->loadSample(SOUNDFONT_PATH, modificationTime, SAMPLE_POS, SAMPLE_SIZE, 10, 21, oggSample, &sampleData), -1);
+}
+
+TEST_F(Audio_SoundFontSampleStoreTest, DecodedSf3SamplesOfPreviousVersionAreRemoved)
+{
+    SoundFontSampleStore* store = SoundFontSampleStore::instance();
+
+    const int oggSample = FLUID_SAMPLETYPE_MONO | FLUID_SAMPLETYPE_OGG_VORBIS;
+    const std::vector<short> decoded(100, 1);
+
+    //! [GIVEN] The decoded samples of a soundfont are cached
+    store->storeSample(SOUNDFONT_PATH, 1, SAMPLE_POS, 10, 20, oggSample, decoded.data(), static_cast<int>(decoded.size()));
+    store->storeSample(SOUNDFONT_PATH, 1, SAMPLE_POS, 30, 40, oggSample, decoded.data(), static_cast<int>(decoded.size()));
+
+    //! [WHEN] A sample of a modified version of the soundfont is stored
+    store->storeSample(SOUNDFONT_PATH, 2, SAMPLE_POS, 10, 20, oggSample, decoded.data(), static_cast<int>(decoded.size()));
+
+    //! [THEN] Only the samples of the new version are kept
+    RetVal<io::paths_t> files = io::Dir::scanFiles(CACHE_PATH, { "*.pcm" }, io::ScanMode::FilesInCurrentDir);
+    EXPECT_EQ(files.val.size(), 1);
+
+    short* sampleData = nullptr;
+    EXPECT_EQ(store->loadSample(SOUNDFONT_PATH, 1, SAMPLE_POS, SAMPLE_SIZE, 30, 40, oggSample, &sampleData), -1);
+
+    int sampleCount = store->loadSample(SOUNDFONT_PATH, 2, SAMPLE_POS, SAMPLE_SIZE, 10, 20, oggSample, &sampleData);
+    EXPECT_EQ(sampleCount, static_cast<int>(decoded.size()));
+    store->releaseSample(sampleData);
+}
+
+TEST_F(Audio_SoundFontSampleStoreTest, DecodedSf3CacheEvictsLeastRecentlyUsed)
+{
+    SoundFontSampleStore* store = SoundFontSampleStore::instance();
+
+    const int oggSample = FLUID_SAMPLETYPE_MONO | FLUID_SAMPLETYPE_OGG_VORBIS;
+    const std::vector<short> decoded(1000, 1);
+
+    //! [GIVEN] The cache can hold the samples of two soundfonts
+    store->init(CACHE_PATH, 2 * (decoded.size() * sizeof(short) + 100));
+
+    //! [GIVEN] The samples of two soundfonts are cached
+    store->storeSample("first.sf3", 1, SAMPLE_POS, 10, 20, oggSample, decoded.data(), static_cast<int>(decoded.size()));
+    store->storeSample("second.sf3", 1, SAMPLE_POS, 10, 20, oggSample, decoded.data(), static_cast<int>(decoded.size()));
+
+    //! [WHEN] The samples of a third soundfont are stored
+    store->storeSample("third.sf3", 1, SAMPLE_POS, 10, 20, oggSample, decoded.data(), static_cast<int>(decoded.size()));
+
+    //! [THEN] The least recently used soundfont is removed from the cache
+    short* sampleData = nullptr;
+    EXPECT_EQ(store->loadSample("first.sf3", 1, SAMPLE_POS, SAMPLE_SIZE, 10, 20, oggSample, &sampleData), -1);
+
+    for (const char* fileName : { "second.sf3", "third.sf3" }) {
+        int sampleCount = store->loadSample(fileName, 1, SAMPLE_POS, SAMPLE_SIZE, 10, 20, oggSample, &sampleData);
+        EXPECT_EQ(sampleCount, static_cast<int>(decoded.size()));
+        store->releaseSample(sampleData);
+    }
+
+    //! [WHEN] The samples of the first soundfont are stored again
+    store->storeSample("first.sf3", 1, SAMPLE_POS, 10, 20, oggSample, decoded.data(), static_cast<int>(decoded.size()));
+
+    //! [THEN] The second one, used before the third one, is removed instead
+    EXPECT_EQ(store->loadSample("second.sf3", 1, SAMPLE_POS, SAMPLE_SIZE, 10, 20, oggSample, &sampleData), -1);
+
+    RetVal<io::paths_t> files = io::Dir::scanFiles(CACHE_PATH, { "*.pcm" }, io::ScanMode::FilesInCurrentDir);
+    EXPECT_EQ(files.val.size(), 2);
+}
+
+TEST_F(Audio_SoundFontSampleStoreTest, FluidSampleCacheUsesProvider)
+{
+    ProviderCalls* calls = ProviderCalls::instance();
+    *calls = ProviderCalls();
+    calls->loadResult = 3;
+    calls->providedData = { 1, 2, 3 };
+
+    fluid_samplecache_provider_t provider { nullptr, ProviderCalls::load, ProviderCalls::store, ProviderCalls::release };
+    fluid_samplecache_set_provider(&provider);
+
+    SFData sf {};
+    sf.fname = const_cast<char*>(SOUNDFONT_PATH);
+    sf.samplepos = SAMPLE_POS;
+    sf.samplesize = SAMPLE_SIZE;
+
+    //! [WHEN] The same sample is loaded twice
+    short* first = nullptr;
+    short* second = nullptr;
+    char* data24 = nullptr;
+    EXPECT_EQ(fluid_samplecache_load(&sf, 0, 2, FLUID_SAMPLETYPE_MONO, 0, &first, &data24), 3);
+    EXPECT_EQ(fluid_samplecache_load(&sf, 0, 2, FLUID_SAMPLETYPE_MONO, 0, &second, &data24), 3);
+
+    //! [THEN] It is asked once to the provider, and its data is used as is
+    EXPECT_EQ(calls->loadCount, 1);
+    EXPECT_EQ(calls->storeCount, 0);
+    EXPECT_EQ(first, calls->providedData.data());
+    EXPECT_EQ(second, first);
+
+    //! [THEN] It is released to the provider (not freed) when it isn't used anymore
+    EXPECT_EQ(fluid_samplecache_unload(first), FLUID_OK);
+    EXPECT_EQ(calls->releaseCount, 0);
+
+    EXPECT_EQ(fluid_samplecache_unload(second), FLUID_OK);
+    EXPECT_EQ(calls->releaseCount, 1);
+    EXPECT_EQ(calls->releasedData, calls->providedData.data());
+
+    fluid_samplecache_set_provider(nullptr);
+}
+
+TEST_F(Audio_SoundFontSampleStoreTest, FluidSampleCacheStoresReadSamples)
+{
+    ProviderCalls* calls = ProviderCalls::instance();
+    *calls = ProviderCalls();
+    calls->loadResult = -1;
+
+    fluid_samplecache_provider_t provider { nullptr, ProviderCalls::load, ProviderCalls::store, ProviderCalls::release };
+    fluid_samplecache_set_provider(&provider);
+
+    SFData sf {};
+    sf.fname = const_cast<char*>(SOUNDFONT_PATH);
+    sf.samplepos = SAMPLE_POS;
+    sf.samplesize = SAMPLE_SIZE;
+    sf.fcbs = &FILE_CALLBACKS;
+    sf.sffd = static_cast<FILE*>(FILE_CALLBACKS.fopen(SOUNDFONT_PATH));
+    ASSERT_TRUE(sf.sffd);
+
+    //! [WHEN] The provider can't provide a sample
+    short* sampleData = nullptr;
+    char* data24 = nullptr;
+    int sampleCount = fluid_samplecache_load(&sf, 10, 19, FLUID_SAMPLETYPE_MONO, 0, &sampleData, &data24);
+
+    //! [THEN] Fluid reads it from the file, and passes it to the provider to be stored
+    ASSERT_EQ(sampleCount, 10);
+    EXPECT_EQ(calls->loadCount, 1);
+    EXPECT_EQ(calls->storeCount, 1);
+    EXPECT_EQ(calls->storedData, std::vector<short>(sampleData, sampleData + sampleCount));
+    EXPECT_EQ(sampleData[0], 10);
+
+    //! [THEN] Its data is freed by Fluid, not released to the provider
+    EXPECT_EQ(fluid_samplecache_unload(sampleData), FLUID_OK);
+    EXPECT_EQ(calls->releaseCount, 0);
+
+    FILE_CALLBACKS.fclose(sf.sffd);
+    fluid_samplecache_set_provider(nullptr);
+}
@@ -0,0 +1,219 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "global/modularity/ioc.h"
+
+#include "internal/audiosanitizer.h"
+#include "internal/audiobuffer.h"
+#include "internal/worker/audioengine.h"
+#include "internal/worker/sinesource.h"
+#include "internal/soundtracks/soundtrackwriter.h"
+
+#include "audioerrors.h"
+
+#include "tests/mocks/audioconfigurationmock.h"
+
+using ::testing::NiceMock;
+using ::testing::Return;
+
+using namespace muse;
+using namespace muse::audio;
+using namespace muse::audio::soundtrack;
+
+namespace muse::audio {
+class Audio_SoundTrackWriterTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        AudioSanitizer::setupWorkerThread();
+
+        m_configuration = std::make_shared<NiceMock<AudioConfigurationMock> >();
+        ON_CALL(*m_configuration, audioChannelsCount()).WillByDefault(Return(AUDIO_CHANNELS_COUNT));
+        ON_CALL(*m_configuration, renderStep()).WillByDefault(Return(RENDER_STEP));
+        ON_CALL(*m_configuration, renderThreadCount()).WillByDefault(Return(2));
+
+        modularity::ioc()->registerExport<IAudioConfiguration>("utests", m_configuration);
+
+        m_buffer = std::make_shared<AudioBuffer>();
+        m_buffer->init(AUDIO_CHANNELS_COUNT, RENDER_STEP);
+
+        AudioEngine::instance()->init(m_buffer);
+        AudioEngine::instance()->setAudioChannelsCount(AUDIO_CHANNELS_COUNT);
+        AudioEngine::instance()->setSampleRate(SAMPLE_RATE);
+    }
+
+    void TearDown() override
+    {
+        std::remove(m_filePath.c_str());
+
+        AudioEngine::instance()->deinit();
+        m_buffer.reset();
+
+        modularity::ioc()->unregisterIfRegistered<IAudioConfiguration>("utests", m_configuration);
+    }
+
+    std::vector<char> readFile() const
+    {
+        std::ifstream stream(m_filePath, std::ios_base::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+
+    //! NOTE: The samples the source gives when it is processed by render steps, like the writer does
+    static std::vector<float> renderDirectly(samples_t samplesPerChannel)
+    {
+        SineSource source;
+        source.setSampleRate(SAMPLE_RATE);
+
+        std::vector<float> step(RENDER_STEP * AUDIO_CHANNELS_COUNT);
+        std::vector<float> samples;
+
+        while (samples.size() < samplesPerChannel * AUDIO_CHANNELS_COUNT) {
+            source.process(step.data(), RENDER_STEP);
+            size_t count = std::min(step.size(), samplesPerChannel * AUDIO_CHANNELS_COUNT - samples.size());
+            samples.insert(samples.end(), step.begin(), step.begin() + count);
+        }
+
+        return samples;
+    }
+
+    static constexpr audioch_t AUDIO_CHANNELS_COUNT = 2;
+    static constexpr unsigned int SAMPLE_RATE = 48000;
+    static constexpr samples_t RENDER_STEP = 512;
+
+    //! NOTE: 18 bytes of the fmt chunk (with cbSize), see WavEncoder::writeHeader
+    static constexpr size_t WAV_HEADER_SIZE = 46;
+    static constexpr size_t WAV_DATA_SIZE_OFFSET = 42;
+
+    std::shared_ptr<AudioConfigurationMock> m_configuration;
+    AudioBufferPtr m_buffer;
+    std::string m_filePath;
+};
+}
+
+TEST_F(Audio_SoundTrackWriterTest, StreamsWholeTrackInChunks)
+{
+    m_filePath = "Audio_SoundTrackWriterTest_StreamsWholeTrackInChunks.wav";
+
+    //! [GIVEN] A track of 2.5 sec: several chunks, the last one ends in the middle of a render step
+    const msecs_t duration = 2500000;
+    const samples_t expectedSamplesPerChannel = SAMPLE_RATE * 5 / 2;
+
+    SoundTrackFormat format;
+    format.type = SoundTrackType::WAV;
+    format.sampleRate = SAMPLE_RATE;
+    format.audioChannelsNumber = AUDIO_CHANNELS_COUNT;
+
+    auto source = std::make_shared<SineSource>();
+    SoundTrackWriter writer(m_filePath, format, duration, source);
+
+    //! [WHEN] The track is written
+    Ret ret = writer.write();
+
+    //! [THEN] The file has all the samples of the track, in order
+    EXPECT_TRUE(ret) << ret.toString();
+    EXPECT_EQ(AudioEngine::instance()->mode(), RenderMode::IdleMode);
+
+    std::vector<char> data = readFile();
+    std::vector<float> expected = renderDirectly(expectedSamplesPerChannel);
+    const uint32_t dataSize = static_cast<uint32_t>(expected.size() * sizeof(float));
+
+    ASSERT_EQ(data.size(), WAV_HEADER_SIZE + dataSize);
+
+    uint32_t headerDataSize = 0;
+    std::memcpy(&headerDataSize, data.data() + WAV_DATA_SIZE_OFFSET, sizeof(headerDataSize));
+    EXPECT_EQ(headerDataSize, dataSize);
+
+    EXPECT_EQ(std::memcmp(data.data() + WAV_HEADER_SIZE, expected.data(), dataSize), 0);
+}
+
+TEST_F(Audio_SoundTrackWriterTest, AbortKeepsValidFile)
+{
+    m_filePath = "Audio_SoundTrackWriterTest_AbortKeepsValidFile.wav";
+
+    //! [GIVEN] A long track
+    SoundTrackFormat format;
+    format.type = SoundTrackType::WAV;
+    format.sampleRate = SAMPLE_RATE;
+    format.audioChannelsNumber = AUDIO_CHANNELS_COUNT;
+
+    auto source = std::make_shared<SineSource>();
+    SoundTrackWriter writer(m_filePath, format, 60000000, source);
+
+    //! [GIVEN] The export is aborted after the first chunk
+    bool aborted = false;
+    writer.progress().progressChanged.onReceive(nullptr, [&writer, &aborted](int64_t current, int64_t, const std::string&) {
+        if (current > 0 && !aborted) {
+            writer.abort();
+            aborted = true;
+        }
+    });
+
+    //! [WHEN] The track is written
+    Ret ret = writer.write();
+
+    //! [THEN] The export is cancelled, but the header describes the samples that have been written
+    EXPECT_EQ(ret.code(), static_cast<int>(Ret::Code::Cancel));
+
+    std::vector<char> data = readFile();
+    ASSERT_GT(data.size(), WAV_HEADER_SIZE);
+
+    uint32_t headerDataSize = 0;
+    std::memcpy(&headerDataSize, data.data() + WAV_DATA_SIZE_OFFSET, sizeof(headerDataSize));
+    EXPECT_EQ(headerDataSize, data.size() - WAV_HEADER_SIZE);
+    EXPECT_LT(headerDataSize, SAMPLE_RATE * 60 * AUDIO_CHANNELS_COUNT * sizeof(float));
+}
+
+#ifdef Q_OS_LINUX
+TEST_F(Audio_SoundTrackWriterTest, EncodingFailureAbortsExport)
+{
+    //! [GIVEN] A long track, written to a device without space left
+    SoundTrackFormat format;
+    format.type = SoundTrackType::WAV;
+    format.sampleRate = SAMPLE_RATE;
+    format.audioChannelsNumber = AUDIO_CHANNELS_COUNT;
+
+    auto source = std::make_shared<SineSource>();
+    SoundTrackWriter writer("/dev/full", format, 60000000, source);
+
+    int64_t lastProgress = 0;
+    writer.progress().progressChanged.onReceive(nullptr, [&lastProgress](int64_t current, int64_t, const std::string&) {
+        lastProgress = current;
+    });
+
+    //! [WHEN] The track is written
+    Ret ret = writer.write();
+
+    //! [THEN] The export fails as soon as a chunk can't be encoded, the rest of the track isn't rendered
+    EXPECT_EQ(ret.code(), static_cast<int>(Err::ErrorEncode));
+    EXPECT_LT(lastProgress, 10);
+    EXPECT_EQ(AudioEngine::instance()->mode(), RenderMode::IdleMode);
+}
+#endif
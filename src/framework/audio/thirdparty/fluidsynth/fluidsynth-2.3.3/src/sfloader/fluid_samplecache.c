@@ -54,10 +54,12 @@ struct _fluid_samplecache_entry_t
 
     int num_references;
     int mlocked;
+    int provided;
 };
 
 static fluid_list_t *samplecache_list = NULL;
 static fluid_mutex_t samplecache_mutex = FLUID_MUTEX_INIT;
+static fluid_samplecache_provider_t samplecache_provider = { NULL, NULL, NULL, NULL };
 
 static fluid_samplecache_entry_t *new_samplecache_entry(SFData *sf, unsigned int sample_start,
         unsigned int sample_end, int sample_type, time_t mtime);
@@ -185,6 +187,23 @@ unlock_exit:
 }
 
 
+void fluid_samplecache_set_provider(const fluid_samplecache_provider_t *provider)
+{
+    fluid_mutex_lock(samplecache_mutex);
+
+    if(provider != NULL)
+    {
+        samplecache_provider = *provider;
+    }
+    else
+    {
+        FLUID_MEMSET(&samplecache_provider, 0, sizeof(samplecache_provider));
+    }
+
+    fluid_mutex_unlock(samplecache_mutex);
+}
+
+
 /* Private functions */
 static fluid_samplecache_entry_t *new_samplecache_entry(SFData *sf,
         unsigned int sample_start,
@@ -221,6 +240,22 @@ static fluid_samplecache_entry_t *new_samplecache_entry(SFData *sf,
     entry->sample_type = sample_type;
     entry->modification_time = mtime;
 
+    /* MuseScore: 16-bit little endian samples and decompressed samples can be provided by the application */
+    if(samplecache_provider.load != NULL && sf->sample24pos == 0
+            && ((sample_type & FLUID_SAMPLETYPE_OGG_VORBIS) || !FLUID_IS_BIG_ENDIAN))
+    {
+        entry->sample_count = samplecache_provider.load(samplecache_provider.data, sf->fname, mtime,
+                              sf->samplepos, sf->samplesize,
+                              sample_start, sample_end, sample_type,
+                              &entry->sample_data);
+
+        if(entry->sample_count >= 0)
+        {
+            entry->provided = TRUE;
+            return entry;
+        }
+    }
+
     entry->sample_count = fluid_sffile_read_sample_data(sf, sample_start, sample_end, sample_type,
                           &entry->sample_data, &entry->sample_data24);
 
@@ -229,6 +264,14 @@ static fluid_samplecache_entry_t *new_samplecache_entry(SFData *sf,
         goto error_exit;
     }
 
+    if(samplecache_provider.store != NULL && sf->sample24pos == 0 && entry->sample_data != NULL)
+    {
+        samplecache_provider.store(samplecache_provider.data, sf->fname, mtime,
+                                   sf->samplepos, sf->samplesize,
+                                   sample_start, sample_end, sample_type,
+                                   entry->sample_data, entry->sample_count);
+    }
+
     return entry;
 
 error_exit:
@@ -241,7 +284,19 @@ static void delete_samplecache_entry(fluid_samplecache_entry_t *entry)
     fluid_return_if_fail(entry != NULL);
 
     FLUID_FREE(entry->filename);
-    FLUID_FREE(entry->sample_data);
+
+    if(entry->provided)
+    {
+        if(samplecache_provider.release != NULL)
+        {
+            samplecache_provider.release(samplecache_provider.data, entry->sample_data);
+        }
+    }
+    else
+    {
+        FLUID_FREE(entry->sample_data);
+    }
+
     FLUID_FREE(entry->sample_data24);
     FLUID_FREE(entry);
 }
@@ -25,13 +25,47 @@
 #include "fluid_sfont.h"
 #include "fluid_sffile.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 int fluid_samplecache_load(SFData *sf,
                            unsigned int sample_start, unsigned int sample_end, int sample_type,
                            int try_mlock, short **data, char **data24);
 
 int fluid_samplecache_unload(const short *sample_data);
 
+/* MuseScore: lets the application provide the sample data (e.g. from memory mapped files
+ * or from a cache of decompressed samples) instead of reading it into the heap.
+ * Only used for 16-bit samples, samples with 24-bit data are always read by the cache */
+typedef struct _fluid_samplecache_provider_t
+{
+    void *data;
+
+    /* Returns the number of sample words and points sample_data to memory owned by the provider,
+     * or -1 if the sample can't be provided, in which case it is read from the file as usual */
+    int (*load)(void *data, const char *filename, time_t mtime,
+                unsigned int samplepos, unsigned int samplesize,
+                unsigned int sample_start, unsigned int sample_end, int sample_type,
+                short **sample_data);
+
+    /* Called with the data of a sample that was read from the file, so that it can be provided next time */
+    void (*store)(void *data, const char *filename, time_t mtime,
+                  unsigned int samplepos, unsigned int samplesize,
+                  unsigned int sample_start, unsigned int sample_end, int sample_type,
+                  const short *sample_data, int sample_count);
+
+    /* Called when provided sample data isn't used anymore */
+    void (*release)(void *data, const short *sample_data);
+} fluid_samplecache_provider_t;
+
+void fluid_samplecache_set_provider(const fluid_samplecache_provider_t *provider);
+
 /* Only used for tests */
 int fluid_samplecache_count_entries(void);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* _FLUID_SAMPLECACHE_H */
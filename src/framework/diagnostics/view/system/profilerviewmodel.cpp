@@ -22,6 +22,7 @@
 #include "profilerviewmodel.h"
 
 #include "global/profiler.h"
+#include "global/allocator.h"
 
 #include "log.h"
 
@@ -90,6 +91,17 @@ void ProfilerViewModel::reload()
         m_allList.append(item);
     }
 
+    group = "Allocators";
+    str = QString::fromStdString(muse::AllocatorsRegister::instance()->statisticString("Object allocators"));
+    list = str.split("\n");
+    foreach (const QString& data, list) {
+        Item item;
+        item.group = group;
+        item.data = data;
+
+        m_allList.append(item);
+    }
+
     find(m_searchText);
 }
 
@@ -122,4 +134,5 @@ void ProfilerViewModel::clear()
 void ProfilerViewModel::print()
 {
     PROFILER_PRINT;
+    muse::AllocatorsRegister::instance()->printStatistic("Object allocators");
 }
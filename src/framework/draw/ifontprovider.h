@@ -61,6 +61,10 @@ public:
     virtual RectF tightBoundingRect(const Font& f, const String& string) const = 0;
 
     // Score symbols
+    //! NOTE: The metrics of the symbols are cached on disk by the engraving fonts.
+    //! Increment the version whenever a provider computes them differently, to invalidate the caches
+    static constexpr int SYMBOL_METRICS_VERSION = 1;
+
     virtual RectF symBBox(const Font& f, char32_t ucs4, double DPI_F) const = 0;
     virtual double symAdvance(const Font& f, char32_t ucs4, double DPI_F) const = 0;
 };
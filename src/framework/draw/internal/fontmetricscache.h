@@ -0,0 +1,75 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MUSE_DRAW_FONTMETRICSCACHE_H
+#define MUSE_DRAW_FONTMETRICSCACHE_H
+
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace muse::draw {
+//! NOTE A cache of computed font metrics (glyph or text metrics).
+//! Lookups take a shared lock, so the concurrent readers (e.g. the layout of several parts) don't block each other.
+//! The cache is bounded: when it is full, it is cleared (the metrics are cheap to compute again)
+template<typename Key, typename Value, typename Hash = std::hash<Key> >
+class FontMetricsCache
+{
+public:
+    explicit FontMetricsCache(size_t maxSize)
+        : m_maxSize(maxSize) {}
+
+    bool find(const Key& key, Value& value) const
+    {
+        std::shared_lock lock(m_mutex);
+        auto it = m_map.find(key);
+        if (it == m_map.end()) {
+            return false;
+        }
+
+        value = it->second;
+        return true;
+    }
+
+    void insert(const Key& key, const Value& value)
+    {
+        std::unique_lock lock(m_mutex);
+        if (m_map.size() >= m_maxSize) {
+            m_map.clear();
+        }
+
+        m_map.insert_or_assign(key, value);
+    }
+
+    size_t size() const
+    {
+        std::shared_lock lock(m_mutex);
+        return m_map.size();
+    }
+
+private:
+    mutable std::shared_mutex m_mutex;
+    std::unordered_map<Key, Value, Hash> m_map;
+    const size_t m_maxSize = 0;
+};
+}
+
+#endif // MUSE_DRAW_FONTMETRICSCACHE_H
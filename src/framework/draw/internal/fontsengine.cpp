@@ -41,6 +41,10 @@ static const double LOADED_PIXEL_SIZE = 200.0;
 
 static const double TEXT_LINE_SCALE = 1.2;
 
+//! NOTE The number of the cached metrics, per face
+static const size_t GLYPH_CACHE_SIZE = 10000;
+static const size_t TEXT_CACHE_SIZE = 10000;
+
 static const int SDF_WIDTH = 64;
 static const int SDF_HEIGHT = 64;
 
@@ -66,24 +70,52 @@ static const IFontFace* findSubtitutionFont(char32_t ch, const std::vector<IFont
     return founded;
 }
 
+struct FontsEngine::GlyphMetrics {
+    glyph_idx_t idx = 0;
+    f26dot6_t advance = 0;
+    FBBox bbox;
+};
+
+struct FontsEngine::TextMetrics {
+    f26dot6_t advance = 0;
+    FBBox bbox;
+    FBBox tightBbox;
+};
+
 bool FontsEngine::RequireFace::isSymbolMode() const
 {
-    return face ? face->isSymbolMode() : false;
+    return symbolMode;
 }
 
 double FontsEngine::RequireFace::pixelScale() const
 {
-    if (!face) {
-        return 0.0;
-    }
-    double scale = static_cast<double>(requireKey.pixelSize) / static_cast<double>(face->key().pixelSize);
     return scale;
 }
 
+bool FontsEngine::FontKey::operator==(const FontKey& k) const
+{
+    return pixelSize == k.pixelSize && type == k.type && bold == k.bold && italic == k.italic
+           && isSymbolMode == k.isSymbolMode && family == k.family;
+}
+
+size_t FontsEngine::FontKeyHash::operator()(const FontKey& k) const
+{
+    size_t h = k.family.hash();
+    h ^= std::hash<int> {}(k.pixelSize) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    h ^= (static_cast<size_t>(k.type) << 3) | (size_t(k.bold) << 2) | (size_t(k.italic) << 1) | size_t(k.isSymbolMode);
+    return h;
+}
+
+FontsEngine::FontsEngine() = default;
+
 FontsEngine::~FontsEngine()
 {
-    for (RequireFace* f : m_requiredFaces) {
-        delete f;
+    for (auto& p : m_requiredTextFaces) {
+        delete p.second;
+    }
+
+    for (auto& p : m_requiredSymbolFaces) {
+        delete p.second;
     }
 
     for (IFontFace* f : m_loadedFaces) {
@@ -103,7 +135,7 @@ double FontsEngine::lineSpacing(const Font& f) const
         return 0.0;
     }
 
-    return from_f26d6(rf->face->leading() + rf->face->ascent() + rf->face->descent()) * rf->pixelScale();
+    return rf->lineSpacing;
 }
 
 double FontsEngine::xHeight(const Font& f) const
@@ -113,7 +145,7 @@ double FontsEngine::xHeight(const Font& f) const
         return 0.0;
     }
 
-    return from_f26d6(rf->face->xHeight()) * rf->pixelScale();
+    return rf->xHeight;
 }
 
 double FontsEngine::height(const Font& f) const
@@ -123,7 +155,7 @@ double FontsEngine::height(const Font& f) const
         return 0.0;
     }
 
-    return from_f26d6(rf->face->ascent() + rf->face->descent()) * rf->pixelScale();
+    return rf->height;
 }
 
 double FontsEngine::ascent(const Font& f) const
@@ -133,7 +165,7 @@ double FontsEngine::ascent(const Font& f) const
         return 0.0;
     }
 
-    return from_f26d6(rf->face->ascent()) * rf->pixelScale();
+    return rf->ascent;
 }
 
 double FontsEngine::descent(const Font& f) const
@@ -143,7 +175,7 @@ double FontsEngine::descent(const Font& f) const
         return 0.0;
     }
 
-    return from_f26d6(rf->face->descent()) * rf->pixelScale();
+    return rf->descent;
 }
 
 bool FontsEngine::inFontUcs4(const Font& f, char32_t ucs4) const
@@ -153,7 +185,7 @@ bool FontsEngine::inFontUcs4(const Font& f, char32_t ucs4) const
         return false;
     }
 
-    return rf->face->glyphIndex(ucs4) != 0;
+    return glyphMetrics(rf, ucs4).idx != 0;
 }
 
 double FontsEngine::horizontalAdvance(const Font& f, const char32_t& ch) const
@@ -163,8 +195,7 @@ double FontsEngine::horizontalAdvance(const Font& f, const char32_t& ch) const
         return 0.0;
     }
 
-    glyph_idx_t glyphIdx = rf->face->glyphIndex(ch);
-    return from_f26d6(rf->face->glyphAdvance(glyphIdx)) * rf->pixelScale();
+    return from_f26d6(glyphMetrics(rf, ch).advance) * rf->pixelScale();
 }
 
 double FontsEngine::horizontalAdvance(const Font& f, const std::u32string& text) const
@@ -178,13 +209,7 @@ double FontsEngine::horizontalAdvance(const Font& f, const std::u32string& text)
         return 0.0;
     }
 
-    std::vector<GlyphPos> glyphs = rf->face->glyphs(&text[0], (int)text.size());
-    f26dot6_t advance = 0;
-    for (const GlyphPos& g : glyphs) {
-        advance += g.x_advance;
-    }
-
-    return from_f26d6(advance) * rf->pixelScale();
+    return from_f26d6(textMetrics(rf, text).advance) * rf->pixelScale();
 }
 
 RectF FontsEngine::boundingRect(const Font& f, const char32_t& ch) const
@@ -194,8 +219,7 @@ RectF FontsEngine::boundingRect(const Font& f, const char32_t& ch) const
         return RectF();
     }
 
-    glyph_idx_t glyphIdx = rf->face->glyphIndex(ch);
-    return fromFBBox(rf->face->glyphBbox(glyphIdx), rf->pixelScale());
+    return fromFBBox(glyphMetrics(rf, ch).bbox, rf->pixelScale());
 }
 
 RectF FontsEngine::boundingRect(const Font& f, const std::u32string& text) const
@@ -209,76 +233,99 @@ RectF FontsEngine::boundingRect(const Font& f, const std::u32string& text) const
         return RectF();
     }
 
-    FBBox rect;      // f26dot6_t units
-    FBBox lineRect;  // f26dot6_t units
-    bool isFirstLine = true;
-    bool isFirstInLine = true;
+    return fromFBBox(textMetrics(rf, text).bbox, rf->pixelScale());
+}
 
-    std::vector<TextBlock> lines = splitTextByLines(text);
-    for (const TextBlock& l : lines) {
-        lineRect = FBBox();
-        isFirstInLine = true;
+RectF FontsEngine::tightBoundingRect(const Font& f, const std::u32string& text) const
+{
+    if (text.empty()) {
+        return RectF();
+    }
 
-        std::vector<TextBlock> fontFaceBlocks = splitTextByFontFaces(rf, l);
-        for (const TextBlock& ffBlock : fontFaceBlocks) {
-            const IFontFace* fontFace = nullptr;
-            if (rf->face->glyphIndex(*ffBlock.text) != 0) {
-                fontFace = rf->face;
-            } else {
-                fontFace = findSubtitutionFont(*ffBlock.text, rf->subtitutionFaces);
-            }
-            if (!fontFace) {
-                continue;
-            }
+    RequireFace* rf = fontFace(f);
+    IF_ASSERT_FAILED(rf && rf->face) {
+        return RectF();
+    }
 
-            std::vector<GlyphPos> glyphs = fontFace->glyphs(ffBlock.text, ffBlock.lenght);
+    return fromFBBox(textMetrics(rf, text).tightBbox, rf->pixelScale());
+}
 
-            for (const GlyphPos& g : glyphs) {
-                FBBox bbox = rf->face->glyphBbox(g.idx);
-                if (isFirstInLine) {
-                    lineRect = bbox;
-                    isFirstInLine = false;
-                } else {
-                    lineRect.setWidth(lineRect.width() + bbox.width());
-                    lineRect.setHeight(std::max(lineRect.height(), bbox.height()));
-                    lineRect.setTop(std::min(lineRect.top(), bbox.top()));
-                    lineRect.setLeft(std::min(lineRect.left(), bbox.left()));
-                }
-            }
-        }
+//! NOTE: Increment IFontProvider::SYMBOL_METRICS_VERSION when the symbol metrics change
+RectF FontsEngine::symBBox(const Font& f, char32_t ucs4) const
+{
+    RequireFace* rf = fontFace(f, true);
+    IF_ASSERT_FAILED(rf && rf->face) {
+        return RectF();
+    }
 
-        if (isFirstLine) {
-            rect = lineRect;
-            isFirstLine = false;
-        } else {
-            rect.setWidth(std::max(rect.width(), lineRect.width()));
-            rect.setHeight(rect.height() + lineRect.height());
-        }
+    return fromFBBox(glyphMetrics(rf, ucs4).bbox, rf->pixelScale());
+}
+
+double FontsEngine::symAdvance(const Font& f, char32_t ucs4) const
+{
+    RequireFace* rf = fontFace(f, true);
+    IF_ASSERT_FAILED(rf && rf->face) {
+        return 0.0;
     }
 
-    return fromFBBox(rect, rf->pixelScale());
+    return from_f26d6(glyphMetrics(rf, ucs4).advance) * rf->pixelScale();
 }
 
-RectF FontsEngine::tightBoundingRect(const Font& f, const std::u32string& text) const
+FontsEngine::GlyphMetrics FontsEngine::glyphMetrics(const RequireFace* rf, char32_t ucs4) const
 {
-    if (text.empty()) {
-        return RectF();
+    GlyphMetrics metrics;
+    if (rf->glyphs->find(ucs4, metrics)) {
+        return metrics;
     }
 
-    RequireFace* rf = fontFace(f);
-    IF_ASSERT_FAILED(rf && rf->face) {
-        return RectF();
+    {
+        std::lock_guard<std::mutex> lock(m_faceMutex);
+        metrics.idx = rf->face->glyphIndex(ucs4);
+        metrics.advance = rf->face->glyphAdvance(metrics.idx);
+        metrics.bbox = rf->face->glyphBbox(metrics.idx);
+    }
+
+    rf->glyphs->insert(ucs4, metrics);
+
+    return metrics;
+}
+
+FontsEngine::TextMetrics FontsEngine::textMetrics(const RequireFace* rf, const std::u32string& text) const
+{
+    TextMetrics metrics;
+    if (rf->texts->find(text, metrics)) {
+        return metrics;
     }
 
-    FBBox rect;      // f26dot6_t units
-    FBBox lineRect;  // f26dot6_t units
+    {
+        std::lock_guard<std::mutex> lock(m_faceMutex);
+        metrics = measureText(rf, text);
+    }
+
+    rf->texts->insert(text, metrics);
+
+    return metrics;
+}
+
+//! NOTE The advance, the bounding rect and the tight bounding rect of the text, in one pass over the glyphs
+FontsEngine::TextMetrics FontsEngine::measureText(const RequireFace* rf, const std::u32string& text) const
+{
+    TextMetrics metrics;
+
+    std::vector<GlyphPos> glyphs = rf->face->glyphs(&text[0], (int)text.size());
+    for (const GlyphPos& g : glyphs) {
+        metrics.advance += g.x_advance;
+    }
+
+    FBBox rect;           // f26dot6_t units
+    FBBox tightRect;      // f26dot6_t units
     bool isFirstLine = true;
-    bool isFirstInLine = true;
 
     std::vector<TextBlock> lines = splitTextByLines(text);
     for (const TextBlock& l : lines) {
-        lineRect = FBBox();
-        isFirstInLine = true;
+        FBBox lineRect;
+        FBBox tightLineRect;
+        bool isFirstInLine = true;
         f26dot6_t advance = 0;
 
         std::vector<TextBlock> fontFaceBlocks = splitTextByFontFaces(rf, l);
@@ -295,61 +342,52 @@ RectF FontsEngine::tightBoundingRect(const Font& f, const std::u32string& text)
                 continue;
             }
 
-            std::vector<GlyphPos> glyphs = fontFace->glyphs(ffBlock.text, ffBlock.lenght);
+            std::vector<GlyphPos> blockGlyphs = fontFace->glyphs(ffBlock.text, ffBlock.lenght);
 
-            for (const GlyphPos& g : glyphs) {
+            for (const GlyphPos& g : blockGlyphs) {
                 FBBox bbox = rf->face->glyphBbox(g.idx);
                 if (isFirstInLine) {
                     lineRect = bbox;
+                    tightLineRect = bbox;
                     isFirstInLine = false;
                 } else {
-                    /// width is calculated as x_advance instead
+                    lineRect.setWidth(lineRect.width() + bbox.width());
+                    lineRect.setHeight(std::max(lineRect.height(), bbox.height()));
                     lineRect.setTop(std::min(lineRect.top(), bbox.top()));
                     lineRect.setLeft(std::min(lineRect.left(), bbox.left()));
-                    lineRect.setBottom(std::max(lineRect.bottom(), bbox.bottom()));
+
+                    /// width is calculated as x_advance instead
+                    tightLineRect.setTop(std::min(tightLineRect.top(), bbox.top()));
+                    tightLineRect.setLeft(std::min(tightLineRect.left(), bbox.left()));
+                    tightLineRect.setBottom(std::max(tightLineRect.bottom(), bbox.bottom()));
                 }
                 advance += g.x_advance;
             }
-            lastGlyph = glyphs.back();
+
+            if (!blockGlyphs.empty()) {
+                lastGlyph = blockGlyphs.back();
+            }
         }
 
         advance -= (lastGlyph.x_advance - rf->face->glyphBbox(lastGlyph.idx).width());
-        lineRect.setWidth(advance);
+        tightLineRect.setWidth(advance);
 
         if (isFirstLine) {
             rect = lineRect;
+            tightRect = tightLineRect;
             isFirstLine = false;
         } else {
             rect.setWidth(std::max(rect.width(), lineRect.width()));
             rect.setHeight(rect.height() + lineRect.height());
+            tightRect.setWidth(std::max(tightRect.width(), tightLineRect.width()));
+            tightRect.setHeight(tightRect.height() + tightLineRect.height());
         }
     }
 
-    return fromFBBox(rect, rf->pixelScale());
-}
-
-RectF FontsEngine::symBBox(const Font& f, char32_t ucs4) const
-{
-    RequireFace* rf = fontFace(f, true);
-    IF_ASSERT_FAILED(rf && rf->face) {
-        return RectF();
-    }
-
-    glyph_idx_t glyphIdx = rf->face->glyphIndex(ucs4);
-    FBBox bb = rf->face->glyphBbox(glyphIdx);
-    return fromFBBox(bb, rf->pixelScale());
-}
-
-double FontsEngine::symAdvance(const Font& f, char32_t ucs4) const
-{
-    RequireFace* rf = fontFace(f, true);
-    IF_ASSERT_FAILED(rf && rf->face) {
-        return 0.0;
-    }
+    metrics.bbox = rect;
+    metrics.tightBbox = tightRect;
 
-    glyph_idx_t glyphIdx = rf->face->glyphIndex(ucs4);
-    f26dot6_t advance = rf->face->glyphAdvance(glyphIdx);
-    return from_f26d6(advance) * rf->pixelScale();
+    return metrics;
 }
 
 static void generateSdf(GlyphImage& out, glyph_idx_t glyphIdx, const IFontFace* face)
@@ -425,6 +463,8 @@ std::vector<GlyphImage> FontsEngine::render(const Font& f, const std::u32string&
         return std::vector<GlyphImage>();
     }
 
+    std::lock_guard<std::mutex> lock(m_faceMutex);
+
     static const std::set<glyph_idx_t> NOT_RENDER_GLYPHS = {
         3 // space
     };
@@ -499,6 +539,33 @@ IFontFace* FontsEngine::createFontFace(const io::path_t& path) const
 }
 
 FontsEngine::RequireFace* FontsEngine::fontFace(const Font& f, bool isSymbolMode) const
+{
+    FontKey fontKey { f.family(), f.type(), pixelSizeForFont(f), f.bold(), f.italic(), isSymbolMode };
+
+    {
+        std::shared_lock lock(m_facesMutex);
+        auto it = m_fontFaces.find(fontKey);
+        if (it != m_fontFaces.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock lock(m_facesMutex);
+    auto it = m_fontFaces.find(fontKey);
+    if (it != m_fontFaces.end()) {
+        return it->second;
+    }
+
+    RequireFace* rf = createRequireFace(f, isSymbolMode);
+    if (rf) {
+        m_fontFaces.emplace(std::move(fontKey), rf);
+    }
+
+    return rf;
+}
+
+//! NOTE Called under the unique lock of m_facesMutex
+FontsEngine::RequireFace* FontsEngine::createRequireFace(const Font& f, bool isSymbolMode) const
 {
     //! NOTE This font is required
     FaceKey requireKey = faceKeyForFont(f);
@@ -521,14 +588,18 @@ FontsEngine::RequireFace* FontsEngine::fontFace(const Font& f, bool isSymbolMode
     }
 
     //! NOTE We are looking for the require font we need among the previously loaded ones
-    for (RequireFace* face : m_requiredFaces) {
-        if (face->requireKey == requireKey && face->isSymbolMode() == isSymbolMode) {
-            return face;
-        }
+    //! (the same face can be required by different fonts, e.g. with a different case of the family name)
+    std::unordered_map<FaceKey, RequireFace*>& requiredFaces = isSymbolMode ? m_requiredSymbolFaces : m_requiredTextFaces;
+    auto it = requiredFaces.find(requireKey);
+    if (it != requiredFaces.end()) {
+        return it->second;
     }
 
+    //! NOTE The faces are used by the other threads under this mutex
+    std::lock_guard<std::mutex> lock(m_faceMutex);
+
     //! If we didn't find it, we create a new require font
-    RequireFace* newFont = new RequireFace();
+    std::unique_ptr<RequireFace> newFont = std::make_unique<RequireFace>();
     newFont->requireKey = requireKey;
 
     //! Let's find out which real font will be used
@@ -594,9 +665,25 @@ FontsEngine::RequireFace* FontsEngine::fontFace(const Font& f, bool isSymbolMode
         newFont->subtitutionFaces.push_back(subtitutionFace);
     }
 
-    m_requiredFaces.push_back(newFont);
+    newFont->symbolMode = face->isSymbolMode();
+    newFont->scale = static_cast<double>(requireKey.pixelSize) / static_cast<double>(face->key().pixelSize);
+    newFont->lineSpacing = from_f26d6(face->leading() + face->ascent() + face->descent()) * newFont->scale;
+    newFont->xHeight = from_f26d6(face->xHeight()) * newFont->scale;
+    newFont->height = from_f26d6(face->ascent() + face->descent()) * newFont->scale;
+    newFont->ascent = from_f26d6(face->ascent()) * newFont->scale;
+    newFont->descent = from_f26d6(face->descent()) * newFont->scale;
+
+    std::unique_ptr<GlyphCache>& glyphCache = m_glyphCaches[face];
+    if (!glyphCache) {
+        glyphCache = std::make_unique<GlyphCache>(GLYPH_CACHE_SIZE);
+    }
+    newFont->glyphs = glyphCache.get();
+    newFont->texts = std::make_unique<TextCache>(TEXT_CACHE_SIZE);
+
+    RequireFace* rf = newFont.release();
+    requiredFaces.emplace(requireKey, rf);
 
-    return newFont;
+    return rf;
 }
 
 std::vector<FontsEngine::TextBlock> FontsEngine::splitTextByLines(const std::u32string& text) const
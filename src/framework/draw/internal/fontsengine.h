@@ -24,11 +24,16 @@
 
 #include <vector>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 
 #include "ifontsengine.h"
 
 #include "global/modularity/ioc.h"
 #include "ifontsdatabase.h"
+#include "fontmetricscache.h"
 
 //#include "fontrendercache.h"
 
@@ -39,7 +44,7 @@ class FontsEngine : public IFontsEngine
     Inject<IFontsDatabase> fontsDatabase;
 
 public:
-    FontsEngine() = default;
+    FontsEngine();
     ~FontsEngine();
 
     void init();
@@ -77,25 +82,75 @@ private:
         int lenght = 0;
     };
 
+    //! NOTE Defined in the cpp, the metrics are in the units of the loaded face
+    struct GlyphMetrics;
+    struct TextMetrics;
+
+    using GlyphCache = FontMetricsCache<char32_t, GlyphMetrics>;
+    using TextCache = FontMetricsCache<std::u32string, TextMetrics>;
+
     struct RequireFace {
         IFontFace* face = nullptr;   // real loaded face
         std::vector<IFontFace*> subtitutionFaces;
         FaceKey requireKey;          // require face
 
+        //! NOTE Computed on creation, they don't change
+        bool symbolMode = false;
+        double scale = 0.0;
+        double lineSpacing = 0.0;
+        double xHeight = 0.0;
+        double height = 0.0;
+        double ascent = 0.0;
+        double descent = 0.0;
+
+        GlyphCache* glyphs = nullptr;   // of the face, shared by all the require faces of the face
+        std::unique_ptr<TextCache> texts;
+
         bool isSymbolMode() const;
         double pixelScale() const;
     };
 
+    //! NOTE The font as given by the callers, the key of the fast lookup of the require faces.
+    //! Unlike FaceKey, it is made without converting the family name
+    struct FontKey {
+        String family;
+        Font::Type type = Font::Type::Undefined;
+        int pixelSize = 0;
+        bool bold = false;
+        bool italic = false;
+        bool isSymbolMode = false;
+
+        bool operator==(const FontKey& k) const;
+    };
+
+    struct FontKeyHash {
+        size_t operator()(const FontKey& k) const;
+    };
+
     IFontFace* createFontFace(const io::path_t& path) const;
     RequireFace* fontFace(const Font& f, bool isSymbolMode = false) const;
+    RequireFace* createRequireFace(const Font& f, bool isSymbolMode) const;
+
+    GlyphMetrics glyphMetrics(const RequireFace* rf, char32_t ucs4) const;
+    TextMetrics textMetrics(const RequireFace* rf, const std::u32string& text) const;
+    TextMetrics measureText(const RequireFace* rf, const std::u32string& text) const;
 
     std::vector<TextBlock> splitTextByLines(const std::u32string& text) const;
     std::vector<TextBlock> splitTextByFontFaces(const RequireFace* rf, const TextBlock& text) const;
 
     FontFaceFactory m_fontFaceFactory;
 
+    //! NOTE The text can be measured from several threads.
+    //! The metrics are cached, so usually only the lookups are done (with shared locks).
+    //! The faces are loaded on demand and are not thread-safe, so all the calls to them are made under m_faceMutex.
+    //! Lock order: m_facesMutex, then m_faceMutex
+    mutable std::shared_mutex m_facesMutex;
+    mutable std::mutex m_faceMutex;
     mutable std::vector<IFontFace*> m_loadedFaces;
-    mutable std::vector<RequireFace*> m_requiredFaces;
+    mutable std::unordered_map<FontKey, RequireFace*, FontKeyHash> m_fontFaces;
+    mutable std::unordered_map<FaceKey, RequireFace*> m_requiredTextFaces;
+    mutable std::unordered_map<FaceKey, RequireFace*> m_requiredSymbolFaces;
+    mutable std::unordered_map<const IFontFace*, std::unique_ptr<GlyphCache> > m_glyphCaches;
 
     //mutable FontRenderCache m_renderCache;
 };
@@ -143,6 +143,7 @@ RectF QFontProvider::tightBoundingRect(const Font& f, const String& string) cons
 }
 
 // Score symbols
+//! NOTE: Increment IFontProvider::SYMBOL_METRICS_VERSION when the symbol metrics change
 RectF QFontProvider::symBBox(const Font& f, char32_t ucs4, double dpi_f) const
 {
     FontEngineFT* engine = symEngine(f);
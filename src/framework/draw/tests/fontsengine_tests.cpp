@@ -0,0 +1,298 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "global/modularity/ioc.h"
+
+#include "draw/internal/fontsengine.h"
+#include "draw/internal/ifontface.h"
+#include "draw/internal/ifontsdatabase.h"
+
+using namespace muse;
+using namespace muse::draw;
+
+namespace muse::draw {
+class FakeFontsDatabase : public IFontsDatabase
+{
+public:
+    void setDefaultFont(Font::Type, const FontDataKey&) override {}
+    int addFont(const FontDataKey&, const io::path_t&) override { return 0; }
+    FontDataKey actualFont(const FontDataKey& requireKey, Font::Type) const override { return requireKey; }
+    std::vector<FontDataKey> substitutionFonts(Font::Type) const override { return {}; }
+    FontData fontData(const FontDataKey&, Font::Type) const override { return FontData(); }
+    io::path_t fontPath(const FontDataKey& requireKey, Font::Type) const override { return requireKey.family() + ".otf"; }
+    void addAdditionalFonts(const io::path_t&) override {}
+};
+
+//! NOTE Every glyph has its own metrics, the calls are counted
+class FakeFontFace : public IFontFace
+{
+public:
+    explicit FakeFontFace(std::atomic<int>& calls)
+        : m_calls(calls) {}
+
+    bool load(const FaceKey& key, const io::path_t&, bool isSymbolMode) override
+    {
+        m_key = key;
+        m_isSymbolMode = isSymbolMode;
+        return true;
+    }
+
+    const FaceKey& key() const override { return m_key; }
+    bool isSymbolMode() const override { return m_isSymbolMode; }
+
+    f26dot6_t leading() const override { return 64 * 10; }
+    f26dot6_t ascent() const override { return 64 * 160; }
+    f26dot6_t descent() const override { return 64 * 40; }
+    f26dot6_t xHeight() const override { return 64 * 90; }
+
+    std::vector<GlyphPos> glyphs(const char32_t* text, int text_length) const override
+    {
+        ++m_calls;
+        std::vector<GlyphPos> result;
+        for (int i = 0; i < text_length; ++i) {
+            glyph_idx_t idx = glyphIndex(text[i]);
+            result.push_back({ idx, glyphAdvance(idx) });
+        }
+        return result;
+    }
+
+    glyph_idx_t glyphIndex(char32_t ucs4) const override { return ucs4 < 0x10000 ? static_cast<glyph_idx_t>(ucs4) : 0; }
+    glyph_idx_t glyphIndex(const std::string&) const override { return 0; }
+    char32_t findCharCode(glyph_idx_t idx) const override { return static_cast<char32_t>(idx); }
+
+    FBBox glyphBbox(glyph_idx_t idx) const override
+    {
+        ++m_calls;
+        return FBBox(64, -64 * (100 + idx % 50), 64 * (40 + idx % 30), 64 * (100 + idx % 70));
+    }
+
+    f26dot6_t glyphAdvance(glyph_idx_t idx) const override
+    {
+        ++m_calls;
+        return 64 * (50 + idx % 30);
+    }
+
+    const msdfgen::Shape& glyphShape(glyph_idx_t) const override
+    {
+        static const msdfgen::Shape shape;
+        return shape;
+    }
+
+private:
+    std::atomic<int>& m_calls;
+    FaceKey m_key;
+    bool m_isSymbolMode = false;
+};
+}
+
+class Draw_FontsEngineTests : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        m_fontsDatabase = std::make_shared<FakeFontsDatabase>();
+        modularity::ioc()->registerExport<IFontsDatabase>("utests", m_fontsDatabase);
+
+        m_engine = std::make_shared<FontsEngine>();
+        m_engine->setFontFaceFactory([this](const io::path_t&) {
+            return new FakeFontFace(m_faceCalls);
+        });
+    }
+
+    void TearDown() override
+    {
+        m_engine.reset();
+        modularity::ioc()->unregister<IFontsDatabase>("utests");
+    }
+
+    static Font makeFont(const String& family, double pointSize, bool italic = false)
+    {
+        Font f;
+        f.setFamily(family, Font::Type::Text);
+        f.setPointSizeF(pointSize);
+        f.setItalic(italic);
+        return f;
+    }
+
+    std::shared_ptr<FakeFontsDatabase> m_fontsDatabase;
+    std::shared_ptr<FontsEngine> m_engine;
+    std::atomic<int> m_faceCalls = 0;
+};
+
+TEST_F(Draw_FontsEngineTests, GlyphMetrics_Cached)
+{
+    //! [GIVEN] A font
+    Font font = makeFont(u"Edwin", 10.0);
+
+    //! [WHEN] Measure a glyph
+    double advance = m_engine->horizontalAdvance(font, U'a');
+    RectF bbox = m_engine->boundingRect(font, U'a');
+    int callsAfterFirst = m_faceCalls;
+
+    //! [THEN] The metrics come from the face, scaled to the size of the font
+    FakeFontFace face(m_faceCalls);
+    double scale = pixelSizeForFont(font) / 200.0;
+    EXPECT_DOUBLE_EQ(advance, from_f26d6(face.glyphAdvance(U'a')) * scale);
+    EXPECT_DOUBLE_EQ(bbox.width(), from_f26d6(face.glyphBbox(U'a').width()) * scale);
+
+    //! [WHEN] Measure it again, with another size and with a family name in another case
+    m_faceCalls = callsAfterFirst;
+    EXPECT_DOUBLE_EQ(m_engine->horizontalAdvance(font, U'a'), advance);
+    EXPECT_EQ(m_engine->boundingRect(font, U'a'), bbox);
+    EXPECT_DOUBLE_EQ(m_engine->horizontalAdvance(makeFont(u"Edwin", 20.0), U'a'), advance * 2);
+    EXPECT_DOUBLE_EQ(m_engine->horizontalAdvance(makeFont(u"EDWIN", 10.0), U'a'), advance);
+
+    //! [THEN] The face is not used anymore
+    EXPECT_EQ(m_faceCalls, callsAfterFirst);
+
+    //! [THEN] Another style is another face
+    EXPECT_DOUBLE_EQ(m_engine->horizontalAdvance(makeFont(u"Edwin", 10.0, true), U'a'), advance);
+    EXPECT_GT(m_faceCalls, callsAfterFirst);
+}
+
+TEST_F(Draw_FontsEngineTests, TextMetrics_Cached)
+{
+    //! [GIVEN] A font and a lyrics syllable
+    Font font = makeFont(u"Edwin", 10.0);
+    std::u32string text = U"Glo-";
+
+    //! [WHEN] Measure it
+    double advance = m_engine->horizontalAdvance(font, text);
+    RectF bbox = m_engine->boundingRect(font, text);
+    RectF tightBbox = m_engine->tightBoundingRect(font, text);
+    int callsAfterFirst = m_faceCalls;
+
+    //! [THEN] The advance is the sum of the glyphs advances
+    double expectedAdvance = 0.0;
+    for (char32_t ch : text) {
+        expectedAdvance += m_engine->horizontalAdvance(font, ch);
+    }
+    EXPECT_DOUBLE_EQ(advance, expectedAdvance);
+    EXPECT_GT(bbox.width(), 0.0);
+    EXPECT_GT(tightBbox.width(), 0.0);
+
+    //! [WHEN] Measure it again
+    m_faceCalls = callsAfterFirst;
+    EXPECT_DOUBLE_EQ(m_engine->horizontalAdvance(font, text), advance);
+    EXPECT_EQ(m_engine->boundingRect(font, text), bbox);
+    EXPECT_EQ(m_engine->tightBoundingRect(font, text), tightBbox);
+
+    //! [THEN] The face is not used
+    EXPECT_EQ(m_faceCalls, callsAfterFirst);
+}
+
+TEST_F(Draw_FontsEngineTests, ConcurrentReaders)
+{
+    //! [GIVEN] Lyrics syllables in a few fonts
+    const std::vector<std::u32string> syllables = { U"Glo", U"ri-", U"a", U"in", U"ex", U"cel", U"sis", U"De", U"o" };
+    const std::vector<Font> fonts = { makeFont(u"Edwin", 10.0), makeFont(u"Edwin", 11.0), makeFont(u"FreeSerif", 10.0, true) };
+
+    auto measure = [&]() {
+        std::vector<double> result;
+        for (const Font& font : fonts) {
+            for (const std::u32string& s : syllables) {
+                result.push_back(m_engine->horizontalAdvance(font, s));
+                result.push_back(m_engine->boundingRect(font, s).width());
+                result.push_back(m_engine->tightBoundingRect(font, s).height());
+                result.push_back(m_engine->symBBox(font, s.front()).width());
+            }
+            result.push_back(m_engine->lineSpacing(font));
+        }
+        return result;
+    };
+
+    //! [WHEN] Measure them from several threads at once, on an empty cache
+    constexpr size_t THREAD_COUNT = 8;
+    std::vector<std::vector<double> > results(THREAD_COUNT);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREAD_COUNT; ++t) {
+        threads.emplace_back([&results, &measure, t]() {
+            for (int i = 0; i < 100; ++i) {
+                results[t] = measure();
+            }
+        });
+    }
+
+    for (std::thread& th : threads) {
+        th.join();
+    }
+
+    //! [THEN] All the threads get the same metrics
+    std::vector<double> expected = measure();
+    for (const std::vector<double>& result : results) {
+        EXPECT_EQ(result, expected);
+    }
+}
+
+TEST_F(Draw_FontsEngineTests, DISABLED_Benchmark_LyricsHeavyScore)
+{
+    //! NOTE Like the layout of a score with lyrics and chord symbols:
+    //! a small set of syllables and chord names measured over and over, in a few fonts
+    const std::vector<std::u32string> texts = {
+        U"Ky", U"ri", U"e", U"e-", U"le", U"i", U"son", U"Chri", U"ste", U"Glo", U"ri-", U"a", U"in", U"ex", U"cel", U"sis",
+        U"De", U"o", U"et", U"pax", U"ho", U"mi", U"ni", U"bus", U"Cmaj7", U"Dm7", U"G7", U"Am", U"F#m7b5", U"B7", U"Em", U"A7sus4"
+    };
+    const std::vector<Font> fonts = { makeFont(u"Edwin", 10.0), makeFont(u"Edwin", 10.0, true), makeFont(u"FreeSerif", 11.0) };
+
+    constexpr size_t NOTES = 200000;
+    constexpr size_t THREAD_COUNT = 4;
+
+    auto layout = [&](size_t notes) {
+        double sum = 0.0;
+        for (size_t i = 0; i < notes; ++i) {
+            const Font& font = fonts[i % fonts.size()];
+            const std::u32string& text = texts[(i * 7) % texts.size()];
+            sum += m_engine->horizontalAdvance(font, text);
+            sum += m_engine->boundingRect(font, text).width();
+            sum += m_engine->tightBoundingRect(font, text).height();
+            sum += m_engine->horizontalAdvance(font, text.front());
+            sum += m_engine->symBBox(font, U'\uE050').width();
+        }
+        return sum;
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    double sum = layout(NOTES);
+    double singleMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREAD_COUNT; ++t) {
+        threads.emplace_back([&layout]() { layout(NOTES / THREAD_COUNT); });
+    }
+    for (std::thread& th : threads) {
+        th.join();
+    }
+    double concurrentMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "notes: " << NOTES << ", calls: " << NOTES * 5 << ", sum: " << sum << std::endl;
+    std::cout << "one thread: " << singleMs << " ms (" << singleMs * 1e6 / (NOTES * 5) << " ns per call)" << std::endl;
+    std::cout << THREAD_COUNT << " threads: " << concurrentMs << " ms" << std::endl;
+    std::cout << "face calls: " << m_faceCalls << std::endl;
+}
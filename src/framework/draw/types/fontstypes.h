@@ -152,4 +152,25 @@ struct FontParams {
 };
 }
 
+template<>
+struct std::hash<muse::draw::FontDataKey>
+{
+    std::size_t operator()(const muse::draw::FontDataKey& k) const noexcept
+    {
+        return std::hash<std::string> {}(k.family()) ^ (size_t(k.bold()) << 1) ^ (size_t(k.italic()) << 2);
+    }
+};
+
+template<>
+struct std::hash<muse::draw::FaceKey>
+{
+    std::size_t operator()(const muse::draw::FaceKey& k) const noexcept
+    {
+        size_t h = std::hash<muse::draw::FontDataKey> {}(k.dataKey);
+        h ^= std::hash<int> {}(k.pixelSize) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        h ^= std::hash<int> {}(static_cast<int>(k.type)) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        return h;
+    }
+};
+
 #endif // MUSE_DRAW_FONTSTYPES_H
@@ -21,8 +21,11 @@
  */
 #include "allocator.h"
 
+#include <algorithm>
+#include <cassert>
 #include <cstdlib>
 #include <iostream>
+#include <set>
 #include <sstream>
 
 #include "stringutils.h"
@@ -30,8 +33,15 @@
 
 using namespace muse;
 
+#ifdef MUSE_ENABLE_CUSTOM_ALLOCATOR
+int ObjectAllocator::s_used = 1;
+#else
 int ObjectAllocator::s_used = 0;
+#endif
+
 size_t ObjectAllocator::DEFAULT_BLOCK_SIZE(1024 * 256); // 256 kB
+std::atomic<size_t> ObjectAllocator::s_nextId = 0;
+std::mutex ObjectAllocator::s_magazineOwnersMutex;
 
 static inline size_t align(size_t n)
 {
@@ -39,24 +49,44 @@ static inline size_t align(size_t n)
 }
 
 // ============================================
-// ObjectAllocator
+// ThreadCache
 // ============================================
-void ObjectAllocator::used()
-{
-#ifdef MUSE_ENABLE_CUSTOM_ALLOCATOR
-    s_used++;
-#endif
-}
+//! NOTE The magazines of a thread, by allocator id.
+//! When the thread ends, its free chunks are returned to the allocators.
+struct ObjectAllocator::ThreadCache {
+    std::vector<Magazine*> magazines;
 
-void ObjectAllocator::unused()
-{
-#ifdef MUSE_ENABLE_CUSTOM_ALLOCATOR
-    s_used--;
-#endif
-}
+    ~ThreadCache()
+    {
+        s_threadCacheDestroyed = true;
 
+        //! NOTE Held while the magazines are released, so that their allocators can't be destroyed meanwhile
+        std::lock_guard<std::mutex> lock(s_magazineOwnersMutex);
+
+        for (Magazine* magazine : magazines) {
+            if (!magazine) {
+                continue;
+            }
+
+            if (magazine->allocator) {
+                magazine->allocator->releaseMagazine(magazine);
+            } else {
+                delete magazine;
+            }
+        }
+
+        magazines.clear();
+    }
+};
+
+thread_local ObjectAllocator::ThreadCache ObjectAllocator::s_threadCache;
+thread_local bool ObjectAllocator::s_threadCacheDestroyed = false;
+
+// ============================================
+// ObjectAllocator
+// ============================================
 ObjectAllocator::ObjectAllocator(const char* module, const char* name, destroyer_t dtor)
-    : m_module(module), m_name(name), m_dtor(dtor)
+    : m_id(s_nextId++), m_module(module), m_name(name), m_dtor(dtor)
 {
     AllocatorsRegister::instance()->reg(this);
 }
@@ -64,6 +94,13 @@ ObjectAllocator::ObjectAllocator(const char* module, const char* name, destroyer
 ObjectAllocator::~ObjectAllocator()
 {
     AllocatorsRegister::instance()->unreg(this);
+
+    //! NOTE The magazines of the threads still running are deleted by the threads
+    std::lock_guard<std::mutex> ownersLock(s_magazineOwnersMutex);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (Magazine* magazine : m_magazines) {
+        magazine->allocator = nullptr;
+    }
 }
 
 const char* ObjectAllocator::module() const
@@ -77,6 +114,139 @@ const char* ObjectAllocator::name() const
 }
 
 void* ObjectAllocator::alloc(size_t size)
+{
+    Magazine* magazine = threadMagazine();
+    if (!magazine) {
+        return allocShared(size);
+    }
+
+    size_t count = magazine->count.load(std::memory_order_relaxed);
+    if (count == 0) {
+        count = refill(magazine, size);
+    }
+
+    // Take the last free chunk of the magazine
+    --count;
+    Chunk* freeChunk = magazine->chunks[count];
+
+    magazine->count.store(count, std::memory_order_relaxed);
+    magazine->allocatedCount.store(magazine->allocatedCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    return freeChunk;
+}
+
+void ObjectAllocator::free(void* chunk)
+{
+    Magazine* magazine = threadMagazine();
+    if (!magazine) {
+        freeShared(chunk);
+        return;
+    }
+
+    size_t count = magazine->count.load(std::memory_order_relaxed);
+    if (count == MAGAZINE_CAPACITY) {
+        count = flush(magazine);
+    }
+
+    magazine->chunks[count] = reinterpret_cast<Chunk*>(chunk);
+
+    magazine->count.store(count + 1, std::memory_order_relaxed);
+    magazine->freeCount.store(magazine->freeCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+ObjectAllocator::Magazine* ObjectAllocator::threadMagazine()
+{
+    //! NOTE Objects deleted by the destructors of the static objects, after the thread cache
+    if (s_threadCacheDestroyed) {
+        return nullptr;
+    }
+
+    const std::vector<Magazine*>& magazines = s_threadCache.magazines;
+    if (m_id < magazines.size() && magazines[m_id]) {
+        return magazines[m_id];
+    }
+
+    return createThreadMagazine();
+}
+
+ObjectAllocator::Magazine* ObjectAllocator::createThreadMagazine()
+{
+    Magazine* magazine = new Magazine();
+    magazine->allocator = this;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_magazines.push_back(magazine);
+    }
+
+    std::vector<Magazine*>& magazines = s_threadCache.magazines;
+    if (magazines.size() <= m_id) {
+        magazines.resize(m_id + 1, nullptr);
+    }
+    magazines[m_id] = magazine;
+
+    return magazine;
+}
+
+void ObjectAllocator::releaseMagazine(Magazine* magazine)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    moveToFreeList(magazine, magazine->count.load(std::memory_order_relaxed));
+
+    m_statistic.totalAllocatedCount += magazine->allocatedCount.load(std::memory_order_relaxed);
+    m_statistic.totalFreeCount += magazine->freeCount.load(std::memory_order_relaxed);
+
+    m_magazines.erase(std::remove(m_magazines.begin(), m_magazines.end(), magazine), m_magazines.end());
+    delete magazine;
+}
+
+void* ObjectAllocator::allocShared(size_t size)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    ensureFreeChunks(size);
+
+    Chunk* freeChunk = m_free;
+    m_free = m_free->next;
+    --m_freeCount;
+
+    m_statistic.totalAllocatedCount++;
+
+    return freeChunk;
+}
+
+void ObjectAllocator::freeShared(void* chunk)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    Chunk* freeChunk = reinterpret_cast<Chunk*>(chunk);
+    freeChunk->next = m_free;
+    m_free = freeChunk;
+    ++m_freeCount;
+
+    m_statistic.totalFreeCount++;
+}
+
+size_t ObjectAllocator::refill(Magazine* magazine, size_t size)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    ensureFreeChunks(size);
+
+    // Take up to half a magazine from the shared free list,
+    // the other half is left for the chunks freed by this thread
+    size_t count = 0;
+    while (m_free && count < MAGAZINE_CAPACITY / 2) {
+        magazine->chunks[count++] = m_free;
+        m_free = m_free->next;
+        --m_freeCount;
+    }
+
+    return count;
+}
+
+void ObjectAllocator::ensureFreeChunks(size_t size)
 {
     size = align(size);
 
@@ -90,42 +260,53 @@ void* ObjectAllocator::alloc(size_t size)
         Block b = allocateBlock(m_chunkSize);
         m_blocks.push_back(b);
         m_free = b.begin;
+        m_freeCount = b.chunkCount;
     }
+}
 
-    // The return value is the current position of
-    // the allocation pointer:
-    Chunk* freeChunk = m_free;
+size_t ObjectAllocator::flush(Magazine* magazine)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
 
-    // Advance (bump) the allocation pointer to the next chunk.
-    //
-    // When no chunks left, the `m_free` will be set to `nullptr`, and
-    // this will cause allocation of a new block on the next request:
-    m_free = m_free->next;
+    // Return the older half of the chunks
+    constexpr size_t half = MAGAZINE_CAPACITY / 2;
+    moveToFreeList(magazine, half);
 
-    m_statistic.totalAllocatedCount++;
+    std::copy(magazine->chunks + half, magazine->chunks + MAGAZINE_CAPACITY, magazine->chunks);
 
-    return freeChunk;
+    return MAGAZINE_CAPACITY - half;
 }
 
-void ObjectAllocator::free(void* chunk)
+void ObjectAllocator::moveToFreeList(Magazine* magazine, size_t count)
 {
-    // The freed chunk's next pointer points to the
-    // current allocation pointer:
-    reinterpret_cast<Chunk*>(chunk)->next = m_free;
+    for (size_t i = 0; i < count; ++i) {
+        Chunk* chunk = magazine->chunks[i];
 
-    // And the allocation pointer is now set
-    // to the returned (free) chunk:
-    m_free = reinterpret_cast<Chunk*>(chunk);
+        // The freed chunk's next pointer points to the
+        // current allocation pointer:
+        chunk->next = m_free;
 
-    m_statistic.totalFreeCount++;
+        // And the allocation pointer is now set
+        // to the returned (free) chunk:
+        m_free = chunk;
+    }
+
+    m_freeCount += count;
 }
 
 void ObjectAllocator::cleanup()
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
     if (m_blocks.empty()) {
         return;
     }
 
+    for (Magazine* magazine : m_magazines) {
+        moveToFreeList(magazine, magazine->count.load(std::memory_order_relaxed));
+        magazine->count.store(0, std::memory_order_relaxed);
+    }
+
     std::set<Chunk*> freeChunks;
     {
         Chunk* free = m_free;
@@ -135,6 +316,7 @@ void ObjectAllocator::cleanup()
         }
     }
 
+    size_t totalChunks = 0;
     for (size_t bi = 0; bi < m_blocks.size(); ++bi) {
         const Block& b = m_blocks.at(bi);
         Chunk* chunk = b.begin;
@@ -157,9 +339,12 @@ void ObjectAllocator::cleanup()
         } else {
             chunk->next = nullptr;
         }
+
+        totalChunks += b.chunkCount;
     }
 
     m_free = m_blocks.front().begin;
+    m_freeCount = totalChunks;
 }
 
 ObjectAllocator::Block ObjectAllocator::allocateBlock(size_t chunkSize) const
@@ -196,6 +381,8 @@ void* ObjectAllocator::not_supported(const char* info)
 
 ObjectAllocator::Info ObjectAllocator::stateInfo() const
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
     Info info;
     info.module = m_module;
     info.name = m_name;
@@ -203,17 +390,20 @@ ObjectAllocator::Info ObjectAllocator::stateInfo() const
     info.blockCount = m_blocks.size();
     info.totalAllocatedCount = m_statistic.totalAllocatedCount;
     info.totalFreeCount = m_statistic.totalFreeCount;
+    info.threadCount = m_magazines.size();
 
     for (const Block& b : m_blocks) {
         info.totalChunks += b.chunkCount;
     }
 
-    Chunk* free = m_free;
-    while (free) {
-        ++info.freeChunks;
-        free = free->next;
+    for (const Magazine* magazine : m_magazines) {
+        info.cachedChunks += magazine->count.load(std::memory_order_relaxed);
+        info.totalAllocatedCount += magazine->allocatedCount.load(std::memory_order_relaxed);
+        info.totalFreeCount += magazine->freeCount.load(std::memory_order_relaxed);
     }
 
+    info.freeChunks = m_freeCount + info.cachedChunks;
+
     return info;
 }
 
@@ -222,16 +412,19 @@ ObjectAllocator::Info ObjectAllocator::stateInfo() const
 // ============================================
 void AllocatorsRegister::reg(ObjectAllocator* a)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_allocators.push_back(a);
 }
 
 void AllocatorsRegister::unreg(ObjectAllocator* a)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_allocators.remove(a);
 }
 
 void AllocatorsRegister::cleanupAll(const std::string& module)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     for (ObjectAllocator* a : m_allocators) {
         if (a->module() == module) {
             a->cleanup();
@@ -239,24 +432,37 @@ void AllocatorsRegister::cleanupAll(const std::string& module)
     }
 }
 
+std::vector<ObjectAllocator::Info> AllocatorsRegister::stateInfo() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<ObjectAllocator::Info> result;
+    result.reserve(m_allocators.size());
+    for (const ObjectAllocator* a : m_allocators) {
+        result.push_back(a->stateInfo());
+    }
+
+    return result;
+}
+
 #define FORMAT(str, width) muse::strings::leftJustified(str, width)
 #define TITLE(str) FORMAT(std::string(str), 20)
 #define VALUE(val) FORMAT(std::to_string(val), 20)
 
-void AllocatorsRegister::printStatistic(const std::string& title)
+std::string AllocatorsRegister::statisticString(const std::string& title) const
 {
+    const std::vector<ObjectAllocator::Info> infos = stateInfo();
+
     std::stringstream stream;
-    stream << "\n\n";
     stream << title << "\n";
-    stream << "allocators: " << m_allocators.size() << '\n';
+    stream << "allocators: " << infos.size() << '\n';
     stream << TITLE("Object") << TITLE("Total alloc") << TITLE("Total free") << TITLE("Used (leak?)") << TITLE("Object size") << "\n";
 
     uint64_t totalBytes = 0;
     uint64_t totalAllocatedCount = 0;
     uint64_t totalFreeCount = 0;
     uint64_t totalUsedCount = 0;
-    for (ObjectAllocator* a : m_allocators) {
-        ObjectAllocator::Info info = a->stateInfo();
+    for (const ObjectAllocator::Info& info : infos) {
         stream << FORMAT(info.name, 20)
                << VALUE(info.totalAllocatedCount)
                << VALUE(info.totalFreeCount)
@@ -274,25 +480,27 @@ void AllocatorsRegister::printStatistic(const std::string& title)
     stream << FORMAT("Total", 20) << VALUE(totalAllocatedCount) << VALUE(totalFreeCount) << VALUE(totalUsedCount) << "\n";
     stream << "Total allocated: " << totalBytes << " bytes\n";
 
-    LOGD() << stream.str() << '\n';
+    return stream.str();
 }
 
-void AllocatorsRegister::printState(const std::string& title)
+std::string AllocatorsRegister::stateString(const std::string& title) const
 {
+    const std::vector<ObjectAllocator::Info> infos = stateInfo();
+
     std::stringstream stream;
-    stream << "\n\n";
     stream << title << "\n";
-    stream << "allocators: " << m_allocators.size() << '\n';
-    stream << TITLE("Object") << TITLE("blockCount") << TITLE("totalChunks") << TITLE("freeChunks") << TITLE("chunkSize")
-           << TITLE("allocatedBytes") << "\n";
+    stream << "allocators: " << infos.size() << '\n';
+    stream << TITLE("Object") << TITLE("blockCount") << TITLE("totalChunks") << TITLE("freeChunks") << TITLE("cachedChunks")
+           << TITLE("threads") << TITLE("chunkSize") << TITLE("allocatedBytes") << "\n";
 
     uint64_t totalBytes = 0;
-    for (ObjectAllocator* a : m_allocators) {
-        ObjectAllocator::Info info = a->stateInfo();
+    for (const ObjectAllocator::Info& info : infos) {
         stream << FORMAT(info.name, 20)
                << VALUE(info.blockCount)
                << VALUE(info.totalChunks)
                << VALUE(info.freeChunks)
+               << VALUE(info.cachedChunks)
+               << VALUE(info.threadCount)
                << VALUE(info.chunkSize)
                << VALUE(info.allocatedBytes())
                << "\n";
@@ -303,5 +511,15 @@ void AllocatorsRegister::printState(const std::string& title)
     stream << "-----------------------------------------------------\n";
     stream << "Total allocated: " << totalBytes << " bytes\n";
 
-    LOGD() << stream.str() << '\n';
+    return stream.str();
+}
+
+void AllocatorsRegister::printStatistic(const std::string& title)
+{
+    LOGD() << "\n\n" << statisticString(title) << '\n';
+}
+
+void AllocatorsRegister::printState(const std::string& title)
+{
+    LOGD() << "\n\n" << stateString(title) << '\n';
 }
@@ -26,8 +26,13 @@
 #include <vector>
 #include <list>
 #include <string>
+#include <atomic>
+#include <mutex>
 
 namespace muse {
+//! NOTE The chunks of an allocator have the size of its class.
+//! A derived class without its own OBJECT_ALLOCATOR gets a different size,
+//! such objects are allocated by the default allocator
 #define OBJECT_ALLOCATOR(Module, ClassName) \
 public: \
     static muse::ObjectAllocator& allocator() { \
@@ -35,10 +40,10 @@ public: \
         return a; \
     } \
     static void* operator new(size_t sz) { \
-        return muse::ObjectAllocator::enabled() ? allocator().alloc(sz) : ::operator new(sz); \
+        return (muse::ObjectAllocator::enabled() && sz == sizeof(ClassName)) ? allocator().alloc(sz) : ::operator new(sz); \
     } \
-    static void operator delete(void* ptr) { \
-        if (muse::ObjectAllocator::enabled()) { \
+    static void operator delete(void* ptr, size_t sz) { \
+        if (muse::ObjectAllocator::enabled() && sz == sizeof(ClassName)) { \
             allocator().free(ptr); \
         } else { \
             ::operator delete(ptr); \
@@ -59,6 +64,10 @@ public: \
     } \
 private:
 
+//! NOTE The allocator can be used from several threads.
+//! Each thread has a magazine of free chunks for each allocator: alloc and free use it without locking,
+//! only refilling an empty magazine or emptying a full one takes the lock of the shared free list.
+//! A chunk can be freed by any thread, it goes to the magazine of that thread.
 class ObjectAllocator
 {
 public:
@@ -69,12 +78,16 @@ public:
     ~ObjectAllocator();
 
     static size_t DEFAULT_BLOCK_SIZE;
+    static constexpr size_t MAGAZINE_CAPACITY = 64;
 
     const char* module() const;
     const char* name() const;
 
     void* alloc(size_t size);
     void free(void* ptr);
+
+    //! NOTE Destroys the objects still allocated,
+    //! must not be called while other threads use the allocator
     void cleanup();
 
     template<class T>
@@ -94,6 +107,8 @@ public:
         size_t blockCount = 0;
         size_t totalChunks = 0;
         size_t freeChunks = 0;
+        size_t cachedChunks = 0; // free chunks in the magazines of the threads
+        size_t threadCount = 0;  // threads having a magazine
 
         uint64_t totalAllocatedCount = 0;
         uint64_t totalFreeCount = 0;
@@ -104,9 +119,9 @@ public:
 
     Info stateInfo() const;
 
+    //! NOTE Set once for the whole run (see MUSE_ENABLE_CUSTOM_ALLOCATOR):
+    //! switching it while objects are alive would free them to the wrong allocator
     static bool enabled() { return s_used; }
-    static void used();
-    static void unused();
 
     static int s_used;
 private:
@@ -128,14 +143,43 @@ private:
         size_t chunkSize = 0;
     };
 
+    //! NOTE Written only by its thread, the counters are read by stateInfo.
+    //! The allocator is reset when the allocator is destroyed before the thread, guarded by s_magazineOwnersMutex
+    struct Magazine {
+        ObjectAllocator* allocator = nullptr;
+        std::atomic<size_t> count = 0;
+        std::atomic<uint64_t> allocatedCount = 0;
+        std::atomic<uint64_t> freeCount = 0;
+        Chunk* chunks[MAGAZINE_CAPACITY];
+    };
+
+    struct ThreadCache;
+
+    Magazine* threadMagazine();
+    Magazine* createThreadMagazine();
+    void releaseMagazine(Magazine* magazine);
+
+    void* allocShared(size_t size);
+    void freeShared(void* ptr);
+
+    size_t refill(Magazine* magazine, size_t size);
+    size_t flush(Magazine* magazine);
+    void moveToFreeList(Magazine* magazine, size_t count);
+    void ensureFreeChunks(size_t size);
+
     Block allocateBlock(size_t chunkSize) const;
 
+    const size_t m_id = 0;
     const char* m_module = nullptr;
     const char* m_name = nullptr;
     size_t m_chunkSize = 0;
     destroyer_t m_dtor = nullptr;
+
+    //! NOTE Guarded by m_mutex
     Chunk* m_free = nullptr;
+    size_t m_freeCount = 0;
     std::vector<Block> m_blocks;
+    std::vector<Magazine*> m_magazines;
 
     struct Statistic
     {
@@ -143,7 +187,15 @@ private:
         uint64_t totalFreeCount = 0;
     };
 
+    //! NOTE The counters of the released magazines
     Statistic m_statistic;
+
+    mutable std::mutex m_mutex;
+
+    static std::atomic<size_t> s_nextId;
+    static std::mutex s_magazineOwnersMutex;
+    static thread_local ThreadCache s_threadCache;
+    static thread_local bool s_threadCacheDestroyed;
 };
 
 class AllocatorsRegister
@@ -161,11 +213,17 @@ public:
 
     void cleanupAll(const std::string& module);
 
+    std::vector<ObjectAllocator::Info> stateInfo() const;
+
+    std::string statisticString(const std::string& title) const;
+    std::string stateString(const std::string& title) const;
+
     void printStatistic(const std::string& title);
     void printState(const std::string& title);
 
 private:
     std::list<ObjectAllocator*> m_allocators;
+    mutable std::mutex m_mutex;
 };
 }
 
@@ -34,6 +34,11 @@ inline void onMainThreadInvoke(const std::function<void(const std::function<void
 {
     kors::async::onMainThreadInvoke(f);
 }
+
+inline void onQueuedInvoke(const std::function<void()>& f)
+{
+    kors::async::onQueuedInvoke(f);
+}
 }
 
 #endif // MUSE_ASYNC_PROCESSEVENTS_H
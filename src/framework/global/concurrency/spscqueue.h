@@ -0,0 +1,128 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUSE_GLOBAL_SPSCQUEUE_H
+#define MUSE_GLOBAL_SPSCQUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace muse {
+//! NOTE: Fixed-capacity lock-free queue for one producer thread and one consumer thread.
+//! It never allocates and never blocks, so it can be used from real-time threads (e.g. audio).
+//! push() must be called only from the producer thread, front()/pop() only from the consumer thread
+template<typename T, size_t Capacity>
+class SpscQueue
+{
+    static_assert(std::is_trivially_copyable_v<T>, "the items are copied between threads without synchronization of their members");
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "the capacity must be a power of two");
+
+public:
+    SpscQueue() = default;
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    static constexpr size_t capacity()
+    {
+        return Capacity;
+    }
+
+    //! NOTE: Returns false if the queue is full
+    bool push(const T& item)
+    {
+        const size_t writeIdx = m_writeIndex.load(std::memory_order_relaxed);
+
+        if (writeIdx - m_cachedReadIndex == Capacity) {
+            m_cachedReadIndex = m_readIndex.load(std::memory_order_acquire);
+
+            if (writeIdx - m_cachedReadIndex == Capacity) {
+                return false;
+            }
+        }
+
+        m_items[writeIdx & MASK] = item;
+        m_writeIndex.store(writeIdx + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    //! NOTE: Returns the oldest item without removing it, or nullptr if the queue is empty
+    const T* front()
+    {
+        const size_t readIdx = m_readIndex.load(std::memory_order_relaxed);
+
+        if (readIdx == m_cachedWriteIndex) {
+            m_cachedWriteIndex = m_writeIndex.load(std::memory_order_acquire);
+
+            if (readIdx == m_cachedWriteIndex) {
+                return nullptr;
+            }
+        }
+
+        return &m_items[readIdx & MASK];
+    }
+
+    //! NOTE: Removes the oldest item, front() must have returned it before
+    void pop()
+    {
+        m_readIndex.store(m_readIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool pop(T& item)
+    {
+        const T* oldest = front();
+        if (!oldest) {
+            return false;
+        }
+
+        item = *oldest;
+        pop();
+
+        return true;
+    }
+
+    //! NOTE: Approximate when called from a thread which is neither the producer nor the consumer
+    bool empty() const
+    {
+        return m_readIndex.load(std::memory_order_acquire) == m_writeIndex.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    //! NOTE: The indexes grow monotonically and are wrapped by MASK, each one is written by one thread only.
+    //! Each thread keeps a cached copy of the other's index, so the shared cache lines are touched
+    //! only when the queue looks full (producer) or empty (consumer)
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_writeIndex = 0;
+    size_t m_cachedReadIndex = 0;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_readIndex = 0;
+    size_t m_cachedWriteIndex = 0;
+
+    alignas(CACHE_LINE_SIZE) std::array<T, Capacity> m_items = {};
+};
+}
+
+#endif // MUSE_GLOBAL_SPSCQUEUE_H
@@ -0,0 +1,285 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "taskscheduler.h"
+
+#include <algorithm>
+
+using namespace muse;
+
+//! NOTE: The worker of the current thread, if the thread belongs to a scheduler
+static thread_local const TaskScheduler* s_currentScheduler = nullptr;
+static thread_local size_t s_currentWorkerIdx = 0;
+
+TaskScheduler::TaskScheduler(const thread_pool_size_t desiredThreadCount)
+    : m_threadPoolSize(vaildateThreadPoolCapacity(desiredThreadCount))
+{
+    m_isActive = true;
+
+    for (thread_pool_size_t i = 0; i < m_threadPoolSize; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+
+    for (thread_pool_size_t i = 0; i < m_threadPoolSize; ++i) {
+        m_workers[i]->thread = std::thread(&TaskScheduler::th_workerLoop, this, i);
+        m_threadIdSet.insert(m_workers[i]->thread.get_id());
+    }
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    waitForAllTasksComplete();
+
+    {
+        std::lock_guard lock(m_sleepMutex);
+        m_isActive = false;
+    }
+
+    m_newTaskAvailableCv.notify_all();
+
+    for (std::unique_ptr<Worker>& worker : m_workers) {
+        worker->thread.join();
+    }
+}
+
+void TaskScheduler::enqueue(const Task& task, TaskPriority priority)
+{
+    size_t priorityIdx = static_cast<size_t>(priority);
+
+    m_pendingTaskCount.fetch_add(1);
+    m_queuedTaskCount.fetch_add(1);
+
+    //! NOTE: Before the push, after it the task may be finished and the group destroyed
+    if (task.group) {
+        task.group->m_queuedCount.fetch_add(1);
+        task.group->onTaskQueued();
+    }
+
+    TaskQueue* queue = nullptr;
+    if (s_currentScheduler == this) {
+        queue = &m_workers[s_currentWorkerIdx]->queues[priorityIdx];
+    } else {
+        queue = &m_injectionQueues[priorityIdx];
+    }
+
+    {
+        std::lock_guard lock(queue->mutex);
+        queue->tasks.push_back(task);
+    }
+
+    if (m_sleepingWorkerCount.load() > 0) {
+        std::lock_guard lock(m_sleepMutex);
+        m_newTaskAvailableCv.notify_one();
+    }
+}
+
+bool TaskScheduler::tryPopTask(Task& task)
+{
+    for (size_t priorityIdx = 0; priorityIdx < PRIORITY_COUNT; ++priorityIdx) {
+        if (tryPopTask(task, priorityIdx)) {
+            onTaskPopped(task);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool TaskScheduler::tryPopGroupTask(Task& task, const TaskGroup& group)
+{
+    auto popGroupTask = [&task, &group](TaskQueue& queue) {
+        std::lock_guard lock(queue.mutex);
+        auto it = std::find_if(queue.tasks.begin(), queue.tasks.end(), [&group](const Task& t) {
+            return t.group == &group;
+        });
+
+        if (it == queue.tasks.end()) {
+            return false;
+        }
+
+        task = *it;
+        queue.tasks.erase(it);
+        return true;
+    };
+
+    for (size_t priorityIdx = 0; priorityIdx < PRIORITY_COUNT; ++priorityIdx) {
+        bool found = popGroupTask(m_injectionQueues[priorityIdx]);
+
+        for (size_t i = 0; !found && i < m_workers.size(); ++i) {
+            found = popGroupTask(m_workers[i]->queues[priorityIdx]);
+        }
+
+        if (found) {
+            onTaskPopped(task);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void TaskScheduler::onTaskPopped(const Task& task)
+{
+    m_queuedTaskCount.fetch_sub(1);
+
+    if (task.group) {
+        task.group->m_queuedCount.fetch_sub(1);
+    }
+}
+
+bool TaskScheduler::tryPopTask(Task& task, size_t priorityIdx)
+{
+    auto popBack = [&task](TaskQueue& queue) {
+        std::lock_guard lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = queue.tasks.back();
+        queue.tasks.pop_back();
+        return true;
+    };
+
+    auto popFront = [&task](TaskQueue& queue) {
+        std::lock_guard lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+        return true;
+    };
+
+    bool isWorker = s_currentScheduler == this;
+    size_t ownIdx = isWorker ? s_currentWorkerIdx : 0;
+
+    //! NOTE: Own tasks first, newest first (they are the most likely to be hot in the cache)
+    if (isWorker && popBack(m_workers[ownIdx]->queues[priorityIdx])) {
+        return true;
+    }
+
+    //! NOTE: Then the tasks from outside of the pool, in order
+    if (popFront(m_injectionQueues[priorityIdx])) {
+        return true;
+    }
+
+    //! NOTE: Then steal the oldest tasks of the other workers
+    for (size_t i = 1; i <= m_workers.size(); ++i) {
+        size_t victimIdx = (ownIdx + i) % m_workers.size();
+        if (isWorker && victimIdx == ownIdx) {
+            continue;
+        }
+
+        if (popFront(m_workers[victimIdx]->queues[priorityIdx])) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void TaskScheduler::execute(const Task& task)
+{
+    task.func(task.context);
+
+    if (task.group) {
+        task.group->onTaskFinished();
+    }
+
+    if (m_pendingTaskCount.fetch_sub(1) == 1) {
+        std::lock_guard lock(m_sleepMutex);
+        m_allTasksDoneCv.notify_all();
+    }
+}
+
+void TaskScheduler::wait(TaskGroup& group)
+{
+    while (!group.isDone()) {
+        Task task;
+        if (tryPopGroupTask(task, group)) {
+            execute(task);
+            continue;
+        }
+
+        //! NOTE: The remaining tasks of the group are running on other threads,
+        //! wait until they are done or until a new task of the group is queued
+        std::unique_lock lock(group.m_mutex);
+        group.m_doneCv.wait(lock, [&group]() {
+            return group.isDone() || group.m_queuedCount.load() > 0;
+        });
+    }
+
+    //! NOTE: Let the last task leave onTaskFinished before the group may be destroyed
+    std::lock_guard lock(group.m_mutex);
+}
+
+void TaskScheduler::waitForAllTasksComplete()
+{
+    std::unique_lock lock(m_sleepMutex);
+    m_allTasksDoneCv.wait(lock, [this]() {
+        return m_pendingTaskCount.load() == 0;
+    });
+}
+
+thread_pool_size_t TaskScheduler::vaildateThreadPoolCapacity(const thread_pool_size_t desiredThreadCount) const
+{
+    thread_pool_size_t maxCapacity = std::thread::hardware_concurrency();
+
+    if (maxCapacity <= 1) {
+        return 1;
+    }
+
+    thread_pool_size_t optimalCapacity = maxCapacity / 2;
+
+    if (desiredThreadCount <= 0) {
+        return optimalCapacity;
+    }
+
+    return desiredThreadCount;
+}
+
+void TaskScheduler::th_workerLoop(size_t workerIdx)
+{
+    s_currentScheduler = this;
+    s_currentWorkerIdx = workerIdx;
+
+    while (true) {
+        Task task;
+        if (tryPopTask(task)) {
+            execute(task);
+            continue;
+        }
+
+        m_sleepingWorkerCount.fetch_add(1);
+
+        {
+            std::unique_lock lock(m_sleepMutex);
+            m_newTaskAvailableCv.wait(lock, [this]() {
+                return !m_isActive || m_queuedTaskCount.load() > 0;
+            });
+        }
+
+        m_sleepingWorkerCount.fetch_sub(1);
+
+        if (!m_isActive) {
+            return;
+        }
+    }
+}
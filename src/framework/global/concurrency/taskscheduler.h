@@ -24,45 +24,92 @@
 #define MUSE_GLOBAL_TASKCHEDULER_H
 
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <future>
 #include <memory>
 #include <mutex>
 #include <atomic>
-#include <queue>
+#include <set>
 #include <thread>
+#include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "log.h"
 
 namespace muse {
 typedef std::invoke_result_t<decltype(std::thread::hardware_concurrency)> thread_pool_size_t;
 
-class TaskScheduler
+enum class TaskPriority {
+    //! NOTE: The user is waiting for the result (layout, playback start, ...)
+    Interactive = 0,
+    //! NOTE: Everything else (autosave, batch conversion, ...)
+    Background,
+};
+
+//! NOTE: Tracks a set of tasks, so that one can wait for them without waiting for the whole queue
+class TaskGroup
 {
 public:
+    TaskGroup() = default;
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
 
-    //!Note Would be moved into globalmodule.cpp for better lifetime control
-    static TaskScheduler* instance()
+    bool isDone() const
     {
-        static TaskScheduler s;
-        return &s;
+        return m_pendingCount.load(std::memory_order_acquire) == 0;
+    }
+
+private:
+    friend class TaskScheduler;
+
+    void onTaskAdded(size_t count = 1)
+    {
+        m_pendingCount.fetch_add(count, std::memory_order_relaxed);
     }
 
-    explicit TaskScheduler(const thread_pool_size_t desiredThreadCount = 0)
-        : m_threadPoolSize(vaildateThreadPoolCapacity(desiredThreadCount)),
-        m_threadPool(std::make_unique<std::thread[]>(vaildateThreadPoolCapacity(desiredThreadCount)))
+    void onTaskQueued()
     {
-        setupThreads();
+        //! NOTE: Wakes the waiter, it executes the queued tasks of its group itself
+        std::lock_guard lock(m_mutex);
+        m_doneCv.notify_all();
     }
 
-    ~TaskScheduler()
+    void onTaskFinished()
     {
-        waitForAllTasksComplete();
-        terminateThreads();
+        //! NOTE: Under the lock, so that the waiter can't destroy the group in the middle of the notification
+        std::lock_guard lock(m_mutex);
+        if (m_pendingCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            m_doneCv.notify_all();
+        }
     }
 
+    std::atomic<size_t> m_pendingCount = 0;
+    std::atomic<size_t> m_queuedCount = 0;
+    std::mutex m_mutex;
+    std::condition_variable m_doneCv;
+};
+
+//! NOTE: A work-stealing thread pool.
+//! Every worker has its own queues (one per priority); it takes its own tasks from the back
+//! and, when it has nothing to do, steals from the front of the other workers' queues.
+//! Tasks pushed from outside of the pool go to shared injection queues.
+class TaskScheduler
+{
+public:
+
+    //!Note Would be moved into globalmodule.cpp for better lifetime control
+    static TaskScheduler* instance()
+    {
+        static TaskScheduler s;
+        return &s;
+    }
+
+    explicit TaskScheduler(const thread_pool_size_t desiredThreadCount = 0);
+    ~TaskScheduler();
+
     thread_pool_size_t threadPoolSize() const
     {
         return m_threadPoolSize;
@@ -71,12 +118,13 @@ public:
     template<typename FuncT, typename ... ArgsT>
     void push(FuncT&& task, ArgsT&&... args)
     {
-        std::function<void()> taskFunctor = std::bind(std::forward<FuncT>(task), std::forward<ArgsT>(args)...);
-        {
-            const std::lock_guard lock(m_mutex);
-            m_taskQueue.push(taskFunctor);
-        }
-        m_newTaskAvailableCv.notify_one();
+        pushTo(TaskPriority::Background, nullptr, std::forward<FuncT>(task), std::forward<ArgsT>(args)...);
+    }
+
+    template<typename FuncT, typename ... ArgsT>
+    void push(TaskGroup& group, TaskPriority priority, FuncT&& task, ArgsT&&... args)
+    {
+        pushTo(priority, &group, std::forward<FuncT>(task), std::forward<ArgsT>(args)...);
     }
 
     template<typename FuncT, typename ... ArgsT, typename ReturnT = std::invoke_result_t<std::decay_t<FuncT>, std::decay_t<ArgsT>...> >
@@ -104,101 +152,196 @@ public:
         return promise->get_future();
     }
 
-    void waitForAllTasksComplete()
+    //! NOTE: Calls func(index) for every index in [0, count) and returns when all calls are finished.
+    //! The items are not scheduled one by one: at most threadPoolSize() tasks share an atomic counter,
+    //! and the calling thread takes part in the work, so nothing is allocated per item.
+    template<typename FuncT>
+    void parallelFor(size_t count, FuncT&& func, TaskPriority priority = TaskPriority::Interactive)
     {
-        m_isWaitingForAllTasksDone = true;
-        std::unique_lock<std::mutex> tasks_lock(m_mutex);
-        m_taskFinishedCv.wait(tasks_lock, [this] { return m_taskQueue.empty(); });
-        m_isWaitingForAllTasksDone = false;
+        using Func = std::remove_reference_t<FuncT>;
+
+        if (count == 0) {
+            return;
+        }
+
+        if (count == 1) {
+            func(0);
+            return;
+        }
+
+        Batch<Func> batch(func, count);
+        TaskGroup group;
+
+        size_t runnerCount = std::min<size_t>(count - 1, m_threadPoolSize);
+        group.onTaskAdded(runnerCount);
+
+        for (size_t i = 0; i < runnerCount; ++i) {
+            enqueue(Task { &runBatch<Func>, &batch, &group }, priority);
+        }
+
+        batch.run();
+        wait(group);
     }
 
-    const std::set<std::thread::id>& threadIdSet() const
+    //! NOTE: Same as parallelFor, but doesn't wait: use wait(group).
+    //! The function is copied once per batch, not per item.
+    template<typename FuncT>
+    void submitBatch(TaskGroup& group, size_t count, FuncT&& func, TaskPriority priority = TaskPriority::Background)
     {
-        static std::set<std::thread::id> result;
+        using Func = std::decay_t<FuncT>;
 
-        if (result.empty()) {
-            for (thread_pool_size_t i = 0; i < m_threadPoolSize; ++i) {
-                result.insert(m_threadPool[i].get_id());
-            }
+        if (count == 0) {
+            return;
         }
 
-        return result;
+        size_t runnerCount = std::min<size_t>(count, m_threadPoolSize);
+
+        auto batch = new SharedBatch<Func>(std::forward<FuncT>(func), count, runnerCount);
+        group.onTaskAdded(runnerCount);
+
+        for (size_t i = 0; i < runnerCount; ++i) {
+            enqueue(Task { &runSharedBatch<Func>, batch, &group }, priority);
+        }
+    }
+
+    //! NOTE: Waits for the tasks of the group. The calling thread executes the queued tasks of the group meanwhile
+    //! (and only them, so that waiting for interactive work never runs unrelated background work),
+    //! so it is safe to wait from inside a task of this scheduler.
+    void wait(TaskGroup& group);
+
+    void waitForAllTasksComplete();
+
+    const std::set<std::thread::id>& threadIdSet() const
+    {
+        return m_threadIdSet;
     }
 
     bool containsThread(const std::thread::id& id) const
     {
-        const auto& idSet = threadIdSet();
-        return idSet.find(id) != idSet.cend();
+        return m_threadIdSet.find(id) != m_threadIdSet.cend();
     }
 
 private:
-    void setupThreads()
-    {
-        m_isActive = true;
-        for (thread_pool_size_t i = 0; i < m_threadPoolSize; ++i) {
-            m_threadPool[i] = std::thread(&TaskScheduler::th_workerLoop, this);
+    static constexpr size_t PRIORITY_COUNT = 2;
+
+    struct Task {
+        void (* func)(void* context) = nullptr;
+        void* context = nullptr;
+        TaskGroup* group = nullptr;
+    };
+
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    struct Worker {
+        TaskQueue queues[PRIORITY_COUNT];
+        std::thread thread;
+    };
+
+    template<typename Func>
+    struct Batch {
+        Batch(Func& f, size_t c)
+            : func(f), count(c) {}
+
+        void run()
+        {
+            size_t index = next.fetch_add(1, std::memory_order_relaxed);
+            while (index < count) {
+                func(index);
+                index = next.fetch_add(1, std::memory_order_relaxed);
+            }
         }
+
+        Func& func;
+        const size_t count = 0;
+        std::atomic<size_t> next = 0;
+    };
+
+    template<typename Func>
+    struct SharedBatch {
+        SharedBatch(Func&& f, size_t c, size_t runners)
+            : func(std::move(f)), batch(func, c), remainingRunners(runners) {}
+
+        SharedBatch(const Func& f, size_t c, size_t runners)
+            : func(f), batch(func, c), remainingRunners(runners) {}
+
+        Func func;
+        Batch<Func> batch;
+        std::atomic<size_t> remainingRunners = 0;
+    };
+
+    template<typename Func>
+    static void runBatch(void* context)
+    {
+        static_cast<Batch<Func>*>(context)->run();
     }
 
-    void terminateThreads()
+    template<typename Func>
+    static void runSharedBatch(void* context)
     {
-        m_isActive = false;
-        m_newTaskAvailableCv.notify_all();
-        for (thread_pool_size_t i = 0; i < m_threadPoolSize; ++i) {
-            m_threadPool[i].join();
+        auto shared = static_cast<SharedBatch<Func>*>(context);
+        shared->batch.run();
+
+        if (shared->remainingRunners.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete shared;
         }
     }
 
-    thread_pool_size_t vaildateThreadPoolCapacity(const thread_pool_size_t desiredThreadCount)
+    template<typename Func>
+    static void runAndDelete(void* context)
     {
-        thread_pool_size_t maxCapacity = std::thread::hardware_concurrency();
+        Func* func = static_cast<Func*>(context);
+        (*func)();
+        delete func;
+    }
 
-        if (maxCapacity <= 1) {
-            return 1;
-        }
+    template<typename FuncT, typename ... ArgsT>
+    void pushTo(TaskPriority priority, TaskGroup* group, FuncT&& task, ArgsT&&... args)
+    {
+        auto functor = [task = std::forward<FuncT>(task), argsTuple = std::make_tuple(std::forward<ArgsT>(args)...)]() mutable {
+            std::apply(task, argsTuple);
+        };
 
-        thread_pool_size_t optimalCapacity = maxCapacity / 2;
+        using Functor = decltype(functor);
 
-        if (desiredThreadCount <= 0) {
-            return optimalCapacity;
+        if (group) {
+            group->onTaskAdded();
         }
 
-        return desiredThreadCount;
+        enqueue(Task { &runAndDelete<Functor>, new Functor(std::move(functor)), group }, priority);
     }
 
-    void th_workerLoop()
-    {
-        while (m_isActive) {
-            std::unique_lock<std::mutex> lock(m_mutex);
-            m_newTaskAvailableCv.wait(lock, [this] { return !m_taskQueue.empty() || !m_isActive; });
+    void enqueue(const Task& task, TaskPriority priority);
 
-            if (!m_isActive) {
-                return;
-            }
+    bool tryPopTask(Task& task);
+    bool tryPopTask(Task& task, size_t priorityIdx);
+    bool tryPopGroupTask(Task& task, const TaskGroup& group);
+    void onTaskPopped(const Task& task);
+    void execute(const Task& task);
 
-            std::function<void()> task = m_taskQueue.front();
-            m_taskQueue.pop();
+    void th_workerLoop(size_t workerIdx);
 
-            lock.unlock();
+    thread_pool_size_t vaildateThreadPoolCapacity(const thread_pool_size_t desiredThreadCount) const;
 
-            task();
+    std::atomic<bool> m_isActive = false;
 
-            if (m_isWaitingForAllTasksDone) {
-                m_taskFinishedCv.notify_one();
-            }
-        }
-    }
+    thread_pool_size_t m_threadPoolSize = 0;
+    std::vector<std::unique_ptr<Worker> > m_workers;
+    std::set<std::thread::id> m_threadIdSet;
 
-    std::atomic<bool> m_isActive = false;
-    std::atomic<bool> m_isWaitingForAllTasksDone = false;
+    //! NOTE: Tasks pushed from threads that are not workers of this scheduler
+    TaskQueue m_injectionQueues[PRIORITY_COUNT];
 
-    mutable std::mutex m_mutex;
-    std::condition_variable m_newTaskAvailableCv;
-    std::condition_variable m_taskFinishedCv;
-    std::queue<std::function<void()> > m_taskQueue;
+    //! NOTE: Queued + running tasks
+    std::atomic<size_t> m_pendingTaskCount = 0;
+    std::atomic<size_t> m_queuedTaskCount = 0;
+    std::atomic<size_t> m_sleepingWorkerCount = 0;
 
-    thread_pool_size_t m_threadPoolSize = 0;
-    std::unique_ptr<std::thread[]> m_threadPool = nullptr;
+    std::mutex m_sleepMutex;
+    std::condition_variable m_newTaskAvailableCv;
+    std::condition_variable m_allTasksDoneCv;
 };
 }
 
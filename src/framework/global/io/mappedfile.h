@@ -0,0 +1,63 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MUSE_IO_MAPPEDFILE_H
+#define MUSE_IO_MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "path.h"
+
+namespace muse::io {
+//! NOTE: A read-only memory mapping of a whole file.
+//! The pages are loaded by the OS on first access and shared with the other processes
+//! (and mappings) of the same file, so mapping a large file costs neither time nor heap memory
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    explicit MappedFile(const path_t& filePath);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const path_t& filePath);
+    void close();
+
+    bool isOpen() const;
+
+    const uint8_t* data() const;
+    size_t size() const;
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+
+#if defined(Q_OS_WIN)
+    void* m_fileHandle = nullptr;
+    void* m_mappingHandle = nullptr;
+#endif
+};
+}
+
+#endif // MUSE_IO_MAPPEDFILE_H
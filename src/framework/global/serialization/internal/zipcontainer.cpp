@@ -21,11 +21,14 @@
  */
 #include "zipcontainer.h"
 
+#include <algorithm>
+#include <atomic>
 #include <ctime>
 #include <cstring>
 #include <zlib.h>
 
 #include "global/io/dir.h"
+#include "global/concurrency/taskscheduler.h"
 
 #include "log.h"
 
@@ -149,7 +152,7 @@ static int inflate(Bytef* dest, ulong* destLen, const Bytef* source, ulong sourc
     return err;
 }
 
-static int deflate(Bytef* dest, ulong* destLen, const Bytef* source, ulong sourceLen)
+static int deflate(Bytef* dest, ulong* destLen, const Bytef* source, ulong sourceLen, int level)
 {
     z_stream stream;
     int err;
@@ -166,7 +169,7 @@ static int deflate(Bytef* dest, ulong* destLen, const Bytef* source, ulong sourc
     stream.zfree = (free_func)0;
     stream.opaque = (voidpf)0;
 
-    err = deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    err = deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
     if (err != Z_OK) {
         return err;
     }
@@ -379,12 +382,32 @@ struct ZipContainer::Impl {
     ZipContainer::Status status = ZipContainer::NoError;
 
     ZipContainer::CompressionPolicy compressionPolicy = ZipContainer::AlwaysCompress;
+    int compressionLevel = Z_DEFAULT_COMPRESSION;
+    std::time_t fileTime = 0;
+    size_t threadCount = 1;
 
     enum EntryType {
         Directory, File, Symlink
     };
 
+    struct PendingEntry {
+        EntryType type = File;
+        std::string fileName;
+        ByteArray contents;
+    };
+
+    //! NOTE The header and the (compressed) data of an entry, ready to be written
+    struct PreparedEntry {
+        FileHeader header;
+        ByteArray data;
+    };
+
+    std::vector<PendingEntry> pendingEntries;
+
     void addEntry(EntryType type, const std::string& fileName, const ByteArray& contents);
+    PreparedEntry prepareEntry(EntryType type, const std::string& fileName, const ByteArray& contents) const;
+    void writeEntry(PreparedEntry& entry);
+    void writePendingEntries();
     bool writeToDevice(const uint8_t* data, size_t len);
     bool writeToDevice(const ByteArray& data);
 
@@ -561,12 +584,21 @@ ZipContainer::FileInfo ZipContainer::Impl::fillFileInfo(size_t index) const
 
 void ZipContainer::Impl::addEntry(EntryType type, const std::string& fileName, const ByteArray& contents)
 {
-    if (!(device->isOpen() || device->open(IODevice::WriteOnly))) {
-        status = ZipContainer::FileOpenError;
+    if (threadCount != 1 && type == File) {
+        pendingEntries.push_back({ type, fileName, contents });
         return;
     }
-    device->seek(start_of_directory);
 
+    writePendingEntries();
+
+    PreparedEntry entry = prepareEntry(type, fileName, contents);
+    writeEntry(entry);
+}
+
+//! NOTE Doesn't change the container, so it can be called concurrently
+ZipContainer::Impl::PreparedEntry ZipContainer::Impl::prepareEntry(EntryType type, const std::string& fileName,
+                                                                   const ByteArray& contents) const
+{
     // don't compress small files
     ZipContainer::CompressionPolicy compression = compressionPolicy;
     if (compressionPolicy == ZipContainer::AutoCompress) {
@@ -577,14 +609,19 @@ void ZipContainer::Impl::addEntry(EntryType type, const std::string& fileName, c
         }
     }
 
-    FileHeader header;
+    if (compressionLevel == Z_NO_COMPRESSION) {
+        compression = ZipContainer::NeverCompress;
+    }
+
+    PreparedEntry entry;
+    FileHeader& header = entry.header;
     std::memset(&header.h, 0, sizeof(CentralFileHeader));
     writeUInt(header.h.signature, 0x02014b50);
 
     writeUShort(header.h.version_needed, ZIP_VERSION);
     writeUInt(header.h.uncompressed_size, (uint)contents.size());
 
-    std::time_t t = std::time(0);   // get time now
+    std::time_t t = fileTime ? fileTime : std::time(0);
     std::tm now;
 #ifdef WIN32
     localtime_s(&now, &t);
@@ -602,7 +639,8 @@ void ZipContainer::Impl::addEntry(EntryType type, const std::string& fileName, c
         int res;
         do {
             data.resize(len);
-            res = deflate((uint8_t*)data.data(), &len, (const uint8_t*)contents.constData(), (ulong)contents.size());
+            res = deflate((uint8_t*)data.data(), &len, (const uint8_t*)contents.constData(), (ulong)contents.size(),
+                          compressionLevel);
 
             switch (res) {
             case Z_OK:
@@ -664,6 +702,21 @@ void ZipContainer::Impl::addEntry(EntryType type, const std::string& fileName, c
         break;
     }
     writeUInt(header.h.external_file_attributes, mode << 16);
+
+    entry.data = std::move(data);
+
+    return entry;
+}
+
+void ZipContainer::Impl::writeEntry(PreparedEntry& entry)
+{
+    if (!(device->isOpen() || device->open(IODevice::WriteOnly))) {
+        status = ZipContainer::FileOpenError;
+        return;
+    }
+    device->seek(start_of_directory);
+
+    FileHeader& header = entry.header;
     writeUInt(header.h.offset_local_header, start_of_directory);
 
     fileHeaders.push_back(header);
@@ -673,7 +726,7 @@ void ZipContainer::Impl::addEntry(EntryType type, const std::string& fileName, c
     LocalFileHeader h = header.h.toLocalHeader();
     ok &= writeToDevice((const uint8_t*)&h, sizeof(LocalFileHeader));
     ok &= writeToDevice(header.file_name);
-    ok &= writeToDevice(data);
+    ok &= writeToDevice(entry.data);
 
     start_of_directory = (uint)device->pos();
     dirtyFileTree = true;
@@ -683,6 +736,43 @@ void ZipContainer::Impl::addEntry(EntryType type, const std::string& fileName, c
     }
 }
 
+void ZipContainer::Impl::writePendingEntries()
+{
+    if (pendingEntries.empty()) {
+        return;
+    }
+
+    const size_t count = pendingEntries.size();
+    std::vector<PreparedEntry> entries(count);
+
+    TaskScheduler* scheduler = TaskScheduler::instance();
+    size_t runnerCount = threadCount == 0 ? scheduler->threadPoolSize() + 1 : threadCount;
+    runnerCount = std::min(runnerCount, count);
+
+    //! NOTE The biggest files are taken first, so that a big file doesn't remain alone at the end
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        return pendingEntries[a].contents.size() > pendingEntries[b].contents.size();
+    });
+
+    std::atomic<size_t> next = 0;
+    scheduler->parallelFor(runnerCount, [&](size_t) {
+        for (size_t i = next.fetch_add(1, std::memory_order_relaxed); i < count; i = next.fetch_add(1, std::memory_order_relaxed)) {
+            const PendingEntry& pending = pendingEntries[order[i]];
+            entries[order[i]] = prepareEntry(pending.type, pending.fileName, pending.contents);
+        }
+    });
+
+    pendingEntries.clear();
+
+    for (PreparedEntry& entry : entries) {
+        writeEntry(entry);
+    }
+}
+
 bool ZipContainer::Impl::writeToDevice(const uint8_t* data, size_t len)
 {
     return device->write(data, len) == len;
@@ -834,6 +924,36 @@ ZipContainer::CompressionPolicy ZipContainer::compressionPolicy() const
     return p->compressionPolicy;
 }
 
+void ZipContainer::setCompressionLevel(int level)
+{
+    p->compressionLevel = level;
+}
+
+int ZipContainer::compressionLevel() const
+{
+    return p->compressionLevel;
+}
+
+void ZipContainer::setThreadCount(size_t count)
+{
+    p->threadCount = count;
+}
+
+size_t ZipContainer::threadCount() const
+{
+    return p->threadCount;
+}
+
+void ZipContainer::setFileTime(std::time_t time)
+{
+    p->fileTime = time;
+}
+
+std::time_t ZipContainer::fileTime() const
+{
+    return p->fileTime;
+}
+
 void ZipContainer::addFile(const std::string& fileName, const ByteArray& data)
 {
     p->addEntry(Impl::File, Dir::fromNativeSeparators(fileName).toStdString(), data);
@@ -856,6 +976,8 @@ void ZipContainer::close()
         return;
     }
 
+    p->writePendingEntries();
+
     bool ok = true;
 
     //qDebug("Zip::close writing directory, %d entries", p->fileHeaders.size());
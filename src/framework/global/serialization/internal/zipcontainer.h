@@ -76,6 +76,21 @@ public:
     void setCompressionPolicy(CompressionPolicy policy);
     CompressionPolicy compressionPolicy() const;
 
+    //! NOTE The zlib compression level (1 - 9), -1 is the zlib default, 0 stores the files without compression
+    void setCompressionLevel(int level);
+    int compressionLevel() const;
+
+    //! NOTE With 1 (default) a file is compressed and written when it is added.
+    //! Otherwise the files are kept until close (or until a directory is added),
+    //! then compressed concurrently by the TaskScheduler, using at most this number of threads
+    //! (0 - all the threads of the scheduler), and written in the order they were added
+    void setThreadCount(size_t count);
+    size_t threadCount() const;
+
+    //! NOTE The modification time of the added files, the current time if not set (0)
+    void setFileTime(std::time_t time);
+    std::time_t fileTime() const;
+
     void addFile(const std::string& fileName, const ByteArray& data);
     void addDirectory(const std::string& dirName);
 
@@ -21,49 +21,488 @@
  */
 #include "xmlstreamreader.h"
 
+#include <algorithm>
 #include <cstring>
+#include <deque>
+#include <set>
+#include <string_view>
 
 #include "global/types/string.h"
 
-#include "../thirdparty/tinyxml/tinyxml2.h"
-
 #include "log.h"
 
 using namespace muse;
 using namespace muse::io;
-using namespace tinyxml2;
+
+static constexpr size_t CHUNK_SIZE = 64 * 1024;
+static constexpr size_t npos = std::string_view::npos;
+
+static inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+static size_t writeUtf8(char32_t code, char* out)
+{
+    if (code < 0x80) {
+        out[0] = static_cast<char>(code);
+        return 1;
+    }
+    if (code < 0x800) {
+        out[0] = static_cast<char>(0xC0 | (code >> 6));
+        out[1] = static_cast<char>(0x80 | (code & 0x3F));
+        return 2;
+    }
+    if (code < 0x10000) {
+        out[0] = static_cast<char>(0xE0 | (code >> 12));
+        out[1] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (code & 0x3F));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xF0 | (code >> 18));
+    out[1] = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+    out[2] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+    out[3] = static_cast<char>(0x80 | (code & 0x3F));
+    return 4;
+}
+
+//! NOTE: Decodes the predefined and the character entities and normalizes the newlines, in place.
+//! The result is never longer than the source. Returns the new size.
+static size_t decodeInPlace(char* str, size_t size)
+{
+    struct Entity {
+        std::string_view name;
+        char ch;
+    };
+
+    static const Entity ENTITIES[] = {
+        { "amp;", '&' }, { "lt;", '<' }, { "gt;", '>' }, { "quot;", '"' }, { "apos;", '\'' }
+    };
+
+    const char* firstSpecial = nullptr;
+    for (size_t i = 0; i < size; ++i) {
+        if (str[i] == '&' || str[i] == '\r') {
+            firstSpecial = str + i;
+            break;
+        }
+    }
+
+    if (!firstSpecial) {
+        return size;
+    }
+
+    char* out = const_cast<char*>(firstSpecial);
+    const char* in = firstSpecial;
+    const char* inEnd = str + size;
+
+    while (in < inEnd) {
+        char c = *in;
+
+        if (c == '\r') {
+            *out++ = '\n';
+            ++in;
+            if (in < inEnd && *in == '\n') {
+                ++in;
+            }
+            continue;
+        }
+
+        if (c != '&') {
+            *out++ = c;
+            ++in;
+            continue;
+        }
+
+        std::string_view rest(in + 1, inEnd - in - 1);
+
+        if (!rest.empty() && rest[0] == '#') {
+            size_t semicolon = rest.find(';');
+            if (semicolon != npos && semicolon > 1) {
+                bool hex = rest[1] == 'x' || rest[1] == 'X';
+                std::string_view digits = rest.substr(hex ? 2 : 1, semicolon - (hex ? 2 : 1));
+
+                char32_t code = 0;
+                bool ok = !digits.empty() && digits.size() <= 8;
+                for (char d : digits) {
+                    int v = -1;
+                    if (d >= '0' && d <= '9') {
+                        v = d - '0';
+                    } else if (hex && d >= 'a' && d <= 'f') {
+                        v = d - 'a' + 10;
+                    } else if (hex && d >= 'A' && d <= 'F') {
+                        v = d - 'A' + 10;
+                    }
+
+                    if (v < 0) {
+                        ok = false;
+                        break;
+                    }
+
+                    code = code * (hex ? 16 : 10) + v;
+                }
+
+                if (ok && code > 0 && code <= 0x10FFFF) {
+                    out += writeUtf8(code, out);
+                    in += semicolon + 2;
+                    continue;
+                }
+            }
+        } else {
+            bool found = false;
+            for (const Entity& e : ENTITIES) {
+                if (rest.substr(0, e.name.size()) == e.name) {
+                    *out++ = e.ch;
+                    in += e.name.size() + 1;
+                    found = true;
+                    break;
+                }
+            }
+
+            if (found) {
+                continue;
+            }
+        }
+
+        //! NOTE: Unknown entity, keep it as is
+        *out++ = c;
+        ++in;
+    }
+
+    return out - str;
+}
 
 struct XmlStreamReader::Xml {
-    XMLDocument doc;
-    XMLNode* node = nullptr;
-    XMLError err;
+    // source
+    IODevice* device = nullptr;
+    ByteArray data;
+    size_t dataPos = 0;
+    bool sourceEnd = false;
+
+    // window of the document: [pos, end) is not consumed yet
+    std::vector<char> buf;
+    size_t pos = 0;
+    size_t end = 0;
+
+    //! NOTE: The '<' at pos was replaced with '\0' to terminate the previous text
+    bool restoreLt = false;
+
+    int64_t line = 1;
+    int64_t tokenLine = 1;
+
+    // current token
+    AsciiStringView name;
+    AsciiStringView value;
+    std::vector<AttributeView> attrs;
+    bool pendingEndElement = false;
+    bool documentStarted = false;
+
+    std::vector<AsciiStringView> openElements;
+    std::set<std::string, std::less<> > names;
+
+    //! NOTE: The attributes of the open elements, one storage per depth.
+    //! The buffer is moved on every refill, so the attributes are copied out of it to stay valid
+    //! while the children of the element are read. A deque, so that adding a depth doesn't move the others
+    std::deque<std::string> attrStorage;
+
+    std::string textCache;
+
+    Error err = NoError;
+    String errStr;
     String customErr;
+
+    void reset()
+    {
+        device = nullptr;
+        data = ByteArray();
+        dataPos = 0;
+        sourceEnd = false;
+        pos = 0;
+        end = 0;
+        restoreLt = false;
+        line = 1;
+        tokenLine = 1;
+        name = AsciiStringView();
+        value = AsciiStringView();
+        attrs.clear();
+        pendingEndElement = false;
+        documentStarted = false;
+        openElements.clear();
+        attrStorage.clear();
+        err = NoError;
+        errStr.clear();
+        customErr.clear();
+    }
+
+    void setError(Error e, const String& str)
+    {
+        err = e;
+        errStr = str;
+        LOGE() << str << ", line: " << line;
+    }
+
+    size_t readSource(char* dst, size_t len)
+    {
+        if (device) {
+            return device->read(reinterpret_cast<uint8_t*>(dst), len);
+        }
+
+        size_t count = std::min(len, data.size() - dataPos);
+        std::memcpy(dst, data.constChar() + dataPos, count);
+        dataPos += count;
+
+        return count;
+    }
+
+    //! NOTE: Reads the next chunk. The not consumed data is moved to the beginning of the buffer,
+    //! so the offsets relative to pos stay valid, but the pointers don't.
+    bool fill()
+    {
+        if (sourceEnd) {
+            return false;
+        }
+
+        if (pos > 0) {
+            std::memmove(buf.data(), buf.data() + pos, end - pos);
+            end -= pos;
+            pos = 0;
+        }
+
+        //! NOTE: +1 to be always able to terminate the last token with '\0'
+        if (buf.size() - end < CHUNK_SIZE / 2 + 1) {
+            buf.resize(end + CHUNK_SIZE + 1);
+        }
+
+        size_t count = readSource(buf.data() + end, buf.size() - end - 1);
+        if (count == 0) {
+            sourceEnd = true;
+            return false;
+        }
+
+        end += count;
+        return true;
+    }
+
+    size_t available() const
+    {
+        return end - pos;
+    }
+
+    const char* at(size_t offset) const
+    {
+        return buf.data() + pos + offset;
+    }
+
+    char* at(size_t offset)
+    {
+        return buf.data() + pos + offset;
+    }
+
+    //! NOTE: All the find functions return an offset relative to pos, or npos at the end of the data
+    size_t find(std::string_view pattern, size_t fromOffset)
+    {
+        while (true) {
+            std::string_view window(at(0), available());
+            if (fromOffset < window.size()) {
+                size_t idx = window.find(pattern, fromOffset);
+                if (idx != npos) {
+                    return idx;
+                }
+
+                if (window.size() >= pattern.size()) {
+                    fromOffset = std::max(fromOffset, window.size() - pattern.size() + 1);
+                }
+            }
+
+            if (!fill()) {
+                return npos;
+            }
+        }
+    }
+
+    size_t findTagEnd(size_t fromOffset)
+    {
+        char quote = 0;
+        size_t offset = fromOffset;
+
+        while (true) {
+            const char* b = at(0);
+            size_t size = available();
+
+            for (; offset < size; ++offset) {
+                char c = b[offset];
+                if (quote) {
+                    if (c == quote) {
+                        quote = 0;
+                    }
+                } else if (c == '"' || c == '\'') {
+                    quote = c;
+                } else if (c == '>') {
+                    return offset;
+                }
+            }
+
+            if (!fill()) {
+                return npos;
+            }
+        }
+    }
+
+    size_t skipWhitespace(size_t fromOffset)
+    {
+        size_t offset = fromOffset;
+
+        while (true) {
+            const char* b = at(0);
+            size_t size = available();
+
+            while (offset < size && isSpace(b[offset])) {
+                ++offset;
+            }
+
+            if (offset < size) {
+                return offset;
+            }
+
+            if (!fill()) {
+                return npos;
+            }
+        }
+    }
+
+    bool startsWith(size_t offset, std::string_view prefix)
+    {
+        while (available() < offset + prefix.size()) {
+            if (!fill()) {
+                return false;
+            }
+        }
+
+        return std::string_view(at(offset), prefix.size()) == prefix;
+    }
+
+    void consume(size_t count)
+    {
+        line += std::count(at(0), at(count), '\n');
+        pos += count;
+    }
+
+    //! NOTE: Moves the attributes of the current start element to the storage of its depth
+    void storeAttributes(size_t depth)
+    {
+        if (attrs.empty()) {
+            return;
+        }
+
+        while (attrStorage.size() <= depth) {
+            attrStorage.emplace_back();
+        }
+
+        std::string& storage = attrStorage[depth];
+        storage.clear();
+
+        for (const AttributeView& a : attrs) {
+            storage.append(a.name.ascii(), a.name.size()).push_back('\0');
+            storage.append(a.value.ascii(), a.value.size()).push_back('\0');
+        }
+
+        const char* str = storage.c_str();
+        for (AttributeView& a : attrs) {
+            size_t nameSize = a.name.size();
+            size_t valueSize = a.value.size();
+
+            a.name = AsciiStringView(str, nameSize);
+            a.value = AsciiStringView(str + nameSize + 1, valueSize);
+            str += nameSize + valueSize + 2;
+        }
+    }
+
+    AsciiStringView internName(std::string_view str)
+    {
+        auto it = names.find(str);
+        if (it == names.end()) {
+            it = names.emplace(str).first;
+        }
+
+        return AsciiStringView(it->c_str(), it->size());
+    }
+
+    //! NOTE: The source is ready to be read, checks the encoding
+    void prepare()
+    {
+        while (available() < 4 && fill()) {
+        }
+
+        if (available() < 4) {
+            setError(NotWellFormedError, u"empty document");
+            return;
+        }
+
+        UtfCodec::Encoding enc = UtfCodec::xmlEncoding(ByteArray::fromRawData(at(0), available()));
+        if (enc == UtfCodec::Encoding::Unknown) {
+            setError(NotWellFormedError, u"unknown encoding");
+            return;
+        }
+
+        if (enc == UtfCodec::Encoding::UTF_16BE) {
+            setError(NotWellFormedError, u"unsupported encoding UTF-16BE");
+            return;
+        }
+
+        if (enc == UtfCodec::Encoding::UTF_16LE) {
+            //! NOTE: Rare, just convert the whole document
+            ByteArray u16(reinterpret_cast<const uint8_t*>(at(0)), available());
+            pos = end;
+            while (fill()) {
+                u16.push_back(reinterpret_cast<const uint8_t*>(at(0)), available());
+                pos = end;
+            }
+
+            ByteArray u8 = String::fromUtf16LE(u16).toUtf8();
+
+            device = nullptr;
+            data = u8;
+            dataPos = 0;
+            sourceEnd = false;
+            pos = 0;
+            end = 0;
+
+            fill();
+        }
+
+        static const std::string_view U8_BOM("\xEF\xBB\xBF");
+        if (startsWith(0, U8_BOM)) {
+            pos += U8_BOM.size();
+        }
+    }
 };
 
 XmlStreamReader::XmlStreamReader()
 {
-    m_xml = new Xml();
+    init();
 }
 
 XmlStreamReader::XmlStreamReader(IODevice* device)
 {
-    m_xml = new Xml();
-    ByteArray data = device->readAll();
-    setData(data);
+    init();
+
+    m_xml->device = device;
+    m_xml->prepare();
+    m_token = m_xml->err == NoError ? TokenType::NoToken : TokenType::Invalid;
 }
 
 XmlStreamReader::XmlStreamReader(const ByteArray& data)
 {
-    m_xml = new Xml();
+    init();
     setData(data);
 }
 
 #ifndef NO_QT_SUPPORT
 XmlStreamReader::XmlStreamReader(const QByteArray& data)
 {
-    m_xml = new Xml();
-    ByteArray ba = ByteArray::fromQByteArrayNoCopy(data);
-    setData(ba);
+    init();
+
+    //! NOTE: The data is read lazily, so the reader must own it
+    setData(ByteArray::fromQByteArray(data));
 }
 
 #endif
@@ -73,44 +512,18 @@ XmlStreamReader::~XmlStreamReader()
     delete m_xml;
 }
 
-void XmlStreamReader::setData(const ByteArray& data_)
+void XmlStreamReader::init()
 {
-    m_xml->doc.Clear();
-    m_xml->customErr.clear();
-    m_token = TokenType::Invalid;
-
-    if (data_.size() < 4) {
-        m_xml->err = XML_ERROR_EMPTY_DOCUMENT;
-        LOGE() << m_xml->doc.ErrorIDToName(m_xml->err);
-        return;
-    }
-
-    UtfCodec::Encoding enc = UtfCodec::xmlEncoding(data_);
-    if (enc == UtfCodec::Encoding::Unknown) {
-        m_xml->err = XML_CAN_NOT_CONVERT_TEXT;
-        LOGE() << "unknown encoding";
-        return;
-    }
-
-    if (enc == UtfCodec::Encoding::UTF_16BE) {
-        m_xml->err = XML_CAN_NOT_CONVERT_TEXT;
-        LOGE() << "unsupported encoding UTF-16BE";
-        return;
-    }
-
-    ByteArray data = data_; // no copy, implicit sharing
-    if (enc == UtfCodec::Encoding::UTF_16LE) {
-        String u16 = String::fromUtf16LE(data_);
-        data = u16.toUtf8();
-    }
+    m_xml = new Xml();
+}
 
-    m_xml->err = m_xml->doc.Parse(reinterpret_cast<const char*>(data.constData()), data.size());
+void XmlStreamReader::setData(const ByteArray& data)
+{
+    m_xml->reset();
+    m_xml->data = data; // no copy, implicit sharing
 
-    if (m_xml->err == XML_SUCCESS) {
-        m_token = TokenType::NoToken;
-    } else {
-        LOGE() << m_xml->doc.ErrorIDToName(m_xml->err);
-    }
+    m_xml->prepare();
+    m_token = m_xml->err == NoError ? TokenType::NoToken : TokenType::Invalid;
 }
 
 bool XmlStreamReader::readNextStartElement()
@@ -130,86 +543,279 @@ bool XmlStreamReader::atEnd() const
     return m_token == TokenType::EndDocument || m_token == TokenType::Invalid;
 }
 
-static XmlStreamReader::TokenType resolveToken(XMLNode* n, bool isStartElement)
+XmlStreamReader::TokenType XmlStreamReader::readNext()
 {
-    if (n->ToElement()) {
-        return isStartElement ? XmlStreamReader::TokenType::StartElement : XmlStreamReader::TokenType::EndElement;
-    } else if (n->ToText()) {
-        return XmlStreamReader::TokenType::Characters;
-    } else if (n->ToComment()) {
-        return XmlStreamReader::TokenType::Comment;
-    } else if (n->ToDeclaration()) {
-        return XmlStreamReader::TokenType::StartDocument;
-    } else if (n->ToDocument()) {
-        return XmlStreamReader::TokenType::EndDocument;
-    } else if (n->ToUnknown()) {
-        return XmlStreamReader::TokenType::DTD;
+    if (m_token == TokenType::Invalid) {
+        return m_token;
     }
-    return XmlStreamReader::TokenType::Unknown;
-}
 
-static std::pair<XMLNode*, XmlStreamReader::TokenType> resolveNode(XMLNode* currentNode, XmlStreamReader::TokenType currentToken)
-{
-    if (currentToken == XmlStreamReader::TokenType::StartElement) {
-        XMLNode* child = currentNode->FirstChild();
-        if (child) {
-            return { child, resolveToken(child, true) };
-        }
+    Xml* xml = m_xml;
 
-        XMLNode* sibling = currentNode->NextSibling();
-        if (!sibling || sibling->ToElement() || sibling->ToText()) {
-            return { currentNode, XmlStreamReader::TokenType::EndElement };
-        }
+    if (xml->err != NoError || m_token == EndDocument) {
+        m_token = TokenType::Invalid;
+        return m_token;
     }
 
-    XMLNode* sibling = currentNode->NextSibling();
-    if (sibling) {
-        return { sibling, resolveToken(sibling, true) };
-    }
+    xml->attrs.clear();
+    xml->value = AsciiStringView();
 
-    XMLNode* parent = currentNode->Parent();
-    if (parent) {
-        return { parent, resolveToken(parent, false) };
+    if (xml->pendingEndElement) {
+        //! NOTE: The end of an empty element (<a/>), the name is the same as for the start
+        xml->pendingEndElement = false;
+        xml->openElements.pop_back();
+        m_token = TokenType::EndElement;
+        return m_token;
     }
 
-    return { nullptr, XmlStreamReader::TokenType::EndDocument };
-}
+    xml->name = AsciiStringView();
 
-XmlStreamReader::TokenType XmlStreamReader::readNext()
-{
-    if (m_token == TokenType::Invalid) {
-        return m_token;
+    if (xml->restoreLt) {
+        *xml->at(0) = '<';
+        xml->restoreLt = false;
     }
 
-    if (m_xml->err != XML_SUCCESS || m_token == EndDocument) {
-        m_xml->node = nullptr;
+    auto fail = [this, xml](Error err, const String& str) {
+        xml->setError(err, str);
         m_token = TokenType::Invalid;
         return m_token;
-    }
+    };
 
-    if (!m_xml->node) {
-        m_xml->node = m_xml->doc.FirstChild();
-        m_token = m_xml->node->ToDeclaration() ? TokenType::StartDocument : resolveToken(m_xml->node, true);
-        return m_token;
-    }
+    while (true) {
+        size_t offset = xml->skipWhitespace(0);
 
-    std::pair<XMLNode*, XmlStreamReader::TokenType> p = resolveNode(m_xml->node, m_token);
+        if (offset == npos) {
+            xml->consume(xml->available());
+            xml->tokenLine = xml->line;
 
-    m_xml->node = p.first;
-    m_token = p.second;
+            if (!xml->openElements.empty()) {
+                return fail(PrematureEndOfDocumentError, u"premature end of document, not closed: "
+                            + String::fromAscii(xml->openElements.back().ascii()));
+            }
 
-    if (m_token == XmlStreamReader::TokenType::DTD) {
-        tryParseEntity(m_xml);
-    }
+            if (!xml->documentStarted) {
+                return fail(NotWellFormedError, u"empty document");
+            }
 
-    return m_token;
+            m_token = TokenType::EndDocument;
+            return m_token;
+        }
+
+        xml->documentStarted = true;
+
+        // Characters
+        if (*xml->at(offset) != '<') {
+            xml->tokenLine = xml->line;
+
+            //! NOTE: Leading whitespaces are a part of the text
+            size_t textEnd = xml->find("<", offset);
+            if (textEnd == npos) {
+                textEnd = xml->available();
+            } else {
+                xml->restoreLt = true;
+            }
+
+            size_t size = decodeInPlace(xml->at(0), textEnd);
+            char* text = xml->at(0);
+            xml->line += std::count(text, text + size, '\n');
+            text[textEnd] = '\0';
+            text[size] = '\0';
+
+            xml->value = AsciiStringView(text, size);
+            xml->pos += textEnd;
+
+            m_token = TokenType::Characters;
+            return m_token;
+        }
+
+        //! NOTE: The whitespaces before a tag are dropped
+        xml->consume(offset);
+        xml->tokenLine = xml->line;
+
+        // Declaration or processing instruction
+        if (xml->startsWith(0, "<?")) {
+            size_t declEnd = xml->find("?>", 2);
+            if (declEnd == npos) {
+                return fail(PrematureEndOfDocumentError, u"not closed declaration");
+            }
+
+            bool isFirstToken = m_token == TokenType::NoToken;
+            xml->consume(declEnd + 2);
+
+            //! NOTE: Declarations in the middle of a document are skipped (see mu_patch.h of tinyxml)
+            if (isFirstToken) {
+                m_token = TokenType::StartDocument;
+                return m_token;
+            }
+
+            continue;
+        }
+
+        // Comment
+        if (xml->startsWith(0, "<!--")) {
+            size_t commentEnd = xml->find("-->", 4);
+            if (commentEnd == npos) {
+                return fail(PrematureEndOfDocumentError, u"not closed comment");
+            }
+
+            xml->line += std::count(xml->at(0), xml->at(commentEnd), '\n');
+            *xml->at(commentEnd) = '\0';
+            xml->value = AsciiStringView(xml->at(4), commentEnd - 4);
+            xml->pos += commentEnd + 3;
+
+            m_token = TokenType::Comment;
+            return m_token;
+        }
+
+        // CDATA
+        if (xml->startsWith(0, "<![CDATA[")) {
+            size_t cdataEnd = xml->find("]]>", 9);
+            if (cdataEnd == npos) {
+                return fail(PrematureEndOfDocumentError, u"not closed CDATA");
+            }
+
+            xml->line += std::count(xml->at(0), xml->at(cdataEnd), '\n');
+            *xml->at(cdataEnd) = '\0';
+            xml->value = AsciiStringView(xml->at(9), cdataEnd - 9);
+            xml->pos += cdataEnd + 3;
+
+            m_token = TokenType::Characters;
+            return m_token;
+        }
+
+        // DTD
+        if (xml->startsWith(0, "<!")) {
+            size_t dtdEnd = xml->find(">", 2);
+            if (dtdEnd == npos) {
+                return fail(PrematureEndOfDocumentError, u"not closed DTD");
+            }
+
+            xml->line += std::count(xml->at(0), xml->at(dtdEnd), '\n');
+            *xml->at(dtdEnd) = '\0';
+            xml->value = AsciiStringView(xml->at(2), dtdEnd - 2);
+            xml->pos += dtdEnd + 1;
+
+            m_token = TokenType::DTD;
+            tryParseEntity(xml);
+            return m_token;
+        }
+
+        // End element
+        if (xml->startsWith(0, "</")) {
+            size_t tagEnd = xml->find(">", 2);
+            if (tagEnd == npos) {
+                return fail(PrematureEndOfDocumentError, u"not closed end tag");
+            }
+
+            std::string_view tag(xml->at(2), tagEnd - 2);
+            while (!tag.empty() && isSpace(tag.back())) {
+                tag.remove_suffix(1);
+            }
+
+            if (xml->openElements.empty() || std::string_view(xml->openElements.back()) != tag) {
+                return fail(NotWellFormedError, u"mismatched element: " + String::fromUtf8(std::string(tag).c_str()));
+            }
+
+            xml->consume(tagEnd + 1);
+
+            xml->name = xml->openElements.back();
+            xml->openElements.pop_back();
+
+            m_token = TokenType::EndElement;
+            return m_token;
+        }
+
+        // Start element
+        size_t tagEnd = xml->findTagEnd(1);
+        if (tagEnd == npos) {
+            return fail(PrematureEndOfDocumentError, u"not closed start tag");
+        }
+
+        xml->line += std::count(xml->at(0), xml->at(tagEnd), '\n');
+
+        char* tag = xml->at(0);
+        size_t i = 1;
+        while (i < tagEnd && !isSpace(tag[i]) && tag[i] != '/') {
+            ++i;
+        }
+
+        if (i == 1) {
+            return fail(NotWellFormedError, u"element without name");
+        }
+
+        xml->name = xml->internName(std::string_view(tag + 1, i - 1));
+
+        bool isEmptyElement = false;
+
+        while (i < tagEnd) {
+            while (i < tagEnd && isSpace(tag[i])) {
+                ++i;
+            }
+
+            if (i == tagEnd) {
+                break;
+            }
+
+            if (tag[i] == '/') {
+                isEmptyElement = true;
+                ++i;
+                continue;
+            }
+
+            size_t nameBegin = i;
+            while (i < tagEnd && tag[i] != '=' && !isSpace(tag[i])) {
+                ++i;
+            }
+            size_t nameEnd = i;
+
+            while (i < tagEnd && isSpace(tag[i])) {
+                ++i;
+            }
+
+            if (i == tagEnd || tag[i] != '=') {
+                return fail(NotWellFormedError, u"attribute without value in element: " + String::fromAscii(xml->name.ascii()));
+            }
+
+            ++i;
+            while (i < tagEnd && isSpace(tag[i])) {
+                ++i;
+            }
+
+            if (i == tagEnd || (tag[i] != '"' && tag[i] != '\'')) {
+                return fail(NotWellFormedError, u"attribute value without quotes in element: " + String::fromAscii(xml->name.ascii()));
+            }
+
+            char quote = tag[i];
+            size_t valueBegin = ++i;
+            while (i < tagEnd && tag[i] != quote) {
+                ++i;
+            }
+            size_t valueEnd = i;
+            ++i;
+
+            size_t valueSize = decodeInPlace(tag + valueBegin, valueEnd - valueBegin);
+            tag[nameEnd] = '\0';
+            tag[valueBegin + valueSize] = '\0';
+
+            xml->attrs.push_back({ AsciiStringView(tag + nameBegin, nameEnd - nameBegin),
+                                   AsciiStringView(tag + valueBegin, valueSize) });
+        }
+
+        xml->pos += tagEnd + 1;
+
+        xml->storeAttributes(xml->openElements.size());
+        xml->openElements.push_back(xml->name);
+        xml->pendingEndElement = isEmptyElement;
+
+        m_token = TokenType::StartElement;
+        return m_token;
+    }
 }
 
 void XmlStreamReader::tryParseEntity(Xml* xml)
 {
     static const char* ENTITY = { "ENTITY" };
 
-    const char* str = xml->node->Value();
+    const char* str = xml->value.ascii();
     if (std::strncmp(str, ENTITY, 6) == 0) {
         String val = String::fromUtf8(str);
         StringList list = val.split(' ');
@@ -225,7 +831,7 @@ void XmlStreamReader::tryParseEntity(Xml* xml)
 
 String XmlStreamReader::nodeValue(Xml* xml) const
 {
-    String str = String::fromUtf8(xml->node->Value());
+    String str = String::fromUtf8(xml->value.ascii());
     if (!m_entities.empty()) {
         for (const auto& p : m_entities) {
             str.replace(p.first, p.second);
@@ -275,7 +881,7 @@ void XmlStreamReader::skipCurrentElement()
 
 AsciiStringView XmlStreamReader::name() const
 {
-    return (m_xml->node && m_xml->node->ToElement()) ? m_xml->node->Value() : AsciiStringView();
+    return (m_token == TokenType::StartElement || m_token == TokenType::EndElement) ? m_xml->name : AsciiStringView();
 }
 
 bool XmlStreamReader::hasAttribute(const char* name) const
@@ -284,24 +890,18 @@ bool XmlStreamReader::hasAttribute(const char* name) const
         return false;
     }
 
-    XMLElement* e = m_xml->node->ToElement();
-    if (!e) {
-        return false;
+    for (const AttributeView& a : m_xml->attrs) {
+        if (a.name == name) {
+            return true;
+        }
     }
-    return e->FindAttribute(name) != nullptr;
+
+    return false;
 }
 
 String XmlStreamReader::attribute(const char* name) const
 {
-    if (m_token != TokenType::StartElement) {
-        return String();
-    }
-
-    XMLElement* e = m_xml->node->ToElement();
-    if (!e) {
-        return String();
-    }
-    return String::fromUtf8(e->Attribute(name));
+    return String::fromUtf8(asciiAttribute(name).ascii());
 }
 
 String XmlStreamReader::attribute(const char* name, const String& def) const
@@ -315,11 +915,13 @@ AsciiStringView XmlStreamReader::asciiAttribute(const char* name) const
         return AsciiStringView();
     }
 
-    XMLElement* e = m_xml->node->ToElement();
-    if (!e) {
-        return AsciiStringView();
+    for (const AttributeView& a : m_xml->attrs) {
+        if (a.name == name) {
+            return a.value;
+        }
     }
-    return e->Attribute(name);
+
+    return AsciiStringView();
 }
 
 AsciiStringView XmlStreamReader::asciiAttribute(const char* name, const AsciiStringView& def) const
@@ -354,23 +956,31 @@ std::vector<XmlStreamReader::Attribute> XmlStreamReader::attributes() const
         return attrs;
     }
 
-    XMLElement* e = m_xml->node->ToElement();
-    if (!e) {
-        return attrs;
+    attrs.reserve(m_xml->attrs.size());
+    for (const AttributeView& a : m_xml->attrs) {
+        //! NOTE: The result can outlive the current token, so the names must be stable
+        attrs.push_back({ m_xml->internName(a.name), String::fromUtf8(a.value.ascii()) });
     }
+    return attrs;
+}
+
+size_t XmlStreamReader::attributeCount() const
+{
+    return m_token == TokenType::StartElement ? m_xml->attrs.size() : 0;
+}
 
-    for (const XMLAttribute* xa = e->FirstAttribute(); xa; xa = xa->Next()) {
-        Attribute a;
-        a.name = xa->Name();
-        a.value = String::fromUtf8(xa->Value());
-        attrs.push_back(std::move(a));
+XmlStreamReader::AttributeView XmlStreamReader::attributeAt(size_t idx) const
+{
+    IF_ASSERT_FAILED(idx < attributeCount()) {
+        return AttributeView();
     }
-    return attrs;
+
+    return m_xml->attrs.at(idx);
 }
 
 String XmlStreamReader::text() const
 {
-    if (m_xml->node && (m_xml->node->ToText() || m_xml->node->ToComment())) {
+    if (m_token == TokenType::Characters || m_token == TokenType::Comment) {
         return nodeValue(m_xml);
     }
     return String();
@@ -378,8 +988,8 @@ String XmlStreamReader::text() const
 
 AsciiStringView XmlStreamReader::asciiText() const
 {
-    if (m_xml->node && (m_xml->node->ToText() || m_xml->node->ToComment())) {
-        return m_xml->node->Value();
+    if (m_token == TokenType::Characters || m_token == TokenType::Comment) {
+        return m_xml->value;
     }
     return AsciiStringView();
 }
@@ -399,6 +1009,8 @@ String XmlStreamReader::readText()
                 break;
             case StartElement:
                 break;
+            case Invalid:
+                return result;
             default:
                 break;
             }
@@ -410,18 +1022,24 @@ String XmlStreamReader::readText()
 AsciiStringView XmlStreamReader::readAsciiText()
 {
     if (isStartElement()) {
-        AsciiStringView result;
+        //! NOTE: The text is in the window of the document, which can move while reading the end tag,
+        //! so keep a copy (the cache buffer is reused, no allocation in most cases)
+        std::string& result = m_xml->textCache;
+        result.clear();
+
         while (1) {
             switch (readNext()) {
             case Characters:
-                result = AsciiStringView(m_xml->node->Value());
+                result.assign(m_xml->value.ascii(), m_xml->value.size());
                 break;
             case EndElement:
-                return result;
+                return AsciiStringView(result.c_str(), result.size());
             case Comment:
                 break;
             case StartElement:
                 break;
+            case Invalid:
+                return AsciiStringView(result.c_str(), result.size());
             default:
                 break;
             }
@@ -444,7 +1062,7 @@ double XmlStreamReader::readDouble(bool* ok)
 
 int64_t XmlStreamReader::lineNumber() const
 {
-    return m_xml->doc.ErrorLineNum();
+    return m_xml->tokenLine;
 }
 
 int64_t XmlStreamReader::columnNumber() const
@@ -458,12 +1076,7 @@ XmlStreamReader::Error XmlStreamReader::error() const
         return CustomError;
     }
 
-    XMLError err = m_xml->doc.ErrorID();
-    if (err == XML_SUCCESS) {
-        return NoError;
-    }
-
-    return NotWellFormedError;
+    return m_xml->err;
 }
 
 bool XmlStreamReader::isError() const
@@ -476,7 +1089,7 @@ String XmlStreamReader::errorString() const
     if (!m_xml->customErr.empty()) {
         return m_xml->customErr;
     }
-    return String::fromUtf8(m_xml->doc.ErrorStr());
+    return m_xml->errStr;
 }
 
 void XmlStreamReader::raiseError(const String& message)
@@ -34,6 +34,11 @@
 #endif
 
 namespace muse {
+//! NOTE: An incremental (pull) reader: the document is tokenized directly from the data
+//! or the device, chunk by chunk, without building a DOM.
+//! The views returned by name() and the names in attributes() stay valid as long as the reader exists,
+//! the attribute views of an element stay valid while its children are read (until the next sibling starts),
+//! other views (texts) are valid until the next token is read.
 class XmlStreamReader
 {
 public:
@@ -65,6 +70,13 @@ public:
         String value;
     };
 
+    //! NOTE: The value is the decoded UTF-8 text, valid until the next token is read
+    struct AttributeView
+    {
+        AsciiStringView name;
+        AsciiStringView value;
+    };
+
     XmlStreamReader();
     explicit XmlStreamReader(io::IODevice* device);
     explicit XmlStreamReader(const ByteArray& data);
@@ -104,6 +116,8 @@ public:
     double doubleAttribute(const char* name) const;
     double doubleAttribute(const char* name, double def) const;
     std::vector<Attribute> attributes() const;
+    size_t attributeCount() const;
+    AttributeView attributeAt(size_t idx) const;
 
     String text() const;
     AsciiStringView asciiText() const;
@@ -122,6 +136,7 @@ public:
 private:
     struct Xml;
 
+    void init();
     void tryParseEntity(Xml* xml);
     String nodeValue(Xml* xml) const;
 
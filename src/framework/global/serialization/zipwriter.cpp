@@ -89,6 +89,21 @@ bool ZipWriter::hasError() const
     return m_impl->zip->status() != ZipContainer::NoError;
 }
 
+void ZipWriter::setFileTime(std::time_t time)
+{
+    m_impl->zip->setFileTime(time);
+}
+
+void ZipWriter::setCompressionLevel(int level)
+{
+    m_impl->zip->setCompressionLevel(level);
+}
+
+void ZipWriter::setThreadCount(size_t count)
+{
+    m_impl->zip->setThreadCount(count);
+}
+
 void ZipWriter::addFile(const std::string& fileName, const ByteArray& data)
 {
     m_impl->zip->addFile(fileName, data);
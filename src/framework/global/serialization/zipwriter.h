@@ -22,6 +22,8 @@
 #ifndef MUSE_GLOBAL_ZIPWRITER_H
 #define MUSE_GLOBAL_ZIPWRITER_H
 
+#include <ctime>
+
 #include "io/path.h"
 #include "io/iodevice.h"
 
@@ -37,6 +39,20 @@ public:
     void close();
     bool hasError() const;
 
+    //! NOTE The modification time of the added files, the current time if not set (0)
+    void setFileTime(std::time_t time);
+
+    static constexpr int DEFAULT_COMPRESSION = -1;
+    static constexpr int NO_COMPRESSION = 0; // the files are stored as is, the fastest to write
+
+    //! NOTE The zlib compression level (1 - 9), see the constants above
+    void setCompressionLevel(int level);
+
+    //! NOTE The number of threads compressing the files, 1 (default) - the files are compressed one by one
+    //! when they are added, 0 - all the threads of the TaskScheduler.
+    //! With several threads, the files are compressed and written on close
+    void setThreadCount(size_t count);
+
     void addFile(const std::string& fileName, const ByteArray& data);
 
 private:
@@ -21,6 +21,13 @@
  */
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <thread>
+
 #include "allocator.h"
 
 #include "log.h"
@@ -74,6 +81,26 @@ DECLARE_ITEM(3)
 DECLARE_ITEM(8)
 DECLARE_ITEM(13)
 DECLARE_ITEM(131)
+
+class Item8Derived : public Item8
+{
+public:
+    Item8Derived(uint8_t n)
+        : Item8(n) {}
+
+    uint8_t moreData[16];
+};
+
+//! NOTE Without logging, for the concurrent use
+class QuietItem : public ItemBase
+{
+    OBJECT_ALLOCATOR(test, QuietItem)
+public:
+    QuietItem(uint8_t n)
+        : ItemBase(n) {}
+
+    uint8_t data[24];
+};
 }
 
 class Global_AllocatorTests : public ::testing::Test
@@ -196,3 +223,162 @@ TEST_F(Global_AllocatorTests, Many_NewCleanup)
     EXPECT_EQ(info.totalChunks, 12); // DEFAULT_BLOCK_SIZE * 3
     EXPECT_EQ(info.freeChunks, 12);
 }
+
+TEST_F(Global_AllocatorTests, DerivedWithoutAllocator_UsesDefaultAllocator)
+{
+    //! GIVEN a derived class without its own allocator
+    ObjectAllocator::Info before = Item8::allocator().stateInfo();
+
+    //! DO Create and destroy Item
+    ItemBase* item = new Item8Derived(4);
+    EXPECT_TRUE(item->alive());
+    delete item;
+
+    //! CHECK The allocator of the base class was not used
+    ObjectAllocator::Info after = Item8::allocator().stateInfo();
+    EXPECT_EQ(after.totalAllocatedCount, before.totalAllocatedCount);
+    EXPECT_EQ(after.totalFreeCount, before.totalFreeCount);
+}
+
+TEST_F(Global_AllocatorTests, Concurrent_NewDeleteFromOtherThreads)
+{
+    //! GIVEN several threads
+    constexpr size_t THREAD_COUNT = 4;
+    constexpr size_t ITEMS_PER_THREAD = 5000;
+
+    ObjectAllocator::DEFAULT_BLOCK_SIZE = 1024 * 256;
+    ObjectAllocator::Info before = QuietItem::allocator().stateInfo();
+
+    //! DO Create Items in each thread
+    std::vector<std::vector<ItemBase*> > items(THREAD_COUNT);
+    {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < THREAD_COUNT; ++t) {
+            threads.emplace_back([&items, t]() {
+                for (size_t i = 0; i < ITEMS_PER_THREAD; ++i) {
+                    items[t].push_back(new QuietItem(static_cast<uint8_t>(i)));
+                }
+            });
+        }
+
+        for (std::thread& th : threads) {
+            th.join();
+        }
+    }
+
+    //! CHECK All the items are distinct and alive
+    std::set<ItemBase*> uniqueItems;
+    for (const std::vector<ItemBase*>& threadItems : items) {
+        for (ItemBase* item : threadItems) {
+            EXPECT_TRUE(item->alive());
+            uniqueItems.insert(item);
+        }
+    }
+    EXPECT_EQ(uniqueItems.size(), THREAD_COUNT * ITEMS_PER_THREAD);
+
+    //! DO Destroy the Items in other threads than the ones which created them
+    {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < THREAD_COUNT; ++t) {
+            threads.emplace_back([&items, t]() {
+                for (ItemBase* item : items[(t + 1) % THREAD_COUNT]) {
+                    delete item;
+                }
+            });
+        }
+
+        for (std::thread& th : threads) {
+            th.join();
+        }
+    }
+
+    //! CHECK The chunks of the finished threads are returned to the allocator
+    ObjectAllocator::Info info = QuietItem::allocator().stateInfo();
+    EXPECT_EQ(info.totalAllocatedCount - before.totalAllocatedCount, THREAD_COUNT * ITEMS_PER_THREAD);
+    EXPECT_EQ(info.totalFreeCount - before.totalFreeCount, THREAD_COUNT * ITEMS_PER_THREAD);
+    EXPECT_EQ(info.usedChunks(), before.usedChunks());
+    EXPECT_EQ(info.threadCount, before.threadCount);
+
+    //! DO Reuse the freed chunks
+    ItemBase* item = new QuietItem(5);
+
+    //! CHECK No new block is needed
+    EXPECT_EQ(QuietItem::allocator().stateInfo().blockCount, info.blockCount);
+    delete item;
+}
+
+TEST_F(Global_AllocatorTests, Concurrent_AllocatorDestroyedWhileThreadEnds)
+{
+    for (int i = 0; i < 100; ++i) {
+        //! GIVEN An allocator used by a thread
+        auto allocator = std::make_unique<ObjectAllocator>("test", "AllocatorDestroyedWhileThreadEnds",
+                                                           ObjectAllocator::destroyer<QuietItem>);
+        std::atomic<bool> used = false;
+
+        std::thread thread([&allocator, &used, i]() {
+            allocator->free(allocator->alloc(sizeof(QuietItem)));
+            used.store(true, std::memory_order_release);
+
+            //! NOTE Every other time, the allocator is most likely destroyed before the thread ends
+            if (i % 2) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+
+        while (!used.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+
+        //! DO Destroy the allocator while the thread ends and releases its magazine
+        allocator.reset();
+        thread.join();
+    }
+
+    //! CHECK Nothing (see the thread sanitizer build): the magazine is released to the allocator or deleted by the thread
+}
+
+//! NOTE The benchmarks are disabled by default, run them with:
+//! global_tests --gtest_filter=*Benchmark* --gtest_also_run_disabled_tests
+TEST_F(Global_AllocatorTests, DISABLED_Benchmark_ConcurrentNewDelete)
+{
+    constexpr size_t THREAD_COUNT = 4;
+    constexpr size_t ITEMS_COUNT = 1000;
+    constexpr size_t ROUNDS = 200;
+
+    ObjectAllocator::DEFAULT_BLOCK_SIZE = 1024 * 256;
+
+    auto run = [&]() {
+        auto start = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < THREAD_COUNT; ++t) {
+            threads.emplace_back([]() {
+                std::vector<ItemBase*> items(ITEMS_COUNT);
+                for (size_t r = 0; r < ROUNDS; ++r) {
+                    for (size_t i = 0; i < ITEMS_COUNT; ++i) {
+                        items[i] = new QuietItem(static_cast<uint8_t>(i));
+                    }
+                    for (ItemBase* item : items) {
+                        delete item;
+                    }
+                }
+            });
+        }
+
+        for (std::thread& th : threads) {
+            th.join();
+        }
+
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    double poolMs = run();
+
+    int used = ObjectAllocator::s_used;
+    ObjectAllocator::s_used = 0;
+    double defaultMs = run();
+    ObjectAllocator::s_used = used;
+
+    std::cout << THREAD_COUNT << " threads, " << THREAD_COUNT * ITEMS_COUNT * ROUNDS << " new/delete: "
+              << "object allocator: " << poolMs << " ms, default allocator: " << defaultMs << " ms" << std::endl;
+}
@@ -0,0 +1,78 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "io/file.h"
+#include "io/mappedfile.h"
+
+using namespace muse;
+using namespace muse::io;
+
+class Global_IO_MappedFileTests : public ::testing::Test
+{
+public:
+};
+
+TEST_F(Global_IO_MappedFileTests, MapWholeFile)
+{
+    path_t filePath("MappedFileTests_Map.bin");
+    std::string ref = "Hello World!";
+
+    {
+        //! GIVEN Some file
+        File f(filePath);
+        EXPECT_TRUE(f.open(IODevice::WriteOnly));
+        f.write(ByteArray(reinterpret_cast<const uint8_t*>(ref.c_str()), ref.size()));
+    }
+
+    {
+        //! DO Map the file
+        MappedFile mapped(filePath);
+
+        //! CHECK The mapping has the content of the file
+        ASSERT_TRUE(mapped.isOpen());
+        ASSERT_EQ(mapped.size(), ref.size());
+        EXPECT_EQ(std::memcmp(mapped.data(), ref.c_str(), ref.size()), 0);
+
+        //! DO Close the mapping
+        mapped.close();
+
+        //! CHECK
+        EXPECT_FALSE(mapped.isOpen());
+        EXPECT_EQ(mapped.data(), nullptr);
+    }
+
+    File::remove(filePath);
+}
+
+TEST_F(Global_IO_MappedFileTests, MissingFile)
+{
+    //! DO Map a file that doesn't exist
+    MappedFile mapped;
+
+    //! CHECK
+    EXPECT_FALSE(mapped.open(path_t("MappedFileTests_Missing.bin")));
+    EXPECT_FALSE(mapped.isOpen());
+    EXPECT_EQ(mapped.size(), 0);
+}
@@ -0,0 +1,106 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "concurrency/spscqueue.h"
+
+using namespace muse;
+
+class Global_SpscQueueTests : public ::testing::Test
+{
+};
+
+TEST_F(Global_SpscQueueTests, PushPop)
+{
+    SpscQueue<int, 4> queue;
+
+    //! [GIVEN] An empty queue
+    int value = 0;
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.pop(value));
+    EXPECT_EQ(queue.front(), nullptr);
+
+    //! [WHEN] Fill it
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.push(i));
+    }
+
+    //! [THEN] There is no room for more items
+    EXPECT_FALSE(queue.push(4));
+
+    //! [THEN] The items come out in order
+    ASSERT_NE(queue.front(), nullptr);
+    EXPECT_EQ(*queue.front(), 0);
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.pop(value));
+        EXPECT_EQ(value, i);
+    }
+
+    EXPECT_TRUE(queue.empty());
+
+    //! [THEN] The queue can be reused after wrapping around
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(queue.push(i));
+        EXPECT_TRUE(queue.pop(value));
+        EXPECT_EQ(value, i);
+    }
+}
+
+TEST_F(Global_SpscQueueTests, ProducerConsumer)
+{
+    SpscQueue<size_t, 64> queue;
+
+    constexpr size_t ITEMS_COUNT = 1000000;
+
+    //! [GIVEN] A producer thread which pushes many items, waiting when the queue is full
+    std::thread producer([&queue]() {
+        for (size_t i = 0; i < ITEMS_COUNT; ++i) {
+            while (!queue.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    //! [WHEN] Consume them in this thread
+    size_t expected = 0;
+    bool isOrdered = true;
+
+    while (expected < ITEMS_COUNT) {
+        size_t value = 0;
+        if (!queue.pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        isOrdered = isOrdered && value == expected;
+        ++expected;
+    }
+
+    producer.join();
+
+    //! [THEN] All the items have been received in order
+    EXPECT_TRUE(isOrdered);
+    EXPECT_TRUE(queue.empty());
+}
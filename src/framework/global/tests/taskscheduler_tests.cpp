@@ -0,0 +1,152 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "concurrency/taskscheduler.h"
+
+using namespace muse;
+
+class Global_TaskSchedulerTests : public ::testing::Test
+{
+};
+
+TEST_F(Global_TaskSchedulerTests, ParallelFor)
+{
+    TaskScheduler scheduler(4);
+
+    //! [GIVEN] Many items
+    std::vector<int> items(10000, 0);
+
+    //! [WHEN] Process them in parallel several times
+    for (int i = 0; i < 10; ++i) {
+        scheduler.parallelFor(items.size(), [&items](size_t idx) {
+            items[idx]++;
+        });
+    }
+
+    //! [THEN] Every item has been processed exactly once per call
+    for (int item : items) {
+        EXPECT_EQ(item, 10);
+    }
+}
+
+TEST_F(Global_TaskSchedulerTests, WaitForGroup)
+{
+    TaskScheduler scheduler(4);
+
+    //! [GIVEN] Single tasks and a batch in one group
+    TaskGroup group;
+    std::atomic<int> counter = 0;
+
+    for (int i = 0; i < 100; ++i) {
+        scheduler.push(group, TaskPriority::Background, [&counter](int value) {
+            counter += value;
+        }, 2);
+    }
+
+    scheduler.submitBatch(group, 1000, [&counter](size_t) {
+        counter++;
+    });
+
+    //! [WHEN] Wait for the group
+    scheduler.wait(group);
+
+    //! [THEN] All the tasks of the group are done
+    EXPECT_TRUE(group.isDone());
+    EXPECT_EQ(counter, 1200);
+}
+
+TEST_F(Global_TaskSchedulerTests, WaitForGroupRunsOnlyItsTasks)
+{
+    TaskScheduler scheduler(1);
+
+    //! [GIVEN] The only worker is busy
+    std::atomic<bool> release = false;
+    std::atomic<bool> workerBusy = false;
+    scheduler.push([&release, &workerBusy]() {
+        workerBusy = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+    });
+
+    while (!workerBusy) {
+        std::this_thread::yield();
+    }
+
+    //! [GIVEN] A background task and a task of a group are queued
+    std::atomic<bool> otherTaskDone = false;
+    scheduler.push([&otherTaskDone]() {
+        otherTaskDone = true;
+    });
+
+    TaskGroup group;
+    std::atomic<bool> groupTaskDone = false;
+    scheduler.push(group, TaskPriority::Interactive, [&groupTaskDone]() {
+        groupTaskDone = true;
+    });
+
+    //! [WHEN] Wait for the group
+    scheduler.wait(group);
+
+    //! [THEN] The waiting thread has executed the task of the group, but not the other one
+    EXPECT_TRUE(groupTaskDone);
+    EXPECT_FALSE(otherTaskDone);
+
+    release = true;
+    scheduler.waitForAllTasksComplete();
+    EXPECT_TRUE(otherTaskDone);
+}
+
+TEST_F(Global_TaskSchedulerTests, NestedParallelFor)
+{
+    TaskScheduler scheduler(2);
+
+    //! [WHEN] A task waits for other tasks of the same scheduler
+    std::atomic<int> counter = 0;
+
+    scheduler.parallelFor(8, [&scheduler, &counter](size_t) {
+        scheduler.parallelFor(100, [&counter](size_t) {
+            counter++;
+        });
+    });
+
+    //! [THEN] No deadlock, everything is done
+    EXPECT_EQ(counter, 800);
+}
+
+TEST_F(Global_TaskSchedulerTests, Submit)
+{
+    TaskScheduler scheduler(2);
+
+    //! [WHEN] Submit a task with a result
+    std::future<int> future = scheduler.submit([](int value) {
+        return value * 2;
+    }, 21);
+
+    //! [THEN] The result is delivered
+    EXPECT_EQ(future.get(), 42);
+}
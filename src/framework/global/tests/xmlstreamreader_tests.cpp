@@ -0,0 +1,188 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "io/buffer.h"
+#include "serialization/xmlstreamreader.h"
+
+using namespace muse;
+using namespace muse::io;
+
+class Global_Ser_XmlStreamReaderTests : public ::testing::Test
+{
+public:
+};
+
+TEST_F(Global_Ser_XmlStreamReaderTests, Tokens)
+{
+    //! GIVEN Document with all supported kinds of tokens
+    ByteArray data("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                   "<museScore version=\"4.20\">\n"
+                   "  <!-- comment -->\n"
+                   "  <a x='1 &amp; 2' y=\"&#65;&#x42;\">t &lt;x&gt;</a>\n"
+                   "  <b/>\n"
+                   "  <c><![CDATA[raw<>]]></c>\n"
+                   "</museScore>\n");
+
+    XmlStreamReader xml(data);
+
+    //! DO / CHECK
+    EXPECT_EQ(xml.readNext(), XmlStreamReader::StartDocument);
+
+    EXPECT_EQ(xml.readNext(), XmlStreamReader::StartElement);
+    EXPECT_EQ(xml.name(), "museScore");
+    EXPECT_EQ(xml.asciiAttribute("version"), "4.20");
+
+    EXPECT_EQ(xml.readNext(), XmlStreamReader::Comment);
+    EXPECT_EQ(xml.asciiText(), " comment ");
+
+    EXPECT_EQ(xml.readNext(), XmlStreamReader::StartElement);
+    EXPECT_EQ(xml.name(), "a");
+    EXPECT_EQ(xml.lineNumber(), 4);
+    ASSERT_EQ(xml.attributeCount(), 2);
+    EXPECT_EQ(xml.attributeAt(0).name, "x");
+    EXPECT_EQ(xml.attributeAt(0).value, "1 & 2");
+    EXPECT_EQ(xml.attributeAt(1).name, "y");
+    EXPECT_EQ(xml.attributeAt(1).value, "AB");
+    EXPECT_EQ(xml.readAsciiText(), "t <x>");
+    EXPECT_TRUE(xml.isEndElement());
+    EXPECT_EQ(xml.name(), "a");
+
+    EXPECT_EQ(xml.readNext(), XmlStreamReader::StartElement);
+    EXPECT_EQ(xml.name(), "b");
+    EXPECT_EQ(xml.readNext(), XmlStreamReader::EndElement);
+    EXPECT_EQ(xml.name(), "b");
+
+    EXPECT_TRUE(xml.readNextStartElement());
+    EXPECT_EQ(xml.name(), "c");
+    EXPECT_EQ(xml.readText(), u"raw<>");
+
+    EXPECT_EQ(xml.readNext(), XmlStreamReader::EndElement);
+    EXPECT_EQ(xml.name(), "museScore");
+    EXPECT_EQ(xml.readNext(), XmlStreamReader::EndDocument);
+    EXPECT_TRUE(xml.atEnd());
+    EXPECT_FALSE(xml.isError());
+}
+
+TEST_F(Global_Ser_XmlStreamReaderTests, ReadFromDevice)
+{
+    //! GIVEN Document bigger than the read chunk
+    std::string doc = "<root>";
+    for (int i = 0; i < 20000; ++i) {
+        doc += "<e id=\"" + std::to_string(i) + "\" v='x&amp;y'>" + std::to_string(i * 2) + "</e>\n";
+    }
+    doc += "</root>";
+
+    ByteArray data(doc.c_str());
+    Buffer buf(&data);
+    buf.open(IODevice::ReadOnly);
+
+    //! DO Read all elements
+    XmlStreamReader xml(&buf);
+    ASSERT_TRUE(xml.readNextStartElement());
+    EXPECT_EQ(xml.name(), "root");
+
+    int count = 0;
+    while (xml.readNextStartElement()) {
+        EXPECT_EQ(xml.name(), "e");
+        int id = xml.intAttribute("id");
+        EXPECT_EQ(xml.asciiAttribute("v"), "x&y");
+        EXPECT_EQ(xml.readInt(), id * 2);
+        ++count;
+    }
+
+    //! CHECK
+    EXPECT_EQ(count, 20000);
+    EXPECT_FALSE(xml.isError());
+}
+
+TEST_F(Global_Ser_XmlStreamReaderTests, AttributesStayValidWhileChildrenAreRead)
+{
+    //! GIVEN Elements with attributes, their children are bigger than the read chunk,
+    //! so the buffer is refilled while the children are read
+    std::string doc = "<root>";
+    for (int i = 0; i < 3; ++i) {
+        doc += "<e type=\"Slur" + std::to_string(i) + "\" v='x&amp;y'>";
+        for (int j = 0; j < 10000; ++j) {
+            doc += "<c n=\"" + std::to_string(j) + "\">text</c>\n";
+        }
+        doc += "</e>";
+    }
+    doc += "</root>";
+
+    ByteArray data(doc.c_str());
+    Buffer buf(&data);
+    buf.open(IODevice::ReadOnly);
+
+    //! DO Hold the attribute views of the element while its children are read
+    XmlStreamReader xml(&buf);
+    ASSERT_TRUE(xml.readNextStartElement());
+
+    int count = 0;
+    while (xml.readNextStartElement()) {
+        const AsciiStringView type = xml.asciiAttribute("type");
+        const AsciiStringView v = xml.asciiAttribute("v");
+
+        int children = 0;
+        while (xml.readNextStartElement()) {
+            EXPECT_EQ(xml.intAttribute("n"), children);
+            xml.skipCurrentElement();
+            ++children;
+        }
+
+        //! CHECK
+        EXPECT_EQ(children, 10000);
+        EXPECT_EQ(type, std::string("Slur" + std::to_string(count)).c_str());
+        EXPECT_EQ(v, "x&y");
+        ++count;
+    }
+
+    EXPECT_EQ(count, 3);
+    EXPECT_FALSE(xml.isError());
+}
+
+TEST_F(Global_Ser_XmlStreamReaderTests, Errors)
+{
+    {
+        //! GIVEN Mismatched end element
+        XmlStreamReader xml(ByteArray("<a><b></a>"));
+        while (!xml.atEnd()) {
+            xml.readNext();
+        }
+
+        //! CHECK
+        EXPECT_EQ(xml.error(), XmlStreamReader::NotWellFormedError);
+    }
+
+    {
+        //! GIVEN Not closed element
+        XmlStreamReader xml(ByteArray("<a><b>"));
+        while (!xml.atEnd()) {
+            xml.readNext();
+        }
+
+        //! CHECK
+        EXPECT_EQ(xml.error(), XmlStreamReader::PrematureEndOfDocumentError);
+    }
+}
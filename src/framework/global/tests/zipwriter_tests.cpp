@@ -0,0 +1,174 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "io/buffer.h"
+#include "serialization/zipreader.h"
+#include "serialization/zipwriter.h"
+
+using namespace muse;
+using namespace muse::io;
+
+using Files = std::vector<std::pair<std::string, ByteArray> >;
+
+class Global_Ser_ZipWriterTests : public ::testing::Test
+{
+public:
+
+    //! NOTE Looks like a project with parts: a big main file, a file per part and a few small files
+    static Files makeFiles(size_t partsCount, size_t chordsCount)
+    {
+        auto makeScore = [chordsCount](size_t seed) {
+            std::string xml = "<museScore version=\"4.50\">\n";
+            for (size_t i = 0; i < chordsCount; ++i) {
+                xml += "<Chord><durationType>quarter</durationType><Note><pitch>" + std::to_string(60 + (i * 7 + seed) % 24)
+                       + "</pitch><tpc>" + std::to_string(14 + (i + seed) % 7) + "</tpc></Note></Chord>\n";
+            }
+            xml += "</museScore>\n";
+            return ByteArray(xml.c_str(), xml.size());
+        };
+
+        Files files;
+        files.push_back({ "META-INF/container.xml", ByteArray("<container/>") });
+        files.push_back({ "score_style.mss", makeScore(0).left(2000) });
+        files.push_back({ "score.mscx", makeScore(0) });
+        for (size_t p = 0; p < partsCount; ++p) {
+            std::string name = "Excerpts/Part " + std::to_string(p) + "/Part " + std::to_string(p) + ".mscx";
+            files.push_back({ name, makeScore(p + 1) });
+        }
+        files.push_back({ "audiosettings.json", ByteArray("{\"tracks\": []}") });
+
+        return files;
+    }
+
+    static ByteArray writeZip(const Files& files, int level, size_t threadCount)
+    {
+        Buffer buf;
+        buf.open(IODevice::WriteOnly);
+
+        ZipWriter zip(&buf);
+        zip.setFileTime(1700000000);
+        zip.setCompressionLevel(level);
+        zip.setThreadCount(threadCount);
+        for (const auto& file : files) {
+            zip.addFile(file.first, file.second);
+        }
+        zip.close();
+
+        EXPECT_FALSE(zip.hasError());
+
+        return buf.data();
+    }
+
+    static void checkZip(const ByteArray& data, const Files& files)
+    {
+        ByteArray copy = data;
+        Buffer buf(&copy);
+        ZipReader reader(&buf);
+
+        std::vector<ZipReader::FileInfo> infos = reader.fileInfoList();
+        ASSERT_EQ(infos.size(), files.size());
+
+        for (size_t i = 0; i < files.size(); ++i) {
+            //! NOTE The files are in the order they were added
+            EXPECT_EQ(infos.at(i).filePath, files.at(i).first);
+            EXPECT_EQ(reader.fileData(files.at(i).first), files.at(i).second);
+        }
+    }
+};
+
+TEST_F(Global_Ser_ZipWriterTests, ParallelCompression_SameAsSequential)
+{
+    //! [GIVEN] Files of a project with parts
+    Files files = makeFiles(10, 300);
+
+    //! [WHEN] Write them compressing one by one and concurrently
+    ByteArray sequential = writeZip(files, ZipWriter::DEFAULT_COMPRESSION, 1);
+    ByteArray parallel = writeZip(files, ZipWriter::DEFAULT_COMPRESSION, 4);
+    ByteArray allThreads = writeZip(files, ZipWriter::DEFAULT_COMPRESSION, 0);
+
+    //! [THEN] The archives are identical and contain the files
+    EXPECT_EQ(parallel, sequential);
+    EXPECT_EQ(allThreads, sequential);
+    checkZip(parallel, files);
+}
+
+TEST_F(Global_Ser_ZipWriterTests, StoreOnly)
+{
+    //! [GIVEN] Files of a project with parts
+    Files files = makeFiles(3, 300);
+
+    size_t totalSize = 0;
+    for (const auto& file : files) {
+        totalSize += file.second.size();
+    }
+
+    //! [WHEN] Write them without compression
+    ByteArray stored = writeZip(files, ZipWriter::NO_COMPRESSION, 4);
+    ByteArray compressed = writeZip(files, ZipWriter::DEFAULT_COMPRESSION, 4);
+
+    //! [THEN] The files are stored as is and can be read
+    EXPECT_GT(stored.size(), totalSize);
+    EXPECT_LT(compressed.size(), totalSize);
+    checkZip(stored, files);
+
+    //! [THEN] The files are readable with other compression levels as well
+    checkZip(writeZip(files, 1, 4), files);
+    checkZip(writeZip(files, 9, 1), files);
+}
+
+TEST_F(Global_Ser_ZipWriterTests, DISABLED_Benchmark_CompressionLevelsAndThreads)
+{
+    //! NOTE A large project: 40 parts
+    Files files = makeFiles(40, 5000);
+
+    size_t totalSize = 0;
+    for (const auto& file : files) {
+        totalSize += file.second.size();
+    }
+
+    std::cout << "files: " << files.size() << ", uncompressed size: " << totalSize / 1024 << " KB" << std::endl;
+
+    for (int level : { ZipWriter::NO_COMPRESSION, 1, ZipWriter::DEFAULT_COMPRESSION, 9 }) {
+        for (size_t threadCount : { 1, 2, 4, 0 }) {
+            constexpr int ROUNDS = 5;
+
+            ByteArray data;
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < ROUNDS; ++i) {
+                data = writeZip(files, level, threadCount);
+            }
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / ROUNDS;
+
+            std::cout << "level: " << level
+                      << ", threads: " << (threadCount == 0 ? std::string("all") : std::to_string(threadCount))
+                      << ", time: " << ms << " ms"
+                      << ", size: " << data.size() / 1024 << " KB" << std::endl;
+        }
+    }
+}
@@ -100,6 +100,11 @@ void AbstractInvoker::onMainThreadInvoke(const std::function<void(const std::fun
     QueuedInvoker::instance()->onMainThreadInvoke(f);
 }
 
+void AbstractInvoker::onQueuedInvoke(const std::function<void()>& f)
+{
+    QueuedInvoker::instance()->onQueuedInvoke(f);
+}
+
 bool AbstractInvoker::isConnected() const
 {
     for (auto it = m_callbacks.cbegin(); it != m_callbacks.cend(); ++it) {
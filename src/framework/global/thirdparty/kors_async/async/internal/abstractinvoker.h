@@ -98,6 +98,7 @@ public:
 
     static void processEvents();
     static void onMainThreadInvoke(const std::function<void(const std::function<void()>&, bool)>& f);
+    static void onQueuedInvoke(const std::function<void()>& f);
 
 protected:
     explicit AbstractInvoker();
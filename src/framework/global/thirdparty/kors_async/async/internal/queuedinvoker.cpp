@@ -39,8 +39,21 @@ void QueuedInvoker::invoke(const std::thread::id& callbackTh, const Functor& f,
         }
     }
 
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
-    m_queues[callbackTh].push(f);
+    Functor onQueued;
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+        m_queues[callbackTh].push(f);
+
+        auto it = m_onQueuedInvoke.find(callbackTh);
+        if (it != m_onQueuedInvoke.end()) {
+            onQueued = it->second;
+        }
+    }
+
+    // called outside the lock, so that it may itself send or process events
+    if (onQueued) {
+        onQueued();
+    }
 }
 
 void QueuedInvoker::processEvents()
@@ -62,6 +75,16 @@ void QueuedInvoker::processEvents()
     }
 }
 
+void QueuedInvoker::onQueuedInvoke(const Functor& f)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    if (f) {
+        m_onQueuedInvoke[std::this_thread::get_id()] = f;
+    } else {
+        m_onQueuedInvoke.erase(std::this_thread::get_id());
+    }
+}
+
 void QueuedInvoker::onMainThreadInvoke(const std::function<void(const std::function<void()>&, bool)>& f)
 {
     m_onMainThreadInvoke = f;
@@ -43,6 +43,11 @@ public:
     void processEvents();
     void onMainThreadInvoke(const std::function<void(const std::function<void()>&, bool)>& f);
 
+    // Called (on the invoking thread) each time a functor is queued for the calling thread,
+    // so that it can sleep until there is something to process instead of polling.
+    // Pass nullptr to remove it, e.g. before the thread exits
+    void onQueuedInvoke(const Functor& f);
+
 private:
 
     QueuedInvoker() = default;
@@ -51,6 +56,7 @@ private:
 
     std::recursive_mutex m_mutex;
     std::map<std::thread::id, Queue > m_queues;
+    std::map<std::thread::id, Functor> m_onQueuedInvoke;
 
     std::function<void(const std::function<void()>&, bool)> m_onMainThreadInvoke;
     std::thread::id m_mainThreadID;
@@ -36,6 +36,11 @@ inline void onMainThreadInvoke(const std::function<void(const std::function<void
 {
     AbstractInvoker::onMainThreadInvoke(f);
 }
+
+inline void onQueuedInvoke(const std::function<void()>& f)
+{
+    AbstractInvoker::onQueuedInvoke(f);
+}
 }
 
 #endif // KORS_ASYNC_PROCESSEVENTS_H
@@ -24,6 +24,7 @@
 
 #include <cstdint>
 #include <array>
+#include <initializer_list>
 #include <set>
 #include <cassert>
 #include <string>
@@ -979,7 +980,8 @@ struct Event {
 private:
     //!Note Temporarily disabled until the end of the investigation, looks like we're not supporting some 'custom' messages from MU3
     //! v.pereverzev@wsmgroup.ru
-    void assertMessageType(const std::set<MessageType>& supportedTypes) const
+    //! NOTE Takes an initializer list rather than a set, so that the (disabled) checks don't allocate on the audio thread
+    void assertMessageType(std::initializer_list<MessageType> supportedTypes) const
     {
         UNUSED(supportedTypes);
         //assert(isMessageTypeIn(supportedTypes));
@@ -991,7 +993,7 @@ private:
 
     //!Note Temporarily disabled until the end of the investigation, looks like we're not supporting some 'custom' messages from MU3
     //! v.pereverzev@wsmgroup.ru
-    void assertOpcode(const std::set<Opcode>& supportedOpcodes) const
+    void assertOpcode(std::initializer_list<Opcode> supportedOpcodes) const
     {
         UNUSED(supportedOpcodes); /*assert(isOpcodeIn(supportedOpcodes));*/
     }
@@ -26,6 +26,7 @@
 #include <variant>
 #include <vector>
 #include <optional>
+#include <limits>
 
 #include "async/channel.h"
 #include "realfn.h"
@@ -45,9 +46,6 @@ struct PlaybackParam;
 using PlaybackParamList = std::vector<PlaybackParam>;
 using PlaybackParamMap = std::map<timestamp_t, PlaybackParamList>;
 
-using MainStreamChanges = async::Channel<PlaybackEventsMap, DynamicLevelMap, PlaybackParamMap>;
-using OffStreamChanges = async::Channel<PlaybackEventsMap, PlaybackParamMap>;
-
 struct ArrangementContext
 {
     timestamp_t nominalTimestamp = 0;
@@ -398,6 +396,44 @@ static const String PLAY_TECHNIQUE_PARAM_CODE(u"playing_technique");
 
 static const std::string ORDINARY_PLAYING_TECHNIQUE_CODE("ordinary_technique");
 
+//! NOTE Replaces all the events within the [from, to] range (both ends inclusive) by the given events
+//!      The default range covers the whole timeline, i.e. the events replace everything
+//!      An empty range (from > to) leaves the events intact
+struct PlaybackEventsChanges {
+    timestamp_t from = std::numeric_limits<timestamp_t>::min();
+    timestamp_t to = std::numeric_limits<timestamp_t>::max();
+    PlaybackEventsMap events;
+
+    bool isFullReplace() const
+    {
+        return from == std::numeric_limits<timestamp_t>::min()
+               && to == std::numeric_limits<timestamp_t>::max();
+    }
+
+    bool isEmptyRange() const
+    {
+        return from > to;
+    }
+
+    void applyTo(PlaybackEventsMap& destination) const
+    {
+        if (isFullReplace()) {
+            destination = events;
+            return;
+        }
+
+        if (isEmptyRange()) {
+            return;
+        }
+
+        destination.erase(destination.lower_bound(from), destination.upper_bound(to));
+        destination.insert(events.cbegin(), events.cend());
+    }
+};
+
+using MainStreamChanges = async::Channel<PlaybackEventsChanges, DynamicLevelMap, PlaybackParamMap>;
+using OffStreamChanges = async::Channel<PlaybackEventsMap, PlaybackParamMap>;
+
 struct PlaybackData {
     PlaybackEventsMap originEvents;
     PlaybackSetupData setupData;
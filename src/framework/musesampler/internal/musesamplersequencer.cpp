@@ -153,15 +153,16 @@ void MuseSamplerSequencer::updateOffStreamEvents(const PlaybackEventsMap& events
             AuditionStartNoteEvent noteOn;
             noteOn.msEvent = { pitch, centsOffset, articulationFlag, notehead, 0.5, presets_cstr, textArticulation_cstr };
             noteOn.msTrack = track;
-            m_offStreamEvents[timestampFrom].emplace(std::move(noteOn));
+            m_offStreamEvents.add(timestampFrom, std::move(noteOn));
 
             AuditionStopNoteEvent noteOff;
             noteOff.msEvent = { pitch };
             noteOff.msTrack = track;
-            m_offStreamEvents[timestampTo].emplace(std::move(noteOff));
+            m_offStreamEvents.add(timestampTo, std::move(noteOff));
         }
     }
 
+    m_offStreamEvents.finalize();
     updateOffSequenceIterator();
 }
 
@@ -110,9 +110,9 @@ samples_t MuseSamplerWrapper::process(float* buffer, samples_t samplesPerChannel
 
     if (!active) {
         msecs_t nextMicros = samplesToMsecs(samplesPerChannel, m_sampleRate);
-        MuseSamplerSequencer::EventSequence sequence = m_sequencer.eventsToBePlayed(nextMicros);
+        m_sequencer.eventsToBePlayed(nextMicros, m_eventsToBePlayed);
 
-        for (const MuseSamplerSequencer::EventType& event : sequence) {
+        for (const MuseSamplerSequencer::EventType& event : m_eventsToBePlayed) {
             handleAuditionEvents(event);
         }
     }
@@ -92,6 +92,7 @@ private:
     bool m_offlineModeStarted = false;
 
     MuseSamplerSequencer m_sequencer;
+    MuseSamplerSequencer::EventSequence m_eventsToBePlayed;
 };
 
 using MuseSamplerWrapperPtr = std::shared_ptr<MuseSamplerWrapper>;
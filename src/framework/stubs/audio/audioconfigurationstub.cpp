@@ -90,9 +90,13 @@ async::Notification AudioConfigurationStub::sampleRateChanged() const
     return async::Notification();
 }
 
-size_t AudioConfigurationStub::minTrackCountForMultithreading() const
+size_t AudioConfigurationStub::renderThreadCount() const
+{
+    return 1;
+}
+
+void AudioConfigurationStub::setRenderThreadCount(size_t)
 {
-    return 0;
 }
 
 // synthesizers
@@ -120,6 +124,11 @@ async::Channel<io::paths_t> AudioConfigurationStub::soundFontDirectoriesChanged(
     return async::Channel<io::paths_t>();
 }
 
+io::path_t AudioConfigurationStub::soundFontSamplesCachePath() const
+{
+    return {};
+}
+
 io::path_t AudioConfigurationStub::knownAudioPluginsFilePath() const
 {
     return {};
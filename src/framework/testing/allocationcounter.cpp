@@ -0,0 +1,66 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "allocationcounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<bool> s_countAllocations = false;
+static std::atomic<size_t> s_allocationsCount = 0;
+
+void* operator new(size_t size)
+{
+    if (s_countAllocations) {
+        ++s_allocationsCount;
+    }
+
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+void muse::testing::startCountingAllocations()
+{
+    s_allocationsCount = 0;
+    s_countAllocations = true;
+}
+
+size_t muse::testing::stopCountingAllocations()
+{
+    s_countAllocations = false;
+    return s_allocationsCount;
+}
@@ -0,0 +1,36 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MUSE_TESTING_ALLOCATIONCOUNTER_H
+#define MUSE_TESTING_ALLOCATIONCOUNTER_H
+
+#include <cstddef>
+
+namespace muse::testing {
+//! NOTE: Counts the heap allocations made by any thread (e.g. the render or layout threads) between start and stop.
+//! The global operator new is replaced for that, so only the test binaries which set MODULE_TEST_COUNT_ALLOCATIONS
+//! (see gtest.cmake) are linked with it
+void startCountingAllocations();
+size_t stopCountingAllocations();
+}
+
+#endif // MUSE_TESTING_ALLOCATIONCOUNTER_H
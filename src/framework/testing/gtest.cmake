@@ -24,6 +24,7 @@
 # set(MODULE_TEST_SRC ...)           - set sources and headers files
 # set(MODULE_TEST_LINK ...)          - set libraries for link
 # set(MODULE_TEST_DATA_ROOT ...)     - set test data root path
+# set(MODULE_TEST_COUNT_ALLOCATIONS ON) - link the allocation counter (replaces the global operator new), see allocationcounter.h
 
 # After all the settings you need to do:
 # include(${PROJECT_SOURCE_DIR}/framework/testing/gtest.cmake)
@@ -33,6 +34,13 @@ message(STATUS "Configuring ${MODULE_TEST}")
 get_property(gmock_LIBS GLOBAL PROPERTY gmock_LIBS)
 get_property(gmock_INCLUDE_DIRS GLOBAL PROPERTY gmock_INCLUDE_DIRS)
 
+if (MODULE_TEST_COUNT_ALLOCATIONS)
+    set(MODULE_TEST_SRC ${MODULE_TEST_SRC}
+        ${CMAKE_CURRENT_LIST_DIR}/allocationcounter.cpp
+        ${CMAKE_CURRENT_LIST_DIR}/allocationcounter.h
+        )
+endif()
+
 add_executable(${MODULE_TEST}
     ${CMAKE_CURRENT_LIST_DIR}/gmain.cpp
     ${CMAKE_CURRENT_LIST_DIR}/environment.cpp
@@ -48,9 +48,7 @@ void VstSequencer::init(ParamsMapping&& mapping)
     m_mapping = std::move(mapping);
     m_inited = true;
 
-    updateMainStreamEvents(m_playbackEventsMap, m_dynamicLevelMap, {});
-
-    m_playbackEventsMap.clear();
+    updateMainStreamEvents(m_mainStreamOrigin, m_dynamicLevelMap, {});
 }
 
 void VstSequencer::updateOffStreamEvents(const mpe::PlaybackEventsMap& events, const mpe::PlaybackParamMap&)
@@ -61,7 +59,8 @@ void VstSequencer::updateOffStreamEvents(const mpe::PlaybackEventsMap& events, c
         m_onOffStreamFlushed();
     }
 
-    updatePlaybackEvents(m_offStreamEvents, events);
+    updatePlaybackEvents(m_offStreamEvents, events.cbegin(), events.cend());
+    m_offStreamEvents.finalize();
     updateOffSequenceIterator();
 }
 
@@ -70,8 +69,8 @@ void VstSequencer::updateMainStreamEvents(const mpe::PlaybackEventsMap& events,
 {
     m_dynamicLevelMap = dynamics;
 
+    //! NOTE The origin events are kept by the base sequencer until the mapping is known
     if (!m_inited) {
-        m_playbackEventsMap = events;
         return;
     }
 
@@ -82,10 +81,32 @@ void VstSequencer::updateMainStreamEvents(const mpe::PlaybackEventsMap& events,
         m_onMainStreamFlushed();
     }
 
-    updatePlaybackEvents(m_mainStreamEvents, events);
+    updatePlaybackEvents(m_mainStreamEvents, events.cbegin(), events.cend());
+    m_mainStreamEvents.finalize();
     updateMainSequenceIterator();
 
     updateDynamicEvents(m_dynamicEvents, dynamics);
+    m_dynamicEvents.finalize();
+    updateDynamicChangesIterator();
+}
+
+void VstSequencer::patchMainStreamEvents(const audio::msecs_t from, const audio::msecs_t to, const mpe::DynamicLevelMap& dynamics,
+                                         const mpe::PlaybackParamMap&)
+{
+    m_dynamicLevelMap = dynamics;
+
+    if (!m_inited) {
+        return;
+    }
+
+    replaceMainStreamRange(from, to, [this](Timeline& destination, mpe::PlaybackEventsMap::const_iterator begin,
+                                            mpe::PlaybackEventsMap::const_iterator end) {
+        updatePlaybackEvents(destination, begin, end);
+    });
+
+    m_dynamicEvents.clear();
+    updateDynamicEvents(m_dynamicEvents, dynamics);
+    m_dynamicEvents.finalize();
     updateDynamicChangesIterator();
 }
 
@@ -95,10 +116,11 @@ muse::audio::gain_t VstSequencer::currentGain() const
     return expressionLevel(currentDynamicLevel);
 }
 
-void VstSequencer::updatePlaybackEvents(EventSequenceMap& destination, const mpe::PlaybackEventsMap& events)
+void VstSequencer::updatePlaybackEvents(Timeline& destination, mpe::PlaybackEventsMap::const_iterator begin,
+                                        mpe::PlaybackEventsMap::const_iterator end)
 {
-    for (const auto& pair : events) {
-        for (const mpe::PlaybackEvent& event : pair.second) {
+    for (auto it = begin; it != end; ++it) {
+        for (const mpe::PlaybackEvent& event : it->second) {
             if (!std::holds_alternative<mpe::NoteEvent>(event)) {
                 continue;
             }
@@ -112,8 +134,8 @@ void VstSequencer::updatePlaybackEvents(EventSequenceMap& destination, const mpe
             float velocityFraction = noteVelocityFraction(noteEvent);
             float tuning = noteTuning(noteEvent, noteId);
 
-            destination[timestampFrom].emplace(buildEvent(VstEvent::kNoteOnEvent, noteId, velocityFraction, tuning));
-            destination[timestampTo].emplace(buildEvent(VstEvent::kNoteOffEvent, noteId, velocityFraction, tuning));
+            destination.add(timestampFrom, buildEvent(VstEvent::kNoteOnEvent, noteId, velocityFraction, tuning));
+            destination.add(timestampTo, buildEvent(VstEvent::kNoteOffEvent, noteId, velocityFraction, tuning));
 
             appendControlSwitch(destination, noteEvent, PEDAL_CC_SUPPORTED_TYPES, SUSTAIN_IDX);
             appendPitchBend(destination, noteEvent, BEND_SUPPORTED_TYPES);
@@ -121,14 +143,14 @@ void VstSequencer::updatePlaybackEvents(EventSequenceMap& destination, const mpe
     }
 }
 
-void VstSequencer::updateDynamicEvents(EventSequenceMap& destination, const mpe::DynamicLevelMap& dynamics)
+void VstSequencer::updateDynamicEvents(Timeline& destination, const mpe::DynamicLevelMap& dynamics)
 {
     for (const auto& pair : dynamics) {
-        destination[pair.first].emplace(expressionLevel(pair.second));
+        destination.add(pair.first, expressionLevel(pair.second));
     }
 }
 
-void VstSequencer::appendControlSwitch(EventSequenceMap& destination, const mpe::NoteEvent& noteEvent,
+void VstSequencer::appendControlSwitch(Timeline& destination, const mpe::NoteEvent& noteEvent,
                                        const mpe::ArticulationTypeSet& appliableTypes, const ControllIdx controlIdx)
 {
     auto controlIt = m_mapping.find(controlIdx);
@@ -149,14 +171,14 @@ void VstSequencer::appendControlSwitch(EventSequenceMap& destination, const mpe:
         const mpe::ArticulationAppliedData& articulationData = noteEvent.expressionCtx().articulations.at(currentType);
         const mpe::ArticulationMeta& articulationMeta = articulationData.meta;
 
-        destination[noteEvent.arrangementCtx().actualTimestamp].emplace(buildParamInfo(controlIt->second, 1 /*on*/));
-        destination[articulationMeta.timestamp + articulationMeta.overallDuration].emplace(buildParamInfo(controlIt->second, 0 /*off*/));
+        destination.add(noteEvent.arrangementCtx().actualTimestamp, buildParamInfo(controlIt->second, 1 /*on*/));
+        destination.add(articulationMeta.timestamp + articulationMeta.overallDuration, buildParamInfo(controlIt->second, 0 /*off*/));
     } else {
-        destination[noteEvent.arrangementCtx().actualTimestamp].emplace(buildParamInfo(controlIt->second, 0 /*off*/));
+        destination.add(noteEvent.arrangementCtx().actualTimestamp, buildParamInfo(controlIt->second, 0 /*off*/));
     }
 }
 
-void VstSequencer::appendPitchBend(EventSequenceMap& destination, const mpe::NoteEvent& noteEvent,
+void VstSequencer::appendPitchBend(Timeline& destination, const mpe::NoteEvent& noteEvent,
                                    const mpe::ArticulationTypeSet& appliableTypes)
 {
     auto pitchBendIt = m_mapping.find(PITCH_BEND_IDX);
@@ -180,7 +202,7 @@ void VstSequencer::appendPitchBend(EventSequenceMap& destination, const mpe::Not
 
     if (currentType == mpe::ArticulationType::Undefined || noteEvent.pitchCtx().pitchCurve.empty()) {
         event.defaultNormalizedValue = 0.5f;
-        destination[timestampFrom].emplace(std::move(event));
+        destination.add(timestampFrom, std::move(event));
         return;
     }
 
@@ -193,7 +215,7 @@ void VstSequencer::appendPitchBend(EventSequenceMap& destination, const mpe::Not
     if (nextIt == endIt) {
         mpe::timestamp_t time = timestampFrom + duration * mpe::percentageToFactor(currIt->first);
         event.defaultNormalizedValue = pitchBendLevel(currIt->second);
-        destination[time].insert(std::move(event));
+        destination.add(time, std::move(event));
         return;
     }
 
@@ -223,7 +245,7 @@ void VstSequencer::appendPitchBend(EventSequenceMap& destination, const mpe::Not
             mpe::timestamp_t time = static_cast<mpe::timestamp_t>(std::round(point.x));
             float bendValue = static_cast<float>(point.y);
             event.defaultNormalizedValue = bendValue;
-            destination[time].insert(event);
+            destination.add(time, event);
         }
     }
 }
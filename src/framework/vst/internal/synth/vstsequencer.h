@@ -62,16 +62,19 @@ public:
     void updateOffStreamEvents(const mpe::PlaybackEventsMap& events, const mpe::PlaybackParamMap& params) override;
     void updateMainStreamEvents(const mpe::PlaybackEventsMap& events, const mpe::DynamicLevelMap& dynamics,
                                 const mpe::PlaybackParamMap& params) override;
+    void patchMainStreamEvents(const audio::msecs_t from, const audio::msecs_t to, const mpe::DynamicLevelMap& dynamics,
+                               const mpe::PlaybackParamMap& params) override;
 
     muse::audio::gain_t currentGain() const;
 
 private:
-    void updatePlaybackEvents(EventSequenceMap& destination, const mpe::PlaybackEventsMap& events);
-    void updateDynamicEvents(EventSequenceMap& destination, const mpe::DynamicLevelMap& dynamics);
+    void updatePlaybackEvents(Timeline& destination, mpe::PlaybackEventsMap::const_iterator begin,
+                              mpe::PlaybackEventsMap::const_iterator end);
+    void updateDynamicEvents(Timeline& destination, const mpe::DynamicLevelMap& dynamics);
 
-    void appendControlSwitch(EventSequenceMap& destination, const mpe::NoteEvent& noteEvent, const mpe::ArticulationTypeSet& appliableTypes,
+    void appendControlSwitch(Timeline& destination, const mpe::NoteEvent& noteEvent, const mpe::ArticulationTypeSet& appliableTypes,
                              const ControllIdx controlIdx);
-    void appendPitchBend(EventSequenceMap& destination, const mpe::NoteEvent& noteEvent, const mpe::ArticulationTypeSet& appliableTypes);
+    void appendPitchBend(Timeline& destination, const mpe::NoteEvent& noteEvent, const mpe::ArticulationTypeSet& appliableTypes);
 
     VstEvent buildEvent(const Steinberg::Vst::Event::EventTypes type, const int32_t noteIdx, const float velocityFraction,
                         const float tuning) const;
@@ -85,7 +88,6 @@ private:
 
     bool m_inited = false;
     ParamsMapping m_mapping;
-    mpe::PlaybackEventsMap m_playbackEventsMap;
 };
 }
 
@@ -190,9 +190,9 @@ muse::audio::samples_t VstSynthesiser::process(float* buffer, muse::audio::sampl
     }
 
     muse::audio::msecs_t nextMsecs = samplesToMsecs(samplesPerChannel, m_sampleRate);
-    VstSequencer::EventSequence sequence = m_sequencer.eventsToBePlayed(nextMsecs);
+    m_sequencer.eventsToBePlayed(nextMsecs, m_eventsToBePlayed);
 
-    for (const VstSequencer::EventType& event : sequence) {
+    for (const VstSequencer::EventType& event : m_eventsToBePlayed) {
         if (std::holds_alternative<VstEvent>(event)) {
             m_vstAudioClient->handleEvent(std::get<VstEvent>(event));
         } else if (std::holds_alternative<PluginParamInfo>(event)) {
@@ -82,6 +82,7 @@ private:
     muse::audio::samples_t m_samplesPerChannel = 0;
 
     VstSequencer m_sequencer;
+    VstSequencer::EventSequence m_eventsToBePlayed;
 
     muse::audio::TrackId m_trackId = muse::audio::INVALID_TRACK_ID;
 };
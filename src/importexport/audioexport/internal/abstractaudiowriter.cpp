@@ -104,6 +104,11 @@ Ret AbstractAudioWriter::doWriteAndWait(INotationPtr notation,
     m_isCompleted = false;
     m_writeRet = muse::Ret();
 
+    //! NOTE The tracks must have the events of the whole score before they are written
+    if (IMasterNotationPtr masterNotation = globalContext()->currentMasterNotation()) {
+        masterNotation->playback()->finishIncrementalLoad();
+    }
+
     playbackController()->setNotation(notation);
     playbackController()->setIsExportingAudio(true);
 
@@ -61,6 +61,9 @@ public:
     virtual muse::RetVal<muse::midi::tick_t> playPositionTickByRawTick(muse::midi::tick_t tick) const = 0;
     virtual muse::RetVal<muse::midi::tick_t> playPositionTickByElement(const EngravingItem* element) const = 0;
 
+    virtual void setPlaybackPosition(muse::midi::tick_t playedTick) = 0;
+    virtual void finishIncrementalLoad() = 0;
+
     enum BoundaryTick {
         FirstScoreTick = 0,
         SelectedNoteTick,
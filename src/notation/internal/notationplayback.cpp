@@ -76,6 +76,10 @@ void NotationPlayback::init()
     m_playbackModel.setPlayRepeats(configuration()->isPlayRepeatsEnabled());
     m_playbackModel.setPlayChordSymbols(configuration()->isPlayChordSymbolsEnabled());
 
+    //! NOTE The console app (e.g. the audio export) needs the whole score right away,
+    //! the export from the GUI app finishes the load before it starts
+    m_playbackModel.setIncrementalLoadEnabled(application()->runMode() == muse::IApplication::RunMode::GuiApp);
+
     m_playbackModel.load(score());
 
     updateTotalPlayTime();
@@ -242,6 +246,16 @@ RetVal<muse::midi::tick_t> NotationPlayback::playPositionTickByElement(const Eng
     return playPositionTickByRawTick(element->tick().ticks());
 }
 
+void NotationPlayback::setPlaybackPosition(tick_t playedTick)
+{
+    m_playbackModel.setPlaybackPosition(static_cast<int>(playedTick));
+}
+
+void NotationPlayback::finishIncrementalLoad()
+{
+    m_playbackModel.finishIncrementalLoad();
+}
+
 void NotationPlayback::addLoopBoundary(LoopBoundaryType boundaryType, tick_t tick)
 {
     if (tick == BoundaryTick::FirstScoreTick) {
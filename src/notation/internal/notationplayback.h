@@ -28,6 +28,8 @@
 #include "async/asyncable.h"
 #include "engraving/playback/playbackmodel.h"
 
+#include "global/iapplication.h"
+
 #include "../inotationplayback.h"
 #include "igetscore.h"
 #include "inotationundostack.h"
@@ -41,6 +43,7 @@ namespace mu::notation {
 class NotationPlayback : public INotationPlayback, public muse::async::Asyncable
 {
     INJECT(INotationConfiguration, configuration)
+    INJECT(muse::IApplication, application)
 
 public:
     NotationPlayback(IGetScore* getScore, muse::async::Notification notationChanged);
@@ -69,6 +72,9 @@ public:
     muse::RetVal<muse::midi::tick_t> playPositionTickByRawTick(muse::midi::tick_t tick) const override;
     muse::RetVal<muse::midi::tick_t> playPositionTickByElement(const EngravingItem* element) const override;
 
+    void setPlaybackPosition(muse::midi::tick_t playedTick) override;
+    void finishIncrementalLoad() override;
+
     void addLoopBoundary(LoopBoundaryType boundaryType, muse::midi::tick_t tick) override;
     void setLoopBoundariesEnabled(bool enabled) override;
     const LoopBoundaries& loopBoundaries() const override;
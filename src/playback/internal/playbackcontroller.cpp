@@ -871,6 +871,9 @@ void PlaybackController::setCurrentPlaybackTime(msecs_t msecs)
     m_currentPlaybackTimeMsecs = msecs;
     m_currentTick = notationPlayback()->secToTick(secondsFromMilliseconds(msecs));
 
+    //! NOTE The part of the score which hasn't been loaded yet is loaded from the playback position first
+    notationPlayback()->setPlaybackPosition(notationPlayback()->secToPlayedTick(secondsFromMilliseconds(msecs)));
+
     m_playbackPositionChanged.notify();
 }
 
@@ -26,6 +26,7 @@
 
 #include "io/path.h"
 #include "types/ret.h"
+#include "async/promise.h"
 
 #include "iprojectaudiosettings.h"
 #include "notation/imasternotation.h"
@@ -72,6 +73,10 @@ public:
     virtual muse::Ret save(const muse::io::path_t& path = muse::io::path_t(), SaveMode saveMode = SaveMode::Save) = 0;
     virtual muse::Ret writeToDevice(QIODevice* device) = 0;
 
+    //! NOTE Same as save(path, SaveMode::AutoSave), but only the writing of the project to memory
+    //! is done on the calling thread, the compression and the writing to the disk are done in background
+    virtual muse::async::Promise<muse::Ret> autoSaveInBackground(const muse::io::path_t& path) = 0;
+
     virtual ProjectMeta metaInfo() const = 0;
     virtual void setMetaInfo(const ProjectMeta& meta, bool undoable = false) = 0;
 
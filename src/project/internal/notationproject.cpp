@@ -28,6 +28,8 @@
 #include "global/io/buffer.h"
 #include "global/io/file.h"
 #include "global/io/ioretcodes.h"
+#include "global/concurrency/concurrent.h"
+#include "global/serialization/zipwriter.h"
 
 #include "engraving/dom/undo.h"
 
@@ -57,6 +59,26 @@ using namespace mu::engraving;
 using namespace mu::notation;
 using namespace mu::project;
 
+static muse::io::path_t savingPath(const muse::io::path_t& path)
+{
+    return engraving::containerPath(path) + "_saving";
+}
+
+static std::string autoSaveSuffix(const muse::io::path_t& path)
+{
+    std::string suffix = io::suffix(path);
+    if (suffix == IProjectAutoSaver::AUTOSAVE_SUFFIX) {
+        suffix = io::suffix(io::completeBasename(path));
+    }
+
+    if (suffix.empty()) {
+        // Then it must be a MSCX folder
+        suffix = engraving::MSCX;
+    }
+
+    return suffix;
+}
+
 static void setupScoreMetaTags(mu::engraving::MasterScore* masterScore, const ProjectCreateOptions& projectOptions)
 {
     if (!projectOptions.title.isEmpty()) {
@@ -494,20 +516,74 @@ Ret NotationProject::save(const muse::io::path_t& path, SaveMode saveMode)
         return ret;
     }
     case SaveMode::AutoSave:
-        std::string suffix = io::suffix(path);
-        if (suffix == IProjectAutoSaver::AUTOSAVE_SUFFIX) {
-            suffix = io::suffix(io::completeBasename(path));
-        }
+        return saveScore(path, autoSaveSuffix(path), false /*generateBackup*/, false /*createThumbnail*/, false /*compress*/);
+    }
 
-        if (suffix.empty()) {
-            // Then it must be a MSCX folder
-            suffix = engraving::MSCX;
-        }
+    return make_ret(notation::Err::UnknownError);
+}
 
-        return saveScore(path, suffix, false /*generateBackup*/, false /*createThumbnail*/);
+async::Promise<Ret> NotationProject::autoSaveInBackground(const muse::io::path_t& path)
+{
+    TRACEFUNC;
+
+    auto result = [](const Ret& ret) {
+        return async::Promise<Ret>([ret](auto resolve, auto reject) {
+            if (!ret) {
+                return reject(ret.code(), ret.text());
+            }
+            return resolve(ret);
+        });
+    };
+
+    const std::string suffix = autoSaveSuffix(path);
+    const MscIoMode ioMode = mscIoModeBySuffix(suffix);
+
+    //! NOTE Exports are not written by MscWriter, they are saved on the calling thread
+    if (ioMode == MscIoMode::Unknown) {
+        return result(saveScore(path, suffix, false /*generateBackup*/, false /*createThumbnail*/));
     }
 
-    return make_ret(notation::Err::UnknownError);
+    Ret ret = checkSaveTarget(path, ioMode);
+    if (!ret) {
+        return result(ret);
+    }
+
+    MscWriter::Params params;
+    params.filePath = savingPath(path);
+    params.mainFileName = engraving::mainFileName(path).toString();
+    params.mode = ioMode;
+    params.compressionLevel = ZipWriter::NO_COMPRESSION;
+    params.snapshot = true;
+
+    MscWriter msczWriter(params);
+    ret = writeProject(msczWriter, false /*onlySelection*/, false /*createThumbnail*/);
+    MscWriter::Snapshot snapshot = msczWriter.takeSnapshot();
+
+    if (!ret) {
+        LOGE() << "failed write project to snapshot: " << ret.toString();
+        return result(ret);
+    }
+
+    //! NOTE The body is called on the next iteration of the event loop (after the caller subscribes to the result),
+    //! it only starts the background task, which doesn't access the project
+    std::shared_ptr<io::IFileSystem> fs = fileSystem();
+    return async::Promise<Ret>([snapshot, fs, path, ioMode](auto resolve, auto reject) {
+        Concurrent::run([snapshot, fs, path, ioMode, resolve, reject]() {
+            Ret ret = MscWriter::writeSnapshot(snapshot);
+            if (ret) {
+                ret = replaceSavedFile(fs, path, ioMode);
+            }
+
+            if (!ret) {
+                (void)reject(ret.code(), ret.text());
+                return;
+            }
+
+            (void)resolve(ret);
+        });
+
+        return async::Promise<Ret>::Result::unchecked();
+    }, async::Promise<Ret>::AsynchronyType::ProvidedByPromise);
 }
 
 Ret NotationProject::writeToDevice(QIODevice* device)
@@ -550,7 +626,8 @@ Ret NotationProject::writeToDevice(QIODevice* device)
     return ret;
 }
 
-Ret NotationProject::saveScore(const muse::io::path_t& path, const std::string& fileSuffix, bool generateBackup, bool createThumbnail)
+Ret NotationProject::saveScore(const muse::io::path_t& path, const std::string& fileSuffix, bool generateBackup, bool createThumbnail,
+                               bool compress)
 {
     if (!isMuseScoreFile(fileSuffix) && !fileSuffix.empty()) {
         return exportProject(path, fileSuffix);
@@ -558,41 +635,29 @@ Ret NotationProject::saveScore(const muse::io::path_t& path, const std::string&
 
     MscIoMode ioMode = mscIoModeBySuffix(fileSuffix);
 
-    return doSave(path, ioMode, generateBackup, createThumbnail);
+    return doSave(path, ioMode, generateBackup, createThumbnail, compress);
 }
 
-Ret NotationProject::doSave(const muse::io::path_t& path, engraving::MscIoMode ioMode, bool generateBackup, bool createThumbnail)
+Ret NotationProject::doSave(const muse::io::path_t& path, engraving::MscIoMode ioMode, bool generateBackup, bool createThumbnail,
+                            bool compress)
 {
     TRACEFUNC;
 
-    QString targetContainerPath = engraving::containerPath(path).toQString();
-    muse::io::path_t targetMainFilePath = engraving::mainFilePath(path);
-    muse::io::path_t targetMainFileName = engraving::mainFileName(path);
-    QString savePath = targetContainerPath + "_saving";
-
     // Step 1: check writable
     {
-        if ((fileSystem()->exists(savePath) && !fileSystem()->isWritable(savePath))
-            || (fileSystem()->exists(targetContainerPath) && !fileSystem()->isWritable(targetContainerPath))) {
-            LOGE() << "failed save, not writable path: " << targetContainerPath;
-            return make_ret(io::Err::FSWriteError);
-        }
-
-        if (ioMode == engraving::MscIoMode::Dir) {
-            // Dir needs to be created, otherwise we can't move to it
-            if (!QDir(targetContainerPath).mkpath(".")) {
-                LOGE() << "Couldn't create container directory: " << targetContainerPath;
-                return make_ret(io::Err::FSMakingError);
-            }
+        Ret ret = checkSaveTarget(path, ioMode);
+        if (!ret) {
+            return ret;
         }
     }
 
     // Step 2: write project
     {
         MscWriter::Params params;
-        params.filePath = savePath;
-        params.mainFileName = targetMainFileName.toQString();
+        params.filePath = savingPath(path);
+        params.mainFileName = engraving::mainFileName(path).toString();
         params.mode = ioMode;
+        params.compressionLevel = compress ? ZipWriter::DEFAULT_COMPRESSION : ZipWriter::NO_COMPRESSION;
         IF_ASSERT_FAILED(params.mode != MscIoMode::Unknown) {
             return make_ret(Ret::Code::InternalError);
         }
@@ -620,36 +685,67 @@ Ret NotationProject::doSave(const muse::io::path_t& path, engraving::MscIoMode i
     }
 
     // Step 4: replace to saved file
-    {
-        if (ioMode == MscIoMode::Dir) {
-            RetVal<io::paths_t> filesToBeMoved = fileSystem()->scanFiles(savePath, { "*" }, io::ScanMode::FilesAndFoldersInCurrentDir);
-            if (!filesToBeMoved.ret) {
-                return filesToBeMoved.ret;
-            }
+    return replaceSavedFile(fileSystem(), path, ioMode);
+}
 
-            Ret ret = muse::make_ok();
+Ret NotationProject::checkSaveTarget(const muse::io::path_t& path, engraving::MscIoMode ioMode) const
+{
+    QString targetContainerPath = engraving::containerPath(path).toQString();
+    QString savePath = savingPath(path).toQString();
 
-            for (const muse::io::path_t& fileToBeMoved : filesToBeMoved.val) {
-                muse::io::path_t destinationFile
-                    = muse::io::path_t(targetContainerPath).appendingComponent(io::filename(fileToBeMoved));
-                LOGD() << fileToBeMoved << " to " << destinationFile;
-                ret = fileSystem()->move(fileToBeMoved, destinationFile, true);
-                if (!ret) {
-                    return ret;
-                }
-            }
+    if ((fileSystem()->exists(savePath) && !fileSystem()->isWritable(savePath))
+        || (fileSystem()->exists(targetContainerPath) && !fileSystem()->isWritable(targetContainerPath))) {
+        LOGE() << "failed save, not writable path: " << targetContainerPath;
+        return make_ret(io::Err::FSWriteError);
+    }
 
-            // Try to remove the temp save folder (not problematic if fails)
-            ret = fileSystem()->remove(savePath, true);
-            if (!ret) {
-                LOGW() << ret.toString();
-            }
-        } else {
-            Ret ret = fileSystem()->move(savePath, targetContainerPath, true);
+    if (ioMode == engraving::MscIoMode::Dir) {
+        // Dir needs to be created, otherwise we can't move to it
+        if (!QDir(targetContainerPath).mkpath(".")) {
+            LOGE() << "Couldn't create container directory: " << targetContainerPath;
+            return make_ret(io::Err::FSMakingError);
+        }
+    }
+
+    return make_ok();
+}
+
+//! NOTE Doesn't access the project, so it can be called on a background thread
+Ret NotationProject::replaceSavedFile(const std::shared_ptr<io::IFileSystem>& fileSystem, const muse::io::path_t& path,
+                                      engraving::MscIoMode ioMode)
+{
+    QString targetContainerPath = engraving::containerPath(path).toQString();
+    muse::io::path_t targetMainFilePath = engraving::mainFilePath(path);
+    muse::io::path_t savePath = savingPath(path);
+
+    if (ioMode == MscIoMode::Dir) {
+        RetVal<io::paths_t> filesToBeMoved = fileSystem->scanFiles(savePath, { "*" }, io::ScanMode::FilesAndFoldersInCurrentDir);
+        if (!filesToBeMoved.ret) {
+            return filesToBeMoved.ret;
+        }
+
+        Ret ret = muse::make_ok();
+
+        for (const muse::io::path_t& fileToBeMoved : filesToBeMoved.val) {
+            muse::io::path_t destinationFile
+                = muse::io::path_t(targetContainerPath).appendingComponent(io::filename(fileToBeMoved));
+            LOGD() << fileToBeMoved << " to " << destinationFile;
+            ret = fileSystem->move(fileToBeMoved, destinationFile, true);
             if (!ret) {
                 return ret;
             }
         }
+
+        // Try to remove the temp save folder (not problematic if fails)
+        ret = fileSystem->remove(savePath, true);
+        if (!ret) {
+            LOGW() << ret.toString();
+        }
+    } else {
+        Ret ret = fileSystem->move(savePath, targetContainerPath, true);
+        if (!ret) {
+            return ret;
+        }
     }
 
     // make file readable by all
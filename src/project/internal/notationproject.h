@@ -91,6 +91,7 @@ public:
 
     muse::Ret save(const muse::io::path_t& path = muse::io::path_t(), SaveMode saveMode = SaveMode::Save) override;
     muse::Ret writeToDevice(QIODevice* device) override;
+    muse::async::Promise<muse::Ret> autoSaveInBackground(const muse::io::path_t& path) override;
 
     ProjectMeta metaInfo() const override;
     void setMetaInfo(const ProjectMeta& meta, bool undoable = false) override;
@@ -107,10 +108,14 @@ private:
     muse::Ret doImport(const muse::io::path_t& path, const muse::io::path_t& stylePath, bool forceMode);
 
     muse::Ret saveScore(const muse::io::path_t& path, const std::string& fileSuffix, bool generateBackup = true,
-                        bool createThumbnail = true);
+                        bool createThumbnail = true, bool compress = true);
     muse::Ret saveSelectionOnScore(const muse::io::path_t& path = muse::io::path_t());
     muse::Ret exportProject(const muse::io::path_t& path, const std::string& suffix);
-    muse::Ret doSave(const muse::io::path_t& path, engraving::MscIoMode ioMode, bool generateBackup = true, bool createThumbnail = true);
+    muse::Ret doSave(const muse::io::path_t& path, engraving::MscIoMode ioMode, bool generateBackup = true, bool createThumbnail = true,
+                     bool compress = true);
+    muse::Ret checkSaveTarget(const muse::io::path_t& path, engraving::MscIoMode ioMode) const;
+    static muse::Ret replaceSavedFile(const std::shared_ptr<muse::io::IFileSystem>& fileSystem, const muse::io::path_t& path,
+                                      engraving::MscIoMode ioMode);
     muse::Ret makeCurrentFileAsBackup();
     muse::Ret writeProject(engraving::MscWriter& msczWriter, bool onlySelection, bool createThumbnail = true);
 
@@ -21,6 +21,8 @@
  */
 #include "projectautosaver.h"
 
+#include <chrono>
+
 #include "engraving/infrastructure/mscio.h"
 
 #include "defer.h"
@@ -145,12 +147,18 @@ void ProjectAutoSaver::onTrySave()
 {
     TRACEFUNC;
 
+    bool restartTimer = true;
     DEFER {
-        if (configuration()->isAutoSaveEnabled()) {
+        if (restartTimer && configuration()->isAutoSaveEnabled()) {
             m_timer.start();
         }
     };
 
+    if (m_isSaving) {
+        LOGD() << "[autosave] the previous save is not finished";
+        return;
+    }
+
     INotationProjectPtr project = globalContext()->currentProject();
     if (!project) {
         LOGD() << "[autosave] no project";
@@ -170,13 +178,54 @@ void ProjectAutoSaver::onTrySave()
     muse::io::path_t projectPath = this->projectPath(project);
     muse::io::path_t savePath = project->isNewlyCreated() ? projectPath : projectAutoSavePath(projectPath);
 
-    Ret ret = project->save(savePath, SaveMode::AutoSave);
+    //! NOTE The project is written to memory here, this is the time the UI is blocked;
+    //! the compression and the writing of the file are done in background
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+
+    async::Promise<Ret> promise = project->autoSaveInBackground(savePath);
+
+    const Clock::time_point backgroundStart = Clock::now();
+    LOGI() << "[autosave] UI blocked for: "
+           << std::chrono::duration_cast<std::chrono::milliseconds>(backgroundStart - start).count() << " ms";
+
+    //! NOTE Changes made from now on are not in the saved file
+    project->setNeedAutoSave(false);
+
+    m_isSaving = true;
+    restartTimer = false;
+
+    promise.onResolve(this, [this, project, projectPath, backgroundStart](const Ret& ret) {
+        LOGI() << "[autosave] saved in background for: "
+               << std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - backgroundStart).count() << " ms";
+        onSaveFinished(project, projectPath, ret);
+    });
+
+    promise.onReject(this, [this, project, projectPath](int code, const std::string& msg) {
+        onSaveFinished(project, projectPath, Ret(code, msg));
+    });
+}
+
+void ProjectAutoSaver::onSaveFinished(INotationProjectPtr project, const muse::io::path_t& projectPath, const Ret& ret)
+{
+    m_isSaving = false;
+
+    if (configuration()->isAutoSaveEnabled()) {
+        m_timer.start();
+    }
+
     if (!ret) {
         LOGE() << "[autosave] failed to save project, err: " << ret.toString();
+        project->setNeedAutoSave(true);
         return;
     }
 
-    project->setNeedAutoSave(false);
+    //! NOTE The project has been saved, renamed or closed while the autosave was written
+    if (m_lastProjectPathNeedingAutosave != projectPath) {
+        LOGD() << "[autosave] the project does not need the autosave anymore";
+        removeProjectUnsavedChanges(projectPath);
+        return;
+    }
 
     LOGD() << "[autosave] successfully saved project";
 }
@@ -62,8 +62,11 @@ private:
 
     muse::io::path_t projectPath(INotationProjectPtr project) const;
 
+    void onSaveFinished(INotationProjectPtr project, const muse::io::path_t& projectPath, const muse::Ret& ret);
+
     QTimer m_timer;
     muse::io::path_t m_lastProjectPathNeedingAutosave;
+    bool m_isSaving = false;
 };
 }
 